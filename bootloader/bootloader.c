@@ -0,0 +1,41 @@
+#include "pico/stdlib.h"
+#include "pico/bootrom.h"
+#include "hardware/resets.h"
+#include "hardware/regs/m0plus.h"
+#include "ota.h"
+#include "ota_flash.h"
+
+// Bootloader do OTA: ocupa os primeiros 32K da flash, escolhe o banco (ver
+// lib/ota.h) e salta para a imagem dele. Não usa stdio nem interrupções.
+
+#define PPB(offset) (*(volatile uint32_t *)(PPB_BASE + (offset)))
+
+// Devolve o chip perto do estado de reset e entra na tabela de vetores da
+// imagem. O clock do sistema continua no PLL: a aplicação o reconfigura.
+static void __attribute__((noreturn)) saltar_para(uint32_t vetores)
+{
+    const uint32_t *tabela = (const uint32_t *)vetores;
+
+    PPB(M0PLUS_SYST_CSR_OFFSET) = 0;
+    PPB(M0PLUS_NVIC_ICER_OFFSET) = 0xFFFFFFFFu;
+    PPB(M0PLUS_NVIC_ICPR_OFFSET) = 0xFFFFFFFFu;
+    reset_block_mask(~(RESETS_RESET_IO_QSPI_BITS | RESETS_RESET_PADS_QSPI_BITS | RESETS_RESET_SYSCFG_BITS |
+                       RESETS_RESET_PLL_SYS_BITS));
+
+    PPB(M0PLUS_VTOR_OFFSET) = vetores;
+    __asm volatile("msr msp, %0\n"
+                   "bx %1\n"
+                   :
+                   : "r"(tabela[0]), "r"(tabela[1]));
+    __builtin_unreachable();
+}
+
+int main(void)
+{
+    uint8_t banco = ota_escolher_banco(&OTA_FLASH_PICO);
+    uint32_t offset = OTA_BANCO_OFFSET(banco);
+    if (!ota_imagem_valida(OTA_FLASH_PICO.ler(offset), banco))
+        reset_usb_boot(0, 0); // Nenhum banco gravado: espera o firmware pela USB
+
+    saltar_para(OTA_XIP_BASE + offset + OTA_VETORES);
+}
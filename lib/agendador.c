@@ -0,0 +1,146 @@
+#include "agendador.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+static Tarefa *tarefas[AGENDADOR_MAX_TAREFAS];
+static int num_tarefas;
+
+// Fila circular de eventos: interrupções escrevem, o laço principal lê
+static Evento eventos[AGENDADOR_MAX_EVENTOS];
+static volatile uint32_t evento_escrita;
+static volatile uint32_t evento_leitura;
+static volatile uint32_t eventos_descartados;
+static evento_tratador_t tratador_eventos;
+
+bool agendador_registrar(Tarefa *tarefa)
+{
+    if (num_tarefas == AGENDADOR_MAX_TAREFAS)
+        return false;
+
+    tarefa->pendente = tarefa->periodo_us > 0;
+    tarefa->proxima_us = time_us_64();
+    tarefas[num_tarefas++] = tarefa;
+    return true;
+}
+
+void agendador_definir_tratador(evento_tratador_t tratador)
+{
+    tratador_eventos = tratador;
+}
+
+void agendador_agendar(Tarefa *tarefa, uint32_t atraso_us)
+{
+    tarefa->proxima_us = time_us_64() + atraso_us;
+    tarefa->pendente = true;
+}
+
+bool agendador_publicar(uint8_t tipo, uint32_t dado)
+{
+    uint32_t interrupcoes = save_and_disable_interrupts();
+    bool aceito = evento_escrita - evento_leitura < AGENDADOR_MAX_EVENTOS;
+    if (aceito)
+    {
+        eventos[evento_escrita % AGENDADOR_MAX_EVENTOS] = (Evento){tipo, dado};
+        evento_escrita++;
+    }
+    else
+    {
+        eventos_descartados++;
+    }
+    restore_interrupts(interrupcoes);
+    __sev(); // Acorda o laço principal se ele estiver em WFE
+    return aceito;
+}
+
+static void tratar_eventos(void)
+{
+    while (evento_leitura != evento_escrita)
+    {
+        Evento evento = eventos[evento_leitura % AGENDADOR_MAX_EVENTOS];
+        evento_leitura++;
+        if (tratador_eventos)
+            tratador_eventos(&evento);
+    }
+}
+
+static void rodar_tarefa(Tarefa *tarefa, uint64_t agora)
+{
+    if (tarefa->periodo_us > 0)
+    {
+        // Próxima liberação no ritmo do período; se já passou, pula as perdidas
+        tarefa->proxima_us += tarefa->periodo_us;
+        if (tarefa->proxima_us <= agora)
+        {
+            uint64_t perdidas = (agora - tarefa->proxima_us) / tarefa->periodo_us + 1;
+            tarefa->atrasos += (uint32_t)perdidas;
+            tarefa->proxima_us += perdidas * tarefa->periodo_us;
+        }
+    }
+    else
+    {
+        tarefa->pendente = false;
+    }
+
+    tarefa->funcao(tarefa->contexto);
+
+    uint32_t duracao = (uint32_t)(time_us_64() - agora);
+    uint32_t prazo = tarefa->prazo_us ? tarefa->prazo_us : tarefa->periodo_us;
+    tarefa->execucoes++;
+    tarefa->duracao_us = duracao;
+    if (duracao > tarefa->duracao_max_us)
+        tarefa->duracao_max_us = duracao;
+    if (prazo && duracao > prazo)
+        tarefa->estouros++;
+}
+
+void agendador_executar(void)
+{
+    while (true)
+    {
+        tratar_eventos();
+
+        // Uma tarefa por passada, a de maior prioridade entre as liberadas:
+        // eventos novos são atendidos entre duas tarefas
+        uint64_t agora = time_us_64();
+        uint64_t proxima = UINT64_MAX;
+        Tarefa *escolhida = NULL;
+        for (int i = 0; i < num_tarefas; i++)
+        {
+            Tarefa *tarefa = tarefas[i];
+            if (!tarefa->pendente)
+                continue;
+            if (tarefa->proxima_us <= agora)
+            {
+                escolhida = tarefa;
+                break;
+            }
+            if (tarefa->proxima_us < proxima)
+                proxima = tarefa->proxima_us;
+        }
+
+        if (escolhida)
+        {
+            rodar_tarefa(escolhida, agora);
+            continue;
+        }
+
+        // Nada a fazer: dorme até a próxima liberação ou até uma interrupção
+        if (evento_leitura == evento_escrita && proxima != UINT64_MAX)
+            best_effort_wfe_or_timeout(from_us_since_boot(proxima));
+    }
+}
+
+int agendador_num_tarefas(void)
+{
+    return num_tarefas;
+}
+
+const Tarefa *agendador_tarefa(int indice)
+{
+    return indice >= 0 && indice < num_tarefas ? tarefas[indice] : NULL;
+}
+
+uint32_t agendador_eventos_descartados(void)
+{
+    return eventos_descartados;
+}
@@ -0,0 +1,70 @@
+#ifndef AGENDADOR_H
+#define AGENDADOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------- Limites ---------- */
+#define AGENDADOR_MAX_TAREFAS 12
+#define AGENDADOR_MAX_EVENTOS 16 // Capacidade da fila de eventos (potência de 2)
+
+typedef void (*tarefa_funcao_t)(void *contexto);
+
+/* ---------- Tarefa ---------- */
+// Tarefas rodam até o fim (sem preempção) no laço principal. Uma tarefa
+// periódica é liberada a cada @p periodo_us; com período 0 ela só roda quando
+// agendada por agendador_agendar(). Nenhuma tarefa deve bloquear.
+typedef struct {
+    const char *nome;
+    tarefa_funcao_t funcao;
+    void *contexto;
+    uint32_t periodo_us;
+    uint32_t prazo_us;      // Duração máxima esperada (0 = o próprio período)
+
+    // Estado
+    bool pendente;
+    uint64_t proxima_us;
+
+    // Estatísticas
+    uint32_t execucoes;
+    uint32_t estouros;      // Execuções mais longas que o prazo
+    uint32_t atrasos;       // Liberações perdidas por começar depois do período seguinte
+    uint32_t duracao_us;
+    uint32_t duracao_max_us;
+} Tarefa;
+
+/* ---------- Evento ---------- */
+// Publicado por interrupções e tratado no laço principal, antes das tarefas.
+typedef struct {
+    uint8_t tipo;
+    uint32_t dado;
+} Evento;
+
+typedef void (*evento_tratador_t)(const Evento *evento);
+
+/* ---------- API ---------- */
+
+// Adiciona uma tarefa; as periódicas começam a rodar na primeira passada.
+// A ordem de registro define a prioridade entre tarefas liberadas juntas.
+bool agendador_registrar(Tarefa *tarefa);
+
+// Define a função que recebe os eventos publicados.
+void agendador_definir_tratador(evento_tratador_t tratador);
+
+// Libera a tarefa daqui a @p atraso_us (substitui uma liberação pendente).
+void agendador_agendar(Tarefa *tarefa, uint32_t atraso_us);
+
+// Publica um evento. Pode ser chamada de interrupções; retorna false (e conta
+// o descarte) se a fila estiver cheia.
+bool agendador_publicar(uint8_t tipo, uint32_t dado);
+
+// Laço principal: trata eventos, roda as tarefas liberadas e dorme (WFE) até a
+// próxima liberação ou interrupção. Não retorna.
+void agendador_executar(void);
+
+// Consulta das tarefas registradas, para a telemetria.
+int agendador_num_tarefas(void);
+const Tarefa *agendador_tarefa(int indice);
+uint32_t agendador_eventos_descartados(void);
+
+#endif // AGENDADOR_H
@@ -2,6 +2,7 @@
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "aht20.h"
+#include "i2c_fila.h"
 
 /* ---------- Constantes do Sensor AHT20 ---------- */
 #define AHT20_I2C_ADDR      0x38
@@ -11,18 +12,47 @@
 #define AHT20_STATUS_BUSY   0x80  // Bit de status ocupado
 #define AHT20_STATUS_CALIBRATED 0x08  // Bit de calibração
 
+/* ---------- Funções Internas ---------- */
+
+// CRC-8 do AHT20 (polinômio 0x31, valor inicial 0xFF) sobre status + 5 bytes
+static uint8_t aht20_crc8(const uint8_t *data, int len) {
+    uint8_t crc = 0xFF;
+    for (int i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Converte os 6 bytes lidos do sensor (status + 5 bytes de dados)
+static void aht20_convert(const uint8_t *buffer, AHT20_Data *data) {
+    // Processa os dados de umidade (20 bits)
+    uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) | 
+                           ((uint32_t)buffer[2] << 4) | 
+                           (buffer[3] >> 4);
+    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;
+
+    // Processa os dados de temperatura (20 bits)
+    uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | 
+                        ((uint32_t)buffer[4] << 8) | 
+                        buffer[5];
+    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
+}
+
 /* ---------- Funções Públicas ---------- */
 
-bool aht20_init(i2c_inst_t *i2c) {
+bool aht20_init(i2c_inst_t *i2c, uint8_t addr) {
     uint8_t init_cmd[3] = {AHT20_CMD_INIT, 0x08, 0x00};
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, init_cmd, 3, false);
+    i2c_fila_escrever(i2c, addr, init_cmd, 3);
     sleep_ms(50);  // Aguarda o sensor inicializar
 
     // Verifica status até que o sensor esteja pronto
     uint8_t status;
     for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false);
-        if ((status & AHT20_STATUS_CALIBRATED) == AHT20_STATUS_CALIBRATED) {
+        if (i2c_fila_ler(i2c, addr, &status, 1) == 1 &&
+            (status & AHT20_STATUS_CALIBRATED) == AHT20_STATUS_CALIBRATED) {
             return true;  // Sensor calibrado e pronto
         }
         sleep_ms(10);
@@ -31,18 +61,62 @@ bool aht20_init(i2c_inst_t *i2c) {
     return false;  // Falhou na calibração
 }
 
-bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
+bool aht20_trigger(i2c_inst_t *i2c, uint8_t addr) {
     uint8_t trigger_cmd[3] = {AHT20_CMD_TRIGGER, 0x33, 0x00};
+    return i2c_fila_escrever(i2c, addr, trigger_cmd, 3) == 3;
+}
+
+bool aht20_request_result(i2c_inst_t *i2c, uint8_t addr, AHT20_Leitura *leitura) {
+    // Status + 5 bytes de dados + CRC
+    leitura->transacao = (I2CTransacao){
+        .endereco = addr,
+        .leitura = leitura->buffer,
+        .leitura_len = sizeof(leitura->buffer),
+    };
+    return i2c_fila_enviar(i2c, &leitura->transacao);
+}
+
+AHT20_Result aht20_finish_result(AHT20_Leitura *leitura, AHT20_Data *data) {
+    const uint8_t *buffer = leitura->buffer;
+
+    if (i2c_fila_aguardar(&leitura->transacao) != I2C_FILA_OK) {
+        return AHT20_ERRO_I2C;
+    }
+    if (buffer[0] & AHT20_STATUS_BUSY) {
+        return AHT20_ERRO_OCUPADO;
+    }
+    if (!(buffer[0] & AHT20_STATUS_CALIBRATED)) {
+        return AHT20_ERRO_NAO_CALIBRADO;
+    }
+    if (aht20_crc8(buffer, 6) != buffer[6]) {
+        return AHT20_ERRO_CRC;
+    }
+
+    aht20_convert(buffer, data);
+    return AHT20_OK;
+}
+
+AHT20_Result aht20_read_result(i2c_inst_t *i2c, uint8_t addr, AHT20_Data *data) {
+    AHT20_Leitura leitura;
+    if (!aht20_request_result(i2c, addr, &leitura)) {
+        return AHT20_ERRO_I2C;
+    }
+    return aht20_finish_result(&leitura, data);
+}
+
+bool aht20_read(i2c_inst_t *i2c, uint8_t addr, AHT20_Data *data) {
     uint8_t buffer[6];
 
     // Envia comando de medição
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, trigger_cmd, 3, false);
+    if (!aht20_trigger(i2c, addr)) {
+        return false;
+    }
     
     // Aguarda até o sensor estar pronto
-    uint8_t status;
+    uint8_t status = AHT20_STATUS_BUSY;
     for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false);
-        if (!(status & AHT20_STATUS_BUSY)) {
+        if (i2c_fila_ler(i2c, addr, &status, 1) == 1 &&
+            !(status & AHT20_STATUS_BUSY)) {
             break;
         }
         sleep_ms(10);
@@ -54,33 +128,22 @@ bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
     }
 
     // Lê os 6 bytes de dados
-    if (i2c_read_blocking(i2c, AHT20_I2C_ADDR, buffer, 6, false) != 6) {
+    if (i2c_fila_ler(i2c, addr, buffer, 6) != 6) {
         return false;
     }
 
-    // Processa os dados de umidade (20 bits)
-    uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) | 
-                           ((uint32_t)buffer[2] << 4) | 
-                           (buffer[3] >> 4);
-    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;
-
-    // Processa os dados de temperatura (20 bits)
-    uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | 
-                        ((uint32_t)buffer[4] << 8) | 
-                        buffer[5];
-    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
-
+    aht20_convert(buffer, data);
     return true;
 }
 
-void aht20_reset(i2c_inst_t *i2c) {
+bool aht20_reset(i2c_inst_t *i2c, uint8_t addr) {
     uint8_t reset_cmd = AHT20_CMD_RESET;
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, &reset_cmd, 1, false);
+    i2c_fila_escrever(i2c, addr, &reset_cmd, 1);
     sleep_ms(20);
-    aht20_init(i2c);
+    return aht20_init(i2c, addr);
 }
 
-bool aht20_check(i2c_inst_t *i2c) {
+bool aht20_check(i2c_inst_t *i2c, uint8_t addr) {
     uint8_t status;
-    return i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false) == 1;
+    return i2c_fila_ler(i2c, addr, &status, 1) == 1;
 }
@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include "hardware/i2c.h"
+#include "i2c_fila.h"
 
 /* ---------- Configurações do Sensor AHT20 ---------- */
 #define AHT20_I2C_ADDR      0x38
@@ -12,6 +13,18 @@
 #define AHT20_CMD_TRIGGER   0xAC
 #define AHT20_CMD_RESET     0xBA
 
+/* ---------- Temporização ---------- */
+#define AHT20_TEMPO_MEDICAO_MS 80  // Tempo típico de conversão após o disparo
+
+/* ---------- Resultado de uma leitura ---------- */
+typedef enum {
+    AHT20_OK,
+    AHT20_ERRO_I2C,           // Sensor não respondeu
+    AHT20_ERRO_OCUPADO,       // Conversão ainda em andamento
+    AHT20_ERRO_NAO_CALIBRADO, // Bit de calibração zerado no status
+    AHT20_ERRO_CRC            // Quadro corrompido no barramento
+} AHT20_Result;
+
 /* ---------- Estrutura de Dados ---------- */
 // Estrutura para armazenar os valores de temperatura e umidade
 typedef struct {
@@ -19,18 +32,40 @@ typedef struct {
     float humidity;
 } AHT20_Data;
 
+// Leitura assíncrona: transação e buffer precisam viver até aht20_finish_result()
+typedef struct {
+    I2CTransacao transacao;
+    uint8_t buffer[7];
+} AHT20_Leitura;
+
 /* ---------- API do Sensor AHT20 ---------- */
+// Todas as funções recebem o endereço do sensor (normalmente AHT20_I2C_ADDR),
+// permitindo vários sensores em barramentos diferentes ou atrás de um mux.
+// O tráfego passa pela fila I2C (i2c_fila.h), que deve estar iniciada no barramento.
 
 // Inicializa o sensor AHT20
-bool aht20_init(i2c_inst_t *i2c);
+bool aht20_init(i2c_inst_t *i2c, uint8_t addr);
+
+// Faz leitura de temperatura e umidade do AHT20 (bloqueia até a conversão terminar)
+bool aht20_read(i2c_inst_t *i2c, uint8_t addr, AHT20_Data *data);
+
+// Dispara uma medição sem esperar o resultado
+bool aht20_trigger(i2c_inst_t *i2c, uint8_t addr);
+
+// Lê o resultado de uma medição disparada com aht20_trigger(), validando
+// o status e o CRC do quadro. Só preenche @p data quando retorna AHT20_OK.
+AHT20_Result aht20_read_result(i2c_inst_t *i2c, uint8_t addr, AHT20_Data *data);
+
+// Mesma leitura em duas etapas: enfileira a transação sem bloquear...
+bool aht20_request_result(i2c_inst_t *i2c, uint8_t addr, AHT20_Leitura *leitura);
 
-// Faz leitura de temperatura e umidade do AHT20
-bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data);
+// ...e espera o fim dela para validar e converter o quadro.
+AHT20_Result aht20_finish_result(AHT20_Leitura *leitura, AHT20_Data *data);
 
-// Reseta o sensor AHT20
-void aht20_reset(i2c_inst_t *i2c);
+// Reseta o sensor AHT20 e refaz a inicialização (retorna o resultado de aht20_init)
+bool aht20_reset(i2c_inst_t *i2c, uint8_t addr);
 
 // Verifica se o sensor AHT20 está respondendo
-bool aht20_check(i2c_inst_t *i2c);
+bool aht20_check(i2c_inst_t *i2c, uint8_t addr);
 
 #endif // AHT20_H
@@ -0,0 +1,47 @@
+#include "atuadores.h"
+#include "hardware/irq.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+
+static Zona *zonas_atuadas;
+static int num_zonas_atuadas;
+static uint fatia_base;
+static volatile AtuadoresEstatisticas estatisticas_irq;
+
+static void atuadores_irq(void)
+{
+    uint32_t inicio = time_us_32();
+    pwm_clear_irq(fatia_base);
+
+    // Um período do servo de referência se passou desde a última interrupção
+    float dt = 1.0f / zonas_atuadas[0].pwm_servo.frequencia_real;
+    for (int i = 0; i < num_zonas_atuadas; i++)
+        zona_atualizar_atuadores(&zonas_atuadas[i], dt);
+
+    uint32_t duracao = time_us_32() - inicio;
+    estatisticas_irq.execucoes++;
+    estatisticas_irq.duracao_us = duracao;
+    if (duracao > estatisticas_irq.duracao_max_us)
+        estatisticas_irq.duracao_max_us = duracao;
+}
+
+void atuadores_iniciar(Zona *zonas, int num_zonas)
+{
+    zonas_atuadas = zonas;
+    num_zonas_atuadas = num_zonas;
+    fatia_base = pwm_gpio_to_slice_num(zonas[0].hw.pino_servo);
+
+    pwm_clear_irq(fatia_base);
+    pwm_set_irq_enabled(fatia_base, true);
+    irq_set_exclusive_handler(PWM_IRQ_WRAP, atuadores_irq);
+    irq_set_enabled(PWM_IRQ_WRAP, true);
+}
+
+void atuadores_estatisticas(AtuadoresEstatisticas *estatisticas)
+{
+    uint32_t interrupcoes = save_and_disable_interrupts();
+    estatisticas->execucoes = estatisticas_irq.execucoes;
+    estatisticas->duracao_us = estatisticas_irq.duracao_us;
+    estatisticas->duracao_max_us = estatisticas_irq.duracao_max_us;
+    restore_interrupts(interrupcoes);
+}
@@ -0,0 +1,26 @@
+#ifndef ATUADORES_H
+#define ATUADORES_H
+
+#include <stdint.h>
+#include "zona.h"
+
+/* ---------- Métricas da interrupção ---------- */
+typedef struct {
+    uint32_t execucoes;
+    uint32_t duracao_us;
+    uint32_t duracao_max_us;
+} AtuadoresEstatisticas;
+
+/* ---------- API ---------- */
+// Os perfis de movimento de todas as zonas avançam na interrupção de fim de
+// período (wrap) do PWM do servo da primeira zona (50 Hz por padrão),
+// independente do período de controle e do laço principal. Atualizar junto
+// com o wrap também garante que o servo nunca recebe um pulso pela metade.
+
+// Deve ser chamada depois de zona_inicializar_atuadores() em todas as zonas.
+void atuadores_iniciar(Zona *zonas, int num_zonas);
+
+// Copia as métricas da interrupção.
+void atuadores_estatisticas(AtuadoresEstatisticas *estatisticas);
+
+#endif // ATUADORES_H
@@ -0,0 +1,74 @@
+#include <math.h>
+#include <string.h>
+#include "escalonamento.h"
+
+bool escalonamento_definir_ponto(Escalonamento *tabela, float chave, float ganho_p, float ganho_i)
+{
+    int i = 0;
+    while (i < tabela->quantidade && tabela->pontos[i].chave < chave)
+        i++;
+
+    if (i == tabela->quantidade || tabela->pontos[i].chave != chave)
+    {
+        if (tabela->quantidade == ESCALONAMENTO_PONTOS_MAX)
+            return false;
+        memmove(&tabela->pontos[i + 1], &tabela->pontos[i], (tabela->quantidade - i) * sizeof(EscalonamentoPonto));
+        tabela->quantidade++;
+    }
+    tabela->pontos[i] = (EscalonamentoPonto){chave, ganho_p, ganho_i};
+    return true;
+}
+
+bool escalonamento_remover_ponto(Escalonamento *tabela, float chave)
+{
+    for (int i = 0; i < tabela->quantidade; i++)
+    {
+        if (tabela->pontos[i].chave != chave)
+            continue;
+        tabela->quantidade--;
+        memmove(&tabela->pontos[i], &tabela->pontos[i + 1], (tabela->quantidade - i) * sizeof(EscalonamentoPonto));
+        return true;
+    }
+    return false;
+}
+
+bool escalonamento_valido(const Escalonamento *tabela)
+{
+    if (tabela->chave > ESCALONAMENTO_ERRO || tabela->quantidade > ESCALONAMENTO_PONTOS_MAX)
+        return false;
+    for (int i = 0; i < tabela->quantidade; i++)
+    {
+        const EscalonamentoPonto *p = &tabela->pontos[i];
+        if (!isfinite(p->chave) || !(p->ganho_p >= 0.0f) || !(p->ganho_i >= 0.0f))
+            return false;
+        if (i > 0 && !(p->chave > tabela->pontos[i - 1].chave))
+            return false;
+    }
+    return true;
+}
+
+void escalonamento_ganhos(const Escalonamento *tabela, float valor, float *ganho_p, float *ganho_i)
+{
+    const EscalonamentoPonto *p = tabela->pontos;
+    int n = tabela->quantidade;
+
+    if (n == 1 || !(valor > p[0].chave)) // Também trata NaN
+    {
+        *ganho_p = p[0].ganho_p;
+        *ganho_i = p[0].ganho_i;
+        return;
+    }
+    if (valor >= p[n - 1].chave)
+    {
+        *ganho_p = p[n - 1].ganho_p;
+        *ganho_i = p[n - 1].ganho_i;
+        return;
+    }
+
+    int i = 1;
+    while (p[i].chave < valor)
+        i++;
+    float f = (valor - p[i - 1].chave) / (p[i].chave - p[i - 1].chave);
+    *ganho_p = p[i - 1].ganho_p + f * (p[i].ganho_p - p[i - 1].ganho_p);
+    *ganho_i = p[i - 1].ganho_i + f * (p[i].ganho_i - p[i - 1].ganho_i);
+}
@@ -0,0 +1,49 @@
+#ifndef ESCALONAMENTO_H
+#define ESCALONAMENTO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------- Tamanho da tabela ---------- */
+#define ESCALONAMENTO_PONTOS_MAX 8
+
+/* ---------- Grandeza que indexa a tabela ---------- */
+typedef enum {
+    ESCALONAMENTO_SETPOINT, // Ponto de operação (°C)
+    ESCALONAMENTO_ERRO      // Módulo do erro (°C)
+} EscalonamentoChave;
+
+typedef struct {
+    float chave;
+    float ganho_p;
+    float ganho_i;
+} EscalonamentoPonto;
+
+/* ---------- Tabela de escalonamento de ganhos ---------- */
+// A eficácia da ventoinha varia muito com a abertura, então um único par de
+// ganhos fica lento num ponto de operação e oscila em outro. A tabela dá Kp e
+// Ki por ponto de operação, interpolando linearmente entre os pontos.
+typedef struct {
+    EscalonamentoChave chave;
+    uint8_t quantidade;
+    EscalonamentoPonto pontos[ESCALONAMENTO_PONTOS_MAX]; // Em ordem crescente de chave
+} Escalonamento;
+
+/* ---------- API ---------- */
+
+// Insere um ponto (ou substitui o de mesma chave), mantendo a ordem. Retorna
+// false se a tabela estiver cheia.
+bool escalonamento_definir_ponto(Escalonamento *tabela, float chave, float ganho_p, float ganho_i);
+
+// Remove o ponto de chave @p chave; retorna false se ele não existir.
+bool escalonamento_remover_ponto(Escalonamento *tabela, float chave);
+
+// Indica se a tabela é consistente (tamanho, ordem e valores finitos), para
+// validar uma tabela lida da flash.
+bool escalonamento_valido(const Escalonamento *tabela);
+
+// Ganhos para @p valor da chave, interpolados e saturados nos pontos das
+// pontas. A tabela precisa ter ao menos um ponto.
+void escalonamento_ganhos(const Escalonamento *tabela, float valor, float *ganho_p, float *ganho_i);
+
+#endif // ESCALONAMENTO_H
@@ -0,0 +1,31 @@
+#include <math.h>
+#include "feedforward.h"
+
+// Posição de @p valor numa grade de @p pontos: retorna a fração entre o ponto
+// *indice e o seguinte, saturando nas bordas (NAN cai no primeiro ponto)
+static float posicao_na_grade(float valor, float minimo, float passo, int pontos, int *indice)
+{
+    float f = (valor - minimo) / passo;
+    if (!(f > 0.0f))
+        f = 0.0f;
+    if (f > pontos - 1)
+        f = pontos - 1;
+
+    int i = (int)f;
+    if (i > pontos - 2)
+        i = pontos - 2;
+    *indice = i;
+    return f - i;
+}
+
+float feedforward_calcular(const FeedForwardTabela *tabela, float setpoint, float umidade, float ambiente)
+{
+    float elevacao = setpoint - (isnan(ambiente) ? tabela->ambiente_ref : ambiente);
+    int i, j;
+    float fe = posicao_na_grade(elevacao, tabela->elevacao_min, tabela->elevacao_passo, FF_PONTOS_ELEVACAO, &i);
+    float fu = posicao_na_grade(umidade, tabela->umidade_min, tabela->umidade_passo, FF_PONTOS_UMIDADE, &j);
+
+    float abaixo = tabela->angulo[i][j] + fu * (tabela->angulo[i][j + 1] - tabela->angulo[i][j]);
+    float acima = tabela->angulo[i + 1][j] + fu * (tabela->angulo[i + 1][j + 1] - tabela->angulo[i + 1][j]);
+    return abaixo + fe * (acima - abaixo);
+}
@@ -0,0 +1,28 @@
+#ifndef FEEDFORWARD_H
+#define FEEDFORWARD_H
+
+/* ---------- Tamanho da tabela ---------- */
+#define FF_PONTOS_ELEVACAO 8
+#define FF_PONTOS_UMIDADE 4
+
+/* ---------- Tabela de avanço (feed-forward) ---------- */
+// Ângulo de regime do servo, menos os 90° de base, que mantém a zona a uma dada
+// elevação sobre o ambiente (setpoint - ambiente) com a umidade dada. A tabela
+// já embute a eficácia não linear da ventoinha e do servo: é identificada a
+// partir de dados registrados por tools/feedforward.py (que gera
+// feedforward_tabela.h), e não calculada na placa.
+typedef struct {
+    float elevacao_min, elevacao_passo; // Eixo das linhas (°C acima do ambiente)
+    float umidade_min, umidade_passo;   // Eixo das colunas (%)
+    float angulo[FF_PONTOS_ELEVACAO][FF_PONTOS_UMIDADE];
+    float ambiente_ref; // Ambiente médio da identificação, usado sem leitura de ambiente (°C)
+} FeedForwardTabela;
+
+/* ---------- API ---------- */
+
+// Termo de avanço (graus somados à saída do PI) por interpolação bilinear,
+// saturando nas bordas da tabela. Com @p ambiente NAN (desconhecido) usa
+// ambiente_ref. Custo fixo de poucas operações, sem depender do histórico.
+float feedforward_calcular(const FeedForwardTabela *tabela, float setpoint, float umidade, float ambiente);
+
+#endif // FEEDFORWARD_H
@@ -0,0 +1,29 @@
+// Gerado por tools/feedforward.py identificar a partir de sintetico.csv; não edite à mão.
+// Ângulo de regime do servo menos 90°, por elevação sobre o ambiente (linhas) e
+// umidade (colunas).
+// Incluído só por main.c.
+
+#ifndef FEEDFORWARD_TABELA_H
+#define FEEDFORWARD_TABELA_H
+
+#include "feedforward.h"
+
+static const FeedForwardTabela FEEDFORWARD_TABELA = {
+    .elevacao_min = 2.50f,
+    .elevacao_passo = 1.214f,
+    .umidade_min = 35.0f,
+    .umidade_passo = 15.00f,
+    .angulo = {
+        {74.1f, 59.3f, 36.1f, 31.7f}, // +2.5 °C
+        {6.3f, 19.0f, 17.4f, 27.2f}, // +3.7 °C
+        {-37.1f, -33.9f, -27.7f, -19.5f}, // +4.9 °C
+        {-60.0f, -55.2f, -50.2f, -48.4f}, // +6.1 °C
+        {-69.5f, -67.9f, -66.1f, -62.4f}, // +7.4 °C
+        {-77.2f, -75.5f, -73.9f, -73.1f}, // +8.6 °C
+        {-81.2f, -79.9f, -79.4f, -77.7f}, // +9.8 °C
+        {-84.3f, -83.5f, -82.8f, -82.0f}, // +11.0 °C
+    },
+    .ambiente_ref = 24.4f,
+};
+
+#endif // FEEDFORWARD_TABELA_H
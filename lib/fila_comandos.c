@@ -0,0 +1,33 @@
+#include "fila_comandos.h"
+#include "hardware/sync.h"
+
+uint32_t fila_comandos_livres(const FilaComandos *fila)
+{
+    return FILA_COMANDOS_CAPACIDADE - (fila->escrita - fila->leitura);
+}
+
+bool fila_comandos_postar(FilaComandos *fila, Comando comando)
+{
+    uint32_t escrita = fila->escrita;
+    if (escrita - fila->leitura >= FILA_COMANDOS_CAPACIDADE)
+    {
+        fila->descartados++;
+        return false;
+    }
+    fila->itens[escrita % FILA_COMANDOS_CAPACIDADE] = comando;
+    __dmb(); // O comando fica visível antes do índice
+    fila->escrita = escrita + 1;
+    return true;
+}
+
+bool fila_comandos_retirar(FilaComandos *fila, Comando *comando)
+{
+    uint32_t leitura = fila->leitura;
+    if (leitura == fila->escrita)
+        return false;
+    __dmb();
+    *comando = fila->itens[leitura % FILA_COMANDOS_CAPACIDADE];
+    __dmb(); // Lido antes de liberar a posição ao produtor
+    fila->leitura = leitura + 1;
+    return true;
+}
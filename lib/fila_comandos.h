@@ -0,0 +1,44 @@
+#ifndef FILA_COMANDOS_H
+#define FILA_COMANDOS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------- Limites ---------- */
+#define FILA_COMANDOS_CAPACIDADE 16 // Potência de 2
+
+/* ---------- Comando ao controlador ---------- */
+// O significado de tipo e dos valores é da aplicação (ver aplicar_comando() em main.c).
+typedef struct {
+    uint8_t tipo;
+    uint8_t zona;
+    int16_t inteiro;
+    float valor;
+    float valor2;
+} Comando;
+
+/* ---------- Fila sem trava (um produtor, um consumidor) ---------- */
+// Cada índice só é escrito por um lado: o produtor grava o comando e depois
+// avança a escrita; o consumidor lê e depois avança a leitura. Não desliga
+// interrupções nem usa exclusão mútua, então vale entre uma interrupção e o
+// laço principal ou entre os dois núcleos. Cada contexto que produz comandos
+// precisa da sua própria fila.
+typedef struct {
+    Comando itens[FILA_COMANDOS_CAPACIDADE];
+    volatile uint32_t escrita;
+    volatile uint32_t leitura;
+    uint32_t descartados; // Escrito só pelo produtor
+} FilaComandos;
+
+/* ---------- API ---------- */
+
+// Produtor: posições livres (para postar um grupo de comandos por inteiro).
+uint32_t fila_comandos_livres(const FilaComandos *fila);
+
+// Produtor: retorna false (e conta o descarte) se a fila estiver cheia.
+bool fila_comandos_postar(FilaComandos *fila, Comando comando);
+
+// Consumidor: retira o comando mais antigo; false com a fila vazia.
+bool fila_comandos_retirar(FilaComandos *fila, Comando *comando);
+
+#endif // FILA_COMANDOS_H
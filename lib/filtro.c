@@ -0,0 +1,110 @@
+#include <math.h>
+#include "filtro.h"
+
+// Mediana da janela circular (ordenação por inserção em cópia local; N <= 7)
+static float calcular_mediana(const Filtro *filtro)
+{
+    float ordenado[FILTRO_MEDIANA_MAX];
+    uint8_t n = filtro->janela_n;
+    for (uint8_t i = 0; i < n; i++)
+    {
+        float v = filtro->janela[i];
+        int j = i - 1;
+        while (j >= 0 && ordenado[j] > v)
+        {
+            ordenado[j + 1] = ordenado[j];
+            j--;
+        }
+        ordenado[j + 1] = v;
+    }
+    return ordenado[n / 2];
+}
+
+void filtro_configurar(Filtro *filtro, const FiltroConfig *cfg)
+{
+    filtro->cfg = *cfg;
+    if (filtro->cfg.janela_mediana < 1)
+        filtro->cfg.janela_mediana = 1;
+    if (filtro->cfg.janela_mediana > FILTRO_MEDIANA_MAX)
+        filtro->cfg.janela_mediana = FILTRO_MEDIANA_MAX;
+    if (filtro->cfg.amostras_burst < 1)
+        filtro->cfg.amostras_burst = 1;
+    filtro_reiniciar(filtro);
+}
+
+void filtro_reiniciar(Filtro *filtro)
+{
+    filtro->janela_n = 0;
+    filtro->janela_pos = 0;
+    filtro->iniciado = false;
+    filtro->estimativa = 0.0f;
+    filtro->variancia = 0.0f;
+    filtro->rejeicoes_seguidas = 0;
+}
+
+bool filtro_atualizar(Filtro *filtro, float amostra, float entrada_controle, float *saida)
+{
+    const FiltroConfig *cfg = &filtro->cfg;
+    filtro->amostras++;
+
+    // Rejeição de outliers: compara com a estimativa atual. Depois de algumas
+    // rejeições seguidas o novo valor é aceito, para não travar em um degrau real.
+    if (filtro->iniciado && cfg->limite_outlier > 0.0f &&
+        fabsf(amostra - filtro->estimativa) > cfg->limite_outlier)
+    {
+        if (++filtro->rejeicoes_seguidas < FILTRO_REJEICOES_MAX)
+        {
+            filtro->rejeitadas_outlier++;
+            *saida = filtro->estimativa;
+            return false;
+        }
+        filtro_reiniciar(filtro);
+    }
+    filtro->rejeicoes_seguidas = 0;
+
+    // Mediana de N
+    filtro->janela[filtro->janela_pos] = amostra;
+    filtro->janela_pos = (filtro->janela_pos + 1) % cfg->janela_mediana;
+    if (filtro->janela_n < cfg->janela_mediana)
+        filtro->janela_n++;
+    float valor = calcular_mediana(filtro);
+
+    if (!filtro->iniciado)
+    {
+        filtro->estimativa = valor;
+        filtro->variancia = cfg->kalman_r;
+        filtro->iniciado = true;
+        *saida = valor;
+        return true;
+    }
+
+    switch (cfg->tipo)
+    {
+    case FILTRO_EMA:
+        filtro->estimativa += cfg->alfa_ema * (valor - filtro->estimativa);
+        break;
+
+    case FILTRO_KALMAN:
+    {
+        // Predição: modelo de primeira ordem opcional (efeito da ventoinha por amostra)
+        float predicao = filtro->estimativa;
+        if (cfg->usar_modelo)
+            predicao += cfg->modelo_ganho * (entrada_controle / 100.0f);
+        float p = filtro->variancia + cfg->kalman_q;
+
+        // Correção
+        float k = p / (p + cfg->kalman_r);
+        filtro->estimativa = predicao + k * (valor - predicao);
+        filtro->variancia = (1.0f - k) * p;
+        break;
+    }
+
+    case FILTRO_NENHUM:
+    default:
+        filtro->estimativa = valor;
+        break;
+    }
+
+    *saida = filtro->estimativa;
+    return true;
+}
@@ -0,0 +1,74 @@
+#ifndef FILTRO_H
+#define FILTRO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------- Limites ---------- */
+#define FILTRO_MEDIANA_MAX 7      // Janela máxima da mediana (ímpar)
+#define FILTRO_REJEICOES_MAX 3    // Rejeições seguidas antes de aceitar um novo patamar
+
+/* ---------- Tipo de suavização aplicada após a mediana ---------- */
+typedef enum {
+    FILTRO_NENHUM, FILTRO_EMA, FILTRO_KALMAN
+} FiltroTipo;
+
+/* ---------- Configuração ---------- */
+typedef struct {
+    uint8_t janela_mediana; // 1 desliga a mediana; 3, 5 ou 7 amostras
+    FiltroTipo tipo;
+    float alfa_ema;         // Peso da nova amostra (0 < alfa <= 1)
+    float kalman_q;         // Variância do processo (°C² por amostra)
+    float kalman_r;         // Variância da medição (°C²)
+    bool usar_modelo;       // Usa o modelo da planta na predição do Kalman
+    float modelo_ganho;     // °C por amostra com a ventoinha a 100% (negativo resfria)
+    float limite_outlier;   // Desvio máximo aceito em relação à estimativa (0 desliga)
+    uint8_t amostras_burst; // Leituras por ciclo (sobreamostragem), de 1 a 4
+} FiltroConfig;
+
+/* ---------- Estado ---------- */
+typedef struct {
+    FiltroConfig cfg;
+
+    float janela[FILTRO_MEDIANA_MAX];
+    uint8_t janela_n;
+    uint8_t janela_pos;
+
+    bool iniciado;
+    float estimativa;  // Saída atual do filtro
+    float variancia;   // P do Kalman
+    uint8_t rejeicoes_seguidas;
+
+    // Estatísticas
+    uint32_t amostras;
+    uint32_t rejeitadas_outlier;
+    uint32_t rejeitadas_sensor; // Status ou CRC inválidos (contadas por quem lê o sensor)
+} Filtro;
+
+// Configuração padrão: mediana de 3, EMA com alfa 0.5 e rejeição de saltos > 5 °C.
+#define FILTRO_CONFIG_PADRAO {          \
+    .janela_mediana = 3,                \
+    .tipo = FILTRO_EMA,                 \
+    .alfa_ema = 0.5f,                   \
+    .kalman_q = 0.01f,                  \
+    .kalman_r = 0.04f,                  \
+    .usar_modelo = false,               \
+    .modelo_ganho = 0.0f,               \
+    .limite_outlier = 5.0f,             \
+    .amostras_burst = 1,                \
+}
+
+/* ---------- API ---------- */
+
+// Aplica uma nova configuração e descarta o estado anterior.
+void filtro_configurar(Filtro *filtro, const FiltroConfig *cfg);
+
+// Descarta o histórico (mantém configuração e estatísticas).
+void filtro_reiniciar(Filtro *filtro);
+
+// Processa uma amostra. @p entrada_controle é a última saída da ventoinha (0-100%),
+// usada apenas pelo modelo do Kalman. Retorna false se a amostra foi rejeitada
+// como outlier; nesse caso @p saida recebe a estimativa anterior.
+bool filtro_atualizar(Filtro *filtro, float amostra, float entrada_controle, float *saida);
+
+#endif // FILTRO_H
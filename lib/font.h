@@ -1,70 +1,480 @@
+// Gerado por tools/gerar_fonte.py a partir de tools/fontes/*.txt; não edite à mão.
+// Glifos coluna a coluna, com (altura + 7) / 8 bytes por coluna e bit 0 na linha
+// de cima, no mesmo arranjo das páginas do SSD1306. Incluído só por ssd1306.c.
 
-// Fontes para A-Z e 0-9. Os caracteres tem 8x8 pixels
+#ifndef FONT_H
+#define FONT_H
 
+#include "ssd1306.h"
 
-static uint8_t font[] = {
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // Nothing
-0x3e, 0x41, 0x41, 0x49, 0x41, 0x41, 0x3e, 0x00, //0
-0x00, 0x00, 0x42, 0x7f, 0x40, 0x00, 0x00, 0x00, //1
-0x30, 0x49, 0x49, 0x49, 0x49, 0x46, 0x00, 0x00, //2
-0x49, 0x49, 0x49, 0x49, 0x49, 0x49, 0x36, 0x00, //3
-0x3f, 0x20, 0x20, 0x78, 0x20, 0x20, 0x00, 0x00, //4
-0x4f, 0x49, 0x49, 0x49, 0x49, 0x30, 0x00, 0x00, //5
-0x3f, 0x48, 0x48, 0x48, 0x48, 0x48, 0x30, 0x00, //6
-0x01, 0x01, 0x01, 0x61, 0x31, 0x0d, 0x03, 0x00, //7
-0x36, 0x49, 0x49, 0x49, 0x49, 0x49, 0x36, 0x00, //8
-0x06, 0x09, 0x09, 0x09, 0x09, 0x09, 0x7f, 0x00, //9
-0x78, 0x14, 0x12, 0x11, 0x12, 0x14, 0x78, 0x00, //A
-0x7f, 0x49, 0x49, 0x49, 0x49, 0x49, 0x7f, 0x00, //B
-0x7e, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x00, //C
-0x7f, 0x41, 0x41, 0x41, 0x41, 0x41, 0x7e, 0x00, //D
-0x7f, 0x49, 0x49, 0x49, 0x49, 0x49, 0x49, 0x00, //E
-0x7f, 0x09, 0x09, 0x09, 0x09, 0x01, 0x01, 0x00, //F
-0x7f, 0x41, 0x41, 0x41, 0x51, 0x51, 0x73, 0x00, //G
-0x7f, 0x08, 0x08, 0x08, 0x08, 0x08, 0x7f, 0x00, //H
-0x00, 0x00, 0x00, 0x7f, 0x00, 0x00, 0x00, 0x00, //I
-0x21, 0x41, 0x41, 0x3f, 0x01, 0x01, 0x01, 0x00, //J
-0x00, 0x7f, 0x08, 0x08, 0x14, 0x22, 0x41, 0x00, //K
-0x7f, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x00, //L
-0x7f, 0x02, 0x04, 0x08, 0x04, 0x02, 0x7f, 0x00, //M
-0x7f, 0x02, 0x04, 0x08, 0x10, 0x20, 0x7f, 0x00, //N
-0x3e, 0x41, 0x41, 0x41, 0x41, 0x41, 0x3e, 0x00, //O
-0x7f, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e, 0x00, //P
-0x3e, 0x41, 0x41, 0x49, 0x51, 0x61, 0x7e, 0x00, //Q
-0x7f, 0x11, 0x11, 0x11, 0x31, 0x51, 0x0e, 0x00, //R
-0x46, 0x49, 0x49, 0x49, 0x49, 0x30, 0x00, 0x00, //S
-0x01, 0x01, 0x01, 0x7f, 0x01, 0x01, 0x01, 0x00, //T
-0x3f, 0x40, 0x40, 0x40, 0x40, 0x40, 0x3f, 0x00, //U
-0x0f, 0x10, 0x20, 0x40, 0x20, 0x10, 0x0f, 0x00, //V
-0x7f, 0x20, 0x10, 0x08, 0x10, 0x20, 0x7f, 0x00, //W
-0x00, 0x41, 0x22, 0x14, 0x14, 0x22, 0x41, 0x00, //X
-0x01, 0x02, 0x04, 0x78, 0x04, 0x02, 0x01, 0x00, //Y
-0x41, 0x61, 0x59, 0x45, 0x43, 0x41, 0x00, 0x00, //Z
-// Letras minúsculas (a-z)
-0x20, 0x54, 0x54, 0x54, 0x78, 0x00, 0x00, 0x00, // a  
-0x7F, 0x48, 0x44, 0x44, 0x38, 0x00, 0x00, 0x00, // b  
-0x38, 0x44, 0x44, 0x44, 0x20, 0x00, 0x00, 0x00, // c  
-0x38, 0x44, 0x44, 0x48, 0x7F, 0x00, 0x00, 0x00, // d  
-0x38, 0x54, 0x54, 0x54, 0x18, 0x00, 0x00, 0x00, // e  
-0x08, 0x7E, 0x09, 0x01, 0x02, 0x00, 0x00, 0x00, // f  
-0x08, 0x54, 0x54, 0x54, 0x3C, 0x00, 0x00, 0x00, // g  
-0x7F, 0x08, 0x04, 0x04, 0x78, 0x00, 0x00, 0x00, // h  
-0x00, 0x44, 0x7D, 0x40, 0x00, 0x00, 0x00, 0x00, // i  
-0x20, 0x40, 0x44, 0x3D, 0x00, 0x00, 0x00, 0x00, // j  
-0x7F, 0x10, 0x28, 0x44, 0x00, 0x00, 0x00, 0x00, // k  
-0x00, 0x41, 0x7F, 0x40, 0x00, 0x00, 0x00, 0x00, // l  
-0x7C, 0x04, 0x18, 0x04, 0x78, 0x00, 0x00, 0x00, // m  
-0x7C, 0x08, 0x04, 0x04, 0x78, 0x00, 0x00, 0x00, // n  
-0x38, 0x44, 0x44, 0x44, 0x38, 0x00, 0x00, 0x00, // o  
-0x7C, 0x14, 0x14, 0x14, 0x08, 0x00, 0x00, 0x00, // p  
-0x08, 0x14, 0x14, 0x18, 0x7C, 0x00, 0x00, 0x00, // q  
-0x7C, 0x08, 0x04, 0x04, 0x08, 0x00, 0x00, 0x00, // r  
-0x48, 0x54, 0x54, 0x54, 0x20, 0x00, 0x00, 0x00, // s  
-0x04, 0x3F, 0x44, 0x40, 0x20, 0x00, 0x00, 0x00, // t  
-0x3C, 0x40, 0x40, 0x20, 0x7C, 0x00, 0x00, 0x00, // u  
-0x1C, 0x20, 0x40, 0x20, 0x1C, 0x00, 0x00, 0x00, // v  
-0x3C, 0x40, 0x30, 0x40, 0x3C, 0x00, 0x00, 0x00, // w  
-0x44, 0x28, 0x10, 0x28, 0x44, 0x00, 0x00, 0x00, // x  
-0x0C, 0x50, 0x50, 0x50, 0x3C, 0x00, 0x00, 0x00, // y  
-0x44, 0x64, 0x54, 0x4C, 0x44, 0x00, 0x00, 0x00, // z 
+/* ---------- ssd1306_font_small: 191 glifos, altura 8 ---------- */
+
+static const uint8_t ssd1306_font_small_bitmap[] = {
+    0x00, 0x00, 0x00, // 0x20 espaço
+    0x5f, // 0x21 !
+    0x03, 0x00, 0x03, // 0x22 "
+    0x14, 0x7f, 0x14, 0x7f, 0x14, // 0x23 #
+    0x24, 0x2a, 0x7f, 0x2a, 0x12, // 0x24 $
+    0x23, 0x13, 0x08, 0x64, 0x62, // 0x25 %
+    0x36, 0x49, 0x55, 0x22, 0x50, // 0x26 &
+    0x03, // 0x27 '
+    0x1c, 0x22, 0x41, // 0x28 (
+    0x41, 0x22, 0x1c, // 0x29 )
+    0x14, 0x08, 0x3e, 0x08, 0x14, // 0x2A *
+    0x08, 0x08, 0x3e, 0x08, 0x08, // 0x2B +
+    0x80, 0x60, // 0x2C ,
+    0x08, 0x08, 0x08, 0x08, // 0x2D -
+    0x40, // 0x2E .
+    0x20, 0x10, 0x08, 0x04, 0x02, // 0x2F /
+    0x3e, 0x51, 0x49, 0x45, 0x3e, // 0x30 0
+    0x42, 0x7f, 0x40, // 0x31 1
+    0x42, 0x61, 0x51, 0x49, 0x46, // 0x32 2
+    0x21, 0x41, 0x45, 0x4b, 0x31, // 0x33 3
+    0x18, 0x14, 0x12, 0x7f, 0x10, // 0x34 4
+    0x27, 0x45, 0x45, 0x45, 0x39, // 0x35 5
+    0x3c, 0x4a, 0x49, 0x49, 0x30, // 0x36 6
+    0x01, 0x71, 0x09, 0x05, 0x03, // 0x37 7
+    0x36, 0x49, 0x49, 0x49, 0x36, // 0x38 8
+    0x06, 0x49, 0x49, 0x29, 0x1e, // 0x39 9
+    0x44, // 0x3A :
+    0x80, 0x64, // 0x3B ;
+    0x08, 0x14, 0x22, 0x41, // 0x3C <
+    0x14, 0x14, 0x14, 0x14, // 0x3D =
+    0x41, 0x22, 0x14, 0x08, // 0x3E >
+    0x02, 0x01, 0x51, 0x09, 0x06, // 0x3F ?
+    0x32, 0x49, 0x79, 0x41, 0x3e, // 0x40 @
+    0x7e, 0x09, 0x09, 0x09, 0x7e, // 0x41 A
+    0x7f, 0x49, 0x49, 0x49, 0x36, // 0x42 B
+    0x3e, 0x41, 0x41, 0x41, 0x22, // 0x43 C
+    0x7f, 0x41, 0x41, 0x22, 0x1c, // 0x44 D
+    0x7f, 0x49, 0x49, 0x49, 0x41, // 0x45 E
+    0x7f, 0x09, 0x09, 0x09, 0x01, // 0x46 F
+    0x3e, 0x41, 0x49, 0x49, 0x7a, // 0x47 G
+    0x7f, 0x08, 0x08, 0x08, 0x7f, // 0x48 H
+    0x41, 0x7f, 0x41, // 0x49 I
+    0x20, 0x40, 0x40, 0x3f, // 0x4A J
+    0x7f, 0x08, 0x14, 0x22, 0x41, // 0x4B K
+    0x7f, 0x40, 0x40, 0x40, // 0x4C L
+    0x7f, 0x02, 0x0c, 0x02, 0x7f, // 0x4D M
+    0x7f, 0x04, 0x08, 0x10, 0x7f, // 0x4E N
+    0x3e, 0x41, 0x41, 0x41, 0x3e, // 0x4F O
+    0x7f, 0x09, 0x09, 0x09, 0x06, // 0x50 P
+    0x3e, 0x41, 0x51, 0x21, 0x5e, // 0x51 Q
+    0x7f, 0x09, 0x19, 0x29, 0x46, // 0x52 R
+    0x46, 0x49, 0x49, 0x49, 0x31, // 0x53 S
+    0x01, 0x01, 0x7f, 0x01, 0x01, // 0x54 T
+    0x3f, 0x40, 0x40, 0x40, 0x3f, // 0x55 U
+    0x1f, 0x20, 0x40, 0x20, 0x1f, // 0x56 V
+    0x3f, 0x40, 0x38, 0x40, 0x3f, // 0x57 W
+    0x63, 0x14, 0x08, 0x14, 0x63, // 0x58 X
+    0x03, 0x04, 0x78, 0x04, 0x03, // 0x59 Y
+    0x61, 0x51, 0x49, 0x45, 0x43, // 0x5A Z
+    0x7f, 0x41, // 0x5B [
+    0x02, 0x04, 0x08, 0x10, 0x20, // 0x5C barra invertida
+    0x41, 0x7f, // 0x5D ]
+    0x02, 0x01, 0x02, // 0x5E ^
+    0x80, 0x80, 0x80, 0x80, // 0x5F _
+    0x01, 0x02, // 0x60 `
+    0x20, 0x54, 0x54, 0x78, // 0x61 a
+    0x7f, 0x44, 0x44, 0x38, // 0x62 b
+    0x38, 0x44, 0x44, 0x44, // 0x63 c
+    0x38, 0x44, 0x44, 0x7f, // 0x64 d
+    0x38, 0x54, 0x54, 0x58, // 0x65 e
+    0x7e, 0x09, 0x01, // 0x66 f
+    0x18, 0xa4, 0xa4, 0x7c, // 0x67 g
+    0x7f, 0x04, 0x04, 0x78, // 0x68 h
+    0x7d, // 0x69 i
+    0x80, 0x80, 0x7d, // 0x6A j
+    0x7f, 0x10, 0x28, 0x44, // 0x6B k
+    0x3f, 0x40, // 0x6C l
+    0x7c, 0x04, 0x78, 0x04, 0x78, // 0x6D m
+    0x7c, 0x04, 0x04, 0x78, // 0x6E n
+    0x38, 0x44, 0x44, 0x38, // 0x6F o
+    0xfc, 0x24, 0x24, 0x18, // 0x70 p
+    0x18, 0x24, 0x24, 0xfc, // 0x71 q
+    0x7c, 0x08, 0x04, // 0x72 r
+    0x48, 0x54, 0x54, 0x24, // 0x73 s
+    0x04, 0x3f, 0x44, // 0x74 t
+    0x3c, 0x40, 0x40, 0x7c, // 0x75 u
+    0x1c, 0x20, 0x40, 0x20, 0x1c, // 0x76 v
+    0x3c, 0x40, 0x30, 0x40, 0x3c, // 0x77 w
+    0x44, 0x28, 0x10, 0x28, 0x44, // 0x78 x
+    0x1c, 0xa0, 0xa0, 0x7c, // 0x79 y
+    0x64, 0x54, 0x4c, 0x44, // 0x7A z
+    0x08, 0x36, 0x41, // 0x7B {
+    0x7f, // 0x7C |
+    0x41, 0x36, 0x08, // 0x7D }
+    0x08, 0x04, 0x08, 0x10, 0x08, // 0x7E ~
+    0x00, 0x00, 0x00, // 0xA0 espaço sem quebra
+    0x7d, // 0xA1 ¡
+    0x1c, 0x22, 0x7f, 0x22, // 0xA2 ¢
+    0x48, 0x3e, 0x49, 0x41, 0x22, // 0xA3 £
+    0x22, 0x1c, 0x14, 0x1c, 0x22, // 0xA4 ¤
+    0x29, 0x2a, 0x7c, 0x2a, 0x29, // 0xA5 ¥
+    0x77, // 0xA6 ¦
+    0x4a, 0x55, 0x55, 0x29, // 0xA7 §
+    0x01, 0x00, 0x01, // 0xA8 ¨
+    0x3e, 0x41, 0x5d, 0x55, 0x41, 0x3e, // 0xA9 ©
+    0x12, 0x15, 0x17, // 0xAA ª
+    0x10, 0x28, 0x54, 0x28, 0x44, // 0xAB «
+    0x08, 0x08, 0x08, 0x18, // 0xAC ¬
+    0x08, 0x08, 0x08, // 0xAD hífen condicional
+    0x3e, 0x41, 0x5d, 0x4d, 0x51, 0x3e, // 0xAE ®
+    0x01, 0x01, 0x01, 0x01, // 0xAF ¯
+    0x02, 0x05, 0x02, // 0xB0 °
+    0x44, 0x44, 0x5f, 0x44, 0x44, // 0xB1 ±
+    0x09, 0x0d, 0x0a, // 0xB2 ²
+    0x09, 0x0b, 0x0f, // 0xB3 ³
+    0x02, 0x01, // 0xB4 ´
+    0xfc, 0x20, 0x20, 0x1c, // 0xB5 µ
+    0x06, 0x0f, 0x7f, 0x01, 0x7f, // 0xB6 ¶
+    0x08, // 0xB7 ·
+    0x80, 0x40, // 0xB8 ¸
+    0x0a, 0x0f, 0x08, // 0xB9 ¹
+    0x12, 0x15, 0x12, // 0xBA º
+    0x44, 0x28, 0x54, 0x28, 0x10, // 0xBB »
+    0x17, 0x08, 0x34, 0x7a, 0x21, // 0xBC ¼
+    0x17, 0x08, 0x44, 0x6a, 0x59, // 0xBD ½
+    0x25, 0x17, 0x2a, 0x74, 0x23, // 0xBE ¾
+    0x30, 0x48, 0x45, 0x40, 0x20, // 0xBF ¿
+    0x7c, 0x13, 0x12, 0x12, 0x7c, // 0xC0 À
+    0x7c, 0x12, 0x12, 0x13, 0x7c, // 0xC1 Á
+    0x7c, 0x12, 0x13, 0x12, 0x7c, // 0xC2 Â
+    0x7c, 0x13, 0x13, 0x13, 0x7c, // 0xC3 Ã
+    0x7c, 0x13, 0x12, 0x13, 0x7c, // 0xC4 Ä
+    0x7c, 0x12, 0x13, 0x12, 0x7c, // 0xC5 Å
+    0x7e, 0x09, 0x7f, 0x49, 0x49, // 0xC6 Æ
+    0x3e, 0x41, 0xc1, 0x41, 0x22, // 0xC7 Ç
+    0x7e, 0x4b, 0x4a, 0x4a, 0x42, // 0xC8 È
+    0x7e, 0x4a, 0x4a, 0x4b, 0x42, // 0xC9 É
+    0x7e, 0x4a, 0x4b, 0x4a, 0x42, // 0xCA Ê
+    0x7e, 0x4b, 0x4a, 0x4b, 0x42, // 0xCB Ë
+    0x43, 0x7e, 0x42, // 0xCC Ì
+    0x42, 0x7e, 0x43, // 0xCD Í
+    0x42, 0x7f, 0x42, // 0xCE Î
+    0x43, 0x7e, 0x43, // 0xCF Ï
+    0x49, 0x7f, 0x49, 0x22, 0x1c, // 0xD0 Ð
+    0x7e, 0x05, 0x09, 0x11, 0x7e, // 0xD1 Ñ
+    0x3c, 0x43, 0x42, 0x42, 0x3c, // 0xD2 Ò
+    0x3c, 0x42, 0x42, 0x43, 0x3c, // 0xD3 Ó
+    0x3c, 0x42, 0x43, 0x42, 0x3c, // 0xD4 Ô
+    0x3c, 0x43, 0x43, 0x43, 0x3c, // 0xD5 Õ
+    0x3c, 0x43, 0x42, 0x43, 0x3c, // 0xD6 Ö
+    0x22, 0x14, 0x08, 0x14, 0x22, // 0xD7 ×
+    0x7e, 0x61, 0x5d, 0x43, 0x3f, // 0xD8 Ø
+    0x3e, 0x41, 0x40, 0x40, 0x3e, // 0xD9 Ù
+    0x3e, 0x40, 0x40, 0x41, 0x3e, // 0xDA Ú
+    0x3e, 0x40, 0x41, 0x40, 0x3e, // 0xDB Û
+    0x3e, 0x41, 0x40, 0x41, 0x3e, // 0xDC Ü
+    0x02, 0x04, 0x78, 0x05, 0x02, // 0xDD Ý
+    0x7f, 0x12, 0x12, 0x12, 0x0c, // 0xDE Þ
+    0xfe, 0x01, 0x49, 0x36, // 0xDF ß
+    0x20, 0x55, 0x56, 0x78, // 0xE0 à
+    0x20, 0x56, 0x55, 0x78, // 0xE1 á
+    0x22, 0x55, 0x55, 0x7a, // 0xE2 â
+    0x22, 0x55, 0x56, 0x79, // 0xE3 ã
+    0x22, 0x54, 0x54, 0x7a, // 0xE4 ä
+    0x20, 0x57, 0x57, 0x78, // 0xE5 å
+    0x24, 0x54, 0x38, 0x54, 0x58, // 0xE6 æ
+    0x38, 0x44, 0xc4, 0x44, // 0xE7 ç
+    0x38, 0x55, 0x56, 0x58, // 0xE8 è
+    0x38, 0x56, 0x55, 0x58, // 0xE9 é
+    0x3a, 0x55, 0x55, 0x5a, // 0xEA ê
+    0x3a, 0x54, 0x54, 0x5a, // 0xEB ë
+    0x01, 0x7e, 0x00, // 0xEC ì
+    0x00, 0x7e, 0x01, // 0xED í
+    0x02, 0x7d, 0x02, // 0xEE î
+    0x02, 0x7c, 0x02, // 0xEF ï
+    0x38, 0x45, 0x46, 0x3c, // 0xF0 ð
+    0x7e, 0x05, 0x06, 0x79, // 0xF1 ñ
+    0x38, 0x45, 0x46, 0x38, // 0xF2 ò
+    0x38, 0x46, 0x45, 0x38, // 0xF3 ó
+    0x3a, 0x45, 0x45, 0x3a, // 0xF4 ô
+    0x3a, 0x45, 0x46, 0x39, // 0xF5 õ
+    0x3a, 0x44, 0x44, 0x3a, // 0xF6 ö
+    0x08, 0x08, 0x2a, 0x08, 0x08, // 0xF7 ÷
+    0x58, 0x34, 0x2c, 0x1a, // 0xF8 ø
+    0x3c, 0x41, 0x42, 0x7c, // 0xF9 ù
+    0x3c, 0x42, 0x41, 0x7c, // 0xFA ú
+    0x3e, 0x41, 0x41, 0x7e, // 0xFB û
+    0x3e, 0x40, 0x40, 0x7e, // 0xFC ü
+    0x1c, 0xa2, 0xa1, 0x7c, // 0xFD ý
+    0xff, 0x24, 0x24, 0x18, // 0xFE þ
+    0x1e, 0xa0, 0xa0, 0x7e, // 0xFF ÿ
+};
+
+static const ssd1306_glyph_t ssd1306_font_small_glyphs[] = {
+    {0, 3}, // 0x20 espaço
+    {3, 1}, // 0x21 !
+    {4, 3}, // 0x22 "
+    {7, 5}, // 0x23 #
+    {12, 5}, // 0x24 $
+    {17, 5}, // 0x25 %
+    {22, 5}, // 0x26 &
+    {27, 1}, // 0x27 '
+    {28, 3}, // 0x28 (
+    {31, 3}, // 0x29 )
+    {34, 5}, // 0x2A *
+    {39, 5}, // 0x2B +
+    {44, 2}, // 0x2C ,
+    {46, 4}, // 0x2D -
+    {50, 1}, // 0x2E .
+    {51, 5}, // 0x2F /
+    {56, 5}, // 0x30 0
+    {61, 3}, // 0x31 1
+    {64, 5}, // 0x32 2
+    {69, 5}, // 0x33 3
+    {74, 5}, // 0x34 4
+    {79, 5}, // 0x35 5
+    {84, 5}, // 0x36 6
+    {89, 5}, // 0x37 7
+    {94, 5}, // 0x38 8
+    {99, 5}, // 0x39 9
+    {104, 1}, // 0x3A :
+    {105, 2}, // 0x3B ;
+    {107, 4}, // 0x3C <
+    {111, 4}, // 0x3D =
+    {115, 4}, // 0x3E >
+    {119, 5}, // 0x3F ?
+    {124, 5}, // 0x40 @
+    {129, 5}, // 0x41 A
+    {134, 5}, // 0x42 B
+    {139, 5}, // 0x43 C
+    {144, 5}, // 0x44 D
+    {149, 5}, // 0x45 E
+    {154, 5}, // 0x46 F
+    {159, 5}, // 0x47 G
+    {164, 5}, // 0x48 H
+    {169, 3}, // 0x49 I
+    {172, 4}, // 0x4A J
+    {176, 5}, // 0x4B K
+    {181, 4}, // 0x4C L
+    {185, 5}, // 0x4D M
+    {190, 5}, // 0x4E N
+    {195, 5}, // 0x4F O
+    {200, 5}, // 0x50 P
+    {205, 5}, // 0x51 Q
+    {210, 5}, // 0x52 R
+    {215, 5}, // 0x53 S
+    {220, 5}, // 0x54 T
+    {225, 5}, // 0x55 U
+    {230, 5}, // 0x56 V
+    {235, 5}, // 0x57 W
+    {240, 5}, // 0x58 X
+    {245, 5}, // 0x59 Y
+    {250, 5}, // 0x5A Z
+    {255, 2}, // 0x5B [
+    {257, 5}, // 0x5C barra invertida
+    {262, 2}, // 0x5D ]
+    {264, 3}, // 0x5E ^
+    {267, 4}, // 0x5F _
+    {271, 2}, // 0x60 `
+    {273, 4}, // 0x61 a
+    {277, 4}, // 0x62 b
+    {281, 4}, // 0x63 c
+    {285, 4}, // 0x64 d
+    {289, 4}, // 0x65 e
+    {293, 3}, // 0x66 f
+    {296, 4}, // 0x67 g
+    {300, 4}, // 0x68 h
+    {304, 1}, // 0x69 i
+    {305, 3}, // 0x6A j
+    {308, 4}, // 0x6B k
+    {312, 2}, // 0x6C l
+    {314, 5}, // 0x6D m
+    {319, 4}, // 0x6E n
+    {323, 4}, // 0x6F o
+    {327, 4}, // 0x70 p
+    {331, 4}, // 0x71 q
+    {335, 3}, // 0x72 r
+    {338, 4}, // 0x73 s
+    {342, 3}, // 0x74 t
+    {345, 4}, // 0x75 u
+    {349, 5}, // 0x76 v
+    {354, 5}, // 0x77 w
+    {359, 5}, // 0x78 x
+    {364, 4}, // 0x79 y
+    {368, 4}, // 0x7A z
+    {372, 3}, // 0x7B {
+    {375, 1}, // 0x7C |
+    {376, 3}, // 0x7D }
+    {379, 5}, // 0x7E ~
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, // 0x7F-0x9F ausentes
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0},
+    {384, 3}, // 0xA0 espaço sem quebra
+    {387, 1}, // 0xA1 ¡
+    {388, 4}, // 0xA2 ¢
+    {392, 5}, // 0xA3 £
+    {397, 5}, // 0xA4 ¤
+    {402, 5}, // 0xA5 ¥
+    {407, 1}, // 0xA6 ¦
+    {408, 4}, // 0xA7 §
+    {412, 3}, // 0xA8 ¨
+    {415, 6}, // 0xA9 ©
+    {421, 3}, // 0xAA ª
+    {424, 5}, // 0xAB «
+    {429, 4}, // 0xAC ¬
+    {433, 3}, // 0xAD hífen condicional
+    {436, 6}, // 0xAE ®
+    {442, 4}, // 0xAF ¯
+    {446, 3}, // 0xB0 °
+    {449, 5}, // 0xB1 ±
+    {454, 3}, // 0xB2 ²
+    {457, 3}, // 0xB3 ³
+    {460, 2}, // 0xB4 ´
+    {462, 4}, // 0xB5 µ
+    {466, 5}, // 0xB6 ¶
+    {471, 1}, // 0xB7 ·
+    {472, 2}, // 0xB8 ¸
+    {474, 3}, // 0xB9 ¹
+    {477, 3}, // 0xBA º
+    {480, 5}, // 0xBB »
+    {485, 5}, // 0xBC ¼
+    {490, 5}, // 0xBD ½
+    {495, 5}, // 0xBE ¾
+    {500, 5}, // 0xBF ¿
+    {505, 5}, // 0xC0 À
+    {510, 5}, // 0xC1 Á
+    {515, 5}, // 0xC2 Â
+    {520, 5}, // 0xC3 Ã
+    {525, 5}, // 0xC4 Ä
+    {530, 5}, // 0xC5 Å
+    {535, 5}, // 0xC6 Æ
+    {540, 5}, // 0xC7 Ç
+    {545, 5}, // 0xC8 È
+    {550, 5}, // 0xC9 É
+    {555, 5}, // 0xCA Ê
+    {560, 5}, // 0xCB Ë
+    {565, 3}, // 0xCC Ì
+    {568, 3}, // 0xCD Í
+    {571, 3}, // 0xCE Î
+    {574, 3}, // 0xCF Ï
+    {577, 5}, // 0xD0 Ð
+    {582, 5}, // 0xD1 Ñ
+    {587, 5}, // 0xD2 Ò
+    {592, 5}, // 0xD3 Ó
+    {597, 5}, // 0xD4 Ô
+    {602, 5}, // 0xD5 Õ
+    {607, 5}, // 0xD6 Ö
+    {612, 5}, // 0xD7 ×
+    {617, 5}, // 0xD8 Ø
+    {622, 5}, // 0xD9 Ù
+    {627, 5}, // 0xDA Ú
+    {632, 5}, // 0xDB Û
+    {637, 5}, // 0xDC Ü
+    {642, 5}, // 0xDD Ý
+    {647, 5}, // 0xDE Þ
+    {652, 4}, // 0xDF ß
+    {656, 4}, // 0xE0 à
+    {660, 4}, // 0xE1 á
+    {664, 4}, // 0xE2 â
+    {668, 4}, // 0xE3 ã
+    {672, 4}, // 0xE4 ä
+    {676, 4}, // 0xE5 å
+    {680, 5}, // 0xE6 æ
+    {685, 4}, // 0xE7 ç
+    {689, 4}, // 0xE8 è
+    {693, 4}, // 0xE9 é
+    {697, 4}, // 0xEA ê
+    {701, 4}, // 0xEB ë
+    {705, 3}, // 0xEC ì
+    {708, 3}, // 0xED í
+    {711, 3}, // 0xEE î
+    {714, 3}, // 0xEF ï
+    {717, 4}, // 0xF0 ð
+    {721, 4}, // 0xF1 ñ
+    {725, 4}, // 0xF2 ò
+    {729, 4}, // 0xF3 ó
+    {733, 4}, // 0xF4 ô
+    {737, 4}, // 0xF5 õ
+    {741, 4}, // 0xF6 ö
+    {745, 5}, // 0xF7 ÷
+    {750, 4}, // 0xF8 ø
+    {754, 4}, // 0xF9 ù
+    {758, 4}, // 0xFA ú
+    {762, 4}, // 0xFB û
+    {766, 4}, // 0xFC ü
+    {770, 4}, // 0xFD ý
+    {774, 4}, // 0xFE þ
+    {778, 4}, // 0xFF ÿ
 };
+
+const ssd1306_font_t ssd1306_font_small = {
+    .height = 8,
+    .spacing = 1,
+    .first = 0x20,
+    .last = 0xFF,
+    .glyphs = ssd1306_font_small_glyphs,
+    .bitmap = ssd1306_font_small_bitmap,
+};
+
+/* ---------- ssd1306_font_numbers: 15 glifos, altura 14 ---------- */
+
+static const uint8_t ssd1306_font_numbers_bitmap[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x20 espaço
+    0xc0, 0x00, 0xc0, 0x00, 0xc0, 0x00, 0xc0, 0x00, 0xc0, 0x00, 0xc0, 0x00, // 0x2D -
+    0x00, 0x30, 0x00, 0x30, // 0x2E .
+    0xfc, 0x0f, 0xfe, 0x1f, 0x07, 0x38, 0x03, 0x30, 0x03, 0x30, 0x07, 0x38, 0xfe, 0x1f, 0xfc, 0x0f, // 0x30 0
+    0x04, 0x30, 0x06, 0x30, 0xff, 0x3f, 0xff, 0x3f, 0x00, 0x30, 0x00, 0x30, // 0x31 1
+    0x0c, 0x3c, 0x0e, 0x3e, 0x07, 0x37, 0x83, 0x33, 0xc3, 0x31, 0xe7, 0x30, 0x7e, 0x30, 0x3c, 0x30, // 0x32 2
+    0x06, 0x0c, 0x07, 0x1c, 0x03, 0x38, 0x63, 0x30, 0x63, 0x30, 0x63, 0x38, 0xff, 0x1f, 0x9e, 0x0f, // 0x33 3
+    0xe0, 0x01, 0xf0, 0x01, 0x98, 0x01, 0x8c, 0x01, 0x86, 0x01, 0xff, 0x3f, 0xff, 0x3f, 0x80, 0x01, // 0x34 4
+    0x7f, 0x0c, 0x7f, 0x1c, 0x63, 0x38, 0x63, 0x30, 0x63, 0x30, 0x63, 0x38, 0xe3, 0x1f, 0xc3, 0x0f, // 0x35 5
+    0xfc, 0x0f, 0xfe, 0x1f, 0xc7, 0x38, 0x63, 0x30, 0x63, 0x30, 0xe7, 0x38, 0xc6, 0x1f, 0x84, 0x0f, // 0x36 6
+    0x03, 0x00, 0x03, 0x00, 0x03, 0x3f, 0xc3, 0x3f, 0xf3, 0x01, 0x7b, 0x00, 0x1f, 0x00, 0x0f, 0x00, // 0x37 7
+    0x3c, 0x0f, 0xfe, 0x1f, 0xe7, 0x39, 0xc3, 0x30, 0xc3, 0x30, 0xe7, 0x39, 0xfe, 0x1f, 0x3c, 0x0f, // 0x38 8
+    0x7c, 0x08, 0xfe, 0x18, 0xc7, 0x39, 0x83, 0x31, 0x83, 0x31, 0xc7, 0x38, 0xfe, 0x1f, 0xfc, 0x0f, // 0x39 9
+    0xfc, 0x0f, 0xfe, 0x1f, 0x07, 0x38, 0x03, 0x30, 0x03, 0x30, 0x07, 0x38, 0x0e, 0x1c, 0x0c, 0x0c, // 0x43 C
+    0x06, 0x00, 0x09, 0x00, 0x09, 0x00, 0x06, 0x00, // 0xB0 °
+};
+
+static const ssd1306_glyph_t ssd1306_font_numbers_glyphs[] = {
+    {0, 4}, // 0x20 espaço
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, // 0x21-0x2C ausentes
+    {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {4, 6}, // 0x2D -
+    {10, 2}, // 0x2E .
+    {0, 0}, // 0x2F ausente
+    {12, 8}, // 0x30 0
+    {20, 6}, // 0x31 1
+    {26, 8}, // 0x32 2
+    {34, 8}, // 0x33 3
+    {42, 8}, // 0x34 4
+    {50, 8}, // 0x35 5
+    {58, 8}, // 0x36 6
+    {66, 8}, // 0x37 7
+    {74, 8}, // 0x38 8
+    {82, 8}, // 0x39 9
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, // 0x3A-0x42 ausentes
+    {0, 0},
+    {90, 8}, // 0x43 C
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, // 0x44-0xAF ausentes
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {98, 4}, // 0xB0 °
+};
+
+const ssd1306_font_t ssd1306_font_numbers = {
+    .height = 14,
+    .spacing = 2,
+    .first = 0x20,
+    .last = 0xB0,
+    .glyphs = ssd1306_font_numbers_glyphs,
+    .bitmap = ssd1306_font_numbers_bitmap,
+};
+
+#endif // FONT_H
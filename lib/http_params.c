@@ -0,0 +1,392 @@
+#include "http_params.h"
+#include "http_parser.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Valor convertido, guardado até que toda a entrada seja validada
+typedef union
+{
+    int i;
+    float f;
+    bool b;
+    char s[HTTP_PARAMS_MAX_VALUE];
+} param_value_t;
+
+// Estado de uma extração em andamento
+typedef struct
+{
+    const http_param_spec_t *specs;
+    size_t count;
+    unsigned found; // Bit i = specs[i] já recebido
+    param_value_t values[HTTP_PARAMS_MAX];
+    http_param_result_t result;
+} param_ctx_t;
+_Static_assert(HTTP_PARAMS_MAX <= sizeof(unsigned) * 8, "found tem um bit por especificação");
+
+static bool set_error(param_ctx_t *ctx, http_param_status_t status, const char *name)
+{
+    ctx->result.status = status;
+    ctx->result.name = name;
+    return false;
+}
+
+static bool parse_number(const char *text, bool integer, float *out)
+{
+    // Rejeita vazio, hexadecimal, nan/inf e lixo após o número
+    if (text[0] == '\0' || strpbrk(text, "xXnN") != NULL)
+        return false;
+    char *end;
+    double v = integer ? (double)strtol(text, &end, 10) : strtod(text, &end);
+    if (*end != '\0' || !isfinite(v))
+        return false;
+    *out = (float)v;
+    return true;
+}
+
+static bool convert_value(param_ctx_t *ctx, size_t idx, const char *text)
+{
+    const http_param_spec_t *spec = &ctx->specs[idx];
+    param_value_t *value = &ctx->values[idx];
+    float number;
+
+    switch (spec->type)
+    {
+    case HTTP_PARAM_INT:
+    case HTTP_PARAM_FLOAT:
+        if (!parse_number(text, spec->type == HTTP_PARAM_INT, &number))
+            return set_error(ctx, HTTP_PARAM_ERR_SYNTAX, spec->name);
+        if (number < spec->min || number > spec->max)
+            return set_error(ctx, HTTP_PARAM_ERR_RANGE, spec->name);
+        if (spec->type == HTTP_PARAM_INT)
+            value->i = (int)number;
+        else
+            value->f = number;
+        return true;
+
+    case HTTP_PARAM_BOOL:
+        if (strcmp(text, "true") == 0 || strcmp(text, "1") == 0 || strcmp(text, "on") == 0)
+            value->b = true;
+        else if (strcmp(text, "false") == 0 || strcmp(text, "0") == 0 || strcmp(text, "off") == 0)
+            value->b = false;
+        else
+            return set_error(ctx, HTTP_PARAM_ERR_SYNTAX, spec->name);
+        return true;
+
+    case HTTP_PARAM_ENUM:
+        for (int i = 0; spec->options && spec->options[i]; i++)
+        {
+            if (strcmp(text, spec->options[i]) == 0)
+            {
+                value->i = i;
+                return true;
+            }
+        }
+        return set_error(ctx, HTTP_PARAM_ERR_RANGE, spec->name);
+
+    case HTTP_PARAM_STRING:
+        strcpy(value->s, text); // Já cabe: a leitura rejeita valores maiores
+        return true;
+    }
+    return set_error(ctx, HTTP_PARAM_ERR_SYNTAX, spec->name);
+}
+
+// Associa um par nome/valor a uma especificação (nomes desconhecidos são ignorados)
+static bool accept_pair(param_ctx_t *ctx, const char *key, size_t key_len, const char *value)
+{
+    for (size_t i = 0; i < ctx->count; i++)
+    {
+        const char *name = ctx->specs[i].name;
+        if (strlen(name) != key_len || memcmp(name, key, key_len) != 0)
+            continue;
+        if (ctx->found & (1u << i))
+            return set_error(ctx, HTTP_PARAM_ERR_DUPLICATE, name);
+        if (!convert_value(ctx, i, value))
+            return false;
+        ctx->found |= 1u << i;
+        return true;
+    }
+    return true;
+}
+
+// Recusa listas maiores que os valores guardados (e os bits de found): cortar
+// a lista ignoraria parâmetros, inclusive obrigatórios, sem aviso
+static bool begin(param_ctx_t *ctx, const http_param_spec_t *specs, size_t count)
+{
+    ctx->specs = specs;
+    ctx->count = count;
+    ctx->found = 0;
+    ctx->result.status = HTTP_PARAM_OK;
+    ctx->result.name = NULL;
+    if (count > HTTP_PARAMS_MAX)
+        return set_error(ctx, HTTP_PARAM_ERR_SPEC, NULL);
+    return true;
+}
+
+// Verifica os obrigatórios e só então escreve os valores nos destinos
+static http_param_result_t commit(param_ctx_t *ctx)
+{
+    for (size_t i = 0; i < ctx->count; i++)
+    {
+        if (ctx->specs[i].required && !(ctx->found & (1u << i)))
+        {
+            set_error(ctx, HTTP_PARAM_ERR_MISSING, ctx->specs[i].name);
+            return ctx->result;
+        }
+    }
+
+    for (size_t i = 0; i < ctx->count; i++)
+    {
+        const http_param_spec_t *spec = &ctx->specs[i];
+        bool found = (ctx->found & (1u << i)) != 0;
+        if (spec->present)
+            *spec->present = found;
+        if (!found || !spec->out)
+            continue;
+        switch (spec->type)
+        {
+        case HTTP_PARAM_INT:
+        case HTTP_PARAM_ENUM:
+            *(int *)spec->out = ctx->values[i].i;
+            break;
+        case HTTP_PARAM_FLOAT:
+            *(float *)spec->out = ctx->values[i].f;
+            break;
+        case HTTP_PARAM_BOOL:
+            *(bool *)spec->out = ctx->values[i].b;
+            break;
+        case HTTP_PARAM_STRING:
+            strcpy((char *)spec->out, ctx->values[i].s);
+            break;
+        }
+    }
+    return ctx->result;
+}
+
+http_param_result_t http_params_parse_query(const char *query, size_t len, const http_param_spec_t *specs, size_t count)
+{
+    param_ctx_t ctx;
+    if (!begin(&ctx, specs, count))
+        return ctx.result;
+
+    const char *p = query;
+    const char *end = query + len;
+    while (p < end)
+    {
+        const char *pair_end = memchr(p, '&', (size_t)(end - p));
+        if (!pair_end)
+            pair_end = end;
+        const char *eq = memchr(p, '=', (size_t)(pair_end - p));
+        const char *key_end = eq ? eq : pair_end;
+
+        if (key_end > p)
+        {
+            char value[HTTP_PARAMS_MAX_VALUE];
+            const char *raw = eq ? eq + 1 : pair_end;
+            int n = http_url_decode(value, sizeof(value), raw, (size_t)(pair_end - raw));
+            if (n < 0)
+            {
+                // Só é erro se o parâmetro for um dos esperados
+                char key[HTTP_PARAMS_MAX_VALUE];
+                size_t key_len = (size_t)(key_end - p);
+                if (key_len < sizeof(key))
+                {
+                    memcpy(key, p, key_len);
+                    key[key_len] = '\0';
+                    for (size_t i = 0; i < ctx.count; i++)
+                    {
+                        if (strcmp(specs[i].name, key) == 0)
+                        {
+                            set_error(&ctx, (size_t)(pair_end - raw) >= sizeof(value) ? HTTP_PARAM_ERR_TOO_LONG : HTTP_PARAM_ERR_SYNTAX,
+                                      specs[i].name);
+                            return ctx.result;
+                        }
+                    }
+                }
+            }
+            else if (!accept_pair(&ctx, p, (size_t)(key_end - p), value))
+            {
+                return ctx.result;
+            }
+        }
+        p = pair_end + 1;
+    }
+    return commit(&ctx);
+}
+
+// --- Leitor de JSON plano ---
+
+static const char *skip_ws(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+        p++;
+    return p;
+}
+
+// Lê uma string JSON para @p out; retorna o ponteiro após as aspas finais ou NULL
+static const char *read_string(const char *p, const char *end, char *out, size_t out_len, bool *too_long)
+{
+    size_t n = 0;
+    *too_long = false;
+    if (p >= end || *p != '"')
+        return NULL;
+    p++;
+    while (p < end && *p != '"')
+    {
+        char c = *p++;
+        if ((unsigned char)c < ' ')
+            return NULL;
+        if (c == '\\')
+        {
+            if (p >= end)
+                return NULL;
+            switch (*p++)
+            {
+            case '"': c = '"'; break;
+            case '\\': c = '\\'; break;
+            case '/': c = '/'; break;
+            case 'n': c = '\n'; break;
+            case 't': c = '\t'; break;
+            case 'r': c = '\r'; break;
+            default: return NULL; // \uXXXX não é necessário para os parâmetros de controle
+            }
+        }
+        if (n + 1 >= out_len)
+            *too_long = true;
+        else
+            out[n++] = c;
+    }
+    if (p >= end)
+        return NULL;
+    out[n] = '\0';
+    return p + 1;
+}
+
+// Lê um literal (número, true, false, null) até o próximo delimitador
+static const char *read_literal(const char *p, const char *end, char *out, size_t out_len, bool *too_long)
+{
+    size_t n = 0;
+    *too_long = false;
+    while (p < end && *p != ',' && *p != '}' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+    {
+        if (*p == '{' || *p == '[' || *p == '"')
+            return NULL;
+        if (n + 1 >= out_len)
+            *too_long = true;
+        else
+            out[n++] = *p;
+        p++;
+    }
+    if (n == 0)
+        return NULL;
+    out[n] = '\0';
+    return p;
+}
+
+http_param_result_t http_params_parse_json(const char *json, size_t len, const http_param_spec_t *specs, size_t count)
+{
+    param_ctx_t ctx;
+    if (!begin(&ctx, specs, count))
+        return ctx.result;
+
+    const char *end = json + len;
+    const char *p = skip_ws(json, end);
+    char key[HTTP_PARAMS_MAX_VALUE];
+    char value[HTTP_PARAMS_MAX_VALUE];
+    bool too_long;
+
+    if (p >= end || *p++ != '{')
+    {
+        set_error(&ctx, HTTP_PARAM_ERR_SYNTAX, NULL);
+        return ctx.result;
+    }
+    p = skip_ws(p, end);
+    if (p < end && *p == '}')
+    {
+        p++;
+    }
+    else
+    {
+        while (true)
+        {
+            bool key_too_long;
+            p = read_string(skip_ws(p, end), end, key, sizeof(key), &key_too_long);
+            if (!p)
+                break;
+            p = skip_ws(p, end);
+            if (p >= end || *p++ != ':')
+            {
+                p = NULL;
+                break;
+            }
+            p = skip_ws(p, end);
+            bool is_string = p < end && *p == '"';
+            p = is_string ? read_string(p, end, value, sizeof(value), &too_long)
+                          : read_literal(p, end, value, sizeof(value), &too_long);
+            if (!p)
+                break;
+            if (strcmp(value, "null") == 0 && !is_string)
+            {
+                // null equivale a parâmetro ausente
+            }
+            else if (!key_too_long)
+            {
+                if (too_long)
+                {
+                    for (size_t i = 0; i < ctx.count; i++)
+                    {
+                        if (strcmp(specs[i].name, key) == 0)
+                        {
+                            set_error(&ctx, HTTP_PARAM_ERR_TOO_LONG, specs[i].name);
+                            return ctx.result;
+                        }
+                    }
+                }
+                else if (!accept_pair(&ctx, key, strlen(key), value))
+                {
+                    return ctx.result;
+                }
+            }
+            p = skip_ws(p, end);
+            if (p < end && *p == ',')
+            {
+                p++;
+                continue;
+            }
+            if (p < end && *p == '}')
+                p++;
+            else
+                p = NULL;
+            break;
+        }
+    }
+
+    if (!p || skip_ws(p, end) != end)
+    {
+        set_error(&ctx, HTTP_PARAM_ERR_SYNTAX, NULL);
+        return ctx.result;
+    }
+    return commit(&ctx);
+}
+
+const char *http_param_status_str(http_param_status_t status)
+{
+    switch (status)
+    {
+    case HTTP_PARAM_OK:
+        return "ok";
+    case HTTP_PARAM_ERR_MISSING:
+        return "parametro obrigatorio ausente";
+    case HTTP_PARAM_ERR_SYNTAX:
+        return "valor malformado";
+    case HTTP_PARAM_ERR_RANGE:
+        return "valor fora da faixa permitida";
+    case HTTP_PARAM_ERR_DUPLICATE:
+        return "parametro repetido";
+    case HTTP_PARAM_ERR_TOO_LONG:
+        return "valor muito longo";
+    case HTTP_PARAM_ERR_SPEC:
+        return "parametros demais na especificacao";
+    }
+    return "erro desconhecido";
+}
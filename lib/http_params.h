@@ -0,0 +1,80 @@
+#ifndef HTTP_PARAMS_H
+#define HTTP_PARAMS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define HTTP_PARAMS_MAX 12       // Parâmetros por especificação
+#define HTTP_PARAMS_MAX_VALUE 32 // Tamanho máximo de um valor já decodificado
+
+// Tipos de parâmetro suportados
+typedef enum
+{
+    HTTP_PARAM_INT,   // out: int*
+    HTTP_PARAM_FLOAT, // out: float*
+    HTTP_PARAM_BOOL,  // out: bool* (true/false, 1/0, on/off)
+    HTTP_PARAM_ENUM,  // out: int* com o índice da opção em options[]
+    HTTP_PARAM_STRING // out: char[HTTP_PARAMS_MAX_VALUE]
+} http_param_type_t;
+
+// Resultado da extração
+typedef enum
+{
+    HTTP_PARAM_OK,
+    HTTP_PARAM_ERR_MISSING,   // Parâmetro obrigatório ausente
+    HTTP_PARAM_ERR_SYNTAX,    // Valor (ou corpo JSON) malformado
+    HTTP_PARAM_ERR_RANGE,     // Fora de [min, max] ou opção desconhecida
+    HTTP_PARAM_ERR_DUPLICATE, // Parâmetro informado mais de uma vez
+    HTTP_PARAM_ERR_TOO_LONG,  // Valor maior que HTTP_PARAMS_MAX_VALUE
+    HTTP_PARAM_ERR_SPEC       // Mais de HTTP_PARAMS_MAX especificações: erro do chamador
+} http_param_status_t;
+
+// Descrição de um parâmetro esperado
+typedef struct
+{
+    const char *name;
+    http_param_type_t type;
+    bool required;
+    float min, max;             // Faixa aceita para INT e FLOAT
+    const char *const *options; // Opções de ENUM, terminadas em NULL
+    void *out;                  // Destino do valor (ver http_param_type_t)
+    bool *present;              // Opcional: indica se o parâmetro foi enviado
+} http_param_spec_t;
+
+// Resultado detalhado: status e o nome do parâmetro que falhou
+typedef struct
+{
+    http_param_status_t status;
+    const char *name;
+} http_param_result_t;
+
+/**
+ * @brief Extrai parâmetros de uma query string ou formulário (a=1&b=2).
+ *
+ * Percorre a entrada uma única vez, decodificando %XX e '+'. Os valores só são
+ * escritos nos destinos se todos os parâmetros forem válidos; parâmetros não
+ * descritos em @p specs são ignorados.
+ *
+ * @param query A query string, sem o '?' inicial (não precisa terminar em '\0').
+ * @param len O tamanho de @p query.
+ * @param specs Os parâmetros esperados.
+ * @param count Quantidade de especificações; acima de HTTP_PARAMS_MAX a
+ *              entrada nem é lida e o status é HTTP_PARAM_ERR_SPEC.
+ * @return O status e, em caso de erro, o nome do parâmetro com problema.
+ */
+http_param_result_t http_params_parse_query(const char *query, size_t len, const http_param_spec_t *specs, size_t count);
+
+/**
+ * @brief Extrai parâmetros de um objeto JSON plano ({"kp": 10, "modo": "auto"}).
+ *
+ * Aceita números, strings e booleanos; objetos e listas aninhados são
+ * rejeitados. Mesmas regras de validação de http_params_parse_query().
+ */
+http_param_result_t http_params_parse_json(const char *json, size_t len, const http_param_spec_t *specs, size_t count);
+
+/**
+ * @brief Retorna uma descrição curta do status, para mensagens de erro.
+ */
+const char *http_param_status_str(http_param_status_t status);
+
+#endif // HTTP_PARAMS_H
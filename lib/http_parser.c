@@ -0,0 +1,386 @@
+#include "http_parser.h"
+#include <string.h>
+
+// --- Estados internos da máquina de estados ---
+enum
+{
+    ST_METHOD,
+    ST_TARGET,
+    ST_VERSION,
+    ST_REQUEST_LF,
+    ST_HEADER_START,
+    ST_HEADER_NAME,
+    ST_HEADER_VALUE,
+    ST_HEADER_LF,
+    ST_HEADERS_END_LF,
+    ST_BODY,
+    ST_BODY_STREAM,
+    ST_DONE,
+    ST_ERROR
+};
+
+// Cabeçalhos cujo valor interessa ao servidor
+enum
+{
+    HDR_OTHER,
+    HDR_CONTENT_LENGTH,
+    HDR_AUTHORIZATION
+};
+
+static char to_lower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+}
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    c = to_lower(c);
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+static bool name_equals(const char *name, uint8_t len, const char *expected)
+{
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (expected[i] == '\0' || to_lower(name[i]) != expected[i])
+            return false;
+    }
+    return expected[len] == '\0';
+}
+
+static http_parse_result_t fail(http_parser_t *parser, http_parser_error_t error)
+{
+    parser->state = ST_ERROR;
+    parser->error = error;
+    return HTTP_PARSE_ERROR;
+}
+
+// Chamada ao fim dos cabeçalhos: decide se ainda há corpo a receber
+static http_parse_result_t end_of_headers(http_parser_t *parser)
+{
+    if (parser->content_length > HTTP_PARSER_MAX_BODY)
+    {
+        parser->state = ST_BODY_STREAM;
+        return HTTP_PARSE_BODY;
+    }
+    if (parser->content_length == 0)
+    {
+        parser->state = ST_DONE;
+        return HTTP_PARSE_DONE;
+    }
+    parser->state = ST_BODY;
+    return HTTP_PARSE_INCOMPLETE;
+}
+
+// Fim da linha do cabeçalho Authorization: tira os espaços finais ou descarta
+// o valor se ele não coube
+static void finish_authorization(http_parser_t *parser)
+{
+    if (parser->authorization_len > HTTP_PARSER_MAX_AUTHORIZATION)
+        parser->authorization_len = 0;
+    while (parser->authorization_len > 0 && (parser->authorization[parser->authorization_len - 1] == ' ' ||
+                                             parser->authorization[parser->authorization_len - 1] == '\t'))
+        parser->authorization_len--;
+    parser->authorization[parser->authorization_len] = '\0';
+}
+
+static bool finish_method(http_parser_t *parser)
+{
+    if (parser->method_len == 3 && memcmp(parser->method_buf, "GET", 3) == 0)
+        parser->method = HTTP_METHOD_GET;
+    else if (parser->method_len == 4 && memcmp(parser->method_buf, "POST", 4) == 0)
+        parser->method = HTTP_METHOD_POST;
+    else
+        return false;
+    return true;
+}
+
+void http_parser_init(http_parser_t *parser)
+{
+    parser->state = ST_METHOD;
+    parser->error = HTTP_PARSER_OK;
+    parser->method = HTTP_METHOD_UNKNOWN;
+    parser->method_len = 0;
+    parser->target[0] = '\0';
+    parser->target_len = 0;
+    parser->path_len = 0;
+    parser->header_name_len = 0;
+    parser->header_id = HDR_OTHER;
+    parser->header_bytes = 0;
+    parser->authorization[0] = '\0';
+    parser->authorization_len = 0;
+    parser->content_length = 0;
+    parser->body[0] = '\0';
+    parser->body_len = 0;
+}
+
+http_parse_result_t http_parser_feed(http_parser_t *parser, const char *data, size_t len, size_t *consumed)
+{
+    size_t i = 0;
+    http_parse_result_t result = HTTP_PARSE_INCOMPLETE;
+
+    while (i < len && result == HTTP_PARSE_INCOMPLETE)
+    {
+        char c = data[i++];
+
+        if (parser->state >= ST_HEADER_START && parser->state <= ST_HEADERS_END_LF &&
+            ++parser->header_bytes > HTTP_PARSER_MAX_HEADER_BYTES)
+        {
+            result = fail(parser, HTTP_PARSER_ERR_HEADERS_TOO_LARGE);
+            break;
+        }
+
+        switch (parser->state)
+        {
+        case ST_METHOD:
+            if (c == ' ')
+            {
+                if (!finish_method(parser))
+                    result = fail(parser, HTTP_PARSER_ERR_METHOD);
+                else
+                    parser->state = ST_TARGET;
+            }
+            else if (c < 'A' || c > 'Z' || parser->method_len >= sizeof(parser->method_buf))
+            {
+                result = fail(parser, HTTP_PARSER_ERR_METHOD);
+            }
+            else
+            {
+                parser->method_buf[parser->method_len++] = c;
+            }
+            break;
+
+        case ST_TARGET:
+            if (c == ' ')
+            {
+                if (parser->target_len == 0 || parser->target[0] != '/')
+                {
+                    result = fail(parser, HTTP_PARSER_ERR_BAD_REQUEST);
+                    break;
+                }
+                if (parser->path_len == 0)
+                    parser->path_len = parser->target_len;
+                parser->target[parser->target_len] = '\0';
+                parser->state = ST_VERSION;
+            }
+            else if ((unsigned char)c <= ' ' || c == 0x7f)
+            {
+                result = fail(parser, HTTP_PARSER_ERR_BAD_REQUEST);
+            }
+            else if (parser->target_len >= HTTP_PARSER_MAX_TARGET - 1)
+            {
+                result = fail(parser, HTTP_PARSER_ERR_URI_TOO_LONG);
+            }
+            else
+            {
+                if (c == '?' && parser->path_len == 0)
+                    parser->path_len = parser->target_len;
+                parser->target[parser->target_len++] = c;
+            }
+            break;
+
+        case ST_VERSION:
+            // O texto da versão não é armazenado; só aguarda o fim da linha
+            if (c == '\r')
+                parser->state = ST_REQUEST_LF;
+            else if (c == '\n')
+                parser->state = ST_HEADER_START;
+            else if ((unsigned char)c < ' ')
+                result = fail(parser, HTTP_PARSER_ERR_BAD_REQUEST);
+            break;
+
+        case ST_REQUEST_LF:
+        case ST_HEADER_LF:
+            if (c != '\n')
+                result = fail(parser, HTTP_PARSER_ERR_BAD_REQUEST);
+            else
+                parser->state = ST_HEADER_START;
+            break;
+
+        case ST_HEADER_START:
+            if (c == '\r')
+            {
+                parser->state = ST_HEADERS_END_LF;
+                break;
+            }
+            if (c == '\n')
+            {
+                result = end_of_headers(parser); // Aceita "\n" sozinho
+                break;
+            }
+            parser->header_name_len = 0;
+            parser->header_id = HDR_OTHER;
+            parser->state = ST_HEADER_NAME;
+            // fall through
+        case ST_HEADER_NAME:
+            if (c == ':')
+            {
+                if (parser->header_name_len == 0)
+                {
+                    result = fail(parser, HTTP_PARSER_ERR_BAD_REQUEST);
+                    break;
+                }
+                if (parser->header_name_len <= HTTP_PARSER_MAX_HEADER_NAME &&
+                    name_equals(parser->header_name, parser->header_name_len, "content-length"))
+                {
+                    parser->header_id = HDR_CONTENT_LENGTH;
+                    parser->content_length = 0;
+                }
+                else if (parser->header_name_len <= HTTP_PARSER_MAX_HEADER_NAME &&
+                         name_equals(parser->header_name, parser->header_name_len, "authorization"))
+                {
+                    parser->header_id = HDR_AUTHORIZATION;
+                    parser->authorization_len = 0;
+                }
+                parser->state = ST_HEADER_VALUE;
+            }
+            else if (c == '\r' || c == '\n' || c == ' ')
+            {
+                result = fail(parser, HTTP_PARSER_ERR_BAD_REQUEST);
+            }
+            else
+            {
+                // Nomes longos demais são contados mas não armazenados
+                if (parser->header_name_len < HTTP_PARSER_MAX_HEADER_NAME)
+                    parser->header_name[parser->header_name_len] = c;
+                if (parser->header_name_len < UINT8_MAX)
+                    parser->header_name_len++;
+            }
+            break;
+
+        case ST_HEADERS_END_LF:
+            if (c != '\n')
+                result = fail(parser, HTTP_PARSER_ERR_BAD_REQUEST);
+            else
+                result = end_of_headers(parser);
+            break;
+
+        case ST_HEADER_VALUE:
+            if (c == '\r' || c == '\n')
+            {
+                if (parser->header_id == HDR_AUTHORIZATION)
+                    finish_authorization(parser);
+                parser->state = c == '\r' ? ST_HEADER_LF : ST_HEADER_START;
+            }
+            else if (parser->header_id == HDR_AUTHORIZATION)
+            {
+                // Espaços iniciais ignorados; um byte além do buffer invalida o valor
+                if (parser->authorization_len == 0 && (c == ' ' || c == '\t'))
+                    break;
+                if (parser->authorization_len < HTTP_PARSER_MAX_AUTHORIZATION)
+                    parser->authorization[parser->authorization_len++] = c;
+                else
+                    parser->authorization_len = HTTP_PARSER_MAX_AUTHORIZATION + 1;
+            }
+            else if (parser->header_id == HDR_CONTENT_LENGTH && c != ' ' && c != '\t')
+            {
+                // Até 8 dígitos: imagens de firmware passam de 1 MB
+                if (c < '0' || c > '9' || parser->content_length > 9999999)
+                    result = fail(parser, HTTP_PARSER_ERR_BAD_REQUEST);
+                else
+                    parser->content_length = parser->content_length * 10 + (uint32_t)(c - '0');
+            }
+            break;
+
+        case ST_BODY:
+            parser->body[parser->body_len++] = c;
+            if (parser->body_len >= parser->content_length)
+            {
+                parser->body[parser->body_len] = '\0';
+                parser->state = ST_DONE;
+                result = HTTP_PARSE_DONE;
+            }
+            break;
+
+        case ST_DONE:
+            // Bytes após uma requisição completa (pipelining) são ignorados
+            i--;
+            result = HTTP_PARSE_DONE;
+            break;
+
+        case ST_BODY_STREAM:
+            i--; // O corpo é do chamador
+            result = HTTP_PARSE_BODY;
+            break;
+
+        default:
+            i--;
+            result = HTTP_PARSE_ERROR;
+            break;
+        }
+    }
+
+    if (consumed)
+        *consumed = i;
+    return result;
+}
+
+bool http_parser_path_equals(const http_parser_t *parser, const char *path)
+{
+    size_t len = strlen(path);
+    return len == parser->path_len && memcmp(parser->target, path, len) == 0;
+}
+
+int http_url_decode(char *dst, size_t dst_len, const char *src, size_t src_len)
+{
+    size_t out = 0;
+    if (dst_len == 0)
+        return -1; // Nem o '\0' cabe
+    for (size_t i = 0; i < src_len; i++)
+    {
+        char c = src[i];
+        if (c == '+')
+        {
+            c = ' ';
+        }
+        else if (c == '%')
+        {
+            if (i + 2 >= src_len)
+                return -1;
+            int hi = hex_value(src[i + 1]);
+            int lo = hex_value(src[i + 2]);
+            if (hi < 0 || lo < 0)
+                return -1;
+            c = (char)((hi << 4) | lo);
+            i += 2;
+        }
+        if (out + 1 >= dst_len)
+            return -1;
+        dst[out++] = c;
+    }
+    dst[out] = '\0';
+    return (int)out;
+}
+
+bool http_parser_query_param(const http_parser_t *parser, const char *name, char *out, size_t out_len)
+{
+    if (out_len > 0)
+        out[0] = '\0';
+    if (parser->path_len >= parser->target_len)
+        return false;
+
+    size_t name_len = strlen(name);
+    const char *p = parser->target + parser->path_len + 1; // Pula o '?'
+    const char *end = parser->target + parser->target_len;
+
+    while (p < end)
+    {
+        const char *pair_end = memchr(p, '&', (size_t)(end - p));
+        if (!pair_end)
+            pair_end = end;
+
+        const char *eq = memchr(p, '=', (size_t)(pair_end - p));
+        const char *key_end = eq ? eq : pair_end;
+        if ((size_t)(key_end - p) == name_len && memcmp(p, name, name_len) == 0)
+        {
+            const char *value = eq ? eq + 1 : pair_end;
+            return http_url_decode(out, out_len, value, (size_t)(pair_end - value)) >= 0;
+        }
+        p = pair_end + 1;
+    }
+    return false;
+}
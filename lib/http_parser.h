@@ -0,0 +1,120 @@
+#ifndef HTTP_PARSER_H
+#define HTTP_PARSER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Limites do parser (todo o estado vive dentro de http_parser_t) ---
+#define HTTP_PARSER_MAX_TARGET 160      // Caminho + '?' + query string
+#define HTTP_PARSER_MAX_HEADER_NAME 32  // Nomes maiores são ignorados, não rejeitados
+#define HTTP_PARSER_MAX_HEADER_BYTES 2048 // Soma de todas as linhas de cabeçalho
+#define HTTP_PARSER_MAX_BODY 256        // Corpo guardado em requisições POST
+#define HTTP_PARSER_MAX_AUTHORIZATION 80 // Valor de "Authorization" (ex: "Bearer <token>")
+
+// Métodos HTTP reconhecidos pelo servidor
+typedef enum
+{
+    HTTP_METHOD_UNKNOWN,
+    HTTP_METHOD_GET,
+    HTTP_METHOD_POST
+} http_method_t;
+
+// Resultado de uma chamada a http_parser_feed()
+typedef enum
+{
+    HTTP_PARSE_INCOMPLETE, // Precisa de mais bytes
+    HTTP_PARSE_DONE,       // Requisição completa (linha, cabeçalhos e corpo)
+    HTTP_PARSE_BODY,       // Cabeçalhos completos; o corpo, maior que HTTP_PARSER_MAX_BODY, fica com o chamador
+    HTTP_PARSE_ERROR       // Requisição malformada; ver http_parser_t.error
+} http_parse_result_t;
+
+// Motivo da falha, usado para escolher o código de status da resposta
+typedef enum
+{
+    HTTP_PARSER_OK,
+    HTTP_PARSER_ERR_BAD_REQUEST,      // 400
+    HTTP_PARSER_ERR_METHOD,           // 405
+    HTTP_PARSER_ERR_URI_TOO_LONG,     // 414
+    HTTP_PARSER_ERR_HEADERS_TOO_LARGE, // 431
+    HTTP_PARSER_ERR_BODY_TOO_LARGE    // 413
+} http_parser_error_t;
+
+// Estado incremental do parser. Não aloca memória: pode ser embutido na
+// estrutura de conexão e alimentado com cada segmento da cadeia de pbufs.
+typedef struct
+{
+    uint8_t state;
+    http_parser_error_t error;
+    http_method_t method;
+
+    char method_buf[8];
+    uint8_t method_len;
+
+    char target[HTTP_PARSER_MAX_TARGET]; // "/caminho?query", terminado em '\0'
+    uint16_t target_len;
+    uint16_t path_len; // Posição do '?' (ou target_len se não houver query)
+
+    char header_name[HTTP_PARSER_MAX_HEADER_NAME];
+    uint8_t header_name_len;
+    uint8_t header_id;
+    uint16_t header_bytes;
+
+    char authorization[HTTP_PARSER_MAX_AUTHORIZATION + 1]; // Vazio se ausente ou longo demais
+    uint8_t authorization_len;
+
+    uint32_t content_length;
+    char body[HTTP_PARSER_MAX_BODY + 1]; // Terminado em '\0'
+    uint16_t body_len;
+} http_parser_t;
+
+/**
+ * @brief Prepara o parser para uma nova requisição.
+ *
+ * @param parser O estado a ser (re)inicializado.
+ */
+void http_parser_init(http_parser_t *parser);
+
+/**
+ * @brief Alimenta o parser com um bloco de bytes recebidos.
+ *
+ * Pode ser chamada quantas vezes forem necessárias, com blocos de qualquer
+ * tamanho (ex: cada pbuf da cadeia). Nunca lê além de @p len e nunca exige
+ * terminador '\0' nos dados de entrada.
+ *
+ * @param parser O estado do parser.
+ * @param data Ponteiro para os bytes recebidos.
+ * @param len Quantidade de bytes em @p data.
+ * @param consumed Se não for NULL, recebe quantos bytes foram consumidos.
+ * @return HTTP_PARSE_DONE quando a requisição estiver completa,
+ * HTTP_PARSE_INCOMPLETE se faltar dados, HTTP_PARSE_BODY quando o corpo não
+ * couber no parser (começa em data + *consumed; o chamador decide entre
+ * recebê-lo em fluxo ou responder 413) ou HTTP_PARSE_ERROR.
+ */
+http_parse_result_t http_parser_feed(http_parser_t *parser, const char *data, size_t len, size_t *consumed);
+
+/**
+ * @brief Compara o caminho da requisição (sem query string) com @p path.
+ */
+bool http_parser_path_equals(const http_parser_t *parser, const char *path);
+
+/**
+ * @brief Busca um parâmetro da query string e o decodifica (%XX e '+').
+ *
+ * @param parser Parser com uma requisição completa.
+ * @param name Nome do parâmetro, sem o sinal de igual (ex: "temperatura").
+ * @param out Buffer de saída, sempre terminado em '\0' quando out_len > 0.
+ * @param out_len Tamanho do buffer de saída.
+ * @return true se o parâmetro existir e couber no buffer.
+ */
+bool http_parser_query_param(const http_parser_t *parser, const char *name, char *out, size_t out_len);
+
+/**
+ * @brief Decodifica uma string codificada para URL (%XX e '+').
+ *
+ * @return O número de bytes escritos em @p dst (sem o '\0'), ou -1 se a
+ * entrada tiver um escape inválido ou não couber em @p dst.
+ */
+int http_url_decode(char *dst, size_t dst_len, const char *src, size_t src_len);
+
+#endif // HTTP_PARSER_H
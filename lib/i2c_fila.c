@@ -0,0 +1,309 @@
+#include "i2c_fila.h"
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+// Nível da FIFO de TX (16 posições) abaixo do qual o DMA é acionado
+#define NIVEL_DMA_TX 8
+
+typedef struct {
+    i2c_inst_t *i2c;
+    bool iniciado;
+    int canal_tx;
+    int canal_rx;
+
+    // Fila circular de cadeias; fila[cabeca] é a cadeia em andamento
+    I2CTransacao *fila[I2C_FILA_PROFUNDIDADE];
+    uint8_t cabeca;
+    uint8_t quantidade;
+    I2CTransacao *atual; // Descritor ativo dentro da cadeia (NULL = ocioso)
+
+    // Palavras de comando do IC_DATA_CMD montadas para o descritor ativo
+    uint16_t comandos[I2C_FILA_MAX_PALAVRAS];
+    alarm_id_t alarme;
+    uint64_t inicio_us;
+
+    I2CFilaEstatisticas estatisticas;
+    uint64_t iniciado_em_us;
+} Barramento;
+
+static Barramento barramentos[2];
+
+static void iniciar_proxima(Barramento *b);
+
+static Barramento *barramento_de(i2c_inst_t *i2c)
+{
+    return &barramentos[i2c_hw_index(i2c)];
+}
+
+static size_t palavras_do_descritor(const I2CTransacao *t)
+{
+    return t->escrita_len + t->leitura_len;
+}
+
+// Encerra o descritor ativo: segue a cadeia ou conclui e passa para a próxima
+static void finalizar_descritor(Barramento *b, I2CFilaStatus status)
+{
+    if (b->alarme > 0)
+    {
+        cancel_alarm(b->alarme);
+        b->alarme = 0;
+    }
+    if (status != I2C_FILA_OK)
+    {
+        dma_channel_abort(b->canal_tx);
+        dma_channel_abort(b->canal_rx);
+    }
+    else if (b->atual->leitura_len > 0)
+    {
+        // O STOP chega junto com o último byte; o DMA ainda pode estar copiando
+        while (dma_channel_is_busy(b->canal_rx))
+            tight_loop_contents();
+    }
+    b->estatisticas.tempo_ocupado_us += time_us_64() - b->inicio_us;
+
+    if (status == I2C_FILA_OK && b->atual->proxima)
+    {
+        b->atual = b->atual->proxima;
+        iniciar_proxima(b);
+        return;
+    }
+
+    I2CTransacao *cadeia = b->fila[b->cabeca];
+    b->cabeca = (b->cabeca + 1) % I2C_FILA_PROFUNDIDADE;
+    b->quantidade--;
+    b->atual = NULL;
+
+    if (status == I2C_FILA_OK)
+        b->estatisticas.concluidas++;
+    else if (status == I2C_FILA_ERRO_TIMEOUT)
+        b->estatisticas.timeouts++;
+    else
+        b->estatisticas.erros++;
+
+    cadeia->status = status;
+    if (cadeia->callback)
+        cadeia->callback(cadeia, cadeia->contexto);
+
+    iniciar_proxima(b);
+}
+
+static int64_t timeout_callback(alarm_id_t id, void *contexto)
+{
+    Barramento *b = contexto;
+    if (b->alarme != id || !b->atual)
+        return 0;
+    b->alarme = 0;
+
+    // Desabilitar o controlador aborta a transação e esvazia as FIFOs
+    i2c_hw_t *hw = i2c_get_hw(b->i2c);
+    hw->enable = 0;
+    finalizar_descritor(b, I2C_FILA_ERRO_TIMEOUT);
+    return 0;
+}
+
+// Programa o descritor b->atual (ou o primeiro da próxima cadeia) no hardware
+static void iniciar_proxima(Barramento *b)
+{
+    if (!b->atual)
+    {
+        if (b->quantidade == 0)
+            return;
+        b->atual = b->fila[b->cabeca];
+    }
+    const I2CTransacao *t = b->atual;
+
+    // Cada byte vira uma palavra do IC_DATA_CMD: escrita, depois os comandos de
+    // leitura (START repetido no primeiro) e STOP na última palavra
+    size_t n = 0;
+    for (size_t i = 0; i < t->escrita_len; i++)
+        b->comandos[n++] = t->escrita[i];
+    for (size_t i = 0; i < t->leitura_len; i++)
+    {
+        uint16_t palavra = I2C_IC_DATA_CMD_CMD_BITS;
+        if (i == 0 && t->escrita_len > 0)
+            palavra |= I2C_IC_DATA_CMD_RESTART_BITS;
+        b->comandos[n++] = palavra;
+    }
+    b->comandos[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    i2c_hw_t *hw = i2c_get_hw(b->i2c);
+    hw->enable = 0;
+    hw->tar = t->endereco;
+    hw->enable = I2C_IC_ENABLE_ENABLE_BITS;
+    (void)hw->clr_intr;
+
+    if (t->leitura_len > 0)
+    {
+        dma_channel_config cfg_rx = dma_channel_get_default_config(b->canal_rx);
+        channel_config_set_transfer_data_size(&cfg_rx, DMA_SIZE_8);
+        channel_config_set_read_increment(&cfg_rx, false);
+        channel_config_set_write_increment(&cfg_rx, true);
+        channel_config_set_dreq(&cfg_rx, i2c_get_dreq(b->i2c, false));
+        dma_channel_configure(b->canal_rx, &cfg_rx, t->leitura, &hw->data_cmd, t->leitura_len, true);
+    }
+
+    dma_channel_config cfg_tx = dma_channel_get_default_config(b->canal_tx);
+    channel_config_set_transfer_data_size(&cfg_tx, DMA_SIZE_16);
+    channel_config_set_read_increment(&cfg_tx, true);
+    channel_config_set_write_increment(&cfg_tx, false);
+    channel_config_set_dreq(&cfg_tx, i2c_get_dreq(b->i2c, true));
+
+    // Timeout: duas vezes o tempo nominal (9 bits por byte) mais uma folga fixa
+    uint64_t timeout_us = I2C_FILA_TIMEOUT_BASE_US +
+                          2ull * n * 9u * 1000000u / b->estatisticas.frequencia_hz;
+    b->inicio_us = time_us_64();
+    b->estatisticas.bytes += n;
+    b->alarme = add_alarm_in_us(timeout_us, timeout_callback, b, true);
+
+    dma_channel_configure(b->canal_tx, &cfg_tx, &hw->data_cmd, b->comandos, n, true);
+}
+
+static void tratar_irq(Barramento *b)
+{
+    i2c_hw_t *hw = i2c_get_hw(b->i2c);
+    uint32_t status = hw->raw_intr_stat;
+    if (!b->atual)
+    {
+        (void)hw->clr_intr;
+        return;
+    }
+
+    // O abort também gera STOP_DET; trata primeiro e limpa as duas
+    if (status & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+    {
+        (void)hw->clr_intr;
+        finalizar_descritor(b, I2C_FILA_ERRO_NACK);
+    }
+    else if (status & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS)
+    {
+        (void)hw->clr_stop_det;
+        finalizar_descritor(b, I2C_FILA_OK);
+    }
+}
+
+static void i2c0_irq(void) { tratar_irq(&barramentos[0]); }
+static void i2c1_irq(void) { tratar_irq(&barramentos[1]); }
+
+void i2c_fila_iniciar(i2c_inst_t *i2c, uint frequencia_hz)
+{
+    uint indice = i2c_hw_index(i2c);
+    Barramento *b = &barramentos[indice];
+    uint irq = indice == 0 ? I2C0_IRQ : I2C1_IRQ;
+
+    irq_set_enabled(irq, false);
+    i2c_init(i2c, frequencia_hz);
+
+    if (!b->iniciado)
+    {
+        b->i2c = i2c;
+        b->canal_tx = dma_claim_unused_channel(true);
+        b->canal_rx = dma_claim_unused_channel(true);
+        b->iniciado_em_us = time_us_64();
+        irq_set_exclusive_handler(irq, indice == 0 ? i2c0_irq : i2c1_irq);
+        b->iniciado = true;
+    }
+    b->estatisticas.frequencia_hz = frequencia_hz;
+
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    hw->dma_tdlr = NIVEL_DMA_TX;
+    hw->dma_rdlr = 0;
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    irq_set_enabled(irq, true);
+}
+
+bool i2c_fila_iniciado(i2c_inst_t *i2c)
+{
+    return barramento_de(i2c)->iniciado;
+}
+
+bool i2c_fila_enviar(i2c_inst_t *i2c, I2CTransacao *cadeia)
+{
+    for (const I2CTransacao *t = cadeia; t; t = t->proxima)
+    {
+        size_t n = palavras_do_descritor(t);
+        if (n == 0 || n > I2C_FILA_MAX_PALAVRAS)
+        {
+            cadeia->status = I2C_FILA_ERRO_TAMANHO;
+            return false;
+        }
+    }
+
+    Barramento *b = barramento_de(i2c);
+    uint32_t interrupcoes = save_and_disable_interrupts();
+    if (b->quantidade == I2C_FILA_PROFUNDIDADE)
+    {
+        restore_interrupts(interrupcoes);
+        cadeia->status = I2C_FILA_ERRO_CHEIA;
+        return false;
+    }
+
+    cadeia->status = I2C_FILA_PENDENTE;
+    b->fila[(b->cabeca + b->quantidade) % I2C_FILA_PROFUNDIDADE] = cadeia;
+    b->quantidade++;
+    if (b->quantidade > b->estatisticas.profundidade_max)
+        b->estatisticas.profundidade_max = b->quantidade;
+    if (!b->atual)
+        iniciar_proxima(b);
+    restore_interrupts(interrupcoes);
+    return true;
+}
+
+I2CFilaStatus i2c_fila_aguardar(I2CTransacao *cadeia)
+{
+    while (cadeia->status == I2C_FILA_PENDENTE)
+        tight_loop_contents();
+    return cadeia->status;
+}
+
+void i2c_fila_aguardar_ocioso(i2c_inst_t *i2c)
+{
+    Barramento *b = barramento_de(i2c);
+    while (b->quantidade > 0)
+        tight_loop_contents();
+}
+
+// Envia uma transação e espera, tentando de novo enquanto a fila estiver cheia
+static int executar_bloqueante(i2c_inst_t *i2c, I2CTransacao *t, size_t len)
+{
+    while (!i2c_fila_enviar(i2c, t))
+    {
+        if (t->status != I2C_FILA_ERRO_CHEIA)
+            return PICO_ERROR_GENERIC;
+        tight_loop_contents();
+    }
+
+    switch (i2c_fila_aguardar(t))
+    {
+    case I2C_FILA_OK:
+        return (int)len;
+    case I2C_FILA_ERRO_TIMEOUT:
+        return PICO_ERROR_TIMEOUT;
+    default:
+        return PICO_ERROR_GENERIC;
+    }
+}
+
+int i2c_fila_escrever(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *dados, size_t len)
+{
+    I2CTransacao t = {.endereco = endereco, .escrita = dados, .escrita_len = len};
+    return executar_bloqueante(i2c, &t, len);
+}
+
+int i2c_fila_ler(i2c_inst_t *i2c, uint8_t endereco, uint8_t *dados, size_t len)
+{
+    I2CTransacao t = {.endereco = endereco, .leitura = dados, .leitura_len = len};
+    return executar_bloqueante(i2c, &t, len);
+}
+
+void i2c_fila_estatisticas(i2c_inst_t *i2c, I2CFilaEstatisticas *estatisticas)
+{
+    Barramento *b = barramento_de(i2c);
+    uint32_t interrupcoes = save_and_disable_interrupts();
+    *estatisticas = b->estatisticas;
+    estatisticas->profundidade = b->quantidade;
+    restore_interrupts(interrupcoes);
+    estatisticas->tempo_total_us = b->iniciado ? time_us_64() - b->iniciado_em_us : 0;
+}
@@ -0,0 +1,89 @@
+#ifndef I2C_FILA_H
+#define I2C_FILA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hardware/i2c.h"
+
+/* ---------- Limites ---------- */
+#define I2C_FILA_PROFUNDIDADE 8      // Cadeias pendentes por barramento
+#define I2C_FILA_MAX_PALAVRAS 1040   // Bytes por descritor (um quadro do SSD1306 cabe inteiro)
+#define I2C_FILA_TIMEOUT_BASE_US 2000 // Folga do timeout além do tempo nominal da transação
+
+/* ---------- Situação de uma cadeia ---------- */
+typedef enum {
+    I2C_FILA_OK,           // Concluída (também o estado de um descritor nunca enviado)
+    I2C_FILA_PENDENTE,     // Na fila ou em andamento
+    I2C_FILA_ERRO_NACK,    // Escravo não respondeu (abort do controlador)
+    I2C_FILA_ERRO_TIMEOUT, // Barramento travado
+    I2C_FILA_ERRO_CHEIA,   // Fila cheia: nada foi enviado
+    I2C_FILA_ERRO_TAMANHO  // Descritor vazio ou maior que I2C_FILA_MAX_PALAVRAS
+} I2CFilaStatus;
+
+typedef struct I2CTransacao I2CTransacao;
+
+// Chamada na interrupção quando a cadeia termina (com sucesso ou no primeiro erro).
+typedef void (*i2c_fila_callback_t)(I2CTransacao *cadeia, void *contexto);
+
+/* ---------- Descritor de transação ---------- */
+// Escreve @p escrita e, se houver, lê @p leitura com um START repetido, tudo em
+// uma única transação terminada por STOP. Descritores ligados por @p proxima
+// formam uma cadeia executada sem intervalos; callback, contexto e status valem
+// para a cadeia e ficam no primeiro descritor. Os buffers e os descritores
+// precisam continuar válidos até a cadeia terminar.
+struct I2CTransacao {
+    uint8_t endereco;
+    const uint8_t *escrita;
+    size_t escrita_len;
+    uint8_t *leitura;
+    size_t leitura_len;
+    I2CTransacao *proxima;
+
+    i2c_fila_callback_t callback;
+    void *contexto;
+    volatile I2CFilaStatus status;
+};
+
+/* ---------- Métricas por barramento ---------- */
+typedef struct {
+    uint32_t frequencia_hz;
+    uint32_t concluidas;
+    uint32_t erros;
+    uint32_t timeouts;
+    uint32_t bytes;
+    uint8_t profundidade;     // Cadeias na fila agora (incluindo a ativa)
+    uint8_t profundidade_max;
+    uint64_t tempo_ocupado_us;
+    uint64_t tempo_total_us;  // Desde i2c_fila_iniciar(); ocupado/total = utilização
+} I2CFilaEstatisticas;
+
+/* ---------- API ---------- */
+
+// Configura o controlador I2C, os canais de DMA e a interrupção do barramento.
+// Pode ser chamada de novo (ex.: após uma recuperação) para reconfigurar o
+// periférico; os pinos ficam por conta de quem chama.
+void i2c_fila_iniciar(i2c_inst_t *i2c, uint frequencia_hz);
+
+// Indica se o barramento já foi configurado por i2c_fila_iniciar().
+bool i2c_fila_iniciado(i2c_inst_t *i2c);
+
+// Enfileira uma cadeia sem bloquear. Retorna false (com o status da cadeia em
+// I2C_FILA_ERRO_CHEIA ou I2C_FILA_ERRO_TAMANHO) se ela não foi aceita.
+bool i2c_fila_enviar(i2c_inst_t *i2c, I2CTransacao *cadeia);
+
+// Espera a cadeia terminar e retorna o resultado.
+I2CFilaStatus i2c_fila_aguardar(I2CTransacao *cadeia);
+
+// Espera o barramento esvaziar (ex.: antes de uma recuperação).
+void i2c_fila_aguardar_ocioso(i2c_inst_t *i2c);
+
+// Versões bloqueantes, com o mesmo retorno de i2c_write_blocking()/i2c_read_blocking():
+// bytes transferidos, PICO_ERROR_GENERIC ou PICO_ERROR_TIMEOUT.
+int i2c_fila_escrever(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *dados, size_t len);
+int i2c_fila_ler(i2c_inst_t *i2c, uint8_t endereco, uint8_t *dados, size_t len);
+
+// Copia as métricas do barramento.
+void i2c_fila_estatisticas(i2c_inst_t *i2c, I2CFilaEstatisticas *estatisticas);
+
+#endif // I2C_FILA_H
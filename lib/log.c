@@ -0,0 +1,20 @@
+#include <string.h>
+#include "log.h"
+
+volatile LogNivel log_nivel = LOG_INFO;
+volatile bool log_silenciado = false;
+
+static const char *const NOMES_NIVEL[] = {"nada", "erro", "aviso", "info", "depuracao"};
+
+const char *log_nivel_str(LogNivel nivel)
+{
+    return (unsigned)nivel < sizeof(NOMES_NIVEL) / sizeof(NOMES_NIVEL[0]) ? NOMES_NIVEL[nivel] : "?";
+}
+
+int log_nivel_de_str(const char *nome)
+{
+    for (int i = 0; i < (int)(sizeof(NOMES_NIVEL) / sizeof(NOMES_NIVEL[0])); i++)
+        if (strcmp(nome, NOMES_NIVEL[i]) == 0)
+            return i;
+    return -1;
+}
@@ -0,0 +1,32 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/* ---------- Níveis das mensagens na serial ---------- */
+typedef enum {
+    LOG_NADA,      // Só as respostas do shell
+    LOG_ERRO,
+    LOG_AVISO,
+    LOG_INFO,      // Padrão: inclui a linha de cada zona por ciclo
+    LOG_DEPURACAO,
+} LogNivel;
+
+extern volatile LogNivel log_nivel;
+
+// Verdadeiro durante a saída binária do shell: nenhum texto vai para a serial,
+// para não corromper os quadros.
+extern volatile bool log_silenciado;
+
+#define LOG(nivel, ...)                                          \
+    do {                                                         \
+        if (!log_silenciado && (nivel) <= log_nivel)             \
+            printf(__VA_ARGS__);                                 \
+    } while (0)
+
+// Nome do nível (para o shell e a telemetria) e o inverso; -1 se desconhecido.
+const char *log_nivel_str(LogNivel nivel);
+int log_nivel_de_str(const char *nome);
+
+#endif // LOG_H
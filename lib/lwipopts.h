@@ -19,25 +19,38 @@
 #define MEM_LIBC_MALLOC 0
 #endif
 #define MEM_ALIGNMENT 4
-#define MEM_SIZE 32000 // Aumentado de 16000 para 32000
-#define MEMP_NUM_TCP_SEG 64
+// Dimensionado pela carga real (comando "memoria" do shell mostra os picos):
+// - heap: cópias de envio do TCP (uma página em trânsito, eventos SSE, MQTT),
+//   os pacotes UDP de telemetria e o cliente MQTT (~2,4 KB com o buffer de
+//   saída abaixo);
+// - pool: cada pbuf guarda um quadro recebido (~1,5 KB); 16 cobrem a janela
+//   de recepção de duas conexões com folga.
+#define MEM_SIZE 18000
+#define MEMP_NUM_TCP_SEG 32
+// PCBs: HTTP_MAX_CONNECTIONS do servidor, o cliente MQTT e folga para os que
+// aguardam em TIME_WAIT (sem vaga, o lwIP derrubaria conexões ativas)
+#define MEMP_NUM_TCP_PCB 12
 #define MEMP_NUM_ARP_QUEUE 10
-#define PBUF_POOL_SIZE 48 // Aumentado de 32 para 48
+#define PBUF_POOL_SIZE 16
 #define LWIP_ARP 1
 #define LWIP_ETHERNET 1
 #define LWIP_ICMP 1
 #define LWIP_RAW 1
-#define TCP_WND (16 * TCP_MSS)
+// Requisições e respostas cabem em poucos segmentos; a página principal sai
+// da flash em partes (lib/pico_http_server.c), sem precisar de um buffer grande
+#define TCP_WND (4 * TCP_MSS)
 #define TCP_MSS 1460
-#define TCP_SND_BUF (16 * TCP_MSS)
+#define TCP_SND_BUF (4 * TCP_MSS)
 #define TCP_SND_QUEUELEN ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
 #define LWIP_NETIF_STATUS_CALLBACK 1
 #define LWIP_NETIF_LINK_CALLBACK 1
 #define LWIP_NETIF_HOSTNAME 1
 #define LWIP_NETCONN 0
-#define MEM_STATS 0
+// Ocupação do heap e dos pools, também nas versões de produção
+#define LWIP_STATS 1
+#define MEM_STATS 1
+#define MEMP_STATS 1
 #define SYS_STATS 0
-#define MEMP_STATS 0
 #define LINK_STATS 0
 // #define ETH_PAD_SIZE                2
 #define LWIP_CHKSUM_ALGORITHM 3
@@ -51,10 +64,29 @@
 #define DHCP_DOES_ARP_CHECK 0
 #define LWIP_DHCP_DOES_ACD_CHECK 0
 
+// Temporizadores das aplicações (MQTT e SNTP) além dos internos do lwIP
+#define MEMP_NUM_SYS_TIMEOUT (LWIP_NUM_SYS_TIMEOUT_INTERNAL + 2)
+
+// Buffer de saída do cliente MQTT: um lote inteiro (MQTT_TELEMETRIA_LOTE_MAX,
+// conferido em lib/mqtt_telemetria.c) com tópico e cabeçalho. O padrão de 256
+// bytes recusaria todo lote.
+#define MQTT_OUTPUT_RINGBUF_SIZE 2048
+
+// Hora do dia por SNTP (lib/relogio.c)
+void relogio_definir_hora(unsigned long segundos);
+#define SNTP_SET_SYSTEM_TIME(segundos) relogio_definir_hora(segundos)
+#define SNTP_SERVER_DNS 1
+#define SNTP_UPDATE_DELAY (60 * 60 * 1000) // Ressincroniza a cada hora
+
 #ifndef NDEBUG
 #define LWIP_DEBUG 1
-#define LWIP_STATS 1
 #define LWIP_STATS_DISPLAY 1
+#else
+#define ETHARP_STATS 0
+#define IP_STATS 0
+#define ICMP_STATS 0
+#define UDP_STATS 0
+#define TCP_STATS 0
 #endif
 
 #define ETHARP_DEBUG LWIP_DBG_OFF
@@ -0,0 +1,86 @@
+#include "monitor_sensor.h"
+
+void monitor_sensor_iniciar(MonitorSensor *monitor)
+{
+    monitor->estado = SENSOR_SAUDAVEL;
+    monitor->falhas_seguidas = 0;
+    monitor->backoff_ms = MONITOR_BACKOFF_INICIAL_MS;
+    monitor->proxima_tentativa_ms = 0;
+    monitor->total_falhas = 0;
+    monitor->tentativas_recuperacao = 0;
+    monitor->recuperacoes = 0;
+}
+
+void monitor_sensor_forcar_falha(MonitorSensor *monitor, uint32_t agora_ms)
+{
+    monitor->estado = SENSOR_EM_FALHA;
+    monitor->falhas_seguidas = MONITOR_FALHAS_PARA_FALHA;
+    monitor->proxima_tentativa_ms = agora_ms;
+}
+
+bool monitor_sensor_sucesso(MonitorSensor *monitor)
+{
+    bool estava_em_falha = monitor->estado == SENSOR_EM_FALHA;
+    if (estava_em_falha)
+        monitor->recuperacoes++;
+
+    monitor->estado = SENSOR_SAUDAVEL;
+    monitor->falhas_seguidas = 0;
+    monitor->backoff_ms = MONITOR_BACKOFF_INICIAL_MS;
+    return estava_em_falha;
+}
+
+MonitorAcao monitor_sensor_falha(MonitorSensor *monitor, uint32_t agora_ms)
+{
+    monitor->total_falhas++;
+    monitor->falhas_seguidas++;
+
+    if (monitor->estado != SENSOR_EM_FALHA)
+    {
+        if (monitor->falhas_seguidas < MONITOR_FALHAS_PARA_FALHA)
+        {
+            monitor->estado = SENSOR_INSTAVEL;
+            return MONITOR_ACAO_NENHUMA;
+        }
+        // Acabou de entrar em falha: a primeira tentativa é imediata
+        monitor->estado = SENSOR_EM_FALHA;
+        monitor->proxima_tentativa_ms = agora_ms;
+    }
+
+    // Comparação com sinal para sobreviver ao estouro do contador de ms
+    if ((int32_t)(agora_ms - monitor->proxima_tentativa_ms) < 0)
+        return MONITOR_ACAO_NENHUMA;
+
+    monitor->tentativas_recuperacao++;
+    return MONITOR_ACAO_RECUPERAR;
+}
+
+void monitor_sensor_resultado_recuperacao(MonitorSensor *monitor, bool sucesso, uint32_t agora_ms)
+{
+    if (sucesso)
+    {
+        // O sensor respondeu ao reset; a próxima leitura válida confirma a saída da falha
+        monitor->backoff_ms = MONITOR_BACKOFF_INICIAL_MS;
+        monitor->proxima_tentativa_ms = agora_ms + monitor->backoff_ms;
+        return;
+    }
+
+    monitor->proxima_tentativa_ms = agora_ms + monitor->backoff_ms;
+    monitor->backoff_ms *= 2;
+    if (monitor->backoff_ms > MONITOR_BACKOFF_MAX_MS)
+        monitor->backoff_ms = MONITOR_BACKOFF_MAX_MS;
+}
+
+const char *monitor_sensor_estado_str(SensorEstado estado)
+{
+    switch (estado)
+    {
+    case SENSOR_SAUDAVEL:
+        return "saudavel";
+    case SENSOR_INSTAVEL:
+        return "instavel";
+    case SENSOR_EM_FALHA:
+        return "falha";
+    }
+    return "?";
+}
@@ -0,0 +1,61 @@
+#ifndef MONITOR_SENSOR_H
+#define MONITOR_SENSOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------- Configuração ---------- */
+#define MONITOR_FALHAS_PARA_FALHA 3    // Falhas seguidas até declarar o sensor em falha
+#define MONITOR_BACKOFF_INICIAL_MS 1000
+#define MONITOR_BACKOFF_MAX_MS 64000
+
+/* ---------- Estados de saúde do sensor ---------- */
+typedef enum {
+    SENSOR_SAUDAVEL,  // Última leitura válida
+    SENSOR_INSTAVEL,  // Algumas falhas seguidas: mantém a última saída dos atuadores
+    SENSOR_EM_FALHA   // Atuadores na posição segura e recuperação com backoff
+} SensorEstado;
+
+/* ---------- Ação pedida ao chamador ---------- */
+typedef enum {
+    MONITOR_ACAO_NENHUMA,
+    MONITOR_ACAO_RECUPERAR // Recuperar o barramento e resetar o sensor agora
+} MonitorAcao;
+
+typedef struct {
+    SensorEstado estado;
+    uint32_t falhas_seguidas;
+    uint32_t backoff_ms;
+    uint32_t proxima_tentativa_ms;
+
+    // Estatísticas
+    uint32_t total_falhas;
+    uint32_t tentativas_recuperacao;
+    uint32_t recuperacoes;
+} MonitorSensor;
+
+/* ---------- API ---------- */
+// O monitor não acessa hardware: recebe o resultado de cada leitura e o
+// horário atual, e devolve o que o chamador deve fazer.
+
+// Coloca o monitor no estado saudável e zera as estatísticas.
+void monitor_sensor_iniciar(MonitorSensor *monitor);
+
+// Declara o sensor em falha imediatamente (ex.: não respondeu na inicialização).
+// A primeira tentativa de recuperação ocorre na próxima falha registrada.
+void monitor_sensor_forcar_falha(MonitorSensor *monitor, uint32_t agora_ms);
+
+// Registra uma leitura válida. Retorna true se o sensor estava em falha
+// (o chamador deve descartar o histórico do filtro e do integrador).
+bool monitor_sensor_sucesso(MonitorSensor *monitor);
+
+// Registra uma leitura com erro e informa se é hora de tentar a recuperação.
+MonitorAcao monitor_sensor_falha(MonitorSensor *monitor, uint32_t agora_ms);
+
+// Informa o resultado de uma tentativa de recuperação (dobra o backoff se falhou).
+void monitor_sensor_resultado_recuperacao(MonitorSensor *monitor, bool sucesso, uint32_t agora_ms);
+
+// Nome curto do estado, para a telemetria.
+const char *monitor_sensor_estado_str(SensorEstado estado);
+
+#endif // MONITOR_SENSOR_H
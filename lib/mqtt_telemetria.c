@@ -0,0 +1,372 @@
+#include <stdio.h>
+#include <string.h>
+#include "mqtt_telemetria.h"
+#include "log.h"
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/apps/mqtt.h"
+
+// Espaço reservado no lote para {"id":...,"seq":...,"amostras":[ e ]}
+#define CABECALHO_LOTE 80
+#define CAPACIDADE_REGISTROS (MQTT_TELEMETRIA_LOTE_MAX - CABECALHO_LOTE)
+
+// PUBLISH: cabeçalho fixo (1 + até 2 bytes de tamanho), tamanho do tópico e
+// identificador do pacote
+#define CABECALHO_PUBLISH 7
+_Static_assert(MQTT_TELEMETRIA_LOTE_MAX + MQTT_TELEMETRIA_TOPICO_MAX + CABECALHO_PUBLISH <= MQTT_OUTPUT_RINGBUF_SIZE,
+               "um lote precisa caber no buffer de saída do MQTT (lwipopts.h)");
+
+typedef enum {
+    LOTE_PENDENTE,  // Aguardando envio (ou reenvio)
+    LOTE_ENVIADO,   // Com o lwIP, aguardando o PUBACK (QoS 1)
+    LOTE_CONFIRMADO // Confirmado atrás de um ainda sem PUBACK: sai quando chegar à cabeça
+} LoteEstado;
+
+typedef struct {
+    uint16_t len;
+    uint8_t estado; // LoteEstado
+    uint32_t sequencia;
+    char dados[MQTT_TELEMETRIA_LOTE_MAX];
+} Lote;
+
+static struct {
+    MqttConfig cfg;
+    mqtt_client_t *cliente;
+    ip_addr_t broker;
+    struct mqtt_connect_client_info_t info;
+    char topico_telemetria[MQTT_TELEMETRIA_TOPICO_MAX];
+    char topico_online[MQTT_TELEMETRIA_TOPICO_MAX];
+    char topico_comandos[MQTT_TELEMETRIA_TOPICO_MAX];
+    size_t prefixo_comandos_len; // "<prefixo>/set/", sem o '#'
+
+    // Conexão: as transições para DESCONECTADO vêm do callback do lwIP
+    volatile MqttEstado estado;
+    volatile uint32_t proxima_tentativa_ms;
+    uint32_t backoff_ms;
+
+    // Lote em montagem: registros separados por vírgula
+    char registros[CAPACIDADE_REGISTROS];
+    size_t registros_len;
+    uint32_t lote_inicio_ms;
+    uint32_t sequencia;
+
+    // Fila offline; fila[cabeca] é o mais antigo. O laço principal acrescenta e
+    // publica, o callback do PUBACK (contexto do lwIP) retira: só com o lwIP travado
+    Lote fila[MQTT_TELEMETRIA_FILA_OFFLINE];
+    uint8_t cabeca;
+    uint8_t quantidade;
+
+    // Comando em recepção
+    char comando[MQTT_TELEMETRIA_TOPICO_MAX];
+    char comando_dados[MQTT_TELEMETRIA_COMANDO_MAX + 1];
+    size_t comando_len;
+    bool comando_valido;
+
+    MqttEstatisticas estatisticas;
+} mqtt;
+
+static void agendar_reconexao(uint32_t agora_ms)
+{
+    mqtt.proxima_tentativa_ms = agora_ms + mqtt.backoff_ms;
+    mqtt.backoff_ms *= 2;
+    if (mqtt.backoff_ms > MQTT_TELEMETRIA_BACKOFF_MAX_MS)
+        mqtt.backoff_ms = MQTT_TELEMETRIA_BACKOFF_MAX_MS;
+}
+
+static Lote *lote_na_fila(int i)
+{
+    return &mqtt.fila[(mqtt.cabeca + i) % MQTT_TELEMETRIA_FILA_OFFLINE];
+}
+
+static void retirar_confirmados(void)
+{
+    while (mqtt.quantidade > 0 && mqtt.fila[mqtt.cabeca].estado == LOTE_CONFIRMADO)
+    {
+        mqtt.cabeca = (mqtt.cabeca + 1) % MQTT_TELEMETRIA_FILA_OFFLINE;
+        mqtt.quantidade--;
+    }
+}
+
+// Lotes entregues ao lwIP e ainda sem PUBACK voltam a ser pendentes
+static void reenviar_sem_confirmacao(void)
+{
+    for (int i = 0; i < mqtt.quantidade; i++)
+    {
+        Lote *lote = lote_na_fila(i);
+        if (lote->estado == LOTE_ENVIADO)
+        {
+            lote->estado = LOTE_PENDENTE;
+            mqtt.estatisticas.lotes_reenviados++;
+        }
+    }
+}
+
+// QoS 0: o lote já saiu da fila e err diz se o TCP o enviou. QoS 1: err é
+// ERR_OK com o PUBACK ou ERR_TIMEOUT sem ele; @p arg é a sequência do lote.
+static void publicacao_concluida(void *arg, err_t err)
+{
+    if (mqtt.cfg.qos == 0)
+    {
+        if (err == ERR_OK)
+            mqtt.estatisticas.lotes_confirmados++;
+        return;
+    }
+
+    uint32_t sequencia = (uint32_t)(uintptr_t)arg;
+    for (int i = 0; i < mqtt.quantidade; i++)
+    {
+        Lote *lote = lote_na_fila(i);
+        if (lote->sequencia != sequencia || lote->estado != LOTE_ENVIADO)
+            continue;
+        if (err == ERR_OK)
+        {
+            lote->estado = LOTE_CONFIRMADO;
+            mqtt.estatisticas.lotes_confirmados++;
+        }
+        else
+        {
+            lote->estado = LOTE_PENDENTE;
+            mqtt.estatisticas.lotes_reenviados++;
+        }
+        break;
+    }
+    retirar_confirmados();
+}
+
+static void comando_topico_callback(void *arg, const char *topico, u32_t tot_len)
+{
+    mqtt.estatisticas.comandos_recebidos++;
+    mqtt.comando_len = 0;
+    mqtt.comando_valido = strncmp(topico, mqtt.topico_comandos, mqtt.prefixo_comandos_len) == 0 &&
+                          strlen(topico + mqtt.prefixo_comandos_len) < sizeof(mqtt.comando) &&
+                          tot_len <= MQTT_TELEMETRIA_COMANDO_MAX;
+    if (mqtt.comando_valido)
+        strcpy(mqtt.comando, topico + mqtt.prefixo_comandos_len);
+    else
+        mqtt.estatisticas.comandos_descartados++;
+}
+
+static void comando_dados_callback(void *arg, const u8_t *dados, u16_t len, u8_t flags)
+{
+    if (!mqtt.comando_valido)
+        return;
+    if (len > 0)
+    {
+        memcpy(mqtt.comando_dados + mqtt.comando_len, dados, len);
+        mqtt.comando_len += len;
+    }
+    if (flags & MQTT_DATA_FLAG_LAST)
+    {
+        mqtt.comando_dados[mqtt.comando_len] = '\0';
+        mqtt.comando_valido = false;
+        if (mqtt.cfg.ao_receber_comando)
+            mqtt.cfg.ao_receber_comando(mqtt.comando, mqtt.comando_dados, mqtt.comando_len);
+    }
+}
+
+static void conexao_callback(mqtt_client_t *cliente, void *arg, mqtt_connection_status_t status)
+{
+    if (status == MQTT_CONNECT_ACCEPTED)
+    {
+        mqtt.estado = MQTT_CONECTADO;
+        mqtt.backoff_ms = MQTT_TELEMETRIA_BACKOFF_INICIAL_MS;
+        mqtt.estatisticas.conexoes++;
+        mqtt_subscribe(cliente, mqtt.topico_comandos, 1, NULL, NULL);
+        mqtt_publish(cliente, mqtt.topico_online, "1", 1, 1, 1, NULL, NULL);
+        LOG(LOG_INFO, "MQTT: conectado ao broker %s\n", mqtt.cfg.broker);
+        return;
+    }
+
+    // Recusa, timeout do CONNACK ou queda de uma conexão estabelecida. O lwIP
+    // descarta as publicações em andamento sem chamar os callbacks: as que não
+    // tiveram PUBACK (inclusive as enviadas a um broker já morto, até o
+    // keep-alive perceber) voltam para a fila.
+    if (mqtt.estado == MQTT_CONECTADO)
+        LOG(LOG_AVISO, "MQTT: conexao perdida (%d)\n", (int)status);
+    reenviar_sem_confirmacao();
+    mqtt.estado = MQTT_DESCONECTADO;
+    mqtt.estatisticas.falhas_conexao++;
+    agendar_reconexao(to_ms_since_boot(get_absolute_time()));
+}
+
+static void conectar(uint32_t agora_ms)
+{
+    cyw43_arch_lwip_begin();
+    mqtt.estado = MQTT_CONECTANDO;
+    err_t err = mqtt_client_connect(mqtt.cliente, &mqtt.broker, mqtt.cfg.porta,
+                                    conexao_callback, NULL, &mqtt.info);
+    if (err != ERR_OK)
+    {
+        // Sem callback nesse caso (ex.: sem memória ou sem rota)
+        mqtt.estado = MQTT_DESCONECTADO;
+        mqtt.estatisticas.falhas_conexao++;
+        agendar_reconexao(agora_ms);
+    }
+    cyw43_arch_lwip_end();
+}
+
+// Fecha o lote atual e o coloca na fila; com a fila cheia, perde o mais antigo
+// (mesmo que esteja aguardando o PUBACK)
+static void fechar_lote(void)
+{
+    if (mqtt.registros_len == 0)
+        return;
+
+    cyw43_arch_lwip_begin();
+    if (mqtt.quantidade == MQTT_TELEMETRIA_FILA_OFFLINE)
+    {
+        mqtt.cabeca = (mqtt.cabeca + 1) % MQTT_TELEMETRIA_FILA_OFFLINE;
+        mqtt.quantidade--;
+        mqtt.estatisticas.lotes_descartados++;
+    }
+
+    Lote *lote = lote_na_fila(mqtt.quantidade);
+    lote->sequencia = mqtt.sequencia++;
+    int len = snprintf(lote->dados, sizeof(lote->dados), "{\"id\":\"%s\",\"seq\":%lu,\"amostras\":[%.*s]}",
+                       mqtt.cfg.cliente_id, (unsigned long)lote->sequencia, (int)mqtt.registros_len, mqtt.registros);
+    mqtt.registros_len = 0;
+    if (len < 0 || len >= (int)sizeof(lote->dados))
+    {
+        mqtt.estatisticas.lotes_descartados++;
+    }
+    else
+    {
+        lote->len = (uint16_t)len;
+        lote->estado = LOTE_PENDENTE;
+        mqtt.quantidade++;
+    }
+    cyw43_arch_lwip_end();
+}
+
+// Entrega ao lwIP os lotes pendentes, em ordem, até ele recusar (requisições
+// de QoS 1 em andamento ou buffer de saída cheios). Com QoS 1 o lote fica na
+// fila até o PUBACK; com QoS 0 sai assim que é entregue.
+static void drenar_fila(void)
+{
+    cyw43_arch_lwip_begin();
+    for (int i = 0; i < mqtt.quantidade && mqtt.estado == MQTT_CONECTADO; i++)
+    {
+        Lote *lote = lote_na_fila(i);
+        if (lote->estado != LOTE_PENDENTE)
+            continue;
+        if (mqtt_publish(mqtt.cliente, mqtt.topico_telemetria, lote->dados, lote->len, mqtt.cfg.qos, 0,
+                         publicacao_concluida, (void *)(uintptr_t)lote->sequencia) != ERR_OK)
+            break;
+        lote->estado = mqtt.cfg.qos == 0 ? LOTE_CONFIRMADO : LOTE_ENVIADO;
+        mqtt.estatisticas.lotes_publicados++;
+    }
+    retirar_confirmados();
+    cyw43_arch_lwip_end();
+}
+
+bool mqtt_telemetria_iniciar(const MqttConfig *cfg)
+{
+    mqtt.cfg = *cfg;
+    if (mqtt.cfg.qos > 1)
+        mqtt.cfg.qos = 1;
+
+    if (!ipaddr_aton(cfg->broker, &mqtt.broker))
+    {
+        printf("MQTT: endereco do broker invalido: %s\n", cfg->broker);
+        return false;
+    }
+
+    int n1 = snprintf(mqtt.topico_telemetria, sizeof(mqtt.topico_telemetria), "%s/telemetria", cfg->prefixo);
+    int n2 = snprintf(mqtt.topico_online, sizeof(mqtt.topico_online), "%s/online", cfg->prefixo);
+    int n3 = snprintf(mqtt.topico_comandos, sizeof(mqtt.topico_comandos), "%s/set/#", cfg->prefixo);
+    if (n1 >= (int)sizeof(mqtt.topico_telemetria) || n2 >= (int)sizeof(mqtt.topico_online) ||
+        n3 >= (int)sizeof(mqtt.topico_comandos))
+    {
+        printf("MQTT: prefixo de topico muito longo\n");
+        return false;
+    }
+    mqtt.prefixo_comandos_len = (size_t)n3 - 1;
+
+    mqtt.info = (struct mqtt_connect_client_info_t){
+        .client_id = cfg->cliente_id,
+        .client_user = cfg->usuario,
+        .client_pass = cfg->senha,
+        .keep_alive = MQTT_TELEMETRIA_KEEPALIVE_S,
+        .will_topic = mqtt.topico_online,
+        .will_msg = "0",
+        .will_qos = 1,
+        .will_retain = 1,
+    };
+
+    cyw43_arch_lwip_begin();
+    mqtt.cliente = mqtt_client_new();
+    if (mqtt.cliente)
+        mqtt_set_inpub_callback(mqtt.cliente, comando_topico_callback, comando_dados_callback, NULL);
+    cyw43_arch_lwip_end();
+    if (!mqtt.cliente)
+        return false;
+
+    mqtt.estado = MQTT_DESCONECTADO;
+    mqtt.backoff_ms = MQTT_TELEMETRIA_BACKOFF_INICIAL_MS;
+    mqtt.proxima_tentativa_ms = mqtt.lote_inicio_ms = to_ms_since_boot(get_absolute_time());
+    return true;
+}
+
+bool mqtt_telemetria_adicionar(const char *registro)
+{
+    size_t len = strlen(registro);
+    if (len + 1 > CAPACIDADE_REGISTROS)
+    {
+        mqtt.estatisticas.registros_descartados++;
+        return false;
+    }
+    if (mqtt.registros_len + 1 + len > CAPACIDADE_REGISTROS)
+        fechar_lote();
+
+    if (mqtt.registros_len > 0)
+        mqtt.registros[mqtt.registros_len++] = ',';
+    memcpy(mqtt.registros + mqtt.registros_len, registro, len);
+    mqtt.registros_len += len;
+    return true;
+}
+
+void mqtt_telemetria_processar(uint32_t agora_ms)
+{
+    if (!mqtt.cliente)
+        return;
+
+    if (mqtt.estado == MQTT_DESCONECTADO && (int32_t)(agora_ms - mqtt.proxima_tentativa_ms) >= 0)
+        conectar(agora_ms);
+
+    if (agora_ms - mqtt.lote_inicio_ms >= mqtt.cfg.periodo_ms)
+    {
+        fechar_lote();
+        mqtt.lote_inicio_ms = agora_ms;
+    }
+
+    if (mqtt.estado == MQTT_CONECTADO)
+        drenar_fila();
+}
+
+void mqtt_telemetria_definir_periodo(uint32_t periodo_ms)
+{
+    mqtt.cfg.periodo_ms = periodo_ms;
+}
+
+void mqtt_telemetria_estatisticas(MqttEstatisticas *estatisticas)
+{
+    *estatisticas = mqtt.estatisticas;
+    estatisticas->estado = mqtt.estado;
+    estatisticas->fila_offline = mqtt.quantidade;
+    estatisticas->backoff_ms = mqtt.backoff_ms;
+    estatisticas->periodo_ms = mqtt.cfg.periodo_ms;
+}
+
+const char *mqtt_telemetria_estado_str(MqttEstado estado)
+{
+    switch (estado)
+    {
+    case MQTT_DESCONECTADO:
+        return "desconectado";
+    case MQTT_CONECTANDO:
+        return "conectando";
+    case MQTT_CONECTADO:
+        return "conectado";
+    }
+    return "?";
+}
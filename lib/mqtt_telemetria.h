@@ -0,0 +1,92 @@
+#ifndef MQTT_TELEMETRIA_H
+#define MQTT_TELEMETRIA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ---------- Limites ---------- */
+// Um lote precisa caber no MQTT_OUTPUT_RINGBUF_SIZE do lwipopts.h
+#define MQTT_TELEMETRIA_LOTE_MAX 1024
+#define MQTT_TELEMETRIA_FILA_OFFLINE 8    // Lotes guardados enquanto o broker está fora ou sem PUBACK
+#define MQTT_TELEMETRIA_TOPICO_MAX 96
+#define MQTT_TELEMETRIA_COMANDO_MAX 128   // Payload máximo de um comando recebido
+#define MQTT_TELEMETRIA_BACKOFF_INICIAL_MS 1000
+#define MQTT_TELEMETRIA_BACKOFF_MAX_MS 60000
+#define MQTT_TELEMETRIA_KEEPALIVE_S 30
+
+/* ---------- Estado da conexão ---------- */
+typedef enum {
+    MQTT_DESCONECTADO, // Aguardando a próxima tentativa (backoff)
+    MQTT_CONECTANDO,   // CONNECT enviado, aguardando o CONNACK
+    MQTT_CONECTADO
+} MqttEstado;
+
+// Chamada no contexto do lwIP para cada mensagem em <prefixo>/set/#.
+// @p comando é o tópico sem o "<prefixo>/set/" (ex: "zona/0/setpoint") e
+// @p dados termina em '\0'.
+typedef void (*mqtt_comando_t)(const char *comando, const char *dados, size_t len);
+
+/* ---------- Configuração ---------- */
+// Tópicos (com prefixo "estufa/pico01"):
+//   estufa/pico01/telemetria  lotes publicados a cada periodo_ms
+//   estufa/pico01/online      "1" ao conectar, "0" como last will (retidos)
+//   estufa/pico01/set/...     comandos repassados a ao_receber_comando
+typedef struct {
+    const char *broker;      // Endereço IPv4 do broker (ex: "192.168.0.10")
+    uint16_t porta;          // 1883 por padrão
+    const char *cliente_id;
+    const char *usuario;     // NULL = sem autenticação
+    const char *senha;
+    const char *prefixo;
+    uint32_t periodo_ms;     // Intervalo entre lotes de telemetria
+    uint8_t qos;             // 0 ou 1 para a telemetria (comandos são assinados com QoS 1)
+    mqtt_comando_t ao_receber_comando;
+} MqttConfig;
+
+/* ---------- Métricas ---------- */
+typedef struct {
+    MqttEstado estado;
+    uint32_t conexoes;
+    uint32_t falhas_conexao;      // Tentativas recusadas, expiradas ou quedas
+    uint32_t lotes_publicados;    // Entregues ao lwIP, contando os reenvios
+    uint32_t lotes_confirmados;   // PUBACK recebido (QoS 1) ou enviados (QoS 0)
+    uint32_t lotes_reenviados;    // QoS 1 sem PUBACK (queda ou timeout): voltaram para a fila
+    uint32_t lotes_descartados;   // Mais antigos, perdidos com a fila offline cheia
+    uint32_t registros_descartados; // Maiores que um lote inteiro
+    uint32_t comandos_recebidos;
+    uint32_t comandos_descartados; // Tópico ou payload grande demais
+    uint8_t fila_offline;         // Lotes aguardando envio ou PUBACK agora
+    uint32_t backoff_ms;
+    uint32_t periodo_ms;
+} MqttEstatisticas;
+
+/* ---------- API ---------- */
+// Nenhuma função bloqueia: a conexão é assíncrona e os lotes ficam na fila
+// até o broker aceitá-los (com QoS 1, até o PUBACK; os sem PUBACK quando a
+// conexão cai são reenviados ao reconectar e podem chegar repetidos, com o
+// mesmo "seq"). Todas, exceto as de consulta, devem ser chamadas
+// do laço principal.
+
+// Guarda a configuração (as strings precisam continuar válidas) e cria o
+// cliente. A primeira tentativa de conexão acontece em mqtt_telemetria_processar().
+bool mqtt_telemetria_iniciar(const MqttConfig *cfg);
+
+// Acrescenta um registro JSON (ex: um objeto por zona) ao lote atual. Um lote
+// cheio é fechado e vai para a fila antes do registro entrar no próximo.
+bool mqtt_telemetria_adicionar(const char *registro);
+
+// Passo periódico: reconecta quando o backoff vence, fecha o lote no fim do
+// período e drena a fila enquanto o broker estiver conectado.
+void mqtt_telemetria_processar(uint32_t agora_ms);
+
+// Altera o intervalo entre lotes.
+void mqtt_telemetria_definir_periodo(uint32_t periodo_ms);
+
+// Copia as métricas do cliente.
+void mqtt_telemetria_estatisticas(MqttEstatisticas *estatisticas);
+
+// Nome curto do estado, para a telemetria.
+const char *mqtt_telemetria_estado_str(MqttEstado estado);
+
+#endif // MQTT_TELEMETRIA_H
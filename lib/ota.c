@@ -0,0 +1,307 @@
+#include <stddef.h>
+#include <string.h>
+#include "ota.h"
+
+#define OTA_MAGICO 0x4F544131u // "OTA1"
+#define OTA_RAM_INICIO 0x20000000u
+#define OTA_RAM_FIM 0x20042000u // Inclui os bancos de rascunho X e Y
+
+_Static_assert(OTA_REGISTRO_OFFSET(2) <= OTA_FLASH_TAMANHO - OTA_SETOR, "o registro invade a persistência");
+_Static_assert(OTA_BANCO_TAMANHO % OTA_SETOR == 0, "bancos em setores inteiros");
+_Static_assert(sizeof(OtaRegistro) <= OTA_PAGINA, "o registro deve caber em uma página");
+
+static struct {
+    const OtaFlash *flash;
+    OtaRegistro registro;
+    OtaEstatisticas estatisticas;
+
+    // Download em andamento
+    uint8_t alvo;
+    uint8_t sha256[SHA256_TAMANHO];
+    Sha256 sha;
+    uint8_t pagina[OTA_PAGINA];
+    uint32_t pagina_usada;
+    uint32_t gravado; // Bytes já na flash (múltiplo da página)
+} ota;
+
+static uint32_t crc32(const uint8_t *dados, size_t tamanho)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < tamanho; i++)
+    {
+        crc ^= dados[i];
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1u));
+    }
+    return ~crc;
+}
+
+/* ---------- Registro ---------- */
+
+bool ota_ler_registro(const OtaFlash *flash, OtaRegistro *registro)
+{
+    bool encontrado = false;
+    for (int i = 0; i < 2; i++)
+    {
+        OtaRegistro copia;
+        memcpy(&copia, flash->ler(OTA_REGISTRO_OFFSET(i)), sizeof(copia));
+        if (copia.magico != OTA_MAGICO || crc32((const uint8_t *)&copia, offsetof(OtaRegistro, crc)) != copia.crc)
+            continue;
+        if (!encontrado || copia.sequencia > registro->sequencia)
+            *registro = copia;
+        encontrado = true;
+    }
+    return encontrado;
+}
+
+bool ota_gravar_registro(const OtaFlash *flash, OtaRegistro *registro)
+{
+    static uint8_t pagina[OTA_PAGINA];
+    OtaRegistro atual;
+    registro->magico = OTA_MAGICO;
+    registro->sequencia = ota_ler_registro(flash, &atual) ? atual.sequencia + 1 : 1;
+    registro->crc = crc32((const uint8_t *)registro, offsetof(OtaRegistro, crc));
+
+    // Sequências alternam de setor: a cópia em vigor nunca é apagada
+    uint32_t offset = OTA_REGISTRO_OFFSET(registro->sequencia % 2);
+    memset(pagina, 0xFF, sizeof(pagina));
+    memcpy(pagina, registro, sizeof(*registro));
+    return flash->apagar(offset, OTA_SETOR) && flash->programar(offset, pagina, sizeof(pagina)) &&
+           memcmp(flash->ler(offset), pagina, sizeof(*registro)) == 0;
+}
+
+bool ota_imagem_valida(const uint8_t *imagem, uint8_t banco)
+{
+    uint32_t vetores[2]; // Pilha inicial e reset
+    memcpy(vetores, imagem + OTA_VETORES, sizeof(vetores));
+    uint32_t inicio = OTA_XIP_BASE + OTA_BANCO_OFFSET(banco);
+    return vetores[0] > OTA_RAM_INICIO && vetores[0] <= OTA_RAM_FIM && (vetores[0] & 3) == 0 &&
+           (vetores[1] & 1) && vetores[1] > inicio && vetores[1] < inicio + OTA_BANCO_TAMANHO;
+}
+
+/* ---------- Bootloader ---------- */
+
+static bool resumo_confere(const OtaFlash *flash, const OtaRegistro *registro)
+{
+    Sha256 sha;
+    uint8_t resumo[SHA256_TAMANHO];
+    if (registro->tamanho == 0 || registro->tamanho > OTA_BANCO_TAMANHO)
+        return false;
+    sha256_iniciar(&sha);
+    sha256_atualizar(&sha, flash->ler(OTA_BANCO_OFFSET(registro->banco)), registro->tamanho);
+    sha256_finalizar(&sha, resumo);
+    return memcmp(resumo, registro->sha256, sizeof(resumo)) == 0;
+}
+
+// O banco pedido, ou o outro se o pedido estiver vazio
+static uint8_t banco_executavel(const OtaFlash *flash, uint8_t banco)
+{
+    if (!ota_imagem_valida(flash->ler(OTA_BANCO_OFFSET(banco)), banco) &&
+        ota_imagem_valida(flash->ler(OTA_BANCO_OFFSET(!banco)), !banco))
+        return !banco;
+    return banco;
+}
+
+uint8_t ota_escolher_banco(const OtaFlash *flash)
+{
+    OtaRegistro registro;
+    if (!ota_ler_registro(flash, &registro))
+        return banco_executavel(flash, OTA_BANCO_A);
+
+    if (registro.estado == OTA_TESTE)
+    {
+        bool tentar = registro.tentativas < OTA_TENTATIVAS_MAX &&
+                      ota_imagem_valida(flash->ler(OTA_BANCO_OFFSET(registro.banco)), registro.banco) &&
+                      (registro.tentativas > 0 || resumo_confere(flash, &registro));
+        if (tentar)
+        {
+            registro.tentativas++;
+        }
+        else
+        {
+            registro.banco = registro.banco_anterior;
+            registro.estado = OTA_REVERTIDO;
+        }
+        // Se a gravação falhar, a decisão vale só para este boot
+        ota_gravar_registro(flash, &registro);
+    }
+    return banco_executavel(flash, registro.banco);
+}
+
+/* ---------- Aplicação ---------- */
+
+void ota_iniciar(const OtaFlash *flash, uint32_t offset_execucao)
+{
+    ota.flash = flash;
+    ota.estatisticas.banco = offset_execucao >= OTA_BANCO_OFFSET(OTA_BANCO_B) ? OTA_BANCO_B : OTA_BANCO_A;
+    if (!ota_ler_registro(flash, &ota.registro))
+    {
+        // Gravada pela USB, sem registro: o banco atual vale como confirmado
+        memset(&ota.registro, 0, sizeof(ota.registro));
+        ota.registro.banco = ota.registro.banco_anterior = ota.estatisticas.banco;
+        ota.registro.estado = OTA_CONFIRMADO;
+    }
+    ota.estatisticas.estado = (OtaEstado)ota.registro.estado;
+    ota.estatisticas.em_teste = ota.registro.estado == OTA_TESTE && ota.registro.banco == ota.estatisticas.banco;
+}
+
+static OtaResultado falhar(OtaResultado resultado)
+{
+    ota.estatisticas.baixando = false;
+    ota.estatisticas.falhas++;
+    ota.estatisticas.ultimo_erro = resultado;
+    return resultado;
+}
+
+OtaResultado ota_download_iniciar(uint32_t tamanho, const uint8_t sha256[SHA256_TAMANHO])
+{
+    if (ota.estatisticas.baixando)
+        return OTA_ERRO_OCUPADO; // Não conta como falha do download em andamento
+    if (ota.estatisticas.em_teste)
+        return falhar(OTA_ERRO_EM_TESTE); // O outro banco é a volta desta imagem
+    if (tamanho == 0 || tamanho > OTA_BANCO_TAMANHO)
+        return falhar(OTA_ERRO_TAMANHO);
+
+    ota.alvo = !ota.estatisticas.banco;
+    memcpy(ota.sha256, sha256, SHA256_TAMANHO);
+    sha256_iniciar(&ota.sha);
+    ota.pagina_usada = 0;
+    ota.gravado = 0;
+    ota.estatisticas.baixando = true;
+    ota.estatisticas.recebido = 0;
+    ota.estatisticas.tamanho = tamanho;
+    return OTA_OK;
+}
+
+static bool gravar_pagina(void)
+{
+    uint32_t offset = OTA_BANCO_OFFSET(ota.alvo) + ota.gravado;
+    if (offset % OTA_SETOR == 0 && !ota.flash->apagar(offset, OTA_SETOR))
+        return false;
+    if (!ota.flash->programar(offset, ota.pagina, OTA_PAGINA))
+        return false;
+    ota.gravado += OTA_PAGINA;
+    ota.pagina_usada = 0;
+    return true;
+}
+
+OtaResultado ota_download_escrever(const uint8_t *dados, size_t tamanho)
+{
+    if (!ota.estatisticas.baixando)
+        return OTA_ERRO_INCOMPLETO;
+    if (tamanho > ota.estatisticas.tamanho - ota.estatisticas.recebido)
+        return falhar(OTA_ERRO_TAMANHO);
+
+    sha256_atualizar(&ota.sha, dados, tamanho);
+    ota.estatisticas.recebido += tamanho;
+    while (tamanho > 0)
+    {
+        size_t n = OTA_PAGINA - ota.pagina_usada;
+        if (n > tamanho)
+            n = tamanho;
+        memcpy(ota.pagina + ota.pagina_usada, dados, n);
+        ota.pagina_usada += n;
+        dados += n;
+        tamanho -= n;
+        if (ota.pagina_usada == OTA_PAGINA && !gravar_pagina())
+            return falhar(OTA_ERRO_FLASH);
+    }
+    return OTA_OK;
+}
+
+OtaResultado ota_download_concluir(void)
+{
+    if (!ota.estatisticas.baixando || ota.estatisticas.recebido != ota.estatisticas.tamanho)
+        return falhar(OTA_ERRO_INCOMPLETO);
+    if (ota.pagina_usada > 0)
+    {
+        memset(ota.pagina + ota.pagina_usada, 0xFF, OTA_PAGINA - ota.pagina_usada);
+        if (!gravar_pagina())
+            return falhar(OTA_ERRO_FLASH);
+    }
+
+    uint8_t resumo[SHA256_TAMANHO];
+    sha256_finalizar(&ota.sha, resumo);
+    if (memcmp(resumo, ota.sha256, sizeof(resumo)) != 0)
+        return falhar(OTA_ERRO_HASH);
+    if (!ota_imagem_valida(ota.flash->ler(OTA_BANCO_OFFSET(ota.alvo)), ota.alvo))
+        return falhar(OTA_ERRO_IMAGEM);
+
+    OtaRegistro registro = {
+        .banco = ota.alvo,
+        .banco_anterior = ota.estatisticas.banco,
+        .estado = OTA_TESTE,
+        .tamanho = ota.estatisticas.tamanho,
+    };
+    memcpy(registro.sha256, resumo, sizeof(resumo));
+    if (!ota_gravar_registro(ota.flash, &registro))
+        return falhar(OTA_ERRO_FLASH);
+    ota.registro = registro;
+    ota.estatisticas.estado = OTA_TESTE;
+    ota.estatisticas.baixando = false;
+    ota.estatisticas.downloads++;
+    return OTA_OK;
+}
+
+void ota_download_abortar(void)
+{
+    if (ota.estatisticas.baixando)
+        falhar(OTA_ERRO_INCOMPLETO);
+}
+
+bool ota_confirmar(void)
+{
+    if (!ota.estatisticas.em_teste)
+        return true;
+    OtaRegistro registro = ota.registro;
+    registro.estado = OTA_CONFIRMADO;
+    if (!ota_gravar_registro(ota.flash, &registro))
+        return false;
+    ota.registro = registro;
+    ota.estatisticas.estado = OTA_CONFIRMADO;
+    ota.estatisticas.em_teste = false;
+    return true;
+}
+
+void ota_estatisticas(OtaEstatisticas *estatisticas)
+{
+    *estatisticas = ota.estatisticas;
+}
+
+const char *ota_estado_str(OtaEstado estado)
+{
+    switch (estado)
+    {
+    case OTA_CONFIRMADO:
+        return "confirmado";
+    case OTA_TESTE:
+        return "teste";
+    case OTA_REVERTIDO:
+        return "revertido";
+    }
+    return "?";
+}
+
+const char *ota_resultado_str(OtaResultado resultado)
+{
+    switch (resultado)
+    {
+    case OTA_OK:
+        return "ok";
+    case OTA_ERRO_OCUPADO:
+        return "download em andamento";
+    case OTA_ERRO_EM_TESTE:
+        return "imagem atual ainda em teste";
+    case OTA_ERRO_TAMANHO:
+        return "tamanho invalido";
+    case OTA_ERRO_FLASH:
+        return "falha na flash";
+    case OTA_ERRO_INCOMPLETO:
+        return "imagem incompleta";
+    case OTA_ERRO_HASH:
+        return "sha256 nao confere";
+    case OTA_ERRO_IMAGEM:
+        return "imagem invalida para o banco";
+    }
+    return "?";
+}
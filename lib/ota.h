@@ -0,0 +1,127 @@
+#ifndef OTA_H
+#define OTA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sha256.h"
+
+/* ---------- Mapa da flash (2 MB do Pico W) ---------- */
+// | bootloader 32K | banco A | banco B | registro 0 | registro 1 | livre | persistência |
+// O programa roda direto da flash, então cada banco tem o próprio link (ver
+// CMakeLists.txt, que repete estes valores). O bootloader escolhe o banco a
+// cada reset; a imagem nova é gravada no banco que não está rodando.
+#define OTA_FLASH_TAMANHO (2u * 1024 * 1024)
+#define OTA_SETOR 4096u  // Apagamento (FLASH_SECTOR_SIZE)
+#define OTA_PAGINA 256u  // Gravação (FLASH_PAGE_SIZE)
+#define OTA_BOOTLOADER_TAMANHO 0x8000u
+#define OTA_BANCO_TAMANHO 0xFA000u // 1000 KB
+#define OTA_BANCO_OFFSET(banco) (OTA_BOOTLOADER_TAMANHO + (uint32_t)(banco) * OTA_BANCO_TAMANHO)
+#define OTA_REGISTRO_OFFSET(i) (OTA_BANCO_OFFSET(2) + (uint32_t)(i) * OTA_SETOR)
+#define OTA_XIP_BASE 0x10000000u
+#define OTA_VETORES 0x100u // Tabela de vetores da imagem, depois do boot2
+
+/* ---------- Confirmação ---------- */
+#define OTA_TENTATIVAS_MAX 1 // Boots de uma imagem nova sem confirmação antes de voltar
+#define OTA_SAUDE_MS 30000   // Controle saudável por esse tempo confirma a imagem
+#define OTA_PRAZO_MS 120000  // Sem confirmar até aqui, reinicia e volta ao banco anterior
+
+enum { OTA_BANCO_A, OTA_BANCO_B };
+
+/* ---------- Acesso à flash ---------- */
+// Toda escrita passa por aqui, com offsets a partir do início da flash. Na
+// placa é lib/ota_flash.c; no host, um vetor na RAM com a semântica da NOR
+// (gravar só zera bits) basta para exercitar o download, o registro e a
+// escolha de banco.
+typedef struct {
+    bool (*apagar)(uint32_t offset, uint32_t tamanho);                        // Setores inteiros
+    bool (*programar)(uint32_t offset, const uint8_t *dados, uint32_t tamanho); // Páginas inteiras
+    const uint8_t *(*ler)(uint32_t offset);                                   // Conteúdo mapeado
+} OtaFlash;
+
+/* ---------- Registro de boot ---------- */
+// Duas cópias em setores alternados: vale a de maior sequência com CRC certo,
+// então uma gravação interrompida deixa a anterior em vigor.
+typedef enum {
+    OTA_CONFIRMADO, // Banco em uso normal
+    OTA_TESTE,      // Imagem nova aguardando a confirmação
+    OTA_REVERTIDO   // A imagem nova não confirmou; o bootloader voltou ao banco anterior
+} OtaEstado;
+
+typedef struct {
+    uint32_t magico;
+    uint32_t sequencia;
+    uint8_t banco;
+    uint8_t banco_anterior;
+    uint8_t estado;     // OtaEstado
+    uint8_t tentativas; // Boots em teste
+    uint32_t tamanho;   // Imagem gravada no banco
+    uint8_t sha256[SHA256_TAMANHO];
+    uint32_t crc;       // Dos campos anteriores
+} OtaRegistro;
+
+bool ota_ler_registro(const OtaFlash *flash, OtaRegistro *registro);
+
+// Grava com a sequência seguinte, na cópia mais antiga.
+bool ota_gravar_registro(const OtaFlash *flash, OtaRegistro *registro);
+
+// Tabela de vetores coerente com uma imagem linkada para @p banco.
+bool ota_imagem_valida(const uint8_t *imagem, uint8_t banco);
+
+/* ---------- Bootloader ---------- */
+// Decide o banco a executar: conta a tentativa de uma imagem em teste (a
+// primeira confere o SHA-256 gravado), volta ao banco anterior quando as
+// tentativas acabam e cai no outro banco se o escolhido não tiver imagem.
+uint8_t ota_escolher_banco(const OtaFlash *flash);
+
+/* ---------- Aplicação ---------- */
+// O download grava a flash a partir do callback do upload HTTP (contexto do
+// lwIP) e a confirmação, a partir do laço principal. As duas formas valem: a
+// OtaFlash da placa faz cada operação com as interrupções desligadas, então
+// uma não interrompe a outra nem a gravação da persistência. Também não
+// disputam o estado do módulo: com a imagem em teste, o download é recusado.
+typedef enum {
+    OTA_OK,
+    OTA_ERRO_OCUPADO,  // Outro download em andamento
+    OTA_ERRO_EM_TESTE, // A imagem atual não foi confirmada: o outro banco é a volta
+    OTA_ERRO_TAMANHO,  // Vazio ou maior que o banco
+    OTA_ERRO_FLASH,
+    OTA_ERRO_INCOMPLETO,
+    OTA_ERRO_HASH,
+    OTA_ERRO_IMAGEM    // Tabela de vetores inválida ou linkada para o outro banco
+} OtaResultado;
+
+typedef struct {
+    uint8_t banco;       // Em execução
+    OtaEstado estado;    // Do registro
+    bool em_teste;       // Esta imagem ainda não foi confirmada
+    bool baixando;
+    uint32_t recebido;
+    uint32_t tamanho;
+    uint32_t downloads;  // Concluídos com sucesso
+    uint32_t falhas;
+    OtaResultado ultimo_erro;
+} OtaEstatisticas;
+
+// Lê o registro e descobre o banco pelo endereço em que o programa foi linkado.
+void ota_iniciar(const OtaFlash *flash, uint32_t offset_execucao);
+
+// Download para o banco inativo, em blocos de qualquer tamanho: cada página
+// é gravada assim que completa, com o setor apagado na primeira página dele,
+// e o resumo é calculado no caminho. Só um download por vez.
+OtaResultado ota_download_iniciar(uint32_t tamanho, const uint8_t sha256[SHA256_TAMANHO]);
+OtaResultado ota_download_escrever(const uint8_t *dados, size_t tamanho);
+
+// Confere tamanho, resumo e tabela de vetores e marca o banco novo para teste
+// no próximo boot.
+OtaResultado ota_download_concluir(void);
+void ota_download_abortar(void);
+
+// Marca a imagem em teste como boa (grava o registro na flash).
+bool ota_confirmar(void);
+
+void ota_estatisticas(OtaEstatisticas *estatisticas);
+const char *ota_estado_str(OtaEstado estado);
+const char *ota_resultado_str(OtaResultado resultado);
+
+#endif // OTA_H
@@ -0,0 +1,41 @@
+#include "ota_flash.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+
+_Static_assert(OTA_SETOR == FLASH_SECTOR_SIZE && OTA_PAGINA == FLASH_PAGE_SIZE, "geometria da flash");
+_Static_assert(OTA_FLASH_TAMANHO == PICO_FLASH_SIZE_BYTES, "mapa do OTA feito para outra flash");
+
+typedef struct {
+    uint32_t offset;
+    const uint8_t *dados; // NULL para apagar
+    uint32_t tamanho;
+} OperacaoFlash;
+
+// Roda com as interrupções desligadas (e o outro núcleo parado, se estiver em uso)
+static void executar(void *contexto)
+{
+    const OperacaoFlash *operacao = contexto;
+    if (operacao->dados)
+        flash_range_program(operacao->offset, operacao->dados, operacao->tamanho);
+    else
+        flash_range_erase(operacao->offset, operacao->tamanho);
+}
+
+static bool apagar(uint32_t offset, uint32_t tamanho)
+{
+    OperacaoFlash operacao = {offset, NULL, tamanho};
+    return flash_safe_execute(executar, &operacao, UINT32_MAX) == PICO_OK;
+}
+
+static bool programar(uint32_t offset, const uint8_t *dados, uint32_t tamanho)
+{
+    OperacaoFlash operacao = {offset, dados, tamanho};
+    return flash_safe_execute(executar, &operacao, UINT32_MAX) == PICO_OK;
+}
+
+static const uint8_t *ler(uint32_t offset)
+{
+    return (const uint8_t *)(XIP_BASE + offset);
+}
+
+const OtaFlash OTA_FLASH_PICO = {apagar, programar, ler};
@@ -0,0 +1,11 @@
+#ifndef OTA_FLASH_H
+#define OTA_FLASH_H
+
+#include "ota.h"
+
+// Flash do RP2040 para o OTA: apaga e grava por flash_safe_execute() (as
+// interrupções ficam desligadas durante cada operação, que não pode tocar o
+// banco em execução) e lê pelo XIP.
+extern const OtaFlash OTA_FLASH_PICO;
+
+#endif // OTA_FLASH_H
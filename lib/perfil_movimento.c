@@ -0,0 +1,80 @@
+#include <math.h>
+#include "perfil_movimento.h"
+
+static void parar_em(PerfilMovimento *perfil, float posicao)
+{
+    perfil->posicao = posicao;
+    perfil->velocidade = 0.0f;
+    perfil->parado = true;
+}
+
+void perfil_posicionar(PerfilMovimento *perfil, float posicao)
+{
+    perfil->alvo = posicao;
+    parar_em(perfil, posicao);
+}
+
+void perfil_definir_alvo(PerfilMovimento *perfil, float alvo)
+{
+    if (perfil->parado && fabsf(alvo - perfil->alvo) < perfil->banda_morta)
+    {
+        if (alvo != perfil->alvo)
+            perfil->alvos_ignorados++;
+        return;
+    }
+    perfil->alvo = alvo;
+}
+
+float perfil_avancar(PerfilMovimento *perfil, float dt)
+{
+    float alvo = perfil->alvo; // Lido uma vez: o laço pode trocá-lo a qualquer momento
+    float distancia = alvo - perfil->posicao;
+
+    if (distancia == 0.0f && perfil->velocidade == 0.0f)
+    {
+        perfil->parado = true;
+        return perfil->posicao;
+    }
+    if (!(perfil->velocidade_max > 0.0f))
+    {
+        parar_em(perfil, alvo);
+        return alvo;
+    }
+
+    float velocidade;
+    if (perfil->aceleracao_max > 0.0f)
+    {
+        // Maior velocidade que ainda permite frear até o alvo: v² = 2·a·d
+        float desejada = sqrtf(2.0f * perfil->aceleracao_max * fabsf(distancia));
+        if (desejada > perfil->velocidade_max)
+            desejada = perfil->velocidade_max;
+        desejada = copysignf(desejada, distancia);
+
+        float variacao = perfil->aceleracao_max * dt;
+        velocidade = perfil->velocidade;
+        if (desejada > velocidade + variacao)
+            velocidade += variacao;
+        else if (desejada < velocidade - variacao)
+            velocidade -= variacao;
+        else
+            velocidade = desejada;
+    }
+    else
+    {
+        velocidade = copysignf(perfil->velocidade_max, distancia);
+    }
+
+    float passo = velocidade * dt;
+    // Chegou (ou passaria do alvo) neste passo
+    if ((distancia > 0.0f && passo >= distancia) || (distancia < 0.0f && passo <= distancia) ||
+        (distancia == 0.0f && fabsf(velocidade) <= perfil->aceleracao_max * dt))
+    {
+        parar_em(perfil, alvo);
+        return alvo;
+    }
+
+    perfil->posicao = perfil->posicao + passo;
+    perfil->velocidade = velocidade;
+    perfil->parado = false;
+    return perfil->posicao;
+}
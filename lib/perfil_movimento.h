@@ -0,0 +1,42 @@
+#ifndef PERFIL_MOVIMENTO_H
+#define PERFIL_MOVIMENTO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------- Perfil de movimento de um atuador ---------- */
+// O laço de controle só define o alvo (posição comandada); a saída real anda
+// até ele em passos fixos, dados por perfil_avancar() na interrupção dos
+// atuadores. Com aceleração limitada o perfil é trapezoidal (acelera, anda na
+// velocidade máxima e freia a tempo de parar no alvo); sem ela é uma rampa
+// (taxa de variação limitada). As unidades são as do atuador (graus, %).
+typedef struct {
+    // Configuração
+    float velocidade_max; // Unidades/s (0 = sem limite: a saída salta para o alvo)
+    float aceleracao_max; // Unidades/s² (0 = sem limite: rampa de velocidade constante)
+    float banda_morta;    // Com a saída parada, alvos mais próximos que isso são ignorados
+
+    // Estado (a saída é escrita só pela interrupção)
+    volatile float alvo;
+    volatile float posicao;
+    volatile float velocidade;
+    volatile bool parado;
+
+    // Estatísticas
+    uint32_t alvos_ignorados; // Mudanças descartadas pela banda morta
+} PerfilMovimento;
+
+/* ---------- API ---------- */
+
+// Coloca a saída parada em @p posicao, sem movimento.
+void perfil_posicionar(PerfilMovimento *perfil, float posicao);
+
+// Define um novo alvo. Parada, a saída só se move se o alvo mudar ao menos a
+// banda morta, o que evita que o ruído do controle faça o atuador tremular.
+void perfil_definir_alvo(PerfilMovimento *perfil, float alvo);
+
+// Avança a saída @p dt segundos em direção ao alvo e retorna a nova posição.
+// Não passa do alvo: ao alcançá-lo para com velocidade zero.
+float perfil_avancar(PerfilMovimento *perfil, float dt);
+
+#endif // PERFIL_MOVIMENTO_H
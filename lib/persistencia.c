@@ -0,0 +1,81 @@
+#include <string.h>
+#include "persistencia.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+
+#define PERSISTENCIA_MAGICO 0x43464750u // "PGFC"
+#define PERSISTENCIA_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+
+typedef struct {
+    uint32_t magico;
+    uint16_t versao;
+    uint16_t tamanho;
+    uint32_t crc;
+} PersistenciaCabecalho;
+
+_Static_assert(sizeof(PersistenciaCabecalho) == PERSISTENCIA_BLOCO - PERSISTENCIA_DADOS_MAX, "cabeçalho fora do tamanho");
+_Static_assert(PERSISTENCIA_BLOCO % FLASH_PAGE_SIZE == 0, "o bloco deve ocupar páginas inteiras");
+
+static uint8_t bloco[PERSISTENCIA_BLOCO] __attribute__((aligned(4)));
+static uint32_t gravacoes;
+
+static uint32_t crc32(const uint8_t *dados, size_t tamanho)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < tamanho; i++)
+    {
+        crc ^= dados[i];
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1u));
+    }
+    return ~crc;
+}
+
+bool persistencia_ler(uint16_t versao, void *dados, size_t tamanho)
+{
+    const uint8_t *flash = (const uint8_t *)(XIP_BASE + PERSISTENCIA_OFFSET);
+    PersistenciaCabecalho cabecalho;
+    memcpy(&cabecalho, flash, sizeof(cabecalho));
+
+    if (cabecalho.magico != PERSISTENCIA_MAGICO || cabecalho.versao != versao || cabecalho.tamanho != tamanho)
+        return false;
+    if (crc32(flash + sizeof(cabecalho), tamanho) != cabecalho.crc)
+        return false;
+    memcpy(dados, flash + sizeof(cabecalho), tamanho);
+    return true;
+}
+
+// Roda com as interrupções desligadas (e o outro núcleo parado, se estiver em uso)
+static void gravar_setor(void *contexto)
+{
+    (void)contexto;
+    flash_range_erase(PERSISTENCIA_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(PERSISTENCIA_OFFSET, bloco, PERSISTENCIA_BLOCO);
+}
+
+bool persistencia_gravar(uint16_t versao, const void *dados, size_t tamanho)
+{
+    if (tamanho > PERSISTENCIA_DADOS_MAX)
+        return false;
+
+    PersistenciaCabecalho cabecalho = {
+        .magico = PERSISTENCIA_MAGICO,
+        .versao = versao,
+        .tamanho = (uint16_t)tamanho,
+        .crc = crc32(dados, tamanho),
+    };
+    memset(bloco, 0xFF, sizeof(bloco));
+    memcpy(bloco, &cabecalho, sizeof(cabecalho));
+    memcpy(bloco + sizeof(cabecalho), dados, tamanho);
+
+    if (flash_safe_execute(gravar_setor, NULL, UINT32_MAX) != PICO_OK)
+        return false;
+    gravacoes++;
+    // Confere o que ficou na flash
+    return memcmp((const void *)(XIP_BASE + PERSISTENCIA_OFFSET), bloco, sizeof(cabecalho) + tamanho) == 0;
+}
+
+uint32_t persistencia_gravacoes(void)
+{
+    return gravacoes;
+}
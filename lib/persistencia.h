@@ -0,0 +1,29 @@
+#ifndef PERSISTENCIA_H
+#define PERSISTENCIA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ---------- Bloco de configuração na flash ---------- */
+// Um único bloco, no último setor da flash (longe do programa), com cabeçalho
+// de versão, tamanho e CRC-32. Um bloco ausente, de outra versão ou com CRC
+// errado (gravação interrompida) é ignorado e a placa usa os padrões.
+#define PERSISTENCIA_BLOCO 1024 // Bytes gravados, com o cabeçalho (múltiplo da página de 256)
+#define PERSISTENCIA_DADOS_MAX (PERSISTENCIA_BLOCO - 12)
+
+/* ---------- API ---------- */
+
+// Copia o bloco gravado para @p dados se a versão e o tamanho coincidirem e o
+// CRC conferir.
+bool persistencia_ler(uint16_t versao, void *dados, size_t tamanho);
+
+// Apaga o setor e grava o bloco. Leva dezenas de ms com as interrupções
+// desligadas (o programa roda da flash), então só deve ser chamada no laço
+// principal. Retorna false se os dados não couberem ou a gravação falhar.
+bool persistencia_gravar(uint16_t versao, const void *dados, size_t tamanho);
+
+// Gravações desde o boot, para a telemetria.
+uint32_t persistencia_gravacoes(void);
+
+#endif // PERSISTENCIA_H
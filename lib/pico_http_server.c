@@ -1,157 +1,661 @@
 #include "pico_http_server.h"
+#include "http_parser.h"
+#include <math.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include "pico/stdio.h"
+#include "lwip/sys.h"
 
 // --- Variáveis internas da biblioteca ---
-#define MAX_HANDLERS 10
+#define MAX_HANDLERS 16
+#define HTTP_POLL_INTERVAL 2 // Em ciclos do temporizador lento do TCP (500 ms)
 static http_request_handler_t handlers[MAX_HANDLERS];
 static int handler_count = 0;
+static http_upload_handler_t upload_handler;
 static const char *homepage_content = NULL;
+static size_t homepage_len = 0;
 static http_content_type_t response_content_type = HTTP_CONTENT_TYPE_HTML;
+static int response_status = 200;
+static const http_parser_t *current_request = NULL; // Válido apenas durante o handler
+static const char *access_token = NULL;
+static http_server_stats_t stats;
 
 // Estrutura para gerenciar o estado da conexão
 struct http_state
 {
-    char response[16384]; // Tamanho do buffer de resposta
-    size_t len;
+    http_parser_t parser; // Estado incremental da requisição em andamento
+    bool responded;
+    bool streaming;       // Assinante do fluxo de eventos: não fecha após a resposta
+    bool uploading;       // Corpo sendo entregue à rota de upload
+    bool rate_limited;    // IP sem ficha no balde: responde 429 sem analisar
+    uint32_t upload_remaining;
+    ip_addr_t remote_ip;  // Copiado: no erro o pcb já não existe
+    uint32_t progress_ms; // Último avanço: aceite, trecho do upload ou ACK da resposta
+    char response[HTTP_RESPONSE_MAX]; // Cabeçalho e corpo gerado pelo handler
+    size_t len;           // Total da resposta, incluindo o corpo estático
     size_t sent;
+    const char *body;     // Corpo estático (página principal), enviado da flash em partes
+    size_t body_len;
+    size_t body_queued;
 };
 
+// --- Limitador por IP ---
+// Balde de fichas em milésimos: cada conexão gasta 1000 e o tempo repõe
+// HTTP_RATE_PER_SEC por milissegundo, até HTTP_RATE_BURST fichas.
+#define RATE_TOKEN 1000u
+struct rate_client
+{
+    ip_addr_t ip;
+    uint32_t tokens;
+    uint32_t last_ms;
+    bool used;
+};
+static struct rate_client rate_clients[HTTP_RATE_CLIENTS];
+
+// Conexões abertas, para o limite por IP
+static struct http_state *open_states[HTTP_MAX_CONNECTIONS];
+
+static int connections_from(const ip_addr_t *ip)
+{
+    int count = 0;
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++)
+    {
+        if (open_states[i] && ip_addr_cmp(&open_states[i]->remote_ip, ip))
+            count++;
+    }
+    return count;
+}
+
+static bool rate_allow(const ip_addr_t *ip)
+{
+    const uint32_t capacity = HTTP_RATE_BURST * RATE_TOKEN;
+    uint32_t now = sys_now();
+    struct rate_client *client = NULL, *free_slot = NULL, *oldest = NULL;
+    for (int i = 0; i < HTTP_RATE_CLIENTS && !client; i++)
+    {
+        struct rate_client *c = &rate_clients[i];
+        if (!c->used)
+        {
+            if (!free_slot)
+                free_slot = c;
+        }
+        else if (ip_addr_cmp(&c->ip, ip))
+        {
+            client = c;
+        }
+        else if (!oldest || now - c->last_ms > now - oldest->last_ms)
+        {
+            oldest = c;
+        }
+    }
+    if (!client)
+    {
+        // IP novo: vaga livre ou a do menos recente, com o balde cheio
+        client = free_slot ? free_slot : oldest;
+        ip_addr_copy(client->ip, *ip);
+        client->tokens = capacity;
+        client->last_ms = now;
+        client->used = true;
+    }
+
+    uint32_t elapsed = now - client->last_ms;
+    client->last_ms = now;
+    if (elapsed >= capacity / HTTP_RATE_PER_SEC || capacity - client->tokens <= elapsed * HTTP_RATE_PER_SEC)
+        client->tokens = capacity;
+    else
+        client->tokens += elapsed * HTTP_RATE_PER_SEC;
+    if (client->tokens < RATE_TOKEN)
+        return false;
+    client->tokens -= RATE_TOKEN;
+    return true;
+}
+
+// Comparação em tempo constante: o tempo da resposta não revela o token
+static bool authorized(const http_parser_t *req)
+{
+    static const char prefix[] = "Bearer ";
+    if (!access_token || req->method != HTTP_METHOD_POST)
+        return true;
+    size_t prefix_len = sizeof(prefix) - 1;
+    size_t expected_len = prefix_len + strlen(access_token);
+    uint8_t diff = req->authorization_len != expected_len;
+    for (size_t i = 0; i < expected_len; i++)
+    {
+        char expected = i < prefix_len ? prefix[i] : access_token[i - prefix_len];
+        char got = i < req->authorization_len ? req->authorization[i] : 0;
+        diff |= (uint8_t)(expected ^ got);
+    }
+    return diff == 0;
+}
+
+// --- Server-Sent Events ---
+struct sse_client
+{
+    struct tcp_pcb *pcb;
+    struct http_state *hs;
+    uint32_t dropped;
+};
+static const char *event_stream_path = NULL;
+static struct sse_client sse_clients[HTTP_SSE_MAX_CLIENTS];
+static char sse_buffer[HTTP_SSE_EVENT_MAX]; // Evento serializado uma vez para todos
+static uint32_t sse_event_id = 0;
+static uint32_t sse_dropped = 0;
+
+static void sse_remove(struct http_state *hs)
+{
+    for (int i = 0; i < HTTP_SSE_MAX_CLIENTS; i++)
+    {
+        if (sse_clients[i].hs == hs)
+        {
+            sse_clients[i].pcb = NULL;
+            sse_clients[i].hs = NULL;
+        }
+    }
+}
+
+static bool sse_add(struct tcp_pcb *pcb, struct http_state *hs)
+{
+    for (int i = 0; i < HTTP_SSE_MAX_CLIENTS; i++)
+    {
+        if (!sse_clients[i].pcb)
+        {
+            sse_clients[i] = (struct sse_client){pcb, hs, 0};
+            return true;
+        }
+    }
+    return false;
+}
+
+// Conexão perdida no meio do corpo: a rota desfaz o que recebeu
+static void upload_abort(struct http_state *hs)
+{
+    if (hs && hs->uploading)
+    {
+        hs->uploading = false;
+        upload_handler.end(false);
+    }
+}
+
+// Libera o estado da conexão (o pcb fica por conta de quem chama)
+static void http_free(struct http_state *hs)
+{
+    if (!hs)
+    {
+        return;
+    }
+    if (hs->streaming)
+    {
+        sse_remove(hs);
+    }
+    upload_abort(hs);
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++)
+    {
+        if (open_states[i] == hs)
+            open_states[i] = NULL;
+    }
+    stats.connections--;
+    free(hs);
+}
+
+static void http_detach(struct tcp_pcb *tpcb)
+{
+    tcp_arg(tpcb, NULL);
+    tcp_recv(tpcb, NULL);
+    tcp_sent(tpcb, NULL);
+    tcp_err(tpcb, NULL);
+    tcp_poll(tpcb, NULL, 0);
+}
+
+// Libera o estado da conexão e fecha o pcb
+static void http_close(struct tcp_pcb *tpcb, struct http_state *hs)
+{
+    http_detach(tpcb);
+    http_free(hs);
+    tcp_close(tpcb);
+}
+
+// Enfileira o que couber do corpo estático; o restante segue a cada ACK. O
+// dado fica na flash, então o lwIP não precisa de uma cópia da página inteira.
+static void http_write_body(struct tcp_pcb *tpcb, struct http_state *hs)
+{
+    while (hs->body_queued < hs->body_len)
+    {
+        size_t chunk = hs->body_len - hs->body_queued;
+        size_t space = tcp_sndbuf(tpcb);
+        if (space == 0 || tcp_sndqueuelen(tpcb) >= TCP_SND_QUEUELEN)
+        {
+            break;
+        }
+        if (chunk > space)
+        {
+            chunk = space;
+        }
+        u8_t flags = hs->body_queued + chunk < hs->body_len ? TCP_WRITE_FLAG_MORE : 0;
+        if (tcp_write(tpcb, hs->body + hs->body_queued, chunk, flags) != ERR_OK)
+        {
+            break; // Sem memória agora: tenta de novo no próximo ACK
+        }
+        hs->body_queued += chunk;
+    }
+    tcp_output(tpcb);
+}
+
 // Callback para enviar dados após a escrita
 static err_t http_sent_callback(void *arg, struct tcp_pcb *tpcb, u16_t len)
 {
     struct http_state *hs = (struct http_state *)arg;
+    if (hs->streaming)
+    {
+        return ERR_OK; // A conexão continua aberta para os próximos eventos
+    }
     hs->sent += len;
+    hs->progress_ms = sys_now();
     if (hs->sent >= hs->len)
     {
-        tcp_close(tpcb);
-        free(hs);
+        http_close(tpcb, hs);
+    }
+    else if (hs->body_queued < hs->body_len)
+    {
+        http_write_body(tpcb, hs);
     }
     return ERR_OK;
 }
 
+// Callback de erro: o pcb já foi liberado pelo lwIP, resta liberar o estado
+static void http_err_callback(void *arg, err_t err)
+{
+    http_free((struct http_state *)arg);
+}
+
+// Chamado pelo lwIP a cada segundo. Cabeçalhos pingados não contam como
+// avanço: a requisição inteira precisa chegar no prazo (slowloris). Os
+// assinantes de eventos ficam ociosos por natureza e não expiram.
+static err_t http_poll_callback(void *arg, struct tcp_pcb *tpcb)
+{
+    struct http_state *hs = (struct http_state *)arg;
+    if (!hs || hs->streaming || sys_now() - hs->progress_ms < HTTP_IDLE_TIMEOUT_MS)
+    {
+        return ERR_OK;
+    }
+    stats.idle_timeouts++;
+    http_detach(tpcb);
+    http_free(hs);
+    tcp_abort(tpcb);
+    return ERR_ABRT;
+}
+
+// Texto padrão de cada código de status usado pelo servidor
+static const char *status_reason(int code)
+{
+    switch (code)
+    {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 409: return "Conflict";
+    case 413: return "Payload Too Large";
+    case 414: return "URI Too Long";
+    case 422: return "Unprocessable Entity";
+    case 429: return "Too Many Requests";
+    case 431: return "Request Header Fields Too Large";
+    case 503: return "Service Unavailable";
+    default: return "Internal Server Error";
+    }
+}
+
+// Resposta de erro a partir do motivo informado pelo parser
+static void handle_parse_error(struct http_state *hs)
+{
+    const char *status;
+    switch (hs->parser.error)
+    {
+    case HTTP_PARSER_ERR_METHOD:
+        status = "405 Method Not Allowed";
+        break;
+    case HTTP_PARSER_ERR_URI_TOO_LONG:
+        status = "414 URI Too Long";
+        break;
+    case HTTP_PARSER_ERR_HEADERS_TOO_LARGE:
+        status = "431 Request Header Fields Too Large";
+        break;
+    case HTTP_PARSER_ERR_BODY_TOO_LARGE:
+        status = "413 Payload Too Large";
+        break;
+    case HTTP_PARSER_ERR_BAD_REQUEST:
+    default:
+        status = "400 Bad Request";
+        break;
+    }
+    hs->len = snprintf(hs->response, sizeof(hs->response),
+                       "HTTP/1.1 %s\r\nContent-Length: 0\r\nConnection: close\r\n\r\n", status);
+}
+
+static void handle_unauthorized(struct http_state *hs)
+{
+    stats.rejected_auth++;
+    hs->len = snprintf(hs->response, sizeof(hs->response),
+                       "HTTP/1.1 401 Unauthorized\r\nWWW-Authenticate: Bearer\r\n"
+                       "Content-Length: 0\r\nConnection: close\r\n\r\n");
+}
+
+// Resposta com o conteúdo gerado por um handler, no tipo e status que ele definiu
+static void build_response(struct http_state *hs, const char *content)
+{
+    const char *content_type_str;
+    switch (response_content_type)
+    {
+    case HTTP_CONTENT_TYPE_JSON:
+        content_type_str = "application/json";
+        break;
+    case HTTP_CONTENT_TYPE_PLAIN:
+        content_type_str = "text/plain";
+        break;
+    case HTTP_CONTENT_TYPE_HTML:
+    default:
+        content_type_str = "text/html";
+        break;
+    }
+    hs->len = snprintf(hs->response, sizeof(hs->response),
+                       "HTTP/1.1 %d %s\r\n"
+                       "Content-Type: %s\r\n"
+                       "Content-Length: %d\r\n"
+                       "Connection: close\r\n\r\n%s",
+                       response_status, status_reason(response_status),
+                       content_type_str, (int)strlen(content), content);
+}
+
+// --- Upload em fluxo ---
+static void upload_end(struct http_state *hs, bool complete)
+{
+    hs->uploading = false;
+    response_status = 200;
+    current_request = &hs->parser;
+    const char *content = upload_handler.end(complete);
+    current_request = NULL;
+    build_response(hs, content);
+}
+
+// A rota aceita o corpo ou já responde, só com os cabeçalhos
+static void upload_begin(struct http_state *hs)
+{
+    response_status = 200;
+    current_request = &hs->parser;
+    const char *content = upload_handler.begin(hs->parser.target, hs->parser.content_length);
+    current_request = NULL;
+    if (content)
+    {
+        build_response(hs, content);
+        return;
+    }
+    hs->uploading = true;
+    hs->upload_remaining = hs->parser.content_length;
+    hs->progress_ms = sys_now();
+}
+
+static void upload_data(struct http_state *hs, const uint8_t *data, size_t len)
+{
+    if (len > hs->upload_remaining)
+    {
+        len = hs->upload_remaining; // Além do Content-Length: descartado
+    }
+    hs->upload_remaining -= len;
+    hs->progress_ms = sys_now();
+    bool ok = upload_handler.data(data, len);
+    if (!ok || hs->upload_remaining == 0)
+    {
+        upload_end(hs, ok);
+    }
+}
+
+// Corpo maior que o parser: só a rota de upload o recebe
+static void handle_body_stream(struct http_state *hs)
+{
+    if (upload_handler.path && http_parser_path_equals(&hs->parser, upload_handler.path))
+    {
+        if (authorized(&hs->parser))
+            upload_begin(hs);
+        else
+            handle_unauthorized(hs);
+        return;
+    }
+    hs->parser.error = HTTP_PARSER_ERR_BODY_TOO_LARGE;
+    handle_parse_error(hs);
+}
+
 // Roteador de requisições
-static void handle_request(struct http_state *hs, const char *req_line)
+static void handle_request(struct tcp_pcb *tpcb, struct http_state *hs)
 {
-    char *path_end = strchr(req_line, ' ');
-    if (path_end == NULL)
+    const http_parser_t *req = &hs->parser;
+
+    if (event_stream_path && http_parser_path_equals(req, event_stream_path))
     {
-        hs->len = snprintf(hs->response, sizeof(hs->response), "HTTP/1.1 400 Bad Request\r\n\r\n");
+        if (!sse_add(tpcb, hs))
+        {
+            hs->len = snprintf(hs->response, sizeof(hs->response),
+                               "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+            return;
+        }
+        hs->streaming = true;
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: text/event-stream\r\n"
+                           "Cache-Control: no-cache\r\n"
+                           "Connection: keep-alive\r\n\r\n"
+                           "retry: %d\n\n",
+                           HTTP_SSE_RETRY_MS);
         return;
     }
-    size_t path_len = path_end - req_line;
-    char path[path_len + 1];
-    strncpy(path, req_line, path_len);
-    path[path_len] = '\0';
 
-    if ((strcmp(path, "/") == 0) && homepage_content)
+    if (http_parser_path_equals(req, "/") && homepage_content)
     {
         hs->len = snprintf(hs->response, sizeof(hs->response),
                            "HTTP/1.1 200 OK\r\n"
                            "Content-Type: text/html\r\n"
                            "Content-Length: %d\r\n"
-                           "Connection: close\r\n\r\n%s",
-                           (int)strlen(homepage_content), homepage_content);
+                           "Connection: close\r\n\r\n",
+                           (int)homepage_len);
+        hs->body = homepage_content;
+        hs->body_len = homepage_len;
+        return;
+    }
+
+    if (!authorized(req))
+    {
+        handle_unauthorized(hs);
+        return;
+    }
 
+    // Rota de upload com corpo pequeno (ou sem corpo): mesmo caminho do fluxo
+    if (upload_handler.path && http_parser_path_equals(req, upload_handler.path))
+    {
+        upload_begin(hs);
+        if (hs->uploading)
+        {
+            upload_data(hs, (const uint8_t *)req->body, req->body_len);
+        }
         return;
     }
 
     // Procura por um handler registrado
     for (int i = 0; i < handler_count; i++)
     {
-        if (strstr(path, handlers[i].path) && handlers[i].handler)
+        if (http_parser_path_equals(req, handlers[i].path) && handlers[i].handler)
         {
-            const char *content = handlers[i].handler(req_line);
-            const char *content_type_str;
-            switch (response_content_type)
-            {
-            case HTTP_CONTENT_TYPE_JSON:
-                content_type_str = "application/json";
-                break;
-            case HTTP_CONTENT_TYPE_PLAIN:
-                content_type_str = "text/plain";
-                break;
-            case HTTP_CONTENT_TYPE_HTML:
-            default:
-                content_type_str = "text/html";
-                break;
-            }
-            hs->len = snprintf(hs->response, sizeof(hs->response),
-                               "HTTP/1.1 200 OK\r\n"
-                               "Content-Type: %s\r\n"
-                               "Content-Length: %d\r\n"
-                               "Connection: close\r\n\r\n%s",
-                               content_type_str, (int)strlen(content), content);
+            response_status = 200;
+            current_request = req;
+            const char *content = handlers[i].handler(req->target);
+            current_request = NULL;
+            build_response(hs, content);
             return;
         }
     }
 
     // Chegará até aqui se nenhum handler for encontrado
-    hs->len = snprintf(hs->response, sizeof(hs->response), "HTTP/1.1 404 Not Found\r\n\r\n");
+    hs->len = snprintf(hs->response, sizeof(hs->response),
+                       "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
 }
 
 // Callback principal de recepção de dados
 static err_t http_recv_callback(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
 {
+    struct http_state *hs = (struct http_state *)arg;
+
     if (!p)
     {
-        tcp_close(tpcb);
+        http_close(tpcb, hs);
         return ERR_OK;
     }
+    tcp_recved(tpcb, p->tot_len);
 
-    struct http_state *hs = (struct http_state *)malloc(sizeof(struct http_state));
-    hs->sent = 0;
+    // Já respondeu: descarta qualquer dado extra enquanto a resposta é enviada
+    if (hs->responded || err != ERR_OK)
+    {
+        pbuf_free(p);
+        return ERR_OK;
+    }
 
-    char *req = (char *)p->payload;
-    if (strstr(req, "GET ") == req)
+    // Percorre a cadeia de pbufs respeitando o tamanho de cada segmento. No
+    // upload, o corpo vai para a rota direto do pbuf, sem cópia.
+    bool ready = false;
+    if (hs->rate_limited)
     {
-        req += 4; // Avança o ponteiro após "GET "
-        handle_request(hs, req);
+        hs->len = snprintf(hs->response, sizeof(hs->response),
+                           "HTTP/1.1 429 Too Many Requests\r\nRetry-After: 1\r\n"
+                           "Content-Length: 0\r\nConnection: close\r\n\r\n");
+        ready = true;
     }
-    else
+    for (struct pbuf *q = p; q && !ready; q = q->next)
     {
-        hs->len = snprintf(hs->response, sizeof(hs->response), "HTTP/1.1 405 Method Not Allowed\r\n\r\n");
+        const uint8_t *data = (const uint8_t *)q->payload;
+        size_t used = 0;
+        if (!hs->uploading)
+        {
+            http_parse_result_t result = http_parser_feed(&hs->parser, (const char *)data, q->len, &used);
+            if (result == HTTP_PARSE_DONE)
+            {
+                handle_request(tpcb, hs);
+                ready = true;
+            }
+            else if (result == HTTP_PARSE_ERROR)
+            {
+                handle_parse_error(hs);
+                ready = true;
+            }
+            else if (result == HTTP_PARSE_BODY)
+            {
+                handle_body_stream(hs);
+                ready = !hs->uploading;
+            }
+        }
+        if (hs->uploading && used < q->len)
+        {
+            upload_data(hs, data + used, q->len - used);
+            ready = !hs->uploading;
+        }
     }
+    pbuf_free(p);
 
-    tcp_arg(tpcb, hs);
+    if (!ready)
+    {
+        return ERR_OK; // Aguarda o restante da requisição ou do corpo
+    }
+    hs->responded = true;
+
+    if (hs->len >= sizeof(hs->response))
+    {
+        hs->len = sizeof(hs->response) - 1; // snprintf truncou a resposta
+    }
+    size_t header_len = hs->len;
+    hs->len += hs->body_len;
     tcp_sent(tpcb, http_sent_callback);
-    tcp_write(tpcb, hs->response, hs->len, TCP_WRITE_FLAG_COPY);
-    tcp_output(tpcb);
-    pbuf_free(p);
+    tcp_write(tpcb, hs->response, header_len, TCP_WRITE_FLAG_COPY);
+    http_write_body(tpcb, hs);
     return ERR_OK;
 }
 
 // Callback de nova conexão
 static err_t connection_callback(void *arg, struct tcp_pcb *newpcb, err_t err)
 {
+    // Cada conexão custa o estado abaixo no heap: acima do limite, RST sem alocar
+    if (stats.connections >= HTTP_MAX_CONNECTIONS)
+    {
+        stats.rejected_connections++;
+        tcp_abort(newpcb);
+        return ERR_ABRT;
+    }
+    // O balde de taxa não basta: a rajada dele passa do limite global
+    if (connections_from(&newpcb->remote_ip) >= HTTP_MAX_PER_IP)
+    {
+        stats.rejected_per_ip++;
+        tcp_abort(newpcb);
+        return ERR_ABRT;
+    }
+    struct http_state *hs = (struct http_state *)malloc(sizeof(struct http_state));
+    if (!hs)
+    {
+        tcp_abort(newpcb);
+        return ERR_ABRT;
+    }
+    if (++stats.connections > stats.connections_max)
+    {
+        stats.connections_max = stats.connections;
+    }
+    http_parser_init(&hs->parser);
+    hs->responded = false;
+    hs->streaming = false;
+    hs->uploading = false;
+    hs->upload_remaining = 0;
+    hs->rate_limited = !rate_allow(&newpcb->remote_ip);
+    if (hs->rate_limited)
+    {
+        stats.rejected_rate++;
+    }
+    hs->len = 0;
+    hs->sent = 0;
+    hs->body = NULL;
+    hs->body_len = 0;
+    hs->body_queued = 0;
+    ip_addr_copy(hs->remote_ip, newpcb->remote_ip);
+    hs->progress_ms = sys_now();
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++)
+    {
+        if (!open_states[i])
+        {
+            open_states[i] = hs;
+            break;
+        }
+    }
+
+    tcp_arg(newpcb, hs);
+    tcp_err(newpcb, http_err_callback);
     tcp_recv(newpcb, http_recv_callback);
+    tcp_poll(newpcb, http_poll_callback, HTTP_POLL_INTERVAL);
     return ERR_OK;
 }
 
-// Função de inicialização
-int http_server_init(const char *ssid, const char *password)
+// Função de inicialização. A escuta em IP_ADDR_ANY vale para o endereço que o
+// DHCP atribuir depois, então não precisa esperar o Wi-Fi.
+int http_server_init(void)
 {
-    if (cyw43_arch_init())
-    {
-        printf("Falha ao inicializar o Wi-Fi.\n");
-        return -1;
-    }
-
-    cyw43_arch_enable_sta_mode();
-    printf("Conectando a %s...\n", ssid);
-    if (cyw43_arch_wifi_connect_timeout_ms(ssid, password, CYW43_AUTH_WPA2_AES_PSK, 15000))
+    cyw43_arch_lwip_begin();
+    struct tcp_pcb *pcb = tcp_new();
+    struct tcp_pcb *escuta = NULL;
+    if (pcb && tcp_bind(pcb, IP_ADDR_ANY, 80) == ERR_OK)
+        escuta = tcp_listen(pcb);
+    if (escuta)
+        tcp_accept(escuta, connection_callback);
+    else if (pcb)
+        tcp_close(pcb);
+    cyw43_arch_lwip_end();
+    if (!escuta)
     {
-        printf("Falha na conexão Wi-Fi.\n");
+        printf("Falha ao abrir a porta 80.\n");
         return -1;
     }
-    printf("Conectado! IP: %s\n", ip4addr_ntoa(netif_ip4_addr(netif_default)));
-
-    struct tcp_pcb *pcb = tcp_new();
-    tcp_bind(pcb, IP_ADDR_ANY, 80);
-    pcb = tcp_listen(pcb);
-    tcp_accept(pcb, connection_callback);
 
     printf("Servidor HTTP iniciado na porta 80.\n");
     return 0;
@@ -161,6 +665,17 @@ int http_server_init(const char *ssid, const char *password)
 void http_server_set_homepage(const char *html_content)
 {
     homepage_content = html_content;
+    homepage_len = html_content ? strlen(html_content) : 0;
+}
+
+void http_server_set_token(const char *token)
+{
+    access_token = token;
+}
+
+void http_server_get_stats(http_server_stats_t *out)
+{
+    *out = stats;
 }
 
 void http_server_register_handler(http_request_handler_t handler)
@@ -171,18 +686,123 @@ void http_server_register_handler(http_request_handler_t handler)
     }
 }
 
+void http_server_register_upload(http_upload_handler_t handler)
+{
+    upload_handler = handler;
+}
+
+void http_server_register_event_stream(const char *path)
+{
+    event_stream_path = path;
+}
+
+int http_server_publish_event(const char *event, const char *data)
+{
+    int len = snprintf(sse_buffer, sizeof(sse_buffer), "id: %lu\nevent: %s\ndata: %s\n\n",
+                       (unsigned long)++sse_event_id, event, data);
+    if (len < 0 || len >= (int)sizeof(sse_buffer))
+    {
+        return 0; // Não cabe: melhor não enviar um evento truncado
+    }
+
+    int delivered = 0;
+    cyw43_arch_lwip_begin();
+    for (int i = 0; i < HTTP_SSE_MAX_CLIENTS; i++)
+    {
+        struct sse_client *client = &sse_clients[i];
+        if (!client->pcb)
+        {
+            continue;
+        }
+        // Cliente lento: descarta este evento em vez de acumular amostras velhas
+        if (tcp_sndbuf(client->pcb) < len ||
+            tcp_write(client->pcb, sse_buffer, len, TCP_WRITE_FLAG_COPY) != ERR_OK)
+        {
+            client->dropped++;
+            sse_dropped++;
+            continue;
+        }
+        tcp_output(client->pcb);
+        delivered++;
+    }
+    cyw43_arch_lwip_end();
+    return delivered;
+}
+
+int http_server_event_subscribers(void)
+{
+    int count = 0;
+    for (int i = 0; i < HTTP_SSE_MAX_CLIENTS; i++)
+    {
+        if (sse_clients[i].pcb)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+uint32_t http_server_events_dropped(void)
+{
+    return sse_dropped;
+}
+
 void http_server_set_content_type(http_content_type_t type)
 {
     response_content_type = type;
 }
 
-void http_server_parse_float_param(const char *req, const char *param, float *value)
+void http_server_set_status(int status_code)
+{
+    response_status = status_code;
+}
+
+http_method_t http_server_request_method(void)
+{
+    return current_request ? current_request->method : HTTP_METHOD_UNKNOWN;
+}
+
+const char *http_server_request_body(void)
 {
-    char *found = strstr(req, param);
-    if (found)
+    return current_request ? current_request->body : "";
+}
+
+http_param_result_t http_server_parse_params(const char *req, const http_param_spec_t *specs, size_t count)
+{
+    // Corpo de um POST: JSON se começar com '{', senão formulário urlencoded
+    if (current_request && current_request->body_len > 0)
     {
-        *value = atof(found + strlen(param));
+        const char *body = current_request->body;
+        size_t len = current_request->body_len;
+        size_t i = 0;
+        while (i < len && (body[i] == ' ' || body[i] == '\t' || body[i] == '\r' || body[i] == '\n'))
+            i++;
+        if (i < len && body[i] == '{')
+            return http_params_parse_json(body, len, specs, count);
+        return http_params_parse_query(body, len, specs, count);
     }
+
+    const char *query = strchr(req, '?');
+    query = query ? query + 1 : "";
+    return http_params_parse_query(query, strlen(query), specs, count);
+}
+
+bool http_server_parse_float_param(const char *req, const char *param, float *value)
+{
+    // Aceita o nome com ou sem o '=' final, como nas versões anteriores
+    char name[HTTP_PARAMS_MAX_VALUE];
+    size_t len = strlen(param);
+    if (len > 0 && param[len - 1] == '=')
+        len--;
+    if (len >= sizeof(name))
+        return false;
+    memcpy(name, param, len);
+    name[len] = '\0';
+
+    http_param_spec_t spec = {name, HTTP_PARAM_FLOAT, true, -INFINITY, INFINITY, NULL, value, NULL};
+    const char *query = strchr(req, '?');
+    query = query ? query + 1 : "";
+    return http_params_parse_query(query, strlen(query), &spec, 1).status == HTTP_PARAM_OK;
 }
 
 char *http_server_read_html_file(const char *filename)
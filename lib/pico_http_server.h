@@ -3,6 +3,25 @@
 
 #include "lwip/tcp.h"
 #include "pico/cyw43_arch.h"
+#include "http_parser.h"
+#include "http_params.h"
+
+// Resposta montada por conexão: a maior resposta dos handlers (1 KB) mais o
+// cabeçalho. A página principal não passa por aqui: sai direto da flash.
+#define HTTP_RESPONSE_MAX 1280
+
+// --- Controle de acesso ---
+#define HTTP_MAX_CONNECTIONS 8  // Conexões simultâneas, incluindo os assinantes SSE; acima disso, RST
+#define HTTP_MAX_PER_IP 4       // Conexões simultâneas de um mesmo IP (o navegador abre até 6)
+#define HTTP_IDLE_TIMEOUT_MS 5000 // Sem avanço nesse prazo (requisição, corpo ou ACK da resposta), RST
+#define HTTP_RATE_CLIENTS 8     // IPs acompanhados pelo limitador; um IP novo ocupa a vaga do menos recente
+#define HTTP_RATE_BURST 10      // Requisições seguidas aceitas de um mesmo IP
+#define HTTP_RATE_PER_SEC 4     // Reposição do balde de cada IP (requisições por segundo)
+
+// --- Server-Sent Events ---
+#define HTTP_SSE_MAX_CLIENTS 4   // Assinantes simultâneos do fluxo de eventos
+#define HTTP_SSE_EVENT_MAX 512   // Tamanho máximo de um evento serializado
+#define HTTP_SSE_RETRY_MS 2000   // Intervalo de reconexão sugerido ao navegador
 
 // Enumeração para o tipo de conteúdo da resposta HTTP
 typedef enum
@@ -12,32 +31,79 @@ typedef enum
     HTTP_CONTENT_TYPE_PLAIN
 } http_content_type_t;
 
-// Estrutura para representar um manipulador de requisição
+// Contadores do controle de acesso
+typedef struct
+{
+    uint16_t connections;          // Abertas agora
+    uint16_t connections_max;      // Pico desde o boot
+    uint32_t rejected_connections; // Acima de HTTP_MAX_CONNECTIONS
+    uint32_t rejected_per_ip;      // Acima de HTTP_MAX_PER_IP
+    uint32_t idle_timeouts;        // Fechadas por HTTP_IDLE_TIMEOUT_MS
+    uint32_t rejected_rate;        // 429: balde do IP vazio
+    uint32_t rejected_auth;        // 401: POST sem o token
+} http_server_stats_t;
+
+// Estrutura para representar um manipulador de requisição.
+// O caminho é comparado de forma exata (sem a query string) e o handler
+// recebe o alvo da requisição já validado (ex: "/set_temperatura?temperatura=25").
 typedef struct
 {
     const char *path;
     const char *(*handler)(const char *);
 } http_request_handler_t;
 
+// Rota que recebe o corpo em fluxo, sem o limite de HTTP_PARSER_MAX_BODY
+// (ex: imagem de firmware). Roda no contexto do lwIP, como os handlers:
+// - begin: chamada com os cabeçalhos completos; retorna NULL para receber o
+//   corpo, ou a resposta imediata (status por http_server_set_status()), que
+//   serve tanto para recusar quanto para atender um GET;
+// - data: cada trecho do corpo, em ordem; false aborta o recebimento;
+// - end: monta a resposta; complete é false se o corpo não chegou inteiro ou
+//   data() abortou. Com a conexão caída, a resposta é descartada.
+typedef struct
+{
+    const char *path;
+    const char *(*begin)(const char *target, uint32_t content_length);
+    bool (*data)(const uint8_t *data, size_t len);
+    const char *(*end)(bool complete);
+} http_upload_handler_t;
+
 // --- Funções da Biblioteca ---
 
 /**
- * @brief Inicia o Wi-Fi e o servidor HTTP no Pico W.
+ * @brief Inicia o servidor HTTP na porta 80.
  *
- * Esta função configura o Wi-Fi e inicia o servidor na porta 80.
+ * Exige o lwIP já iniciado (wifi_iniciar()), mas não a conexão: o servidor
+ * passa a atender assim que o DHCP fornecer um endereço.
  *
- * @param ssid O nome da rede Wi-Fi.
- * @param password A senha da rede Wi-Fi.
  * @return Retorna 0 em caso de sucesso, -1 em caso de falha.
  */
-int http_server_init(const char *ssid, const char *password);
+int http_server_init(void);
+
+/**
+ * @brief Exige "Authorization: Bearer <token>" em toda requisição POST.
+ *
+ * As rotas alteram o sistema só por POST; sem o token a resposta é 401 e o
+ * handler nem é chamado. GET continua livre para consultas.
+ *
+ * @param token O token esperado; precisa continuar válido. NULL desliga a exigência.
+ */
+void http_server_set_token(const char *token);
+
+/**
+ * @brief Copia os contadores de conexões e de requisições recusadas.
+ */
+void http_server_get_stats(http_server_stats_t *stats);
 
 /**
  * @brief Define o conteúdo HTML da página principal.
  *
- * Esta função define a página que será servida na URL raiz ("/").
+ * Esta função define a página que será servida na URL raiz ("/"). A página é
+ * enviada em partes a partir do próprio ponteiro, sem montar a resposta
+ * inteira na RAM.
  *
- * @param html_content A string contendo o HTML.
+ * @param html_content A string contendo o HTML; precisa continuar válida
+ *                     (normalmente uma constante na flash).
  */
 void http_server_set_homepage(const char *html_content);
 
@@ -51,6 +117,47 @@ void http_server_set_homepage(const char *html_content);
  */
 void http_server_register_handler(http_request_handler_t handler);
 
+/**
+ * @brief Cadastra a rota de upload (uma só), fora da tabela de handlers.
+ *
+ * @param handler A estrutura http_upload_handler_t com o caminho e os callbacks.
+ */
+void http_server_register_upload(http_upload_handler_t handler);
+
+/**
+ * @brief Registra um caminho como fluxo Server-Sent Events (text/event-stream).
+ *
+ * Conexões nesse caminho ficam abertas e recebem os eventos publicados com
+ * http_server_publish_event(). Acima de HTTP_SSE_MAX_CLIENTS assinantes a
+ * resposta é 503.
+ *
+ * @param path O caminho do fluxo (ex: "/events").
+ */
+void http_server_register_event_stream(const char *path);
+
+/**
+ * @brief Publica um evento para todos os assinantes do fluxo.
+ *
+ * O evento é serializado uma única vez e copiado para cada conexão. Um
+ * assinante sem espaço no buffer de envio (tcp_sndbuf) perde este evento,
+ * em vez de acumular amostras velhas. Pode ser chamada fora do contexto do lwIP.
+ *
+ * @param event O nome do evento (campo "event:").
+ * @param data Os dados do evento, em uma única linha (campo "data:").
+ * @return Quantos assinantes receberam o evento.
+ */
+int http_server_publish_event(const char *event, const char *data);
+
+/**
+ * @brief Retorna o número de assinantes conectados ao fluxo de eventos.
+ */
+int http_server_event_subscribers(void);
+
+/**
+ * @brief Retorna o total de eventos descartados por assinantes lentos.
+ */
+uint32_t http_server_events_dropped(void);
+
 /**
  * @brief Define o cabeçalho "Content-Type" para a resposta.
  *
@@ -60,6 +167,44 @@ void http_server_register_handler(http_request_handler_t handler);
  */
 void http_server_set_content_type(http_content_type_t type);
 
+/**
+ * @brief Define o código de status HTTP da resposta (padrão: 200).
+ *
+ * Use esta função dentro de seus manipuladores, assim como
+ * http_server_set_content_type(). O valor volta a 200 a cada requisição.
+ *
+ * @param status_code O código de status (ex: 400, 405, 422).
+ */
+void http_server_set_status(int status_code);
+
+/**
+ * @brief Retorna o método da requisição sendo tratada (GET ou POST).
+ *
+ * Válida apenas dentro de um manipulador.
+ */
+http_method_t http_server_request_method(void);
+
+/**
+ * @brief Retorna o corpo da requisição sendo tratada ("" se não houver).
+ *
+ * Válida apenas dentro de um manipulador.
+ */
+const char *http_server_request_body(void);
+
+/**
+ * @brief Extrai e valida os parâmetros da requisição em uma única passada.
+ *
+ * Em um POST com corpo, lê um objeto JSON plano (ou um formulário urlencoded);
+ * caso contrário lê a query string de @p req. Nenhum destino é alterado se
+ * qualquer parâmetro for inválido ou se faltar um obrigatório.
+ *
+ * @param req O alvo da requisição recebido pelo handler.
+ * @param specs Os parâmetros esperados, com tipo, faixa e destino.
+ * @param count Quantidade de parâmetros em @p specs.
+ * @return O status da extração e o nome do parâmetro com problema, se houver.
+ */
+http_param_result_t http_server_parse_params(const char *req, const http_param_spec_t *specs, size_t count);
+
 /**
  * @brief Extrai um valor float de um parâmetro em uma string de requisição HTTP GET.
  *
@@ -67,11 +212,13 @@ void http_server_set_content_type(http_content_type_t type);
  * o valor associado para um float, armazenando-o no ponteiro fornecido. Útil para
  * processar dados de formulários ou APIs REST simples.
  *
- * @param req A string da requisição HTTP completa (ex: "GET /settings?temp_offset=2.5...").
- * @param param O nome do parâmetro a ser buscado, incluindo o sinal de igual (ex: "temp_offset=").
+ * @param req O alvo da requisição recebido pelo handler (ex: "/settings?temp_offset=2.5").
+ * @param param O nome do parâmetro a ser buscado, com ou sem o sinal de igual (ex: "temp_offset=").
  * @param value Um ponteiro para a variável float onde o valor será armazenado.
+ * @return true se o parâmetro existir e for um número válido; caso contrário
+ * @p value não é alterado.
  */
-void http_server_parse_float_param(const char *req, const char *param, float *value);
+bool http_server_parse_float_param(const char *req, const char *param, float *value);
 
 /**
  * @brief Lê o conteúdo de um arquivo HTML e o armazena em uma string.
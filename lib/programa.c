@@ -0,0 +1,151 @@
+#include <math.h>
+#include <string.h>
+#include "programa.h"
+
+#define MINUTOS_POR_DIA 1440
+
+bool programa_valido(const Programa *programa)
+{
+    if (programa->quantidade > PROGRAMA_SEGMENTOS_MAX || !memchr(programa->nome, '\0', sizeof(programa->nome)))
+        return false;
+    if (programa->zona < 0 || programa->inicio_min < PROGRAMA_SEM_HORARIO || programa->inicio_min >= MINUTOS_POR_DIA)
+        return false;
+    if (!(programa->tolerancia >= 0.0f) || isinf(programa->tolerancia))
+        return false;
+    for (int i = 0; i < programa->quantidade; i++)
+    {
+        const ProgramaSegmento *s = &programa->segmentos[i];
+        if (!isfinite(s->alvo) || !(s->taxa >= 0.0f) || isinf(s->taxa))
+            return false;
+    }
+    return true;
+}
+
+bool programa_definir_segmento(Programa *programa, int indice, float alvo, float taxa, uint16_t patamar_min)
+{
+    if (indice < 0 || indice > programa->quantidade || indice >= PROGRAMA_SEGMENTOS_MAX)
+        return false;
+    programa->segmentos[indice] = (ProgramaSegmento){alvo, taxa, patamar_min};
+    if (indice == programa->quantidade)
+        programa->quantidade++;
+    return true;
+}
+
+// Duração da rampa até o alvo do segmento, partindo de @p setpoint
+static float duracao_rampa_s(const ProgramaSegmento *s, float setpoint)
+{
+    return s->taxa > 0.0f ? fabsf(s->alvo - setpoint) * 60.0f / s->taxa : 0.0f;
+}
+
+float programa_duracao_s(const Programa *programa, float setpoint_inicial)
+{
+    float total = 0.0f, setpoint = setpoint_inicial;
+    for (int i = 0; i < programa->quantidade; i++)
+    {
+        const ProgramaSegmento *s = &programa->segmentos[i];
+        total += duracao_rampa_s(s, setpoint) + s->patamar_min * 60.0f;
+        setpoint = s->alvo;
+    }
+    return total;
+}
+
+static void iniciar_ciclo(ProgramaExecucao *execucao, float setpoint_inicial)
+{
+    execucao->segmento = 0;
+    execucao->fase = PROGRAMA_RAMPA;
+    execucao->setpoint = setpoint_inicial;
+    execucao->patamar_s = 0.0f;
+    execucao->duracao_s = programa_duracao_s(execucao->programa, setpoint_inicial);
+}
+
+void programa_iniciar(ProgramaExecucao *execucao, const Programa *programa, float setpoint_inicial)
+{
+    execucao->programa = programa;
+    execucao->espera_s = 0.0f;
+    execucao->ciclos = 0;
+    if (programa->quantidade == 0)
+    {
+        programa_parar(execucao);
+        return;
+    }
+    iniciar_ciclo(execucao, setpoint_inicial);
+}
+
+void programa_parar(ProgramaExecucao *execucao)
+{
+    execucao->programa = NULL;
+    execucao->fase = PROGRAMA_PARADO;
+}
+
+// Patamar cumprido: passa ao próximo segmento, recomeça ou termina
+static void proximo_segmento(ProgramaExecucao *execucao)
+{
+    const Programa *programa = execucao->programa;
+    execucao->patamar_s = 0.0f;
+    if (++execucao->segmento < programa->quantidade)
+    {
+        execucao->fase = PROGRAMA_RAMPA;
+        return;
+    }
+    execucao->ciclos++;
+    if (programa->repetir)
+        iniciar_ciclo(execucao, execucao->setpoint);
+    else
+        programa_parar(execucao);
+}
+
+float programa_avancar(ProgramaExecucao *execucao, float temperatura, float dt)
+{
+    const Programa *programa = execucao->programa;
+    if (!programa)
+        return execucao->setpoint;
+
+    const ProgramaSegmento *s = &programa->segmentos[execucao->segmento];
+    bool fora = programa->tolerancia > 0.0f &&
+                !(fabsf(temperatura - execucao->setpoint) <= programa->tolerancia); // NAN fica fora
+
+    if (execucao->fase == PROGRAMA_RAMPA)
+    {
+        float distancia = s->alvo - execucao->setpoint;
+        float passo = s->taxa * dt / 60.0f;
+        if (fora && distancia != 0.0f)
+            execucao->espera_s += dt; // Rampa garantida: espera a temperatura alcançar
+        else if (s->taxa <= 0.0f || fabsf(distancia) <= passo)
+            execucao->setpoint = s->alvo;
+        else
+            execucao->setpoint += copysignf(passo, distancia);
+
+        if (execucao->setpoint == s->alvo)
+            execucao->fase = PROGRAMA_PATAMAR;
+        return execucao->setpoint;
+    }
+
+    // Patamar garantido: o tempo só corre com a temperatura na faixa
+    if (fora)
+        execucao->espera_s += dt;
+    else
+        execucao->patamar_s += dt;
+    if (execucao->patamar_s >= s->patamar_min * 60.0f)
+        proximo_segmento(execucao);
+    return execucao->setpoint;
+}
+
+float programa_restante_s(const ProgramaExecucao *execucao)
+{
+    const Programa *programa = execucao->programa;
+    if (!programa)
+        return 0.0f;
+
+    const ProgramaSegmento *s = &programa->segmentos[execucao->segmento];
+    float restante = s->patamar_min * 60.0f - execucao->patamar_s;
+    if (execucao->fase == PROGRAMA_RAMPA)
+        restante += duracao_rampa_s(s, execucao->setpoint);
+    float setpoint = s->alvo;
+    for (int i = execucao->segmento + 1; i < programa->quantidade; i++)
+    {
+        s = &programa->segmentos[i];
+        restante += duracao_rampa_s(s, setpoint) + s->patamar_min * 60.0f;
+        setpoint = s->alvo;
+    }
+    return restante;
+}
@@ -0,0 +1,78 @@
+#ifndef PROGRAMA_H
+#define PROGRAMA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------- Tamanhos ---------- */
+#define PROGRAMAS_MAX 4
+#define PROGRAMA_SEGMENTOS_MAX 8
+#define PROGRAMA_NOME_MAX 16
+#define PROGRAMA_SEM_HORARIO (-1) // inicio_min de um programa só iniciado à mão
+
+/* ---------- Programa de rampas e patamares ---------- */
+// Cada segmento leva o setpoint até o alvo na taxa dada (rampa) e o mantém lá
+// pelo tempo do patamar. A tolerância garante o processo: a rampa espera quando
+// a temperatura se atrasa mais que ela, e o patamar só conta o tempo com a
+// temperatura dentro da faixa (0 desliga as duas esperas).
+typedef struct {
+    float alvo;           // °C
+    float taxa;           // °C/min (0: degrau, suavizado só pela trajetória da zona)
+    uint16_t patamar_min; // Tempo no alvo (min)
+} ProgramaSegmento;
+
+typedef struct {
+    char nome[PROGRAMA_NOME_MAX];
+    uint8_t quantidade;
+    bool repetir;       // Ao terminar, recomeça do primeiro segmento
+    int8_t zona;        // Zona da partida agendada
+    int16_t inicio_min; // Minuto do dia (hora local) da partida agendada
+    float tolerancia;   // °C
+    ProgramaSegmento segmentos[PROGRAMA_SEGMENTOS_MAX];
+} Programa;
+
+typedef enum {
+    PROGRAMA_PARADO, PROGRAMA_RAMPA, PROGRAMA_PATAMAR
+} ProgramaFase;
+
+/* ---------- Execução de um programa numa zona ---------- */
+typedef struct {
+    const Programa *programa; // NULL: nenhum programa rodando
+    uint8_t segmento;
+    ProgramaFase fase;
+    float setpoint;   // Referência gerada (°C)
+    float patamar_s;  // Tempo de patamar já cumprido
+    float espera_s;   // Tempo segurado pela tolerância (rampa e patamar)
+    float duracao_s;  // Estimativa do ciclo atual, sem esperas (para o progresso)
+    uint32_t ciclos;  // Repetições concluídas
+} ProgramaExecucao;
+
+/* ---------- API ---------- */
+
+// Confere os limites de um programa (ex.: lido da flash).
+bool programa_valido(const Programa *programa);
+
+// Substitui o segmento @p indice ou, com indice == quantidade, acrescenta um
+// no fim. Retorna false se o índice estiver fora ou o programa cheio.
+bool programa_definir_segmento(Programa *programa, int indice, float alvo, float taxa, uint16_t patamar_min);
+
+// Duração estimada (s) de um ciclo do programa partindo de @p setpoint_inicial,
+// supondo que a temperatura acompanhe a rampa.
+float programa_duracao_s(const Programa *programa, float setpoint_inicial);
+
+// Começa @p programa pelo primeiro segmento, com a rampa partindo de
+// @p setpoint_inicial (em geral a temperatura medida, para não esperar).
+void programa_iniciar(ProgramaExecucao *execucao, const Programa *programa, float setpoint_inicial);
+
+// Para o programa; o setpoint fica onde estava.
+void programa_parar(ProgramaExecucao *execucao);
+
+// Avança @p dt segundos com a temperatura medida (NAN: sensor em falha, que
+// segura o programa se houver tolerância) e retorna o setpoint. Ao fim do
+// último segmento recomeça ou para, mantendo o último alvo.
+float programa_avancar(ProgramaExecucao *execucao, float temperatura, float dt);
+
+// Tempo restante estimado (s) do ciclo atual, sem contar esperas futuras.
+float programa_restante_s(const ProgramaExecucao *execucao);
+
+#endif // PROGRAMA_H
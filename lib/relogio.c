@@ -0,0 +1,56 @@
+#include <stdio.h>
+#include "relogio.h"
+#include "log.h"
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "hardware/sync.h"
+#include "lwip/apps/sntp.h"
+
+static struct {
+    uint64_t base_segundos; // Hora local (s desde 1970) no instante base_us
+    uint64_t base_us;
+    int fuso_min;
+    uint32_t sincronizacoes;
+} relogio;
+
+void relogio_iniciar(const char *servidor, int fuso_min)
+{
+    relogio.fuso_min = fuso_min;
+    cyw43_arch_lwip_begin();
+    sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    sntp_setservername(0, servidor);
+    sntp_init();
+    cyw43_arch_lwip_end();
+}
+
+// Contexto do lwIP: o laço lê o par base com as interrupções desligadas
+void relogio_definir_hora(unsigned long segundos)
+{
+    uint32_t interrupcoes = save_and_disable_interrupts();
+    relogio.base_segundos = (uint64_t)segundos + (int64_t)relogio.fuso_min * 60;
+    relogio.base_us = time_us_64();
+    relogio.sincronizacoes++;
+    restore_interrupts(interrupcoes);
+    if (relogio.sincronizacoes == 1)
+        LOG(LOG_INFO, "Relogio sincronizado por SNTP.\n");
+}
+
+bool relogio_hora_local(int *minuto_do_dia, uint32_t *dia)
+{
+    uint32_t interrupcoes = save_and_disable_interrupts();
+    uint64_t base_segundos = relogio.base_segundos, base_us = relogio.base_us;
+    bool sincronizado = relogio.sincronizacoes > 0;
+    restore_interrupts(interrupcoes);
+    if (!sincronizado)
+        return false;
+
+    uint64_t agora = base_segundos + (time_us_64() - base_us) / 1000000u;
+    *minuto_do_dia = (int)(agora / 60 % 1440);
+    *dia = (uint32_t)(agora / 86400);
+    return true;
+}
+
+uint32_t relogio_sincronizacoes(void)
+{
+    return relogio.sincronizacoes;
+}
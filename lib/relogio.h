@@ -0,0 +1,29 @@
+#ifndef RELOGIO_H
+#define RELOGIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------- Hora do dia sincronizada por SNTP ---------- */
+// O cliente SNTP do lwIP consulta o servidor periodicamente (SNTP_UPDATE_DELAY
+// em lwipopts.h) e entrega a hora por relogio_definir_hora(); entre uma
+// resposta e outra a hora anda pelo temporizador da placa. Sem sincronização
+// não há hora do dia, e as partidas agendadas não acontecem.
+
+/* ---------- API ---------- */
+
+// Inicia o SNTP com @p servidor (nome ou IPv4). A hora local é UTC somada a
+// @p fuso_min minutos. Chamar com o Wi-Fi já conectado.
+void relogio_iniciar(const char *servidor, int fuso_min);
+
+// Chamada pelo SNTP (SNTP_SET_SYSTEM_TIME) com os segundos desde 1970 (UTC).
+void relogio_definir_hora(unsigned long segundos);
+
+// Minuto do dia (0 a 1439) e número do dia, ambos na hora local; false antes
+// da primeira sincronização.
+bool relogio_hora_local(int *minuto_do_dia, uint32_t *dia);
+
+// Respostas recebidas do servidor desde o início.
+uint32_t relogio_sincronizacoes(void);
+
+#endif // RELOGIO_H
@@ -0,0 +1,40 @@
+#include <string.h>
+#include "seqlock.h"
+#include "hardware/sync.h"
+
+void *seqlock_escrita(Seqlock *seqlock)
+{
+    int livre = !seqlock->publicado;
+    seqlock->sequencia[livre]++; // Ímpar: em escrita
+    __dmb();
+    return seqlock->buffers[livre];
+}
+
+void seqlock_publicar(Seqlock *seqlock)
+{
+    int livre = !seqlock->publicado;
+    __dmb(); // Os dados ficam visíveis antes do contador par
+    seqlock->sequencia[livre]++;
+    __dmb();
+    seqlock->publicado = (uint8_t)livre;
+}
+
+uint32_t seqlock_ler(Seqlock *seqlock, void *destino)
+{
+    for (;;)
+    {
+        int indice = seqlock->publicado;
+        uint32_t sequencia = seqlock->sequencia[indice];
+        __dmb();
+        if ((sequencia & 1) == 0)
+        {
+            memcpy(destino, seqlock->buffers[indice], seqlock->tamanho);
+            __dmb();
+            // As publicações alternam buffers a partir do 1: o buffer 1 guarda as
+            // ímpares (sequência 2m após a m-ésima, publicação 2m - 1) e o 0 as pares
+            if (seqlock->sequencia[indice] == sequencia)
+                return sequencia - (uint32_t)indice;
+        }
+        seqlock->releituras++;
+    }
+}
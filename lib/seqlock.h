@@ -0,0 +1,38 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ---------- Publicação de estado por buffer duplo ---------- */
+// Um único escritor publica uma estrutura inteira de cada vez; os leitores
+// copiam a última publicada sem travar o escritor nem ler uma mistura de duas
+// publicações. O escritor sempre preenche o buffer que não está publicado,
+// então um leitor que o interrompe (ex.: handler HTTP no contexto do lwIP) lê
+// o outro, completo, sem esperar. Cada buffer tem um contador de sequência
+// (ímpar durante a escrita): se o escritor voltar a escrever o buffer durante
+// a cópia, o que só acontece com o leitor em outro núcleo, a cópia é repetida.
+typedef struct {
+    void *buffers[2];
+    size_t tamanho;
+    volatile uint32_t sequencia[2];
+    volatile uint8_t publicado;    // Índice do buffer que os leitores copiam
+    volatile uint32_t releituras;  // Cópias repetidas por concorrência com o escritor
+} Seqlock;
+
+// Inicializador estático sobre um vetor de duas estruturas.
+#define SEQLOCK_INICIAL(buffers_) {{&(buffers_)[0], &(buffers_)[1]}, sizeof((buffers_)[0])}
+
+/* ---------- API ---------- */
+
+// Escritor: buffer livre, a preencher por inteiro antes de seqlock_publicar().
+void *seqlock_escrita(Seqlock *seqlock);
+
+// Escritor: torna o buffer preenchido o publicado.
+void seqlock_publicar(Seqlock *seqlock);
+
+// Leitor: copia a última publicação para @p destino (tamanho do buffer).
+// Pode ser chamada de interrupções. Retorna o número da publicação copiada.
+uint32_t seqlock_ler(Seqlock *seqlock, void *destino);
+
+#endif // SEQLOCK_H
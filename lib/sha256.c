@@ -0,0 +1,114 @@
+#include <string.h>
+#include "sha256.h"
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static uint32_t rotr(uint32_t x, int n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+static void processar_bloco(Sha256 *sha, const uint8_t *bloco)
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++)
+        w[i] = (uint32_t)bloco[4 * i] << 24 | (uint32_t)bloco[4 * i + 1] << 16 | (uint32_t)bloco[4 * i + 2] << 8 |
+               bloco[4 * i + 3];
+    for (int i = 16; i < 64; i++)
+    {
+        uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = sha->estado[0], b = sha->estado[1], c = sha->estado[2], d = sha->estado[3];
+    uint32_t e = sha->estado[4], f = sha->estado[5], g = sha->estado[6], h = sha->estado[7];
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    sha->estado[0] += a;
+    sha->estado[1] += b;
+    sha->estado[2] += c;
+    sha->estado[3] += d;
+    sha->estado[4] += e;
+    sha->estado[5] += f;
+    sha->estado[6] += g;
+    sha->estado[7] += h;
+}
+
+void sha256_iniciar(Sha256 *sha)
+{
+    static const uint32_t INICIAL[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    memcpy(sha->estado, INICIAL, sizeof(INICIAL));
+    sha->total = 0;
+    sha->usado = 0;
+}
+
+void sha256_atualizar(Sha256 *sha, const void *dados, size_t tamanho)
+{
+    const uint8_t *p = dados;
+    sha->total += tamanho;
+    if (sha->usado)
+    {
+        size_t n = sizeof(sha->bloco) - sha->usado;
+        if (n > tamanho)
+            n = tamanho;
+        memcpy(sha->bloco + sha->usado, p, n);
+        sha->usado += n;
+        p += n;
+        tamanho -= n;
+        if (sha->usado < sizeof(sha->bloco))
+            return;
+        processar_bloco(sha, sha->bloco);
+        sha->usado = 0;
+    }
+    // Blocos inteiros direto da origem, sem cópia
+    for (; tamanho >= sizeof(sha->bloco); p += sizeof(sha->bloco), tamanho -= sizeof(sha->bloco))
+        processar_bloco(sha, p);
+    memcpy(sha->bloco, p, tamanho);
+    sha->usado = tamanho;
+}
+
+void sha256_finalizar(Sha256 *sha, uint8_t resumo[SHA256_TAMANHO])
+{
+    uint64_t bits = sha->total * 8;
+    sha->bloco[sha->usado++] = 0x80;
+    if (sha->usado > 56)
+    {
+        memset(sha->bloco + sha->usado, 0, sizeof(sha->bloco) - sha->usado);
+        processar_bloco(sha, sha->bloco);
+        sha->usado = 0;
+    }
+    memset(sha->bloco + sha->usado, 0, 56 - sha->usado);
+    for (int i = 0; i < 8; i++)
+        sha->bloco[56 + i] = (uint8_t)(bits >> (56 - 8 * i));
+    processar_bloco(sha, sha->bloco);
+
+    for (int i = 0; i < 8; i++)
+    {
+        resumo[4 * i] = (uint8_t)(sha->estado[i] >> 24);
+        resumo[4 * i + 1] = (uint8_t)(sha->estado[i] >> 16);
+        resumo[4 * i + 2] = (uint8_t)(sha->estado[i] >> 8);
+        resumo[4 * i + 3] = (uint8_t)sha->estado[i];
+    }
+}
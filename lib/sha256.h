@@ -0,0 +1,24 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA256_TAMANHO 32
+
+/* ---------- Resumo incremental ---------- */
+// SHA-256 em software (o RP2040 não tem acelerador), alimentado em blocos de
+// qualquer tamanho: a imagem de OTA é conferida enquanto chega, sem ficar
+// inteira na RAM.
+typedef struct {
+    uint32_t estado[8];
+    uint64_t total;    // Bytes processados
+    uint8_t bloco[64];
+    uint8_t usado;     // Bytes pendentes em bloco
+} Sha256;
+
+void sha256_iniciar(Sha256 *sha);
+void sha256_atualizar(Sha256 *sha, const void *dados, size_t tamanho);
+void sha256_finalizar(Sha256 *sha, uint8_t resumo[SHA256_TAMANHO]);
+
+#endif // SHA256_H
@@ -0,0 +1,203 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "shell.h"
+#include "log.h"
+#include "hardware/sync.h"
+
+static struct {
+    // Recepção: um produtor (interrupção) e um consumidor (laço principal)
+    uint8_t rx[SHELL_RX_CAPACIDADE];
+    volatile uint32_t rx_escrita;
+    volatile uint32_t rx_leitura;
+
+    char linha[SHELL_LINHA_MAX];
+    int tamanho;
+    bool descartando; // Linha longa demais: ignora até o fim dela
+
+    const ShellComando *comandos;
+    int quantidade;
+    shell_funcao_t padrao;
+    bool erro_no_comando;
+    ShellEstatisticas estatisticas;
+} shell;
+
+void shell_iniciar(const ShellComando *comandos, int quantidade, shell_funcao_t padrao)
+{
+    shell.comandos = comandos;
+    shell.quantidade = quantidade;
+    shell.padrao = padrao;
+}
+
+void shell_receber(uint8_t byte)
+{
+    uint32_t escrita = shell.rx_escrita;
+    if (escrita - shell.rx_leitura >= SHELL_RX_CAPACIDADE)
+    {
+        shell.estatisticas.bytes_descartados++;
+        return;
+    }
+    shell.rx[escrita % SHELL_RX_CAPACIDADE] = byte;
+    __dmb(); // O byte fica visível antes do índice
+    shell.rx_escrita = escrita + 1;
+}
+
+void shell_escrever(const char *formato, ...)
+{
+    if (log_silenciado)
+        return;
+    va_list args;
+    va_start(args, formato);
+    vprintf(formato, args);
+    va_end(args);
+}
+
+void shell_erro(const char *formato, ...)
+{
+    shell.erro_no_comando = true;
+    if (log_silenciado)
+        return;
+    va_list args;
+    va_start(args, formato);
+    printf("ERRO: ");
+    vprintf(formato, args);
+    va_end(args);
+}
+
+static void ajuda(void)
+{
+    shell_escrever("Comandos:\n  ajuda\n");
+    for (int i = 0; i < shell.quantidade; i++)
+        shell_escrever("  %s %s\n", shell.comandos[i].nome, shell.comandos[i].uso);
+}
+
+static void executar(char *linha)
+{
+    char *argv[SHELL_ARGS_MAX + 1];
+    int argc = 0;
+    for (char *token = strtok(linha, " \t"); token; token = strtok(NULL, " \t"))
+    {
+        if (argc == SHELL_ARGS_MAX)
+        {
+            shell_erro("argumentos demais\n");
+            shell.estatisticas.erros++;
+            return;
+        }
+        argv[argc++] = token;
+    }
+    if (argc == 0)
+        return;
+    argv[argc] = NULL;
+
+    shell.estatisticas.linhas++;
+    shell.erro_no_comando = false;
+    if (strcmp(argv[0], "ajuda") == 0 || strcmp(argv[0], "?") == 0)
+    {
+        ajuda();
+        return;
+    }
+
+    const ShellComando *comando = NULL;
+    for (int i = 0; i < shell.quantidade && !comando; i++)
+        if (strcmp(argv[0], shell.comandos[i].nome) == 0)
+            comando = &shell.comandos[i];
+
+    if (!comando)
+    {
+        if (shell.padrao)
+            shell.padrao(argc, argv);
+        else
+            shell_erro("comando desconhecido: %s (digite ajuda)\n", argv[0]);
+    }
+    else if (argc - 1 < comando->args_min || argc - 1 > comando->args_max)
+        shell_erro("uso: %s %s\n", comando->nome, comando->uso);
+    else
+        comando->funcao(argc, argv);
+
+    if (shell.erro_no_comando)
+        shell.estatisticas.erros++;
+}
+
+void shell_processar(void)
+{
+    while (shell.rx_leitura != shell.rx_escrita)
+    {
+        __dmb();
+        char c = (char)shell.rx[shell.rx_leitura % SHELL_RX_CAPACIDADE];
+        shell.rx_leitura++;
+
+        if (c == '\r' || c == '\n')
+        {
+            if (shell.descartando)
+                shell_erro("linha com mais de %d caracteres\n", SHELL_LINHA_MAX - 1);
+            else if (shell.tamanho > 0)
+            {
+                shell.linha[shell.tamanho] = '\0';
+                executar(shell.linha);
+            }
+            shell.tamanho = 0;
+            shell.descartando = false;
+        }
+        else if (c == '\b' || c == 0x7f)
+        {
+            if (shell.tamanho > 0)
+                shell.tamanho--;
+        }
+        else if (shell.descartando)
+        {
+            continue;
+        }
+        else if (shell.tamanho < SHELL_LINHA_MAX - 1)
+        {
+            shell.linha[shell.tamanho++] = c;
+        }
+        else
+        {
+            shell.descartando = true;
+            shell.estatisticas.linhas_longas++;
+        }
+    }
+}
+
+bool shell_ler_float(const char *texto, float min, float max, float *valor)
+{
+    char numero[24];
+    size_t n = strlen(texto);
+    if (n == 0 || n >= sizeof(numero))
+        return false;
+    memcpy(numero, texto, n + 1);
+    for (char *c = numero; *c; c++)
+        if (*c == ',')
+            *c = '.';
+
+    char *fim;
+    float v = strtof(numero, &fim);
+    if (*fim != '\0' || !(v >= min && v <= max)) // Rejeita também NAN
+        return false;
+    *valor = v;
+    return true;
+}
+
+bool shell_ler_int(const char *texto, int min, int max, int *valor)
+{
+    char *fim;
+    long v = strtol(texto, &fim, 10);
+    if (*texto == '\0' || *fim != '\0' || v < min || v > max)
+        return false;
+    *valor = (int)v;
+    return true;
+}
+
+int shell_ler_opcao(const char *texto, const char *const *opcoes)
+{
+    for (int i = 0; opcoes[i]; i++)
+        if (strcmp(texto, opcoes[i]) == 0)
+            return i;
+    return -1;
+}
+
+void shell_estatisticas(ShellEstatisticas *estatisticas)
+{
+    *estatisticas = shell.estatisticas;
+}
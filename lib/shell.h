@@ -0,0 +1,62 @@
+#ifndef SHELL_H
+#define SHELL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------- Limites ---------- */
+#define SHELL_RX_CAPACIDADE 256 // Potência de 2
+#define SHELL_LINHA_MAX 64
+#define SHELL_ARGS_MAX 6        // Incluindo o nome do comando
+
+/* ---------- Tabela de comandos ---------- */
+// argv[0] é o nome digitado; o shell confere a quantidade de argumentos antes
+// de chamar a função.
+typedef void (*shell_funcao_t)(int argc, char **argv);
+
+typedef struct {
+    const char *nome;
+    const char *uso;  // Argumentos e descrição, para a ajuda
+    uint8_t args_min; // Sem contar o nome
+    uint8_t args_max;
+    shell_funcao_t funcao;
+} ShellComando;
+
+/* ---------- Métricas ---------- */
+typedef struct {
+    uint32_t linhas;
+    uint32_t erros;             // Comando desconhecido ou argumentos inválidos
+    uint32_t linhas_longas;     // Descartadas por passar de SHELL_LINHA_MAX
+    uint32_t bytes_descartados; // Recepção com o buffer cheio
+} ShellEstatisticas;
+
+/* ---------- API ---------- */
+
+// Define a tabela de comandos. @p padrao recebe as linhas que não começam por
+// um comando (ex.: um número solto); NULL as trata como erro. O comando
+// "ajuda" é embutido e lista a tabela.
+void shell_iniciar(const ShellComando *comandos, int quantidade, shell_funcao_t padrao);
+
+// Produtor: guarda um byte recebido. Feita para a interrupção de recepção
+// (UART ou USB); não bloqueia e conta o descarte se o buffer estiver cheio.
+void shell_receber(uint8_t byte);
+
+// Consumidor (laço principal): monta as linhas recebidas e executa cada uma.
+void shell_processar(void);
+
+// Respostas dos comandos (suprimidas durante a saída binária).
+void shell_escrever(const char *formato, ...) __attribute__((format(printf, 1, 2)));
+
+// Marca o comando atual como erro e escreve o motivo.
+void shell_erro(const char *formato, ...) __attribute__((format(printf, 1, 2)));
+
+// Converte @p texto (aceita vírgula decimal) e confere a faixa [min, max].
+bool shell_ler_float(const char *texto, float min, float max, float *valor);
+bool shell_ler_int(const char *texto, int min, int max, int *valor);
+
+// Índice de @p texto na lista terminada por NULL, ou -1.
+int shell_ler_opcao(const char *texto, const char *const *opcoes);
+
+void shell_estatisticas(ShellEstatisticas *estatisticas);
+
+#endif // SHELL_H
@@ -1,3 +1,4 @@
+#include <string.h>
 #include "ssd1306.h"
 #include "font.h"
 
@@ -11,70 +12,129 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->tx_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd1306_invalidate(ssd); // A RAM do painel começa com lixo
 }
 
+// Byte de controle 0x00 (Co = 0): todos os bytes seguintes são comandos, então
+// a sequência de inicialização vai numa única transação I2C.
+static const uint8_t ssd1306_init_sequence[] = {
+  0x00,
+  SET_DISP | 0x00,
+  SET_MEM_ADDR, 0x01,
+  SET_DISP_START_LINE | 0x00,
+  SET_SEG_REMAP | 0x01,
+  SET_MUX_RATIO, HEIGHT - 1,
+  SET_COM_OUT_DIR | 0x08,
+  SET_DISP_OFFSET, 0x00,
+  SET_COM_PIN_CFG, 0x12,
+  SET_DISP_CLK_DIV, 0x80,
+  SET_PRECHARGE, 0xF1,
+  SET_VCOM_DESEL, 0x30,
+  SET_CONTRAST, 0xFF,
+  SET_ENTIRE_ON,
+  SET_NORM_INV,
+  SET_CHARGE_PUMP, 0x14,
+  SET_DISP | 0x01
+};
+
 void ssd1306_config(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
-  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
-  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
-  ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
-  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
-  ssd1306_command(ssd, SET_DISP_OFFSET);
-  ssd1306_command(ssd, 0x00);
-  ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
-  ssd1306_command(ssd, SET_DISP_CLK_DIV);
-  ssd1306_command(ssd, 0x80);
-  ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
-  ssd1306_command(ssd, SET_VCOM_DESEL);
-  ssd1306_command(ssd, 0x30);
-  ssd1306_command(ssd, SET_CONTRAST);
-  ssd1306_command(ssd, 0xFF);
-  ssd1306_command(ssd, SET_ENTIRE_ON);
-  ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
-  ssd1306_command(ssd, SET_DISP | 0x01);
+  i2c_fila_escrever(
+    ssd->i2c_port,
+    ssd->address,
+    ssd1306_init_sequence,
+    sizeof(ssd1306_init_sequence)
+  );
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   ssd->port_buffer[1] = command;
-  i2c_write_blocking(
+  i2c_fila_escrever(
     ssd->i2c_port,
     ssd->address,
     ssd->port_buffer,
-    2,
-    false
+    2
   );
 }
 
+void ssd1306_wait_flush(ssd1306_t *ssd) {
+  i2c_fila_aguardar(&ssd->flush[0]);
+}
+
+static void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t col, uint8_t page) {
+  if (!ssd->dirty) {
+    ssd->dirty = true;
+    ssd->dirty_col_min = ssd->dirty_col_max = col;
+    ssd->dirty_page_min = ssd->dirty_page_max = page;
+    return;
+  }
+  if (col < ssd->dirty_col_min) ssd->dirty_col_min = col;
+  if (col > ssd->dirty_col_max) ssd->dirty_col_max = col;
+  if (page < ssd->dirty_page_min) ssd->dirty_page_min = page;
+  if (page > ssd->dirty_page_max) ssd->dirty_page_max = page;
+}
+
+// Força a próxima descarga a enviar o quadro inteiro.
+void ssd1306_invalidate(ssd1306_t *ssd) {
+  ssd1306_mark_dirty(ssd, 0, 0);
+  ssd1306_mark_dirty(ssd, ssd->width - 1, ssd->pages - 1);
+}
+
+// Enfileira a janela alterada e seus bytes numa cadeia de descritores e
+// retorna na hora; nada é enviado se o quadro não mudou. Os bytes são
+// copiados, então dá para voltar a desenhar enquanto são enviados.
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  if (!ssd->dirty)
+    return;
+  ssd1306_wait_flush(ssd);
+
+  // Endereçamento vertical: o painel preenche a janela página a página em
+  // cada coluna, que é também o layout do ram_buffer
+  uint8_t pages = ssd->dirty_page_max - ssd->dirty_page_min + 1;
+  uint8_t *out = ssd->tx_buffer;
+  *out++ = 0x40;
+  for (uint16_t col = ssd->dirty_col_min; col <= ssd->dirty_col_max; ++col) {
+    memcpy(out, &ssd->ram_buffer[(col << 3) + ssd->dirty_page_min + 1], pages);
+    out += pages;
+  }
+
+  ssd->addr_buffer[0] = 0x00;
+  ssd->addr_buffer[1] = SET_COL_ADDR;
+  ssd->addr_buffer[2] = ssd->dirty_col_min;
+  ssd->addr_buffer[3] = ssd->dirty_col_max;
+  ssd->addr_buffer[4] = SET_PAGE_ADDR;
+  ssd->addr_buffer[5] = ssd->dirty_page_min;
+  ssd->addr_buffer[6] = ssd->dirty_page_max;
+  ssd->dirty = false;
+
+  ssd->flush[1] = (I2CTransacao){
+    .endereco = ssd->address,
+    .escrita = ssd->tx_buffer,
+    .escrita_len = out - ssd->tx_buffer,
+  };
+  ssd->flush[0] = (I2CTransacao){
+    .endereco = ssd->address,
+    .escrita = ssd->addr_buffer,
+    .escrita_len = sizeof(ssd->addr_buffer),
+    .proxima = &ssd->flush[1],
+  };
+  i2c_fila_enviar(ssd->i2c_port, &ssd->flush[0]);
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height)
+    return;
   uint16_t index = (y >> 3) + (x << 3) + 1;
   uint8_t pixel = (y & 0b111);
+  uint8_t byte = ssd->ram_buffer[index];
   if (value)
-    ssd->ram_buffer[index] |= (1 << pixel);
+    byte |= (1 << pixel);
   else
-    ssd->ram_buffer[index] &= ~(1 << pixel);
+    byte &= ~(1 << pixel);
+  if (byte == ssd->ram_buffer[index])
+    return;
+  ssd->ram_buffer[index] = byte;
+  ssd1306_mark_dirty(ssd, x, y >> 3);
 }
 
 /*
@@ -153,46 +213,147 @@ void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value
     ssd1306_pixel(ssd, x, y, value);
 }
 
-// Função para desenhar um caractere
-void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
-{
-  uint16_t index = 0;
-  char ver=c;
-  if (c >= 'A' && c <= 'Z')
-  {
-    index = (c - 'A' + 11) * 8; // Para letras maiúsculas
-  }else  if (c >= '0' && c <= '9')
-  {
-    index = (c - '0' + 1) * 8; // Adiciona o deslocamento necessário
-  }else if (c >= 'a' && c <= 'z'){
-    index = (c - 'a' + 37) * 8; // Para letras maiúsculas
+// Escreve as linhas top..bottom da coluna x de uma vez: a linha y recebe o
+// bit y de bits. Trabalha um byte de página por vez (8 escritas no máximo).
+void ssd1306_column(ssd1306_t *ssd, uint8_t x, uint8_t top, uint8_t bottom, uint64_t bits) {
+  if (x >= ssd->width || top > bottom)
+    return;
+  if (bottom >= ssd->height)
+    bottom = ssd->height - 1;
+  uint64_t area = ssd1306_span_bits(top, bottom);
+
+  for (uint8_t page = top >> 3; page <= bottom >> 3; ++page) {
+    uint8_t mask = area >> (page * 8);
+    uint8_t value = bits >> (page * 8);
+    uint8_t *byte = &ssd->ram_buffer[(x << 3) + page + 1];
+    uint8_t updated = (*byte & ~mask) | (value & mask);
+    if (updated != *byte) {
+      *byte = updated;
+      ssd1306_mark_dirty(ssd, x, page);
+    }
   }
-  
-  for (uint8_t i = 0; i < 8; ++i)
-  {
-    uint8_t line = font[index + i];
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j));
+}
+
+/* ---------- Texto ---------- */
+
+// Cache de glifos decodificados, mapeado direto por (fonte, código). Cada
+// palavra guarda uma coluna inteira do glifo (até 32 linhas): desenhar um
+// glifo em cache é um ssd1306_column() por coluna, sem ler a flash. Os
+// dígitos redesenhados a cada quadro ficam residentes.
+#define GLYPH_CACHE_SIZE 32
+#define GLYPH_MAX_WIDTH 12 // tools/gerar_fonte.py recusa glifos mais largos
+
+typedef struct {
+  const ssd1306_font_t *font;
+  uint8_t code;
+  uint32_t columns[GLYPH_MAX_WIDTH];
+} glyph_cache_entry_t;
+
+static glyph_cache_entry_t glyph_cache[GLYPH_CACHE_SIZE];
+
+// Código Latin-1 do próximo caractere de uma string UTF-8. Caracteres fora
+// do Latin-1 viram '?'; bytes soltos que não são UTF-8 valem como Latin-1.
+static uint8_t next_code(const char **str) {
+  const uint8_t *s = (const uint8_t *)*str;
+  if (s[0] >= 0xC0 && (s[1] & 0xC0) == 0x80) {
+    uint16_t code = ((s[0] & 0x1F) << 6) | (s[1] & 0x3F);
+    size_t len = 2;
+    while ((s[len] & 0xC0) == 0x80)
+      len++;
+    *str += len;
+    return len == 2 && s[0] < 0xE0 && code <= 0xFF ? code : '?';
+  }
+  *str += 1;
+  return s[0];
+}
+
+// Glifo do código, ou o '?' da fonte quando não existe (NULL se faltar também)
+static const ssd1306_glyph_t *find_glyph(const ssd1306_font_t *font, uint8_t *code) {
+  for (int attempt = 0; attempt < 2; attempt++) {
+    if (*code >= font->first && *code <= font->last) {
+      const ssd1306_glyph_t *glyph = &font->glyphs[*code - font->first];
+      if (glyph->width)
+        return glyph;
     }
+    *code = '?';
+  }
+  return NULL;
+}
+
+static const uint32_t *glyph_columns(const ssd1306_font_t *font, uint8_t code, const ssd1306_glyph_t *glyph) {
+  glyph_cache_entry_t *entry = &glyph_cache[(code ^ ((uintptr_t)font >> 3)) % GLYPH_CACHE_SIZE];
+  if (entry->font == font && entry->code == code)
+    return entry->columns;
+
+  uint8_t pages = (font->height + 7) / 8;
+  const uint8_t *src = &font->bitmap[glyph->offset * pages];
+  for (uint8_t i = 0; i < glyph->width && i < GLYPH_MAX_WIDTH; i++) {
+    uint32_t column = 0;
+    for (uint8_t page = 0; page < pages; page++)
+      column |= (uint32_t)*src++ << (page * 8);
+    entry->columns[i] = column;
   }
+  entry->font = font;
+  entry->code = code;
+  return entry->columns;
+}
+
+// Função para desenhar um glifo: escreve a célula inteira, espaçamento
+// incluído, e o texto substitui o que havia embaixo sem apagar antes.
+// Retorna o avanço em pixels.
+static uint8_t draw_glyph(ssd1306_t *ssd, const ssd1306_font_t *font, uint8_t code, uint8_t x, uint8_t y) {
+  const ssd1306_glyph_t *glyph = find_glyph(font, &code);
+  if (!glyph)
+    return 0;
+  const uint32_t *columns = glyph_columns(font, code, glyph);
+  uint8_t bottom = y + font->height - 1;
+  uint8_t advance = glyph->width + font->spacing;
+  for (uint8_t i = 0; i < advance && x + i < ssd->width; i++)
+    ssd1306_column(ssd, x + i, y, bottom, i < glyph->width ? (uint64_t)columns[i] << y : 0);
+  return advance;
+}
+
+static uint8_t glyph_advance(const ssd1306_font_t *font, uint8_t code) {
+  const ssd1306_glyph_t *glyph = find_glyph(font, &code);
+  return glyph ? glyph->width + font->spacing : 0;
 }
 
-// Função para desenhar uma string
+uint8_t ssd1306_draw_text(ssd1306_t *ssd, const ssd1306_font_t *font, const char *str, uint8_t x, uint8_t y) {
+  uint8_t cursor = x;
+  while (*str && cursor < ssd->width)
+    cursor += draw_glyph(ssd, font, next_code(&str), cursor, y);
+  return cursor - x;
+}
+
+uint8_t ssd1306_text_width(const ssd1306_font_t *font, const char *str) {
+  unsigned width = 0;
+  while (*str)
+    width += glyph_advance(font, next_code(&str));
+  return width > UINT8_MAX ? UINT8_MAX : width;
+}
+
+// Função para desenhar um caractere (Latin-1, fonte pequena)
+void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+{
+  draw_glyph(ssd, &ssd1306_font_small, (uint8_t)c, x, y);
+}
+
+// Função para desenhar uma string, quebrando a linha na borda do display
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
 {
+  const ssd1306_font_t *font = &ssd1306_font_small;
   while (*str)
   {
-    ssd1306_draw_char(ssd, *str++, x, y);
-    x += 8;
-    if (x + 8 >= ssd->width)
+    uint8_t code = next_code(&str);
+    if (x + glyph_advance(font, code) > ssd->width)
     {
       x = 0;
-      y += 8;
+      y += font->height;
     }
-    if (y + 8 >= ssd->height)
+    if (y + font->height > ssd->height)
     {
       break;
     }
+    x += draw_glyph(ssd, font, code, x, y);
   }
-}
\ No newline at end of file
+}
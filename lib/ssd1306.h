@@ -1,6 +1,10 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "i2c_fila.h"
 
 #define WIDTH 128
 #define HEIGHT 64
@@ -32,12 +36,40 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  // Descarga assíncrona: cópia do quadro e cadeia de descritores da fila I2C
+  uint8_t *tx_buffer;
+  uint8_t addr_buffer[7];
+  I2CTransacao flush[2];
+  // Região alterada (colunas x páginas) desde a última descarga
+  bool dirty;
+  uint8_t dirty_col_min, dirty_col_max;
+  uint8_t dirty_page_min, dirty_page_max;
 } ssd1306_t;
 
+// Fonte proporcional em bitmap; as tabelas são geradas em font.h por
+// tools/gerar_fonte.py. Códigos em Latin-1 (as strings são lidas como UTF-8).
+typedef struct {
+  uint16_t offset;  // Primeira coluna no bitmap
+  uint8_t width;    // Colunas; 0 = glifo ausente na fonte
+} ssd1306_glyph_t;
+
+typedef struct {
+  uint8_t height;       // Linhas (até 32)
+  uint8_t spacing;      // Colunas em branco após cada glifo
+  uint8_t first, last;  // Códigos cobertos por glyphs[]
+  const ssd1306_glyph_t *glyphs;
+  const uint8_t *bitmap; // Por coluna, (height + 7) / 8 bytes cada, bit 0 = linha de cima
+} ssd1306_font_t;
+
+extern const ssd1306_font_t ssd1306_font_small;   // ASCII + Latin-1, 8 linhas
+extern const ssd1306_font_t ssd1306_font_numbers; // Dígitos, '-', '.', '°', 'C', 14 linhas
+
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_wait_flush(ssd1306_t *ssd);
+void ssd1306_invalidate(ssd1306_t *ssd);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -45,5 +77,18 @@ void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
+void ssd1306_column(ssd1306_t *ssd, uint8_t x, uint8_t top, uint8_t bottom, uint64_t bits);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+// Desenha uma linha de texto UTF-8 (sem quebra, cortada na borda direita) e
+// retorna a largura em pixels, com o espaçamento final.
+uint8_t ssd1306_draw_text(ssd1306_t *ssd, const ssd1306_font_t *font, const char *str, uint8_t x, uint8_t y);
+uint8_t ssd1306_text_width(const ssd1306_font_t *font, const char *str);
+
+// Bits y0..y1 ligados, para montar máscaras do ssd1306_column()
+static inline uint64_t ssd1306_span_bits(uint8_t y0, uint8_t y1) {
+  uint64_t below_y1 = y1 >= 63 ? ~0ull : (1ull << (y1 + 1)) - 1;
+  return below_y1 & ~((1ull << y0) - 1);
+}
+
+#endif // SSD1306_H
@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include "supervisor.h"
+#include "hardware/watchdog.h"
+
+// Registradores de rascunho do watchdog (sobrevivem ao reset; o SDK usa os de 4 a 7)
+#define SCRATCH_MAGICO 0
+#define SCRATCH_MOTIVO 1
+#define SCRATCH_REINICIOS 2
+#define SCRATCH_UPTIME 3
+#define SUPERVISOR_MAGICO 0x53555056u // "SUPV"
+
+static Zona *zonas_supervisionadas;
+static int num_zonas_supervisionadas;
+static float limite_critico;
+static repeating_timer_t temporizador;
+
+static volatile uint32_t ultimo_sinal_vida_ms;
+static volatile bool laco_travado;
+static volatile bool critico;
+
+static MotivoReinicio motivo_reinicio;
+static uint32_t reinicios;
+static uint32_t uptime_anterior_ms;
+
+static void ler_motivo_reinicio(void)
+{
+    if (watchdog_caused_reboot())
+    {
+        if (watchdog_hw->scratch[SCRATCH_MAGICO] == SUPERVISOR_MAGICO)
+        {
+            motivo_reinicio = (MotivoReinicio)watchdog_hw->scratch[SCRATCH_MOTIVO];
+            reinicios = watchdog_hw->scratch[SCRATCH_REINICIOS] + 1;
+            uptime_anterior_ms = watchdog_hw->scratch[SCRATCH_UPTIME];
+        }
+        else
+        {
+            motivo_reinicio = REINICIO_WATCHDOG;
+            reinicios = 1;
+        }
+    }
+    else
+    {
+        motivo_reinicio = REINICIO_ENERGIA;
+        reinicios = 0;
+    }
+
+    // Motivo padrão caso o próximo reset venha sem aviso (interrupções travadas)
+    watchdog_hw->scratch[SCRATCH_MAGICO] = SUPERVISOR_MAGICO;
+    watchdog_hw->scratch[SCRATCH_MOTIVO] = REINICIO_WATCHDOG;
+    watchdog_hw->scratch[SCRATCH_REINICIOS] = reinicios;
+    watchdog_hw->scratch[SCRATCH_UPTIME] = 0;
+}
+
+static bool supervisor_callback(repeating_timer_t *t)
+{
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+    bool algum_critico = false;
+
+    for (int i = 0; i < num_zonas_supervisionadas; i++)
+    {
+        Zona *zona = &zonas_supervisionadas[i];
+
+        // Sem leitura válida o estado anterior é mantido
+        if (zona->sensor_ok)
+        {
+            if (!zona->temperatura_critica && zona->temperatura_atual >= limite_critico)
+                zona->temperatura_critica = true;
+            else if (zona->temperatura_critica && zona->temperatura_atual < limite_critico - SUPERVISOR_HISTERESE)
+                zona->temperatura_critica = false;
+        }
+
+        if (zona->temperatura_critica || laco_travado)
+            zona_forcar_resfriamento_maximo(zona);
+        algum_critico |= zona->temperatura_critica;
+    }
+    critico = algum_critico;
+
+    watchdog_hw->scratch[SCRATCH_UPTIME] = agora;
+    if (laco_travado)
+        return true; // Não alimenta mais: o watchdog reinicia a placa
+
+    if (agora - ultimo_sinal_vida_ms > SUPERVISOR_TIMEOUT_LACO_MS)
+    {
+        laco_travado = true;
+        watchdog_hw->scratch[SCRATCH_MOTIVO] = REINICIO_LACO_TRAVADO;
+        for (int i = 0; i < num_zonas_supervisionadas; i++)
+            zona_forcar_resfriamento_maximo(&zonas_supervisionadas[i]);
+        return true;
+    }
+
+    watchdog_update();
+    return true;
+}
+
+void supervisor_iniciar(Zona *zonas, int num_zonas, float limite)
+{
+    zonas_supervisionadas = zonas;
+    num_zonas_supervisionadas = num_zonas;
+    limite_critico = limite;
+
+    ler_motivo_reinicio();
+    printf("Motivo do ultimo reinicio: %s (reinicios seguidos: %lu)\n",
+           supervisor_motivo_str(motivo_reinicio), (unsigned long)reinicios);
+
+    ultimo_sinal_vida_ms = to_ms_since_boot(get_absolute_time());
+    add_repeating_timer_ms(SUPERVISOR_PERIODO_MS, supervisor_callback, NULL, &temporizador);
+    watchdog_enable(SUPERVISOR_WATCHDOG_MS, true);
+}
+
+void supervisor_sinalizar_vida(void)
+{
+    ultimo_sinal_vida_ms = to_ms_since_boot(get_absolute_time());
+}
+
+bool supervisor_temperatura_critica(void)
+{
+    return critico;
+}
+
+MotivoReinicio supervisor_motivo_reinicio(void)
+{
+    return motivo_reinicio;
+}
+
+void supervisor_reiniciar(MotivoReinicio motivo)
+{
+    cancel_repeating_timer(&temporizador);
+    for (int i = 0; i < num_zonas_supervisionadas; i++)
+        zona_forcar_resfriamento_maximo(&zonas_supervisionadas[i]);
+    watchdog_hw->scratch[SCRATCH_MOTIVO] = motivo;
+    watchdog_hw->scratch[SCRATCH_UPTIME] = to_ms_since_boot(get_absolute_time());
+    watchdog_reboot(0, 0, 10);
+    while (true)
+        tight_loop_contents();
+}
+
+uint32_t supervisor_reinicios(void)
+{
+    return reinicios;
+}
+
+uint32_t supervisor_uptime_anterior_ms(void)
+{
+    return uptime_anterior_ms;
+}
+
+const char *supervisor_motivo_str(MotivoReinicio motivo)
+{
+    switch (motivo)
+    {
+    case REINICIO_ENERGIA:
+        return "energia";
+    case REINICIO_WATCHDOG:
+        return "watchdog";
+    case REINICIO_LACO_TRAVADO:
+        return "laco_travado";
+    case REINICIO_ATUALIZACAO:
+        return "atualizacao";
+    case REINICIO_SEM_CONFIRMACAO:
+        return "sem_confirmacao";
+    }
+    return "?";
+}
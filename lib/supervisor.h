@@ -0,0 +1,53 @@
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "zona.h"
+
+/* ---------- Configuração ---------- */
+#define SUPERVISOR_PERIODO_MS 100        // Período da interrupção do supervisor
+#define SUPERVISOR_HISTERESE 2.0f        // Sai do alerta abaixo de (limite - histerese)
+#define SUPERVISOR_TIMEOUT_LACO_MS 5000  // Sem sinal de vida do laço por esse tempo = travado
+#define SUPERVISOR_WATCHDOG_MS 2000      // Reset após parar de alimentar o watchdog
+
+/* ---------- Motivo do último reinício ---------- */
+typedef enum {
+    REINICIO_ENERGIA,      // Energização ou botão RUN
+    REINICIO_WATCHDOG,     // Watchdog sem motivo registrado (interrupções paradas)
+    REINICIO_LACO_TRAVADO, // O supervisor deixou de alimentar o watchdog
+    REINICIO_ATUALIZACAO,  // Firmware novo recebido por OTA
+    REINICIO_SEM_CONFIRMACAO // Firmware novo não confirmou no prazo: o bootloader volta ao anterior
+} MotivoReinicio;
+
+/* ---------- API ---------- */
+// O supervisor roda em uma interrupção de temporizador, independente do laço
+// principal: aplica o limite crítico de cada zona (com histerese) direto no PWM
+// e só alimenta o watchdog enquanto o laço sinalizar que está vivo.
+
+// Lê o motivo do último reinício, inicia o temporizador e habilita o watchdog.
+// Deve ser chamado depois da inicialização dos atuadores.
+void supervisor_iniciar(Zona *zonas, int num_zonas, float limite_critico);
+
+// Chamado pelo laço de controle ao completar um ciclo.
+void supervisor_sinalizar_vida(void);
+
+// Indica se alguma zona está acima do limite crítico.
+bool supervisor_temperatura_critica(void);
+
+MotivoReinicio supervisor_motivo_reinicio(void);
+
+// Reinício pedido pelo programa: registra o motivo e reinicia pelo watchdog,
+// com as saídas no estado seguro. Não retorna.
+void supervisor_reiniciar(MotivoReinicio motivo);
+
+// Reinícios por watchdog seguidos desde a última energização.
+uint32_t supervisor_reinicios(void);
+
+// Tempo de operação (ms) antes do último reinício por watchdog.
+uint32_t supervisor_uptime_anterior_ms(void);
+
+// Nome curto do motivo, para a telemetria.
+const char *supervisor_motivo_str(MotivoReinicio motivo);
+
+#endif // SUPERVISOR_H
@@ -0,0 +1,115 @@
+#include <string.h>
+#include "telemetria_udp.h"
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/udp.h"
+
+_Static_assert(sizeof(TelemetriaUdpCabecalho) == 12, "cabecalho fora do formato do receptor");
+_Static_assert(sizeof(TelemetriaUdpAmostra) == 23, "amostra fora do formato do receptor");
+
+static struct {
+    struct udp_pcb *pcb;
+    ip_addr_t destino;
+    uint16_t porta;
+    uint8_t amostras_por_pacote;
+    bool ativa;
+
+    // Datagrama em montagem
+    struct __attribute__((packed)) {
+        TelemetriaUdpCabecalho cabecalho;
+        TelemetriaUdpAmostra amostras[TELEMETRIA_UDP_LOTE_MAX];
+    } pacote;
+
+    TelemetriaUdpEstatisticas estatisticas;
+} udp;
+
+static void enviar_lote(void)
+{
+    if (udp.pacote.cabecalho.amostras == 0)
+        return;
+
+    udp.pacote.cabecalho.envio_us = time_us_32();
+    u16_t len = (u16_t)(sizeof(TelemetriaUdpCabecalho) +
+                        udp.pacote.cabecalho.amostras * sizeof(TelemetriaUdpAmostra));
+
+    cyw43_arch_lwip_begin();
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, len, PBUF_RAM);
+    err_t err = ERR_MEM;
+    if (p)
+    {
+        memcpy(p->payload, &udp.pacote, len);
+        err = udp_sendto(udp.pcb, p, &udp.destino, udp.porta);
+        pbuf_free(p);
+    }
+    cyw43_arch_lwip_end();
+
+    // A sequência avança mesmo se o envio falhar: o receptor enxerga a perda
+    if (err == ERR_OK)
+        udp.estatisticas.pacotes++;
+    else
+        udp.estatisticas.erros_envio++;
+    udp.pacote.cabecalho.sequencia++;
+    udp.pacote.cabecalho.amostras = 0;
+}
+
+bool telemetria_udp_iniciar(const char *destino, uint16_t porta, uint8_t amostras_por_pacote)
+{
+    ip_addr_t endereco;
+    if (!ipaddr_aton(destino, &endereco) || porta == 0 ||
+        amostras_por_pacote == 0 || amostras_por_pacote > TELEMETRIA_UDP_LOTE_MAX)
+        return false;
+
+    if (!udp.pcb)
+    {
+        cyw43_arch_lwip_begin();
+        udp.pcb = udp_new();
+        cyw43_arch_lwip_end();
+        if (!udp.pcb)
+            return false;
+    }
+
+    udp.destino = endereco;
+    udp.porta = porta;
+    udp.amostras_por_pacote = amostras_por_pacote;
+    udp.pacote.cabecalho = (TelemetriaUdpCabecalho){
+        .magico = TELEMETRIA_UDP_MAGICO,
+        .versao = TELEMETRIA_UDP_VERSAO,
+    };
+    udp.estatisticas = (TelemetriaUdpEstatisticas){0};
+    udp.ativa = true;
+    return true;
+}
+
+bool telemetria_udp_destino_valido(const char *destino)
+{
+    ip_addr_t endereco;
+    return ipaddr_aton(destino, &endereco) != 0;
+}
+
+void telemetria_udp_parar(void)
+{
+    if (!udp.ativa)
+        return;
+    enviar_lote();
+    udp.ativa = false;
+}
+
+bool telemetria_udp_ativa(void)
+{
+    return udp.ativa;
+}
+
+void telemetria_udp_adicionar(const TelemetriaUdpAmostra *amostra)
+{
+    if (!udp.ativa)
+        return;
+    udp.pacote.amostras[udp.pacote.cabecalho.amostras++] = *amostra;
+    udp.estatisticas.amostras++;
+    if (udp.pacote.cabecalho.amostras >= udp.amostras_por_pacote)
+        enviar_lote();
+}
+
+void telemetria_udp_estatisticas(TelemetriaUdpEstatisticas *estatisticas)
+{
+    *estatisticas = udp.estatisticas;
+}
@@ -0,0 +1,73 @@
+#ifndef TELEMETRIA_UDP_H
+#define TELEMETRIA_UDP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------- Formato do datagrama ---------- */
+// Cabeçalho seguido de 1 a TELEMETRIA_UDP_LOTE_MAX amostras, tudo em
+// little-endian e sem preenchimento (ver tools/receptor_udp.py).
+#define TELEMETRIA_UDP_MAGICO 0x5450 // "PT"
+#define TELEMETRIA_UDP_VERSAO 2
+#define TELEMETRIA_UDP_LOTE_MAX 16   // Amostras por datagrama
+#define TELEMETRIA_UDP_PORTA_PADRAO 5005
+
+typedef struct __attribute__((packed)) {
+    uint16_t magico;
+    uint8_t versao;
+    uint8_t amostras;    // Amostras neste datagrama
+    uint32_t sequencia;  // Conta datagramas desde o início do fluxo; um salto indica perda
+    uint32_t envio_us;   // Instante do envio (time_us_32), para o jitter
+} TelemetriaUdpCabecalho;
+
+// Bits de TelemetriaUdpAmostra.estado
+#define TELEMETRIA_UDP_SENSOR_OK (1u << 0)
+#define TELEMETRIA_UDP_CRITICA (1u << 1)
+#define TELEMETRIA_UDP_MODO_SHIFT 2 // 2 bits com o ModoControle
+
+typedef struct __attribute__((packed)) {
+    uint32_t instante_us;      // time_us_32 da captura
+    uint8_t zona;
+    uint8_t estado;
+    uint16_t ciclo;            // Ciclo de controle que produziu os valores
+    int16_t temperatura_bruta; // Centésimos de °C
+    int16_t temperatura;       // Centésimos de °C, saída do filtro
+    int16_t setpoint;          // Centésimos de °C
+    int16_t integral;          // Centésimos
+    uint16_t angulo;           // Décimos de grau, comandado pelo controle
+    uint8_t ventoinha;         // %, comandada pelo controle
+    uint16_t angulo_atual;     // Décimos de grau, saída do perfil de movimento
+    uint8_t ventoinha_atual;   // %, saída da rampa
+    uint8_t umidade;           // %
+} TelemetriaUdpAmostra;
+
+/* ---------- Métricas ---------- */
+typedef struct {
+    uint32_t pacotes;
+    uint32_t amostras;
+    uint32_t erros_envio; // Sem memória para o pbuf ou recusado pelo lwIP
+} TelemetriaUdpEstatisticas;
+
+/* ---------- API ---------- */
+// Tudo roda no laço principal e nada bloqueia: um datagrama que o lwIP não
+// aceitar é contado como erro e descartado.
+
+// Ativa (ou reconfigura) o fluxo para @p destino (IPv4) e @p porta, juntando
+// @p amostras_por_pacote amostras por datagrama. Reinicia a sequência.
+bool telemetria_udp_iniciar(const char *destino, uint16_t porta, uint8_t amostras_por_pacote);
+
+// Indica se @p destino é um endereço IPv4 aceito por telemetria_udp_iniciar().
+bool telemetria_udp_destino_valido(const char *destino);
+
+// Envia o lote parcial e desativa o fluxo.
+void telemetria_udp_parar(void);
+
+bool telemetria_udp_ativa(void);
+
+// Acrescenta uma amostra ao lote; o datagrama sai quando o lote enche.
+void telemetria_udp_adicionar(const TelemetriaUdpAmostra *amostra);
+
+// Copia as métricas do fluxo atual.
+void telemetria_udp_estatisticas(TelemetriaUdpEstatisticas *estatisticas);
+
+#endif // TELEMETRIA_UDP_H
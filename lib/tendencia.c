@@ -0,0 +1,89 @@
+#include <math.h>
+#include "tendencia.h"
+
+static int16_t centesimos(float valor)
+{
+    float v = roundf(valor * 100.0f);
+    return v < INT16_MIN ? INT16_MIN : v > INT16_MAX ? INT16_MAX : (int16_t)v;
+}
+
+void tendencia_iniciar(Tendencia *tendencia, uint8_t amostras_por_coluna)
+{
+    *tendencia = (Tendencia){
+        .amostras_por_coluna = amostras_por_coluna ? amostras_por_coluna : 1,
+    };
+}
+
+int tendencia_num_colunas(const Tendencia *tendencia)
+{
+    return tendencia->quantidade + (tendencia->amostras_parcial > 0);
+}
+
+const TendenciaColuna *tendencia_coluna(const Tendencia *tendencia, int indice)
+{
+    if (indice == tendencia->quantidade)
+        return &tendencia->parcial;
+    return &tendencia->colunas[(tendencia->inicio + indice) % TENDENCIA_COLUNAS];
+}
+
+static void atualizar_escala(Tendencia *tendencia)
+{
+    int16_t minimo = INT16_MAX, maximo = INT16_MIN;
+    int n = tendencia_num_colunas(tendencia);
+    for (int i = 0; i < n; i++)
+    {
+        const TendenciaColuna *c = tendencia_coluna(tendencia, i);
+        int16_t baixo = c->minimo < c->setpoint ? c->minimo : c->setpoint;
+        int16_t alto = c->maximo > c->setpoint ? c->maximo : c->setpoint;
+        if (baixo < minimo)
+            minimo = baixo;
+        if (alto > maximo)
+            maximo = alto;
+    }
+
+    float escala_min = floorf(minimo / 100.0f);
+    float escala_max = ceilf(maximo / 100.0f);
+    if (escala_max - escala_min < TENDENCIA_FAIXA_MIN)
+    {
+        float folga = ceilf((TENDENCIA_FAIXA_MIN - (escala_max - escala_min)) / 2.0f);
+        escala_min -= folga;
+        escala_max += folga;
+    }
+    tendencia->escala_min = escala_min;
+    tendencia->escala_max = escala_max;
+}
+
+void tendencia_adicionar(Tendencia *tendencia, float temperatura, float setpoint)
+{
+    int16_t valor = centesimos(temperatura);
+    TendenciaColuna *parcial = &tendencia->parcial;
+    if (tendencia->amostras_parcial == 0)
+    {
+        parcial->minimo = parcial->maximo = valor;
+    }
+    else
+    {
+        if (valor < parcial->minimo)
+            parcial->minimo = valor;
+        if (valor > parcial->maximo)
+            parcial->maximo = valor;
+    }
+    parcial->setpoint = centesimos(setpoint);
+
+    if (++tendencia->amostras_parcial == tendencia->amostras_por_coluna)
+    {
+        // Fecha a coluna; com o buffer cheio a mais antiga sai
+        if (tendencia->quantidade == TENDENCIA_COLUNAS)
+        {
+            tendencia->inicio = (tendencia->inicio + 1) % TENDENCIA_COLUNAS;
+            tendencia->quantidade--;
+        }
+        tendencia->colunas[(tendencia->inicio + tendencia->quantidade) % TENDENCIA_COLUNAS] = *parcial;
+        tendencia->quantidade++;
+        tendencia->amostras_parcial = 0;
+        tendencia->colunas_fechadas++;
+    }
+
+    tendencia->versao++;
+    atualizar_escala(tendencia);
+}
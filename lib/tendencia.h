@@ -0,0 +1,50 @@
+#ifndef TENDENCIA_H
+#define TENDENCIA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------- Limites ---------- */
+#define TENDENCIA_COLUNAS 96     // Colunas guardadas (uma por pixel do gráfico)
+#define TENDENCIA_FAIXA_MIN 2.0f // Menor faixa da escala automática (°C), evita ampliar ruído
+
+/* ---------- Coluna: resumo de várias amostras ---------- */
+// Valores em centésimos de °C; mínimo e máximo preservam picos que a média esconderia.
+typedef struct {
+    int16_t minimo;
+    int16_t maximo;
+    int16_t setpoint;  // Último setpoint do intervalo
+} TendenciaColuna;
+
+/* ---------- Histórico de uma zona ---------- */
+// Buffer circular de colunas, cada uma resumindo @p amostras_por_coluna amostras.
+// A coluna em formação também é exibida, então o gráfico anda a cada amostra.
+typedef struct {
+    TendenciaColuna colunas[TENDENCIA_COLUNAS];
+    uint8_t inicio;            // colunas[inicio] é a mais antiga
+    uint8_t quantidade;        // Colunas fechadas
+    TendenciaColuna parcial;
+    uint8_t amostras_parcial;
+    uint8_t amostras_por_coluna;
+    uint32_t colunas_fechadas; // Desde o início; mantém o tracejado do setpoint preso aos dados
+    uint32_t versao;           // Muda a cada amostra (o gráfico compara para saber se redesenha)
+
+    // Escala automática, em graus inteiros, cobrindo temperaturas e setpoints guardados
+    float escala_min;
+    float escala_max;
+} Tendencia;
+
+/* ---------- API ---------- */
+
+void tendencia_iniciar(Tendencia *tendencia, uint8_t amostras_por_coluna);
+
+// Acrescenta uma amostra e atualiza a escala (custo limitado a TENDENCIA_COLUNAS).
+void tendencia_adicionar(Tendencia *tendencia, float temperatura, float setpoint);
+
+// Colunas disponíveis, incluindo a que está em formação.
+int tendencia_num_colunas(const Tendencia *tendencia);
+
+// Coluna @p indice, da mais antiga (0) à mais recente (a em formação, se houver).
+const TendenciaColuna *tendencia_coluna(const Tendencia *tendencia, int indice);
+
+#endif // TENDENCIA_H
@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <string.h>
+#include "widget.h"
+
+// Altura em pixels de um valor na faixa do widget (0 a altura)
+static uint8_t altura_em_pixels(const Widget *widget, float valor)
+{
+    float fracao = (valor - widget->minimo) / (widget->maximo - widget->minimo);
+    if (!(fracao > 0.0f)) // Também trata NaN
+        return 0;
+    if (fracao >= 1.0f)
+        return widget->altura;
+    return (uint8_t)(fracao * widget->altura + 0.5f);
+}
+
+static void definir_texto(Widget *widget, const char *texto)
+{
+    if (strcmp(widget->texto, texto) == 0)
+        return;
+    snprintf(widget->texto, sizeof(widget->texto), "%s", texto);
+    widget->sujo = true;
+}
+
+void widget_texto(Widget *widget, const char *texto)
+{
+    widget->tem_valor = false;
+    definir_texto(widget, texto);
+}
+
+void widget_valor(Widget *widget, float valor)
+{
+    if (widget->tem_valor && valor == widget->valor)
+        return;
+    widget->tem_valor = true;
+    widget->valor = valor;
+
+    char texto[WIDGET_TEXTO_MAX];
+    snprintf(texto, sizeof(texto), widget->formato, valor);
+    definir_texto(widget, texto);
+}
+
+void widget_barra(Widget *widget, float valor)
+{
+    uint8_t nivel = altura_em_pixels(widget, valor);
+    if (widget->tem_valor && nivel == widget->nivel)
+        return;
+    widget->tem_valor = true;
+    widget->nivel = nivel;
+    widget->sujo = true;
+}
+
+void widget_sparkline(Widget *widget, const Tendencia *serie)
+{
+    if (widget->serie == serie && widget->versao == serie->versao)
+        return;
+    widget->serie = serie;
+    widget->versao = serie->versao;
+    widget->sujo = true;
+}
+
+// Os desenhos escrevem cada pixel com o valor final em vez de apagar e
+// redesenhar: só os bytes que realmente mudam entram na região suja do display.
+
+static void desenhar_texto(ssd1306_t *ssd, Widget *widget)
+{
+    const ssd1306_font_t *fonte = widget->fonte ? widget->fonte : &ssd1306_font_small;
+    uint8_t largura = ssd1306_draw_text(ssd, fonte, widget->texto, widget->x, widget->y);
+    // A fonte é proporcional: um texto mais curto em pixels deixa sobra à direita
+    for (uint8_t dx = largura; dx < widget->desenhado_largura; dx++)
+        ssd1306_column(ssd, widget->x + dx, widget->y, widget->y + fonte->height - 1, 0);
+    widget->desenhado_largura = largura;
+}
+
+static void desenhar_barra(ssd1306_t *ssd, const Widget *widget)
+{
+    uint8_t fundo = widget->y + widget->altura - 1;
+    uint64_t bits = widget->nivel ? ssd1306_span_bits(fundo - widget->nivel + 1, fundo) : 0;
+    for (uint8_t dx = 0; dx < widget->largura; dx++)
+        ssd1306_column(ssd, widget->x + dx, widget->y, fundo, bits);
+}
+
+// Linha do display (dentro da área do widget) de um valor em centésimos de °C
+static int linha_do_valor(const Widget *widget, int16_t centesimos)
+{
+    const Tendencia *serie = widget->serie;
+    float fracao = (centesimos / 100.0f - serie->escala_min) / (serie->escala_max - serie->escala_min);
+    int nivel = (int)(fracao * (widget->altura - 1) + 0.5f);
+    if (nivel < 0)
+        nivel = 0;
+    if (nivel > widget->altura - 1)
+        nivel = widget->altura - 1;
+    return widget->y + widget->altura - 1 - nivel;
+}
+
+// Cada coluna é um único segmento vertical cobrindo o mínimo e o máximo do
+// intervalo, esticado até a coluna anterior para não deixar buracos. O custo
+// é fixo: largura x páginas da área, independente do histórico.
+static void desenhar_sparkline(ssd1306_t *ssd, const Widget *widget)
+{
+    const Tendencia *serie = widget->serie;
+    uint8_t fundo = widget->y + widget->altura - 1;
+    int n = tendencia_num_colunas(serie);
+    int primeira = n - widget->largura; // Os dados ficam alinhados à direita
+    uint32_t absoluta_base = serie->colunas_fechadas - serie->quantidade;
+
+    for (int coluna = 0; coluna < widget->largura; coluna++)
+    {
+        int k = primeira + coluna;
+        uint64_t bits = 0;
+        if (k >= 0)
+        {
+            const TendenciaColuna *c = tendencia_coluna(serie, k);
+            int16_t baixo = c->minimo, alto = c->maximo;
+            if (k > 0)
+            {
+                const TendenciaColuna *anterior = tendencia_coluna(serie, k - 1);
+                if (anterior->maximo < baixo)
+                    baixo = anterior->maximo;
+                if (anterior->minimo > alto)
+                    alto = anterior->minimo;
+            }
+            // Linhas crescem para baixo: o valor alto fica na linha menor
+            bits = ssd1306_span_bits(linha_do_valor(widget, alto), linha_do_valor(widget, baixo));
+            if ((absoluta_base + k) % 2 == 0)
+                bits |= 1ull << linha_do_valor(widget, c->setpoint);
+        }
+        ssd1306_column(ssd, widget->x + coluna, widget->y, fundo, bits);
+    }
+}
+
+void tela_mostrar(ssd1306_t *ssd, Tela *tela)
+{
+    ssd1306_fill(ssd, false);
+    for (int i = 0; i < tela->quantidade; i++)
+    {
+        Widget *widget = &tela->widgets[i];
+        if (widget->tipo == WIDGET_ROTULO && widget->inicial && widget->texto[0] == '\0')
+            definir_texto(widget, widget->inicial);
+        widget->desenhado_largura = 0;
+        widget->sujo = true;
+        if (widget->tipo == WIDGET_SPARKLINE && !widget->serie)
+            widget->sujo = false; // Nada para desenhar até widget_sparkline()
+    }
+}
+
+int tela_desenhar(ssd1306_t *ssd, Tela *tela)
+{
+    int redesenhados = 0;
+    for (int i = 0; i < tela->quantidade; i++)
+    {
+        Widget *widget = &tela->widgets[i];
+        if (!widget->sujo)
+            continue;
+
+        switch (widget->tipo)
+        {
+        case WIDGET_ROTULO:
+        case WIDGET_VALOR:
+            desenhar_texto(ssd, widget);
+            break;
+        case WIDGET_BARRA:
+            desenhar_barra(ssd, widget);
+            break;
+        case WIDGET_SPARKLINE:
+            desenhar_sparkline(ssd, widget);
+            break;
+        }
+        widget->sujo = false;
+        widget->redesenhos++;
+        redesenhados++;
+    }
+    tela->redesenhos += redesenhados;
+    return redesenhados;
+}
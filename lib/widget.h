@@ -0,0 +1,75 @@
+#ifndef WIDGET_H
+#define WIDGET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ssd1306.h"
+#include "tendencia.h"
+
+/* ---------- Limites ---------- */
+#define WIDGET_TEXTO_MAX 32 // Texto em UTF-8: acentos e '°' ocupam 2 bytes
+
+/* ---------- Tipos de widget ---------- */
+typedef enum {
+    WIDGET_ROTULO,   // Texto fixo ou trocado por widget_texto()
+    WIDGET_VALOR,    // Número formatado com @p formato (ex: "Set: %.1f C")
+    WIDGET_BARRA,    // Barra vertical preenchida de baixo para cima
+    WIDGET_SPARKLINE // Histórico de uma Tendencia: faixa mín-máx por coluna e setpoint tracejado
+} WidgetTipo;
+
+/* ---------- Widget retido ---------- */
+// Guarda o que está desenhado: o valor ligado é comparado com o anterior e o
+// widget só é redesenhado quando o resultado na tela muda. Os campos até
+// @p maximo são a declaração; o resto é estado.
+typedef struct {
+    WidgetTipo tipo;
+    uint8_t x, y;
+    uint8_t largura, altura;  // BARRA e SPARKLINE: área do gráfico
+    const ssd1306_font_t *fonte; // ROTULO e VALOR: NULL usa a fonte pequena
+    const char *inicial;      // ROTULO: texto mostrado até o primeiro widget_texto()
+    const char *formato;      // VALOR: printf com um único float
+    float minimo, maximo;     // BARRA: faixa mapeada na altura (a SPARKLINE usa a escala da Tendencia)
+
+    // Estado retido
+    bool sujo;
+    bool tem_valor;
+    float valor;              // Último valor recebido (VALOR)
+    char texto[WIDGET_TEXTO_MAX];
+    uint8_t desenhado_largura; // Pixels de texto na tela, para apagar a sobra
+    uint8_t nivel;            // BARRA: altura desenhada em pixels
+    const Tendencia *serie;   // SPARKLINE: histórico desenhado e sua versão
+    uint32_t versao;
+    uint32_t redesenhos;
+} Widget;
+
+/* ---------- Tela: conjunto de widgets mostrados juntos ---------- */
+typedef struct {
+    Widget *widgets;
+    int quantidade;
+    uint32_t redesenhos;      // Total de widgets redesenhados nesta tela
+} Tela;
+
+/* ---------- API ---------- */
+// As funções de valor são baratas quando nada muda (uma comparação), então
+// podem ser chamadas a cada quadro com o valor atual.
+
+// Troca o texto de um ROTULO (ou de um VALOR, ex: "--" sem leitura).
+void widget_texto(Widget *widget, const char *texto);
+
+// Atualiza um VALOR; só formata de novo se o número mudou.
+void widget_valor(Widget *widget, float valor);
+
+// Atualiza uma BARRA; só redesenha se a altura em pixels mudou.
+void widget_barra(Widget *widget, float valor);
+
+// Liga a SPARKLINE a um histórico; redesenha quando ele recebe amostras ou
+// quando outro histórico é ligado (ex.: troca de zona).
+void widget_sparkline(Widget *widget, const Tendencia *serie);
+
+// Apaga o display e marca todos os widgets da tela para redesenho (troca de tela).
+void tela_mostrar(ssd1306_t *ssd, Tela *tela);
+
+// Desenha os widgets sujos e retorna quantos foram redesenhados.
+int tela_desenhar(ssd1306_t *ssd, Tela *tela);
+
+#endif // WIDGET_H
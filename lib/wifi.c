@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include "wifi.h"
+#include "log.h"
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/netif.h"
+
+static struct {
+    const char *ssid;
+    const char *senha;
+    struct netif *netif;
+    volatile WifiEstado estado;
+    uint32_t inicio_fase_ms;       // Início do join ou do DHCP, para o limite
+    uint32_t proxima_tentativa_ms;
+    WifiEstatisticas estatisticas;
+} wifi;
+
+static void agendar_tentativa(uint32_t agora_ms)
+{
+    wifi.estado = WIFI_AGUARDANDO;
+    wifi.proxima_tentativa_ms = agora_ms + wifi.estatisticas.backoff_ms;
+    wifi.estatisticas.backoff_ms *= 2;
+    if (wifi.estatisticas.backoff_ms > WIFI_BACKOFF_MAX_MS)
+        wifi.estatisticas.backoff_ms = WIFI_BACKOFF_MAX_MS;
+}
+
+// Contexto do lwIP: o driver do rádio sobe o enlace ao associar (e já inicia o
+// DHCP) e o derruba quando perde o ponto de acesso
+static void enlace_callback(struct netif *netif)
+{
+    uint32_t agora_ms = to_ms_since_boot(get_absolute_time());
+    if (netif_is_link_up(netif))
+    {
+        if (!wifi.estatisticas.associado_us)
+            wifi.estatisticas.associado_us = time_us_32();
+        wifi.estado = WIFI_AGUARDANDO_IP;
+        wifi.inicio_fase_ms = agora_ms;
+        return;
+    }
+    if (wifi.estado == WIFI_AGUARDANDO_IP || wifi.estado == WIFI_CONECTADO)
+    {
+        wifi.estatisticas.quedas++;
+        wifi.estatisticas.ip[0] = '\0';
+        LOG(LOG_AVISO, "Wi-Fi: enlace perdido, reconectando\n");
+        wifi.estatisticas.backoff_ms = WIFI_BACKOFF_INICIAL_MS;
+        agendar_tentativa(agora_ms);
+    }
+}
+
+// Contexto do lwIP: endereço obtido (ou perdido) pelo DHCP
+static void status_callback(struct netif *netif)
+{
+    if (!netif_is_up(netif) || ip4_addr_isany_val(*netif_ip4_addr(netif)) || !netif_is_link_up(netif))
+        return;
+    if (!wifi.estatisticas.endereco_us)
+        wifi.estatisticas.endereco_us = time_us_32();
+    wifi.estado = WIFI_CONECTADO;
+    wifi.estatisticas.conexoes++;
+    wifi.estatisticas.backoff_ms = WIFI_BACKOFF_INICIAL_MS;
+    ip4addr_ntoa_r(netif_ip4_addr(netif), wifi.estatisticas.ip, sizeof(wifi.estatisticas.ip));
+    LOG(LOG_INFO, "Wi-Fi: conectado a %s, IP %s\n", wifi.ssid, wifi.estatisticas.ip);
+}
+
+static void associar(uint32_t agora_ms)
+{
+    cyw43_arch_lwip_begin();
+    wifi.estatisticas.tentativas++;
+    wifi.inicio_fase_ms = agora_ms;
+    if (cyw43_arch_wifi_connect_async(wifi.ssid, wifi.senha, CYW43_AUTH_WPA2_AES_PSK) == 0)
+    {
+        wifi.estado = WIFI_ASSOCIANDO;
+    }
+    else
+    {
+        wifi.estatisticas.falhas++;
+        agendar_tentativa(agora_ms);
+    }
+    cyw43_arch_lwip_end();
+}
+
+// Desiste do join ou do DHCP em andamento e agenda outra tentativa
+static void falhar(uint32_t agora_ms, const char *motivo)
+{
+    cyw43_arch_lwip_begin();
+    cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+    wifi.estatisticas.falhas++;
+    agendar_tentativa(agora_ms);
+    cyw43_arch_lwip_end();
+    LOG(LOG_AVISO, "Wi-Fi: %s, nova tentativa em %lu ms\n", motivo,
+        (unsigned long)(wifi.proxima_tentativa_ms - agora_ms));
+}
+
+bool wifi_iniciar(const char *ssid, const char *senha)
+{
+    wifi.ssid = ssid;
+    wifi.senha = senha;
+    if (cyw43_arch_init())
+        return false;
+    cyw43_arch_enable_sta_mode();
+    wifi.estatisticas.iniciado_us = time_us_32();
+
+    wifi.netif = &cyw43_state.netif[CYW43_ITF_STA];
+    cyw43_arch_lwip_begin();
+    netif_set_link_callback(wifi.netif, enlace_callback);
+    netif_set_status_callback(wifi.netif, status_callback);
+    cyw43_arch_lwip_end();
+
+    wifi.estatisticas.backoff_ms = WIFI_BACKOFF_INICIAL_MS;
+    associar(to_ms_since_boot(get_absolute_time()));
+    LOG(LOG_INFO, "Wi-Fi: associando a %s em segundo plano\n", ssid);
+    return true;
+}
+
+void wifi_processar(uint32_t agora_ms)
+{
+    switch (wifi.estado)
+    {
+    case WIFI_AGUARDANDO:
+        if ((int32_t)(agora_ms - wifi.proxima_tentativa_ms) >= 0)
+            associar(agora_ms);
+        break;
+    case WIFI_ASSOCIANDO:
+    {
+        int status = cyw43_wifi_link_status(&cyw43_state, CYW43_ITF_STA);
+        if (status == CYW43_LINK_BADAUTH)
+            falhar(agora_ms, "senha recusada");
+        else if (status == CYW43_LINK_NONET)
+            falhar(agora_ms, "rede nao encontrada");
+        else if (status == CYW43_LINK_FAIL)
+            falhar(agora_ms, "falha na associacao");
+        else if (agora_ms - wifi.inicio_fase_ms > WIFI_ASSOCIACAO_MAX_MS)
+            falhar(agora_ms, "associacao expirou");
+        break;
+    }
+    case WIFI_AGUARDANDO_IP:
+        if (agora_ms - wifi.inicio_fase_ms > WIFI_ASSOCIACAO_MAX_MS)
+            falhar(agora_ms, "DHCP sem resposta");
+        break;
+    default:
+        break;
+    }
+}
+
+bool wifi_conectado(void)
+{
+    return wifi.estado == WIFI_CONECTADO;
+}
+
+void wifi_estatisticas(WifiEstatisticas *estatisticas)
+{
+    *estatisticas = wifi.estatisticas;
+    estatisticas->estado = wifi.estado;
+}
+
+const char *wifi_estado_str(WifiEstado estado)
+{
+    switch (estado)
+    {
+    case WIFI_DESLIGADO:
+        return "desligado";
+    case WIFI_AGUARDANDO:
+        return "aguardando";
+    case WIFI_ASSOCIANDO:
+        return "associando";
+    case WIFI_AGUARDANDO_IP:
+        return "aguardando_ip";
+    case WIFI_CONECTADO:
+        return "conectado";
+    }
+    return "?";
+}
@@ -0,0 +1,56 @@
+#ifndef WIFI_H
+#define WIFI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------- Limites ---------- */
+#define WIFI_ASSOCIACAO_MAX_MS 20000 // Tentativa sem resposta é refeita
+#define WIFI_BACKOFF_INICIAL_MS 1000
+#define WIFI_BACKOFF_MAX_MS 30000
+
+/* ---------- Estado da conexão ---------- */
+typedef enum {
+    WIFI_DESLIGADO,     // Rádio ainda não iniciado
+    WIFI_AGUARDANDO,    // Sem rede: próxima tentativa após o backoff
+    WIFI_ASSOCIANDO,    // Join em andamento
+    WIFI_AGUARDANDO_IP, // Associado, DHCP em andamento
+    WIFI_CONECTADO
+} WifiEstado;
+
+/* ---------- Métricas ---------- */
+typedef struct {
+    WifiEstado estado;
+    uint32_t tentativas;     // Joins iniciados
+    uint32_t falhas;         // Senha errada, rede ausente ou join expirado
+    uint32_t quedas;         // Enlace perdido depois de associado
+    uint32_t conexoes;       // Endereços obtidos por DHCP
+    uint32_t backoff_ms;
+    uint32_t iniciado_us;    // Instantes desde o boot (0 = ainda não): rádio pronto,
+    uint32_t associado_us;   // primeira associação
+    uint32_t endereco_us;    // e primeiro endereço
+    char ip[16];
+} WifiEstatisticas;
+
+/* ---------- API ---------- */
+// Nada bloqueia além de wifi_iniciar(), que carrega o firmware do rádio. O
+// join é assíncrono; os callbacks de enlace e de status da interface (contexto
+// do lwIP) acompanham a associação e o DHCP, e wifi_processar() refaz o join
+// com backoff exponencial depois de uma falha ou queda.
+
+// Inicia o rádio e o lwIP e dispara o primeiro join. As strings precisam
+// continuar válidas. Retorna false se o rádio não responder.
+bool wifi_iniciar(const char *ssid, const char *senha);
+
+// Passo periódico no laço principal.
+void wifi_processar(uint32_t agora_ms);
+
+bool wifi_conectado(void);
+
+// Copia as métricas da conexão.
+void wifi_estatisticas(WifiEstatisticas *estatisticas);
+
+// Nome curto do estado, para a telemetria.
+const char *wifi_estado_str(WifiEstado estado);
+
+#endif // WIFI_H
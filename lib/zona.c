@@ -0,0 +1,552 @@
+#include <stdio.h>
+#include <math.h>
+#include "zona.h"
+#include "log.h"
+#include "aht20.h"
+#include "i2c_fila.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+
+// === CONFIGURAÇÕES DO SERVO ===
+#define PULSO_MIN_US 500
+#define PULSO_MAX_US 2500
+
+// === RECUPERAÇÃO DO BARRAMENTO I2C ===
+#define PULSOS_RECUPERACAO 9 // Um byte mais o ACK: libera qualquer escravo no meio de uma leitura
+#define MEIO_PERIODO_US 5    // ~100 kHz
+
+static void configurar_pinos_i2c(const ZonaHardware *hw)
+{
+    gpio_set_function(hw->pino_sda, GPIO_FUNC_I2C);
+    gpio_set_function(hw->pino_scl, GPIO_FUNC_I2C);
+    gpio_pull_up(hw->pino_sda);
+    gpio_pull_up(hw->pino_scl);
+}
+
+// Libera um escravo que ficou segurando SDA em nível baixo (ex.: reset no meio de
+// uma transação): pulsa SCL até SDA subir, gera um STOP e reinicia o periférico.
+static void recuperar_barramento_i2c(const ZonaHardware *hw)
+{
+    // Transações pendentes terminam (no máximo por timeout) antes de desligar o periférico
+    i2c_fila_aguardar_ocioso(hw->porta_i2c);
+    i2c_deinit(hw->porta_i2c);
+
+    // Dreno aberto emulado: o pino é entrada (pull-up) para nível alto e saída em 0 para nível baixo
+    gpio_init(hw->pino_sda);
+    gpio_init(hw->pino_scl);
+    gpio_pull_up(hw->pino_sda);
+    gpio_pull_up(hw->pino_scl);
+    gpio_put(hw->pino_sda, false);
+    gpio_put(hw->pino_scl, false);
+
+    for (int i = 0; i < PULSOS_RECUPERACAO && !gpio_get(hw->pino_sda); i++)
+    {
+        gpio_set_dir(hw->pino_scl, GPIO_OUT);
+        sleep_us(MEIO_PERIODO_US);
+        gpio_set_dir(hw->pino_scl, GPIO_IN);
+        sleep_us(MEIO_PERIODO_US);
+    }
+
+    // STOP: SDA sobe com SCL em nível alto
+    gpio_set_dir(hw->pino_sda, GPIO_OUT);
+    sleep_us(MEIO_PERIODO_US);
+    gpio_set_dir(hw->pino_sda, GPIO_IN);
+    sleep_us(MEIO_PERIODO_US);
+
+    i2c_fila_iniciar(hw->porta_i2c, ZONA_I2C_FREQUENCIA_HZ);
+    configurar_pinos_i2c(hw);
+}
+
+float mapear_valores(float valor, float entrada_min, float entrada_max, float saida_min, float saida_max)
+{
+    return (valor - entrada_min) * (saida_max - saida_min) / (entrada_max - entrada_min) + saida_min;
+}
+
+// Divisor para @p frequencia_hz com 2^@p resolucao_bits passos; 0 se não couber
+// no divisor do hardware (8 bits inteiros e 4 fracionários)
+static float calcular_divisor(uint32_t frequencia_hz, uint8_t resolucao_bits)
+{
+    if (frequencia_hz == 0 || resolucao_bits < 8 || resolucao_bits > 16)
+        return 0.0f;
+    float divisor = (float)clock_get_hz(clk_sys) / ((float)frequencia_hz * (1u << resolucao_bits));
+    if (divisor < 1.0f || divisor >= 256.0f)
+        return 0.0f;
+    return divisor;
+}
+
+static void aplicar_pwm(uint pino, PwmConfig *pwm, float divisor)
+{
+    uint fatia = pwm_gpio_to_slice_num(pino);
+    pwm_config configuracao = pwm_get_default_config();
+    pwm_config_set_clkdiv(&configuracao, divisor);
+    pwm_config_set_wrap(&configuracao, (uint16_t)((1u << pwm->resolucao_bits) - 1));
+    pwm_init(fatia, &configuracao, true);
+    // O divisor tem 4 bits de fração: a frequência real difere um pouco da pedida
+    float divisor_real = (int)(divisor * 16.0f) / 16.0f;
+    pwm->frequencia_real = (float)clock_get_hz(clk_sys) / (divisor_real * (1u << pwm->resolucao_bits));
+}
+
+// Converte o ângulo (0-180) para a largura de pulso e a aplica no servo
+static void escrever_pulso_servo(Zona *zona, float angulo)
+{
+    float largura_us = mapear_valores(angulo, 0, 180, PULSO_MIN_US, PULSO_MAX_US);
+    float passos_por_us = zona->pwm_servo.frequencia_real * (1u << zona->pwm_servo.resolucao_bits) / 1e6f;
+    pwm_set_gpio_level(zona->hw.pino_servo, (uint16_t)(largura_us * passos_por_us));
+}
+
+// Ciclo de trabalho (%) que dá a velocidade pedida, pela curva da ventoinha
+static float duty_da_velocidade(const VentoinhaCurva *curva, float velocidade)
+{
+    if (!(velocidade > 0.0f))
+        return 0.0f;
+    float f = velocidade / 100.0f * (VENTOINHA_PONTOS_CURVA - 1);
+    if (f >= VENTOINHA_PONTOS_CURVA - 1)
+        return curva->duty[VENTOINHA_PONTOS_CURVA - 1];
+    int i = (int)f;
+    return curva->duty[i] + (f - i) * (curva->duty[i + 1] - curva->duty[i]);
+}
+
+static void escrever_duty_ventoinha(Zona *zona, float duty)
+{
+    uint32_t topo = (1u << zona->pwm_ventoinha.resolucao_bits) - 1;
+    pwm_set_gpio_level(zona->hw.pino_ena_pwm, (uint16_t)(duty * topo / 100.0f + 0.5f));
+}
+
+bool zona_inicializar_sensor(Zona *zona)
+{
+    // Um barramento dividido com o OLED já está configurado (e na mesma velocidade)
+    if (!i2c_fila_iniciado(zona->hw.porta_i2c))
+    {
+        i2c_fila_iniciar(zona->hw.porta_i2c, ZONA_I2C_FREQUENCIA_HZ);
+        configurar_pinos_i2c(&zona->hw);
+    }
+
+    monitor_sensor_iniciar(&zona->monitor);
+    zona->sensor_ok = aht20_init(zona->hw.porta_i2c, zona->hw.endereco_sensor);
+    if (!zona->sensor_ok)
+    {
+        monitor_sensor_forcar_falha(&zona->monitor, to_ms_since_boot(get_absolute_time()));
+        printf("ERRO: Falha ao inicializar sensor AHT20 da %s!\n", zona->hw.nome);
+        return false;
+    }
+    printf("Sensor AHT20 da %s inicializado com sucesso.\n", zona->hw.nome);
+    return true;
+}
+
+void zona_inicializar_atuadores(Zona *zona)
+{
+    // Configurações inválidas caem nos padrões
+    if (calcular_divisor(zona->pwm_servo.frequencia_hz, zona->pwm_servo.resolucao_bits) == 0.0f)
+        zona->pwm_servo = (PwmConfig)PWM_SERVO_PADRAO;
+    if (calcular_divisor(zona->pwm_ventoinha.frequencia_hz, zona->pwm_ventoinha.resolucao_bits) == 0.0f)
+        zona->pwm_ventoinha = (PwmConfig)PWM_VENTOINHA_PADRAO;
+
+    // Servo
+    gpio_set_function(zona->hw.pino_servo, GPIO_FUNC_PWM);
+    aplicar_pwm(zona->hw.pino_servo, &zona->pwm_servo,
+                calcular_divisor(zona->pwm_servo.frequencia_hz, zona->pwm_servo.resolucao_bits));
+    perfil_posicionar(&zona->perfil_servo, 90.0f); // Posição inicial do servo
+    escrever_pulso_servo(zona, 90.0f);
+    printf("Servo motor da %s inicializado no GPIO %d (%.1f Hz, %d bits).\n", zona->hw.nome,
+           zona->hw.pino_servo, zona->pwm_servo.frequencia_real, zona->pwm_servo.resolucao_bits);
+
+    // Ventoinha
+    gpio_init(zona->hw.pino_in1);
+    gpio_init(zona->hw.pino_in2);
+    gpio_set_dir(zona->hw.pino_in1, GPIO_OUT);
+    gpio_set_dir(zona->hw.pino_in2, GPIO_OUT);
+
+    gpio_put(zona->hw.pino_in1, true); // Define a direção de rotação
+    gpio_put(zona->hw.pino_in2, false);
+
+    gpio_set_function(zona->hw.pino_ena_pwm, GPIO_FUNC_PWM);
+    aplicar_pwm(zona->hw.pino_ena_pwm, &zona->pwm_ventoinha,
+                calcular_divisor(zona->pwm_ventoinha.frequencia_hz, zona->pwm_ventoinha.resolucao_bits));
+
+    perfil_posicionar(&zona->perfil_ventoinha, 0.0f);
+    zona->duty_ventoinha = 0.0f;
+    pwm_set_gpio_level(zona->hw.pino_ena_pwm, 0); // Garante que a ventoinha comece desligada
+    printf("Ventoinha da %s inicializada nos GPIOs %d, %d, %d (%.0f Hz, %d bits).\n", zona->hw.nome,
+           zona->hw.pino_in1, zona->hw.pino_in2, zona->hw.pino_ena_pwm, zona->pwm_ventoinha.frequencia_real,
+           zona->pwm_ventoinha.resolucao_bits);
+}
+
+bool zona_pwm_valido(uint32_t frequencia_hz, uint8_t resolucao_bits)
+{
+    return calcular_divisor(frequencia_hz, resolucao_bits) != 0.0f;
+}
+
+bool zona_configurar_pwm(Zona *zona, bool servo, uint32_t frequencia_hz, uint8_t resolucao_bits)
+{
+    float divisor = calcular_divisor(frequencia_hz, resolucao_bits);
+    if (divisor == 0.0f)
+        return false;
+
+    // A interrupção dos atuadores converte as saídas com a configuração: ela não
+    // pode ver a resolução nova com a frequência antiga
+    uint32_t interrupcoes = save_and_disable_interrupts();
+    PwmConfig *pwm = servo ? &zona->pwm_servo : &zona->pwm_ventoinha;
+    pwm->frequencia_hz = frequencia_hz;
+    pwm->resolucao_bits = resolucao_bits;
+    aplicar_pwm(servo ? zona->hw.pino_servo : zona->hw.pino_ena_pwm, pwm, divisor);
+    if (servo)
+        escrever_pulso_servo(zona, zona->perfil_servo.posicao);
+    else
+        escrever_duty_ventoinha(zona, zona->duty_ventoinha);
+    restore_interrupts(interrupcoes);
+    return true;
+}
+
+bool zona_disparar_leitura(Zona *zona)
+{
+    return aht20_trigger(zona->hw.porta_i2c, zona->hw.endereco_sensor);
+}
+
+bool zona_solicitar_resultado(Zona *zona)
+{
+    return aht20_request_result(zona->hw.porta_i2c, zona->hw.endereco_sensor, &zona->leitura);
+}
+
+AHT20_Result zona_ler_temperatura(Zona *zona, float *temperatura_atual, float *umidade)
+{
+    AHT20_Data dados_sensor;
+    AHT20_Result resultado = aht20_finish_result(&zona->leitura, &dados_sensor);
+    if (resultado == AHT20_OK)
+    {
+        *temperatura_atual = dados_sensor.temperature;
+        *umidade = dados_sensor.humidity;
+    }
+    else if (resultado == AHT20_ERRO_CRC || resultado == AHT20_ERRO_NAO_CALIBRADO)
+    {
+        zona->filtro.rejeitadas_sensor++;
+    }
+    return resultado;
+}
+
+void zona_confirmar_leitura_sensor(Zona *zona)
+{
+    if (monitor_sensor_sucesso(&zona->monitor))
+    {
+        filtro_reiniciar(&zona->filtro);
+        zona->termo_integral = 0.0f;
+        LOG(LOG_INFO, "[%s] Sensor recuperado.\n", zona->hw.nome);
+    }
+    zona->sensor_ok = true;
+}
+
+void zona_tratar_falha_sensor(Zona *zona, uint32_t agora_ms)
+{
+    zona->sensor_ok = false;
+    MonitorAcao acao = monitor_sensor_falha(&zona->monitor, agora_ms);
+
+    // Em falha os atuadores vão para a posição segura; instável mantém a última saída.
+    // Com a temperatura crítica quem comanda é o supervisor.
+    if (zona->monitor.estado == SENSOR_EM_FALHA && !zona->temperatura_critica)
+    {
+        zona_definir_angulo_servo(zona, zona->angulo_seguro);
+        zona_definir_velocidade_ventoinha(zona, zona->ventoinha_segura);
+        zona->angulo_alvo = zona->angulo_seguro;
+        zona->velocidade_ventoinha = zona->ventoinha_segura;
+    }
+
+    if (acao != MONITOR_ACAO_RECUPERAR)
+        return;
+
+    recuperar_barramento_i2c(&zona->hw);
+    bool sucesso = aht20_reset(zona->hw.porta_i2c, zona->hw.endereco_sensor);
+    monitor_sensor_resultado_recuperacao(&zona->monitor, sucesso, agora_ms);
+    LOG(LOG_AVISO, "[%s] Recuperacao do sensor (tentativa %lu): %s\n", zona->hw.nome,
+           (unsigned long)zona->monitor.tentativas_recuperacao, sucesso ? "ok" : "falhou");
+}
+
+bool zona_filtrar_temperatura(Zona *zona, float amostra, float *temperatura_filtrada)
+{
+    return filtro_atualizar(&zona->filtro, amostra, zona->velocidade_ventoinha, temperatura_filtrada);
+}
+
+void zona_definir_angulo_servo(Zona *zona, float angulo)
+{
+    perfil_definir_alvo(&zona->perfil_servo, angulo);
+}
+
+void zona_definir_velocidade_ventoinha(Zona *zona, float porcentagem)
+{
+    if (porcentagem > 100.0f)
+        porcentagem = 100.0f;
+    if (porcentagem < 0.0f)
+        porcentagem = 0.0f;
+    perfil_definir_alvo(&zona->perfil_ventoinha, porcentagem);
+}
+
+void zona_forcar_resfriamento_maximo(Zona *zona)
+{
+    zona_definir_angulo_servo(zona, ANGULO_ABERTURA_TOTAL);
+    zona_definir_velocidade_ventoinha(zona, 100.0f);
+}
+
+void zona_atualizar_atuadores(Zona *zona, float dt)
+{
+    escrever_pulso_servo(zona, perfil_avancar(&zona->perfil_servo, dt));
+
+    const VentoinhaCurva *curva = &zona->curva_ventoinha;
+    float duty = duty_da_velocidade(curva, perfil_avancar(&zona->perfil_ventoinha, dt));
+    if (duty > 0.0f && zona->duty_ventoinha == 0.0f)
+        zona->partida_restante_s = curva->partida_s; // Partindo da ventoinha parada
+    if (duty > 0.0f && zona->partida_restante_s > 0.0f)
+    {
+        if (duty < curva->partida_duty)
+            duty = curva->partida_duty;
+        zona->partida_restante_s -= dt;
+    }
+    else
+    {
+        zona->partida_restante_s = 0.0f;
+    }
+    zona->duty_ventoinha = duty;
+    escrever_duty_ventoinha(zona, duty);
+}
+
+void zona_definir_setpoint(Zona *zona, float setpoint)
+{
+    perfil_definir_alvo(&zona->perfil_setpoint, setpoint);
+}
+
+void zona_definir_taxa_setpoint(Zona *zona, float taxa)
+{
+    zona->perfil_setpoint.velocidade_max = taxa / 60.0f;
+    zona->perfil_setpoint.aceleracao_max = taxa / 60.0f / SETPOINT_TEMPO_ACELERACAO_S;
+}
+
+void zona_avancar_setpoint(Zona *zona, float dt)
+{
+    zona->temperatura_desejada = perfil_avancar(&zona->perfil_setpoint, dt);
+}
+
+static void limitar_integral(Zona *zona)
+{
+    if (zona->termo_integral > zona->integral_max)
+        zona->termo_integral = zona->integral_max;
+    if (zona->termo_integral < zona->integral_min)
+        zona->termo_integral = zona->integral_min;
+}
+
+void zona_ganhos_escalonados(const Zona *zona, float erro, float *ganho_p, float *ganho_i)
+{
+    const Escalonamento *tabela = &zona->escalonamento;
+    if (!zona->escalonamento_ativo || tabela->quantidade == 0)
+    {
+        *ganho_p = zona->ganho_p;
+        *ganho_i = zona->ganho_i;
+        return;
+    }
+    float valor = tabela->chave == ESCALONAMENTO_SETPOINT ? zona->temperatura_desejada : fabsf(erro);
+    escalonamento_ganhos(tabela, valor, ganho_p, ganho_i);
+}
+
+float zona_calcular_controle_pi(Zona *zona, float temperatura_atual)
+{
+    float erro = temperatura_atual - zona->temperatura_desejada;
+    float ganho_p, ganho_i;
+    zona_ganhos_escalonados(zona, erro, &ganho_p, &ganho_i);
+
+    // Sem solavanco: Kp·e + integral fica igual com o Kp novo. O Ki já entra
+    // multiplicando cada incremento do integral, então sua troca não dá salto
+    zona->termo_integral += (zona->ganho_p_aplicado - ganho_p) * erro;
+    zona->ganho_p_aplicado = ganho_p;
+    zona->ganho_i_aplicado = ganho_i;
+
+    float termo_proporcional = ganho_p * erro;
+    zona->termo_integral += ganho_i * erro * PERIODO_AMOSTRA; // Acumula o erro
+
+    // Limita o termo integral para evitar sobrecarga (anti-windup)
+    limitar_integral(zona);
+
+    return termo_proporcional + zona->termo_integral;
+}
+
+float zona_calcular_feedforward(const Zona *zona)
+{
+    if (!zona->feedforward_ativo || !zona->feedforward)
+        return 0.0f;
+    return feedforward_calcular(zona->feedforward, zona->temperatura_desejada, zona->umidade,
+                                zona->temperatura_ambiente);
+}
+
+void zona_definir_feedforward(Zona *zona, bool ativo)
+{
+    if (!zona->feedforward || ativo == zona->feedforward_ativo)
+        return;
+
+    float termo = feedforward_calcular(zona->feedforward, zona->temperatura_desejada, zona->umidade,
+                                       zona->temperatura_ambiente);
+    zona->termo_integral += ativo ? -termo : termo;
+    limitar_integral(zona);
+    zona->feedforward_ativo = ativo;
+}
+
+// Fração (0 a 1) de uma faixa [inicio, fim] da demanda normalizada
+static float fracao_da_faixa(float demanda, float inicio, float fim)
+{
+    if (demanda <= inicio)
+        return 0.0f;
+    if (demanda >= fim)
+        return 1.0f;
+    return (demanda - inicio) / (fim - inicio);
+}
+
+void zona_alocar_demanda(const Zona *zona, float demanda, float *angulo, float *ventoinha)
+{
+    if (zona->alocacao == ALOCACAO_PARALELA)
+    {
+        *angulo = demanda;
+        if (*angulo > zona->angulo_max)
+            *angulo = zona->angulo_max;
+        if (*angulo < zona->angulo_min)
+            *angulo = zona->angulo_min;
+        // Mapeia o ângulo do servo (0-180°) para a velocidade da ventoinha (0-100%)
+        *ventoinha = mapear_valores(*angulo, 0.0f, 180.0f, 0.0f, 100.0f);
+        return;
+    }
+
+    float d = fracao_da_faixa(demanda, 0.0f, ANGULO_ABERTURA_TOTAL);
+    float meia_sobreposicao = zona->alocacao == ALOCACAO_FAIXA_DIVIDIDA ? zona->sobreposicao / 2.0f : 0.0f;
+    float fim_servo = zona->divisao + meia_sobreposicao;
+    float inicio_ventoinha = zona->divisao - meia_sobreposicao;
+    if (fim_servo > 1.0f)
+        fim_servo = 1.0f;
+    if (inicio_ventoinha < 0.0f)
+        inicio_ventoinha = 0.0f;
+
+    *angulo = zona->angulo_min + fracao_da_faixa(d, 0.0f, fim_servo) * (zona->angulo_max - zona->angulo_min);
+    *ventoinha = 100.0f * fracao_da_faixa(d, inicio_ventoinha, 1.0f);
+}
+
+void zona_aplicar_controle(Zona *zona, float temperatura_atual)
+{
+    float erro = temperatura_atual - zona->temperatura_desejada;
+    float angulo_alvo = 90.0f;
+    float velocidade_ventoinha = 0.0f;
+    float termo_feedforward = 0.0f;
+    float demanda = 90.0f;
+
+    if (zona->temperatura_critica)
+    {
+        // Acima do limite crítico o resfriamento máximo vale em qualquer modo
+        angulo_alvo = ANGULO_ABERTURA_TOTAL;
+        velocidade_ventoinha = 100.0f;
+    }
+    else if (zona->modo != MODO_DESLIGADO)
+    {
+        if (zona->modo == MODO_MANUAL)
+        {
+            // Ângulo manual dentro dos limites; a ventoinha segue o ângulo, a não
+            // ser que tenha a própria velocidade manual
+            angulo_alvo = demanda = zona->angulo_manual;
+            if (angulo_alvo > zona->angulo_max)
+                angulo_alvo = zona->angulo_max;
+            if (angulo_alvo < zona->angulo_min)
+                angulo_alvo = zona->angulo_min;
+            velocidade_ventoinha = isnan(zona->ventoinha_manual)
+                                       ? mapear_valores(angulo_alvo, 0.0f, 180.0f, 0.0f, 100.0f)
+                                       : zona->ventoinha_manual;
+        }
+        else
+        {
+            // A demanda parte de 90° e é ajustada pelo sinal de controle; o avanço
+            // já leva ao regime do setpoint assim que ele muda
+            termo_feedforward = zona_calcular_feedforward(zona);
+            demanda = 90.0f + zona_calcular_controle_pi(zona, temperatura_atual) + termo_feedforward;
+            zona_alocar_demanda(zona, demanda, &angulo_alvo, &velocidade_ventoinha);
+        }
+    }
+
+    zona_definir_angulo_servo(zona, angulo_alvo);
+    zona_definir_velocidade_ventoinha(zona, velocidade_ventoinha);
+
+    // Imprime o status atual da zona no monitor serial
+    LOG(LOG_INFO, "[%s] Temp: %.2f C | Setpoint: %.2f C | Erro: %.2f | Servo: %.1f deg (em %.1f) | Ventoinha (motor): %.0f%% (em %.0f%%)\n",
+        zona->hw.nome, temperatura_atual, zona->temperatura_desejada, erro, angulo_alvo,
+        zona->perfil_servo.posicao, velocidade_ventoinha, zona->perfil_ventoinha.posicao);
+
+    // Guarda a amostra para o display e para o servidor HTTP
+    zona->temperatura_atual = temperatura_atual;
+    zona->erro = erro;
+    zona->termo_feedforward = termo_feedforward;
+    zona->demanda = demanda;
+    zona->angulo_alvo = angulo_alvo;
+    zona->velocidade_ventoinha = velocidade_ventoinha;
+}
+
+void zona_amostrar(const Zona *zona, ZonaAmostra *amostra)
+{
+    *amostra = (ZonaAmostra){
+        .temperatura_bruta = zona->temperatura_bruta,
+        .temperatura_atual = zona->temperatura_atual,
+        .umidade = zona->umidade,
+        .temperatura_desejada = zona->temperatura_desejada,
+        .setpoint_alvo = zona->perfil_setpoint.alvo,
+        .erro = zona->erro,
+        .termo_integral = zona->termo_integral,
+        .termo_feedforward = zona->termo_feedforward,
+        .demanda = zona->demanda,
+        .angulo_alvo = zona->angulo_alvo,
+        .velocidade_ventoinha = zona->velocidade_ventoinha,
+        .modo = zona->modo,
+        .sensor_ok = zona->sensor_ok,
+        .temperatura_critica = zona->temperatura_critica,
+        .sensor_estado = zona->monitor.estado,
+        .sensor_falhas = zona->monitor.total_falhas,
+        .sensor_tentativas_recuperacao = zona->monitor.tentativas_recuperacao,
+        .sensor_recuperacoes = zona->monitor.recuperacoes,
+        .ganho_p_aplicado = zona->ganho_p_aplicado,
+        .ganho_i_aplicado = zona->ganho_i_aplicado,
+        .estimativa = zona->filtro.estimativa,
+        .variancia = zona->filtro.variancia,
+        .filtro_amostras = zona->filtro.amostras,
+        .rejeitadas_outlier = zona->filtro.rejeitadas_outlier,
+        .rejeitadas_sensor = zona->filtro.rejeitadas_sensor,
+        .latencia_us = zona->latencia_us,
+        .latencia_max_us = zona->latencia_max_us,
+        .tempo_filtro_us = zona->tempo_filtro_us,
+        .servo_alvo = zona->perfil_servo.alvo,
+        .servo_posicao = zona->perfil_servo.posicao,
+        .servo_velocidade = zona->perfil_servo.velocidade,
+        .servo_ignorados = zona->perfil_servo.alvos_ignorados,
+        .ventoinha_alvo = zona->perfil_ventoinha.alvo,
+        .ventoinha_posicao = zona->perfil_ventoinha.posicao,
+        .duty_ventoinha = zona->duty_ventoinha,
+    };
+}
+
+void zona_copiar_config(const Zona *zona, ZonaConfig *config)
+{
+    *config = (ZonaConfig){
+        .taxa_setpoint = zona->perfil_setpoint.velocidade_max * 60.0f,
+        .ganho_p = zona->ganho_p,
+        .ganho_i = zona->ganho_i,
+        .integral_max = zona->integral_max,
+        .angulo_min = zona->angulo_min,
+        .angulo_max = zona->angulo_max,
+        .angulo_manual = zona->angulo_manual,
+        .ventoinha_manual = zona->ventoinha_manual,
+        .angulo_seguro = zona->angulo_seguro,
+        .ventoinha_segura = zona->ventoinha_segura,
+        .alocacao = zona->alocacao,
+        .divisao = zona->divisao,
+        .sobreposicao = zona->sobreposicao,
+        .servo_velocidade_max = zona->perfil_servo.velocidade_max,
+        .servo_aceleracao_max = zona->perfil_servo.aceleracao_max,
+        .servo_banda_morta = zona->perfil_servo.banda_morta,
+        .ventoinha_rampa = zona->perfil_ventoinha.velocidade_max,
+        .pwm_servo = zona->pwm_servo,
+        .pwm_ventoinha = zona->pwm_ventoinha,
+        .curva_ventoinha = zona->curva_ventoinha,
+        .filtro = zona->filtro.cfg,
+        .escalonamento = zona->escalonamento,
+        .escalonamento_ativo = zona->escalonamento_ativo,
+        .feedforward = zona->feedforward,
+        .feedforward_ativo = zona->feedforward_ativo,
+        .temperatura_ambiente = zona->temperatura_ambiente,
+    };
+}
@@ -0,0 +1,367 @@
+#ifndef ZONA_H
+#define ZONA_H
+
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "aht20.h"
+#include "filtro.h"
+#include "escalonamento.h"
+#include "feedforward.h"
+#include "perfil_movimento.h"
+#include "monitor_sensor.h"
+
+/* ---------- Período do ciclo de controle (s) ---------- */
+#define PERIODO_AMOSTRA 1.0f
+
+/* ---------- Velocidade do barramento dos sensores ---------- */
+#define ZONA_I2C_FREQUENCIA_HZ 400000 // O AHT20 suporta Fast-mode
+
+/* ---------- Abertura total do servo (resfriamento máximo) ---------- */
+#define ANGULO_ABERTURA_TOTAL 180.0f
+
+/* ---------- PWM de um atuador ---------- */
+// Frequência e resolução pedidas; o divisor vem de clock_get_hz(clk_sys), então
+// o período não depende do clock do sistema. Atuadores na mesma fatia de PWM
+// dividem a configuração.
+typedef struct {
+    uint32_t frequencia_hz;
+    uint8_t resolucao_bits; // Passos do ciclo de trabalho = 2^bits (topo = 2^bits - 1)
+    float frequencia_real;  // Obtida com o divisor fracionário (calculada)
+} PwmConfig;
+
+// Servo: 50 Hz com 16 bits (pulso em passos de ~0,3 µs).
+#define PWM_SERVO_PADRAO {.frequencia_hz = 50, .resolucao_bits = 16}
+// Ventoinha: 25 kHz (acima da audição, padrão das ventoinhas de 4 fios) com 12 bits.
+#define PWM_VENTOINHA_PADRAO {.frequencia_hz = 25000, .resolucao_bits = 12}
+
+/* ---------- Curva da ventoinha ---------- */
+#define VENTOINHA_PONTOS_CURVA 11 // Velocidade de 0 a 100% em passos de 10%
+
+// Linearização: ciclo de trabalho que dá cada velocidade pedida. A ventoinha
+// para abaixo de um ciclo mínimo, então duty[0] é esse mínimo e qualquer
+// velocidade acima de zero fica nele ou acima; velocidade zero desliga.
+// Ao partir da ventoinha parada, o impulso de partida vence o atrito estático.
+typedef struct {
+    float duty[VENTOINHA_PONTOS_CURVA]; // % para 0, 10, ..., 100% de velocidade
+    float partida_duty;                 // Ciclo do impulso de partida (%)
+    float partida_s;                    // Duração do impulso (0 desliga)
+} VentoinhaCurva;
+
+// Curva linear de 20% (mínimo de uma ventoinha DC típica) a 100%, com 0,3 s de impulso a 100%.
+#define VENTOINHA_CURVA_PADRAO {                                      \
+    .duty = {20.0f, 28.0f, 36.0f, 44.0f, 52.0f, 60.0f,                \
+             68.0f, 76.0f, 84.0f, 92.0f, 100.0f},                     \
+    .partida_duty = 100.0f,                                           \
+    .partida_s = 0.3f,                                                \
+}
+
+/* ---------- Alocação da saída do controle ---------- */
+// A saída do PI (mais o avanço) é uma demanda de resfriamento em graus, de 0 a
+// 180, dividida entre o servo e a ventoinha:
+//   ALOCACAO_PARALELA:       os dois cobrem a faixa toda; a ventoinha segue o
+//                            ângulo do servo (comportamento original, 1:1)
+//   ALOCACAO_SEQUENCIAL:     o servo cobre a demanda até a divisão e a
+//                            ventoinha só começa com o servo no ângulo máximo
+//   ALOCACAO_FAIXA_DIVIDIDA: como a sequencial, mas as faixas se sobrepõem em
+//                            volta da divisão e a ventoinha entra antes
+typedef enum {
+    ALOCACAO_PARALELA, ALOCACAO_SEQUENCIAL, ALOCACAO_FAIXA_DIVIDIDA
+} AlocacaoModo;
+
+/* ---------- Perfis dos atuadores ---------- */
+// Os perfis avançam uma vez por período do PWM do servo (50 Hz por padrão),
+// que é a taxa com que o próprio servo lê a largura de pulso.
+
+// Servo: até 60°/s, acelerando a 240°/s²; ignora correções menores que 0,5°.
+#define PERFIL_SERVO_PADRAO {       \
+    .velocidade_max = 60.0f,        \
+    .aceleracao_max = 240.0f,       \
+    .banda_morta = 0.5f,            \
+}
+
+// Ventoinha: partida suave, de 0 a 100% em 2 s (e o mesmo para desacelerar).
+#define PERFIL_VENTOINHA_PADRAO {   \
+    .velocidade_max = 50.0f,        \
+    .banda_morta = 1.0f,            \
+}
+
+/* ---------- Trajetória do setpoint ---------- */
+// Um setpoint novo não entra como degrau: temperatura_desejada anda até ele
+// com taxa limitada e acelera e freia em SETPOINT_TEMPO_ACELERACAO_S, então o
+// erro do PI varia aos poucos e a referência não passa do alvo.
+#define SETPOINT_TEMPO_ACELERACAO_S 20.0f
+
+// Até 2 °C/min a partir de @p inicial; sem banda morta.
+#define PERFIL_SETPOINT_PADRAO(inicial) {                               \
+    .velocidade_max = 2.0f / 60.0f,                                     \
+    .aceleracao_max = 2.0f / 60.0f / SETPOINT_TEMPO_ACELERACAO_S,       \
+    .alvo = (inicial),                                                  \
+    .posicao = (inicial),                                               \
+    .parado = true,                                                     \
+}
+
+/* ---------- Modo de controle ---------- */
+typedef enum {
+    MODO_AUTOMATICO, MODO_MANUAL, MODO_DESLIGADO
+} ModoControle;
+
+/* ---------- Ligações físicas de uma zona ---------- */
+// Cada zona tem seu próprio AHT20 (barramento + endereço), servo e canal do L298N.
+// Servos e ventoinhas de zonas diferentes podem dividir uma fatia de PWM apenas
+// se forem do mesmo tipo, pois a fatia tem uma única frequência.
+typedef struct {
+    const char *nome;
+    i2c_inst_t *porta_i2c;
+    uint pino_sda;
+    uint pino_scl;
+    uint8_t endereco_sensor;
+    uint pino_servo;
+    uint pino_in1;
+    uint pino_in2;
+    uint pino_ena_pwm;
+} ZonaHardware;
+
+/* ---------- Estado completo de uma malha de controle ---------- */
+typedef struct {
+    ZonaHardware hw;
+
+    // Parâmetros (ajustáveis por serial, botões e HTTP)
+    float temperatura_desejada; // Referência do ciclo: posição da trajetória do setpoint
+    PerfilMovimento perfil_setpoint; // Alvo (setpoint pedido) e trajetória até ele (°C, °C/s)
+    float ganho_p;
+    float ganho_i;
+    float integral_min;
+    float integral_max;
+    float angulo_min;
+    float angulo_max;
+    float angulo_manual;
+    ModoControle modo;
+    float angulo_seguro;      // Posição aplicada com o sensor em falha
+    float ventoinha_segura;   // Velocidade aplicada com o sensor em falha (%)
+    float ventoinha_manual;   // Velocidade no modo manual (NAN: segue o ângulo manual)
+    AlocacaoModo alocacao;
+    float divisao;            // Fração da demanda em que o servo satura (sequencial e faixa dividida)
+    float sobreposicao;       // Largura da faixa comum aos dois atuadores (faixa dividida)
+
+    // Escalonamento de ganhos: com a tabela ativa e não vazia, ganho_p e ganho_i
+    // são substituídos pelos ganhos do ponto de operação
+    Escalonamento escalonamento;
+    bool escalonamento_ativo;
+
+    // Avanço (feed-forward): soma ao PI o ângulo de regime da tabela, para que o
+    // integral só precise corrigir o resíduo. Ligado por zona_definir_feedforward().
+    const FeedForwardTabela *feedforward; // NULL: zona sem tabela
+    bool feedforward_ativo;
+    float temperatura_ambiente;           // NAN enquanto nenhuma fonte externa informar
+
+    // Saídas: configuração do PWM, perfis de movimento (alvo comandado pelo
+    // controle e saída real) e curva da ventoinha
+    PwmConfig pwm_servo;
+    PwmConfig pwm_ventoinha;
+    PerfilMovimento perfil_servo;
+    PerfilMovimento perfil_ventoinha;
+    VentoinhaCurva curva_ventoinha;
+    float duty_ventoinha;      // Ciclo de trabalho aplicado (%), já linearizado
+    float partida_restante_s;  // Tempo restante do impulso de partida
+
+    // Estado do controlador
+    float termo_integral;
+    float ganho_p_aplicado;   // Ganhos usados no último ciclo (fixos ou escalonados)
+    float ganho_i_aplicado;
+    bool sensor_ok;
+    MonitorSensor monitor;
+    volatile bool temperatura_critica; // Definido pelo supervisor (interrupção)
+
+    // Entrada: leitura bruta (média da rajada), filtro e latência da aquisição
+    Filtro filtro;
+    AHT20_Leitura leitura;    // Transação em andamento na fila I2C
+    float temperatura_bruta;
+    float umidade;
+    uint32_t latencia_us;     // Do disparo da medição até a saída do filtro
+    uint32_t latencia_max_us;
+    uint32_t tempo_filtro_us; // Custo de processamento do filtro
+
+    // Última amostra aplicada (lida pelo display e pela telemetria)
+    float temperatura_atual;
+    float erro;
+    float termo_feedforward;
+    float demanda;            // Saída do controle antes da alocação (graus)
+    float angulo_alvo;
+    float velocidade_ventoinha;
+} Zona;
+
+/* ---------- Amostra publicada de uma zona ---------- */
+// Cópia do estado de um ciclo de controle, coerente entre si, para leitores
+// fora do laço de controle (HTTP, display, telemetria).
+typedef struct {
+    float temperatura_bruta;
+    float temperatura_atual;
+    float umidade;
+    float temperatura_desejada;
+    float setpoint_alvo;
+    float erro;
+    float termo_integral;
+    float termo_feedforward;
+    float demanda;
+    float angulo_alvo;
+    float velocidade_ventoinha;
+    ModoControle modo;
+    bool sensor_ok;
+    bool temperatura_critica;
+    SensorEstado sensor_estado;
+    uint32_t sensor_falhas;
+    uint32_t sensor_tentativas_recuperacao;
+    uint32_t sensor_recuperacoes;
+    float ganho_p_aplicado;
+    float ganho_i_aplicado;
+
+    // Filtro e aquisição
+    float estimativa;
+    float variancia;
+    uint32_t filtro_amostras;
+    uint32_t rejeitadas_outlier;
+    uint32_t rejeitadas_sensor;
+    uint32_t latencia_us;
+    uint32_t latencia_max_us;
+    uint32_t tempo_filtro_us;
+
+    // Saídas dos perfis (a interrupção dos atuadores as atualiza entre ciclos)
+    float servo_alvo;
+    float servo_posicao;
+    float servo_velocidade;
+    uint32_t servo_ignorados;
+    float ventoinha_alvo;
+    float ventoinha_posicao;
+    float duty_ventoinha;
+} ZonaAmostra;
+
+/* ---------- Configuração publicada de uma zona ---------- */
+// Parâmetros ajustáveis da zona, copiados junto com a amostra: quem está fora
+// do laço de controle (handlers HTTP) lê daqui, sem tocar na Zona.
+typedef struct {
+    float taxa_setpoint; // °C/min
+    float ganho_p;
+    float ganho_i;
+    float integral_max;
+    float angulo_min;
+    float angulo_max;
+    float angulo_manual;
+    float ventoinha_manual;
+    float angulo_seguro;
+    float ventoinha_segura;
+    AlocacaoModo alocacao;
+    float divisao;
+    float sobreposicao;
+    float servo_velocidade_max;
+    float servo_aceleracao_max;
+    float servo_banda_morta;
+    float ventoinha_rampa;
+    PwmConfig pwm_servo;
+    PwmConfig pwm_ventoinha;
+    VentoinhaCurva curva_ventoinha;
+    FiltroConfig filtro;
+    Escalonamento escalonamento;
+    bool escalonamento_ativo;
+    const FeedForwardTabela *feedforward;
+    bool feedforward_ativo;
+    float temperatura_ambiente;
+} ZonaConfig;
+
+/* ---------- API ---------- */
+
+// Mapeia um valor de uma faixa de entrada para uma faixa de saída.
+float mapear_valores(float valor, float entrada_min, float entrada_max, float saida_min, float saida_max);
+
+// Configura o barramento I2C da zona na fila I2C (uma única vez por barramento) e inicializa o AHT20.
+bool zona_inicializar_sensor(Zona *zona);
+
+// Configura o PWM do servo e os pinos/PWM da ventoinha da zona.
+void zona_inicializar_atuadores(Zona *zona);
+
+// Aplica uma nova frequência/resolução ao PWM do servo (@p servo true) ou da
+// ventoinha. Retorna false, sem alterar nada, se o divisor necessário ficar
+// fora da faixa do hardware (1 a 256).
+bool zona_configurar_pwm(Zona *zona, bool servo, uint32_t frequencia_hz, uint8_t resolucao_bits);
+
+// Indica se a frequência e a resolução cabem no divisor do PWM, sem aplicar
+// nada (para validar um pedido antes de enfileirá-lo).
+bool zona_pwm_valido(uint32_t frequencia_hz, uint8_t resolucao_bits);
+
+// Dispara a medição do sensor da zona sem bloquear.
+bool zona_disparar_leitura(Zona *zona);
+
+// Enfileira a leitura da medição disparada por zona_disparar_leitura(), sem
+// bloquear: as leituras de várias zonas correm juntas nos seus barramentos.
+bool zona_solicitar_resultado(Zona *zona);
+
+// Espera a leitura pedida por zona_solicitar_resultado(). Quadros com status ou
+// CRC inválidos são contados em zona->filtro.rejeitadas_sensor.
+AHT20_Result zona_ler_temperatura(Zona *zona, float *temperatura_atual, float *umidade);
+
+// Registra uma leitura válida no monitor. Ao sair da falha descarta o histórico
+// do filtro e o termo integral, acumulados com dados velhos.
+void zona_confirmar_leitura_sensor(Zona *zona);
+
+// Registra uma falha de leitura. Com o sensor em falha aplica a posição segura e,
+// respeitando o backoff, recupera o barramento I2C e reseta o AHT20.
+void zona_tratar_falha_sensor(Zona *zona, uint32_t agora_ms);
+
+// Passa a amostra pelo filtro da zona; retorna false se ela foi rejeitada.
+bool zona_filtrar_temperatura(Zona *zona, float amostra, float *temperatura_filtrada);
+
+// Define o ângulo (0-180) comandado ao servo da zona; o servo chega a ele
+// seguindo o perfil de movimento.
+void zona_definir_angulo_servo(Zona *zona, float angulo);
+
+// Define a velocidade (0 a 100%) comandada à ventoinha da zona; o PWM segue a
+// rampa do perfil.
+void zona_definir_velocidade_ventoinha(Zona *zona, float porcentagem);
+
+// Comanda o servo para a abertura total e a ventoinha para 100%. Só mexe nos
+// alvos dos perfis, então pode ser chamada pela interrupção do supervisor.
+void zona_forcar_resfriamento_maximo(Zona *zona);
+
+// Avança os perfis @p dt segundos e escreve as saídas no PWM (a ventoinha pela
+// curva de linearização). Chamada pela interrupção dos atuadores.
+void zona_atualizar_atuadores(Zona *zona, float dt);
+
+// Define o setpoint pedido; temperatura_desejada chega a ele pela trajetória.
+void zona_definir_setpoint(Zona *zona, float setpoint);
+
+// Taxa máxima da trajetória do setpoint (°C/min; 0 volta ao degrau).
+void zona_definir_taxa_setpoint(Zona *zona, float taxa);
+
+// Avança a trajetória do setpoint @p dt segundos (uma vez por ciclo de controle).
+void zona_avancar_setpoint(Zona *zona, float dt);
+
+// Ganhos para o ponto de operação atual: os da tabela de escalonamento, se
+// ativa, ou os fixos.
+void zona_ganhos_escalonados(const Zona *zona, float erro, float *ganho_p, float *ganho_i);
+
+// Calcula o sinal de controle PI com base na temperatura atual. Uma troca de
+// ganhos (escalonamento ou ajuste manual) não causa salto na saída: o termo
+// integral absorve a mudança do termo proporcional.
+float zona_calcular_controle_pi(Zona *zona, float temperatura_atual);
+
+// Termo de avanço para o setpoint, a umidade e o ambiente atuais (0 se desligado).
+float zona_calcular_feedforward(const Zona *zona);
+
+// Liga ou desliga o avanço sem solavanco: o termo integral, que carregava o
+// regime, é descontado (ou devolvido) do termo que a tabela passa a fornecer.
+void zona_definir_feedforward(Zona *zona, bool ativo);
+
+// Divide uma demanda de resfriamento (0 a 180 graus) entre o ângulo do servo e
+// a velocidade da ventoinha, segundo o modo de alocação da zona.
+void zona_alocar_demanda(const Zona *zona, float demanda, float *angulo, float *ventoinha);
+
+// Aplica o controle (PI + avanço, manual ou desligado) ao servo e à ventoinha da zona.
+void zona_aplicar_controle(Zona *zona, float temperatura_atual);
+
+// Copia o estado atual da zona para uma amostra. Chamada pelo laço de controle.
+void zona_amostrar(const Zona *zona, ZonaAmostra *amostra);
+
+// Copia os parâmetros da zona. Chamada pelo laço de controle, junto com zona_amostrar().
+void zona_copiar_config(const Zona *zona, ZonaConfig *config);
+
+#endif // ZONA_H
@@ -1,44 +1,76 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <malloc.h>
 #include <ctype.h>
 #include <math.h>
 #include <string.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "hardware/pwm.h"
+#include "hardware/sync.h"
 #include "aht20.h"
 #include "pico_http_server.h"
 #include "ssd1306.h"
+#include "zona.h"
+#include "supervisor.h"
+#include "atuadores.h"
+#include "persistencia.h"
+#include "seqlock.h"
+#include "fila_comandos.h"
+#include "log.h"
+#include "shell.h"
+#include "programa.h"
+#include "relogio.h"
+#include "wifi.h"
+#include "i2c_fila.h"
+#include "agendador.h"
+#include "mqtt_telemetria.h"
+#include "telemetria_udp.h"
+#include "widget.h"
+#include "feedforward_tabela.h"
+#include "ota.h"
+#include "ota_flash.h"
 #include "hardware/clocks.h"
-
-// === CONFIGURAÇÕES DE HARDWARE ===
-#define PORTA_I2C i2c0
-#define PINO_SDA 0
-#define PINO_SCL 1
-#define PINO_SERVO 8
-
-// === CONFIGURAÇÕES DA VENTOINHA (L298N) ===
-#define PINO_IN1 18
-#define PINO_IN2 19
-#define PINO_ENA_PWM 20
-
-// === CONFIGURAÇÕES DO SERVO ===
-#define PULSO_MIN_US 500
-#define PULSO_MAX_US 2500
-#define DIVISOR_PWM 125.0f
-#define WRAP_PWM 19999
-
-// === CONFIGURAÇÕES PWM DA VENTOINHA ===
-#define DIVISOR_PWM_VENTOINHA 4.0f
-#define WRAP_PWM_VENTOINHA 999
+#include "lwip/stats.h"
 
 // === CONFIGURAÇÕES DO CONTROLE PI ===
 #define GANHO_P 10.0f
 #define GANHO_I 0.2f
-#define PERIODO_AMOSTRA 1.0f
 #define INTEGRAL_MIN -90.0f
 #define INTEGRAL_MAX 90.0f
 #define TEMP_CRITICA 35.0f
+#define SETPOINT_PADRAO 28.0f
+
+// === LIMITES DOS PARÂMETROS AJUSTÁVEIS PELA WEB ===
+#define SETPOINT_MIN -40.0f // Faixa de medição do AHT20
+#define SETPOINT_MAX 85.0f
+#define GANHO_P_MAX 100.0f
+#define GANHO_I_MAX 10.0f
+#define AMBIENTE_MIN -40.0f
+#define AMBIENTE_MAX 85.0f
+#define TAXA_SETPOINT_MAX 60.0f // °C/min
+#define PATAMAR_MAX_MIN 10080   // Uma semana
+#define TOLERANCIA_MAX 20.0f
+
+// === HORA DO DIA (partidas agendadas dos programas) ===
+#define SNTP_SERVIDOR "pool.ntp.org"
+#define FUSO_HORARIO_MIN (-180) // UTC-3 (Brasília)
+
+// === MQTT (telemetria da frota) ===
+#define MQTT_BROKER "192.168.0.10" // IPv4 do broker (ex: mosquitto na rede local)
+#define MQTT_PORTA 1883
+#define MQTT_CLIENTE_ID "pico01"
+#define MQTT_PREFIXO "estufa/" MQTT_CLIENTE_ID
+#define MQTT_PERIODO_MS 5000       // Intervalo entre lotes (ajustável por <prefixo>/set/telemetria)
+#define MQTT_PERIODO_MIN_MS 1000
+#define MQTT_PERIODO_MAX_MS 600000
+#define MQTT_QOS 1
+
+// === TELEMETRIA UDP (captura em alta taxa para sintonia, ativada por /udp) ===
+#define UDP_DESTINO_PADRAO "192.168.0.20"
+#define UDP_TAXA_PADRAO_HZ 20
+#define UDP_TAXA_MAX_HZ 50
+#define UDP_AMOSTRAS_POR_PACOTE 5
 
 // === CONFIGURAÇÕES (Wilton) ===
 #define I2C_PORT_OLED i2c1
@@ -52,20 +84,62 @@
 #define BTN_NEXT_PIN 5
 #define BTN_SELECT_PIN 6
 
+// === ZONAS DE CONTROLE ===
+// Cada entrada é uma malha independente (sensor, servo e ventoinha próprios).
+// O AHT20 tem endereço fixo, então zonas extras usam outro barramento (o i2c1
+// do OLED aceita um AHT20, já que os endereços 0x38 e 0x3C não colidem) ou um mux.
+#define ZONA_PADRAO(...) {                      \
+    .hw = {__VA_ARGS__},                        \
+    .temperatura_desejada = SETPOINT_PADRAO,    \
+    .perfil_setpoint = PERFIL_SETPOINT_PADRAO(SETPOINT_PADRAO), \
+    .ganho_p = GANHO_P,                         \
+    .ganho_i = GANHO_I,                         \
+    .ganho_p_aplicado = GANHO_P,                \
+    .ganho_i_aplicado = GANHO_I,                \
+    .integral_min = INTEGRAL_MIN,               \
+    .integral_max = INTEGRAL_MAX,               \
+    .angulo_min = 0.0f,                         \
+    .angulo_max = 180.0f,                       \
+    .angulo_manual = 90.0f,                     \
+    .modo = MODO_AUTOMATICO,                    \
+    .angulo_seguro = 180.0f,                    \
+    .ventoinha_segura = 100.0f,                 \
+    .feedforward = &FEEDFORWARD_TABELA,         \
+    .ventoinha_manual = NAN,                    \
+    .alocacao = ALOCACAO_PARALELA,              \
+    .divisao = 0.5f,                            \
+    .sobreposicao = 0.2f,                       \
+    .pwm_servo = PWM_SERVO_PADRAO,              \
+    .pwm_ventoinha = PWM_VENTOINHA_PADRAO,      \
+    .perfil_servo = PERFIL_SERVO_PADRAO,        \
+    .perfil_ventoinha = PERFIL_VENTOINHA_PADRAO, \
+    .curva_ventoinha = VENTOINHA_CURVA_PADRAO,  \
+    .temperatura_ambiente = NAN,                \
+    .filtro = {.cfg = FILTRO_CONFIG_PADRAO},    \
+}
+
+Zona zonas[] = {
+    //          nome      I2C   SDA SCL  endereço        servo IN1 IN2 ENA
+    ZONA_PADRAO("Zona 1", i2c0, 0,  1,   AHT20_I2C_ADDR, 8,    18, 19, 20),
+    // ZONA_PADRAO("Zona 2", i2c1, 14, 15, AHT20_I2C_ADDR, 9, 16, 17, 21), // Canal B do L298N
+};
+#define NUM_ZONAS ((int)count_of(zonas))
+
 // === VARIÁVEIS GLOBAIS ===
-float temperatura_desejada = 28.0;
-float termo_integral = 0.0;
-uint fatia_pwm_servo;
-uint fatia_pwm_ventoinha;
 uint fatia_pwm_buzzer;
-float http_temperatura_atual;
-float http_erro;
-float http_angulo_alvo;
-float http_velocidade_ventoinha;
+int zona_exibida = 0; // Zona mostrada no OLED e ajustada pelos botões e pela serial
+uint32_t duracao_ciclo_us; // Do disparo das medições até a aplicação do controle
 
 ssd1306_t oled;
 uint32_t tempo_inicio_operacao;
 
+// === FASES DO BOOT (time_us_32 ao fim de cada uma; 0 = ainda não) ===
+// O controle parte antes da rede: o rádio só é iniciado depois do primeiro
+// ciclo, e a associação e o DHCP correm em segundo plano.
+enum { BOOT_CONTROLE, BOOT_PRIMEIRO_CICLO, BOOT_RADIO, BOOT_FASES };
+uint32_t boot_us[BOOT_FASES];
+bool rede_iniciada;
+
 // === ESTADOS DO SISTEMA E MENU (Wilton) ===
 typedef enum {
     OPERANDO_NORMAL, STANDBY, AQUECENDO, ERRO_TEMP_CRITICA, ERRO_SENSOR, MODO_CONFIG
@@ -73,263 +147,1931 @@ typedef enum {
 SystemStatus status_sistema = OPERANDO_NORMAL;
 
 typedef enum {
-    TELA_PRINCIPAL, TELA_GRAFICO_BARRAS, TELA_INFO_DETALHADA, MENU_CONFIG, CONFIG_SETPOINT
+    TELA_PRINCIPAL, TELA_GRAFICO_BARRAS, TELA_INFO_DETALHADA, TELA_PROGRAMA, MENU_CONFIG, CONFIG_SETPOINT
 } MenuState;
 MenuState estado_menu = TELA_PRINCIPAL;
 int menu_selecionado = 0;
+float setpoint_em_edicao; // Valor da tela de ajuste, aplicado ao confirmar
+
+static const char *const NOMES_MODO[] = {"auto", "manual", "desligado", NULL};
+static const char *const NOMES_CHAVE_ESCALONAMENTO[] = {"setpoint", "erro", NULL};
+static const char *const NOMES_ALOCACAO[] = {"paralela", "sequencial", "faixa_dividida", NULL};
+static const char *const NOMES_ACAO_PROGRAMA[] = {"definir", "iniciar", "parar", "limpar", NULL};
+enum { ACAO_DEFINIR, ACAO_INICIAR, ACAO_PARAR, ACAO_LIMPAR };
+static const char *const NOMES_FASE_PROGRAMA[] = {"parado", "rampa", "patamar"};
+static const char *const NOMES_STATUS[] = {"operando", "standby", "aquecendo", "temperatura_critica", "erro_sensor", "config"};
+
+// Configuração do fluxo /udp: chega pela fila de comandos e a tarefa de
+// captura a aplica no laço principal
+typedef struct {
+    char destino[HTTP_PARAMS_MAX_VALUE];
+    int porta;
+    int taxa_hz;
+    int amostras_por_pacote;
+    bool ativo;
+    bool reconfigurar;
+} FluxoUdp;
+FluxoUdp fluxo_udp = {UDP_DESTINO_PADRAO, TELEMETRIA_UDP_PORTA_PADRAO, UDP_TAXA_PADRAO_HZ, UDP_AMOSTRAS_POR_PACOTE};
+
+// === PROGRAMAS DE RAMPAS E PATAMARES ===
+Programa programas[PROGRAMAS_MAX];
+ProgramaExecucao execucoes[NUM_ZONAS]; // Programa rodando em cada zona
+uint32_t dia_agendado[PROGRAMAS_MAX];  // Dia da última partida agendada (uma por dia)
+
+// === CONFIGURAÇÃO GUARDADA NA FLASH ===
+// Mudar o formato exige trocar a versão: um bloco de outra versão é ignorado.
+#define CONFIG_VERSAO 2
+typedef struct {
+    Escalonamento escalonamento[NUM_ZONAS];
+    bool escalonamento_ativo[NUM_ZONAS];
+    Programa programas[PROGRAMAS_MAX];
+} ConfigPersistente;
+_Static_assert(sizeof(ConfigPersistente) <= PERSISTENCIA_DADOS_MAX, "configuração maior que o bloco da flash");
+
+// === EVENTOS PUBLICADOS POR INTERRUPÇÕES ===
+enum { EVENTO_BOTAO, EVENTO_SALVAR_CONFIG, EVENTO_SERIAL }; // dado: GPIO do botão
+
+// === ESTADO PUBLICADO PELO CONTROLE ===
+// Escrito só pelo laço de controle (a cada ciclo e após aplicar comandos). HTTP,
+// display e telemetria leem uma cópia coerente com seqlock_ler(), em vez de
+// juntar campos das zonas que podem mudar no meio da leitura.
+typedef struct {
+    int8_t programa; // Índice em programas[]; -1: nenhum
+    uint8_t segmento;
+    ProgramaFase fase;
+    float setpoint;
+    float restante_s;
+    float espera_s;
+    uint32_t ciclos;
+} ExecucaoAmostra;
+
+typedef struct {
+    uint32_t ciclo;
+    uint32_t duracao_ciclo_us;
+    SystemStatus status;
+    ZonaAmostra zonas[NUM_ZONAS];
+    ExecucaoAmostra execucoes[NUM_ZONAS];
+} ControleEstado;
+ControleEstado estado_buffers[2];
+Seqlock estado_controle = SEQLOCK_INICIAL(estado_buffers);
+
+// === CONFIGURAÇÃO PUBLICADA ===
+// Parâmetros das zonas, programas e fluxo UDP. Só mudam por comandos, então
+// são publicados à parte do estado: no boot e depois de aplicar comandos. Os
+// handlers HTTP leem e validam contra esta cópia.
+typedef struct {
+    ZonaConfig zonas[NUM_ZONAS];
+    Programa programas[PROGRAMAS_MAX];
+    FluxoUdp udp;
+} ConfigEstado;
+ConfigEstado config_buffers[2];
+Seqlock config_controle = SEQLOCK_INICIAL(config_buffers);
+
+// === COMANDOS AO CONTROLADOR ===
+// Só o laço principal altera o estado do controle: as demais fontes postam
+// comandos, aplicados pela tarefa "comandos". Cada contexto produtor tem sua fila.
+enum {
+    COMANDO_SETPOINT,         // valor: °C
+    COMANDO_TAXA_SETPOINT,    // valor: °C/min
+    COMANDO_GANHO_P,          // valor
+    COMANDO_GANHO_I,          // valor
+    COMANDO_MODO,             // inteiro: ModoControle; valor: ângulo manual (NAN mantém); valor2: ventoinha manual
+    COMANDO_LIMITE_INTEGRAL,  // valor
+    COMANDO_LIMITES_ANGULO,   // valor: mínimo; valor2: máximo
+    COMANDO_POSICAO_SEGURA,   // valor: ângulo; valor2: ventoinha (NAN mantém)
+    COMANDO_FEEDFORWARD,      // inteiro: ligado
+    COMANDO_AMBIENTE,         // valor: °C (todas as zonas)
+    COMANDO_INICIAR_PROGRAMA, // inteiro: programa
+    COMANDO_PARAR_PROGRAMA,
+    COMANDO_FILTRO,           // carga: FiltroConfig
+    COMANDO_ESCALONAMENTO,    // carga: tabela; inteiro: ligado (-1 mantém)
+    COMANDO_DEFINIR_PROGRAMA, // carga: programa; inteiro: índice
+    COMANDO_UDP,              // carga: FluxoUdp
+    COMANDO_PERFIL_SERVO,     // valor: velocidade máxima; valor2: aceleração máxima (NAN mantém)
+    COMANDO_BANDA_MORTA,      // valor: graus
+    COMANDO_RAMPA_VENTOINHA,  // valor: velocidade máxima (%/s)
+    COMANDO_ALOCACAO,         // inteiro: AlocacaoModo (-1 mantém); valor: divisão; valor2: sobreposição (NAN mantém)
+    COMANDO_PWM,              // inteiro: 1 servo, 0 ventoinha; valor: frequência; valor2: resolução
+    COMANDO_PARTIDA_VENTOINHA, // valor: duty; valor2: duração em s (NAN mantém)
+};
+FilaComandos comandos_rede;   // Handlers HTTP e comandos MQTT (contexto do lwIP)
+FilaComandos comandos_locais; // Shell serial e botões (laço principal)
+
+// Dados de um comando da rede que não cabem num Comando. O handler preenche a
+// carga e posta o comando; a tarefa de comandos a libera depois de publicar a
+// configuração, então o pedido seguinte já valida contra a nova. Uma carga por
+// vez: ocupada, a rota responde 503, como com a fila cheia.
+struct {
+    union {
+        FiltroConfig filtro;
+        Escalonamento escalonamento;
+        Programa programa;
+        FluxoUdp udp;
+    };
+    volatile bool ocupada; // Escrito pelo lwIP ao reservar, pelo laço principal ao liberar
+    bool aplicada;         // Só o laço principal
+} carga_rede;
+
+// === BUZZER (sequências tocadas sem bloquear) ===
+typedef struct { uint16_t freq; uint16_t duracao_ms; } Nota; // freq 0 = pausa
+struct {
+    const Nota *notas;
+    int quantidade;
+    int atual;
+    uint32_t fim_nota_ms;
+} buzzer;
 
 // === PÁGINA HTTP ===
-const char *HTML_BODY = "<!DOCTYPE html><html lang=\"pt-BR\"><head><meta charset=\"UTF-8\" /><meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\" /><title>Dashboard de Controle - Pico W</title><script src=\"https://cdn.jsdelivr.net/npm/chart.js\"></script><style>:root{--cor-fundo: #f0f2f5;--cor-container: #ffffff;--cor-texto: #333;--cor-primaria: #007bff;--cor-sombra: rgba(0, 0, 0, 0.1);--cor-sucesso: #28a745;--cor-erro: #dc3545;--cor-borda: #dee2e6;}body{font-family: -apple-system, BlinkMacSystemFont, \"Segoe UI\", Roboto,\"Helvetica Neue\", Arial, sans-serif;background-color: var(--cor-fundo);color: var(--cor-texto);margin: 0;padding: 20px;line-height: 1.6;}.container{max-width: 1200px;margin: auto;display: grid;gap: 20px;}header{background: var(--cor-container);padding: 20px;border-radius: 8px;box-shadow: 0 2px 4px var(--cor-sombra);border-left: 5px solid var(--cor-primaria);text-align: center;}h1,h2{margin: 0;color: var(--cor-primaria);}h2{margin-bottom: 15px;border-bottom: 2px solid var(--cor-borda);padding-bottom: 10px;}.card{background-color: var(--cor-container);padding: 20px;border-radius: 8px;box-shadow: 0 2px 4px var(--cor-sombra);}#dashboard{display: grid;grid-template-columns: repeat(auto-fit, minmax(150px, 1fr));gap: 20px;}.status-item{text-align: center;}.status-item h3{margin: 0 0 10px 0;font-size: 1rem;color: #6c757d;}.status-item p{margin: 0;font-size: 1.8rem;font-weight: 500;}#status-container{display: flex;align-items: center;justify-content: center;gap: 10px;}#status-indicator{width: 15px;height: 15px;border-radius: 50%;background-color: #6c757d;transition: background-color 0.5s ease;}#controle form{display: flex;flex-wrap: wrap;gap: 10px;align-items: center;}#controle input[type=\"text\"]{flex-grow: 1;padding: 10px;border: 1px solid var(--cor-borda);border-radius: 5px;font-size: 1rem;}#controle button{padding: 10px 20px;border: none;border-radius: 5px;background-color: var(--cor-primaria);color: white;font-size: 1rem;cursor: pointer;transition: background-color 0.2s ease;}#controle button:hover{background-color: #0056b3;}#feedback-message{margin-top: 10px;font-weight: bold;height: 20px;}.feedback-success{color: var(--cor-sucesso);}.feedback-error{color: var(--cor-erro);}#grafico-container{position: relative;height: 40vh;min-height: 300px;}</style></head><body><div class=\"container\"><header><h1>Painel de Controle de Temperatura</h1></header><main id=\"dashboard\" class=\"card\"><div class=\"status-item\"><h3>Temperatura Atual</h3><p><span id=\"temp-atual\">--</span> °C</p></div><div class=\"status-item\"><h3>Setpoint</h3><p><span id=\"temp-desejada\">--</span> °C</p></div><div class=\"status-item\"><h3>Erro</h3><p><span id=\"erro\">--</span></p></div><div class=\"status-item\"><h3>Ângulo Servo</h3><p><span id=\"angulo-servo\">--</span> °</p></div><div class=\"status-item\"><h3>Motor</h3><p><span id=\"velocidade-motor\">--</span> %</p></div><div class=\"status-item\"><h3>Status</h3><div id=\"status-container\"><span id=\"status-indicator\"></span><p id=\"status-texto\" style=\"font-size: 1.5rem\">Offline</p></div></div></main><section id=\"controle\" class=\"card\"><h2>Controle Remoto</h2><form id=\"setpoint-form\"><input type=\"text\" id=\"novo-setpoint\" placeholder=\"Digite a nova temperatura (ex: 25.5 ou 25,5)\" required /><button type=\"submit\">Aplicar</button></form><p id=\"feedback-message\"></p></section><section id=\"grafico\" class=\"card\"><h2>Histórico de Temperatura (Últimos 15 minutos)</h2><div id=\"grafico-container\"><canvas id=\"tempChart\"></canvas></div></section></div><script>document.addEventListener(\"DOMContentLoaded\", () => {const tempAtualElem = document.getElementById(\"temp-atual\");const tempDesejadaElem = document.getElementById(\"temp-desejada\");const erroElem = document.getElementById(\"erro\");const anguloServoElem = document.getElementById(\"angulo-servo\");const velocidadeMotorElem = document.getElementById(\"velocidade-motor\");const statusIndicator = document.getElementById(\"status-indicator\");const statusTexto = document.getElementById(\"status-texto\");const setpointForm = document.getElementById(\"setpoint-form\");const novoSetpointInput = document.getElementById(\"novo-setpoint\");const feedbackMessage = document.getElementById(\"feedback-message\");const MAX_DATA_POINTS = 900;const ctx = document.getElementById(\"tempChart\").getContext(\"2d\");const tempChart = new Chart(ctx, {type: \"line\",data: {labels: [],datasets: [{label: \"Temperatura Atual (°C)\",data: [],borderColor: \"rgba(220, 53, 69, 1)\",backgroundColor: \"rgba(220, 53, 69, 0.1)\",borderWidth: 2,tension: 0.3,fill: true,},{label: \"Setpoint (°C)\",data: [],borderColor: \"rgba(0, 123, 255, 1)\",borderWidth: 2,borderDash: [5, 5],tension: 0.3,fill: false,},],},options: {responsive: true,maintainAspectRatio: false,scales: {x: {ticks: {maxRotation: 0,autoSkip: true,maxTicksLimit: 10,},},y: {beginAtZero: false,title: {display: true,text: \"Temperatura (°C)\",},},},animation: {duration: 250,},interaction: {intersect: false,mode: \"index\",},},});async function fetchDataAndUpdate() {try {const response = await fetch(\"/status\");if (!response.ok) {throw new Error(`HTTP error! status: ${response.status}`);}const data = await response.json();tempAtualElem.textContent = data.temperatura_atual.toFixed(2);tempDesejadaElem.textContent = data.temperatura_desejada.toFixed(2);erroElem.textContent = data.erro.toFixed(2);anguloServoElem.textContent = data.angulo_alvo.toFixed(1);velocidadeMotorElem.textContent = data.velocidade_ventoinha.toFixed(0);statusIndicator.style.backgroundColor = \"var(--cor-sucesso)\";statusTexto.textContent = \"Operando\";updateChart(data);} catch (error) {console.error(\"Erro ao buscar dados:\", error);statusIndicator.style.backgroundColor = \"var(--cor-erro)\";statusTexto.textContent = \"Erro\";}}function updateChart(data) {const now = new Date().toLocaleTimeString(\"pt-BR\");tempChart.data.labels.push(now);tempChart.data.datasets[0].data.push(data.temperatura_atual);tempChart.data.datasets[1].data.push(data.temperatura_desejada);if (tempChart.data.labels.length > MAX_DATA_POINTS) {tempChart.data.labels.shift();tempChart.data.datasets.forEach((dataset) => {dataset.data.shift();});}tempChart.update();}setpointForm.addEventListener(\"submit\", async (e) => {e.preventDefault();const tempValue = novoSetpointInput.value.trim().replace(\",\", \".\");const newTemp = parseFloat(tempValue);if (isNaN(newTemp)) {showFeedback(\"Por favor, insira um número válido.\", \"error\");return;}try {const response = await fetch(`/set_temperatura?temperatura=${newTemp}`);const result = await response.json();if (result.status === \"success\") {showFeedback(\"Setpoint atualizado com sucesso!\", \"success\");tempDesejadaElem.textContent = result.temperatura_desejada.toFixed(2);novoSetpointInput.value = \"\";} else {throw new Error(result.message || \"Erro desconhecido\");}} catch (error) {console.error(\"Erro ao enviar setpoint:\", error);showFeedback(\"Falha ao comunicar com o dispositivo.\", \"error\");}});function showFeedback(message, type) {feedbackMessage.textContent = message;feedbackMessage.className = type === \"success\" ? \"feedback-success\" : \"feedback-error\";setTimeout(() => {feedbackMessage.textContent = \"\";feedbackMessage.className = \"\";}, 4000);}fetchDataAndUpdate();setInterval(fetchDataAndUpdate, 1000);});</script></body></html>";
+static const char HTML_BODY[] = "<!DOCTYPE html><html lang=\"pt-BR\"><head><meta charset=\"UTF-8\" /><meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\" /><title>Dashboard de Controle - Pico W</title><script src=\"https://cdn.jsdelivr.net/npm/chart.js\"></script><style>:root{--cor-fundo: #f0f2f5;--cor-container: #ffffff;--cor-texto: #333;--cor-primaria: #007bff;--cor-sombra: rgba(0, 0, 0, 0.1);--cor-sucesso: #28a745;--cor-erro: #dc3545;--cor-borda: #dee2e6;}body{font-family: -apple-system, BlinkMacSystemFont, \"Segoe UI\", Roboto,\"Helvetica Neue\", Arial, sans-serif;background-color: var(--cor-fundo);color: var(--cor-texto);margin: 0;padding: 20px;line-height: 1.6;}.container{max-width: 1200px;margin: auto;display: grid;gap: 20px;}header{background: var(--cor-container);padding: 20px;border-radius: 8px;box-shadow: 0 2px 4px var(--cor-sombra);border-left: 5px solid var(--cor-primaria);text-align: center;}h1,h2{margin: 0;color: var(--cor-primaria);}h2{margin-bottom: 15px;border-bottom: 2px solid var(--cor-borda);padding-bottom: 10px;}.card{background-color: var(--cor-container);padding: 20px;border-radius: 8px;box-shadow: 0 2px 4px var(--cor-sombra);}#dashboard{display: grid;grid-template-columns: repeat(auto-fit, minmax(150px, 1fr));gap: 20px;}.status-item{text-align: center;}.status-item h3{margin: 0 0 10px 0;font-size: 1rem;color: #6c757d;}.status-item p{margin: 0;font-size: 1.8rem;font-weight: 500;}#status-container{display: flex;align-items: center;justify-content: center;gap: 10px;}#status-indicator{width: 15px;height: 15px;border-radius: 50%;background-color: #6c757d;transition: background-color 0.5s ease;}#controle form{display: flex;flex-wrap: wrap;gap: 10px;align-items: center;}#controle input[type=\"text\"]{flex-grow: 1;padding: 10px;border: 1px solid var(--cor-borda);border-radius: 5px;font-size: 1rem;}#controle button{padding: 10px 20px;border: none;border-radius: 5px;background-color: var(--cor-primaria);color: white;font-size: 1rem;cursor: pointer;transition: background-color 0.2s ease;}#controle button:hover{background-color: #0056b3;}#feedback-message{margin-top: 10px;font-weight: bold;height: 20px;}.feedback-success{color: var(--cor-sucesso);}.feedback-error{color: var(--cor-erro);}#grafico-container{position: relative;height: 40vh;min-height: 300px;}</style></head><body><div class=\"container\"><header><h1>Painel de Controle de Temperatura</h1></header><main id=\"dashboard\" class=\"card\"><div class=\"status-item\"><h3>Temperatura Atual</h3><p><span id=\"temp-atual\">--</span> °C</p></div><div class=\"status-item\"><h3>Setpoint</h3><p><span id=\"temp-desejada\">--</span> °C</p></div><div class=\"status-item\"><h3>Erro</h3><p><span id=\"erro\">--</span></p></div><div class=\"status-item\"><h3>Ângulo Servo</h3><p><span id=\"angulo-servo\">--</span> °</p></div><div class=\"status-item\"><h3>Motor</h3><p><span id=\"velocidade-motor\">--</span> %</p></div><div class=\"status-item\"><h3>Status</h3><div id=\"status-container\"><span id=\"status-indicator\"></span><p id=\"status-texto\" style=\"font-size: 1.5rem\">Offline</p></div></div></main><section id=\"controle\" class=\"card\"><h2>Controle Remoto</h2><form id=\"setpoint-form\"><input type=\"text\" id=\"novo-setpoint\" placeholder=\"Digite a nova temperatura (ex: 25.5 ou 25,5)\" required /><button type=\"submit\">Aplicar</button></form><p id=\"feedback-message\"></p></section><section id=\"grafico\" class=\"card\"><h2>Histórico de Temperatura (Últimos 15 minutos)</h2><div id=\"grafico-container\"><canvas id=\"tempChart\"></canvas></div></section></div><script>document.addEventListener(\"DOMContentLoaded\", () => {const tempAtualElem = document.getElementById(\"temp-atual\");const tempDesejadaElem = document.getElementById(\"temp-desejada\");const erroElem = document.getElementById(\"erro\");const anguloServoElem = document.getElementById(\"angulo-servo\");const velocidadeMotorElem = document.getElementById(\"velocidade-motor\");const statusIndicator = document.getElementById(\"status-indicator\");const statusTexto = document.getElementById(\"status-texto\");const setpointForm = document.getElementById(\"setpoint-form\");const novoSetpointInput = document.getElementById(\"novo-setpoint\");const feedbackMessage = document.getElementById(\"feedback-message\");const MAX_DATA_POINTS = 900;const ctx = document.getElementById(\"tempChart\").getContext(\"2d\");const tempChart = new Chart(ctx, {type: \"line\",data: {labels: [],datasets: [{label: \"Temperatura Atual (°C)\",data: [],borderColor: \"rgba(220, 53, 69, 1)\",backgroundColor: \"rgba(220, 53, 69, 0.1)\",borderWidth: 2,tension: 0.3,fill: true,},{label: \"Setpoint (°C)\",data: [],borderColor: \"rgba(0, 123, 255, 1)\",borderWidth: 2,borderDash: [5, 5],tension: 0.3,fill: false,},],},options: {responsive: true,maintainAspectRatio: false,scales: {x: {ticks: {maxRotation: 0,autoSkip: true,maxTicksLimit: 10,},},y: {beginAtZero: false,title: {display: true,text: \"Temperatura (°C)\",},},},animation: {duration: 250,},interaction: {intersect: false,mode: \"index\",},},});function atualizarPainel(data) {tempAtualElem.textContent = data.temperatura_atual.toFixed(2);tempDesejadaElem.textContent = data.temperatura_desejada.toFixed(2);erroElem.textContent = data.erro.toFixed(2);anguloServoElem.textContent = data.angulo_alvo.toFixed(1);velocidadeMotorElem.textContent = data.velocidade_ventoinha.toFixed(0);statusIndicator.style.backgroundColor = \"var(--cor-sucesso)\";statusTexto.textContent = \"Operando\";updateChart(data);}function mostrarErro() {statusIndicator.style.backgroundColor = \"var(--cor-erro)\";statusTexto.textContent = \"Erro\";}async function fetchDataAndUpdate() {try {const response = await fetch(\"/status\");if (!response.ok) {throw new Error(`HTTP error! status: ${response.status}`);}const data = await response.json();atualizarPainel(data);} catch (error) {console.error(\"Erro ao buscar dados:\", error);mostrarErro();}}function updateChart(data) {const now = new Date().toLocaleTimeString(\"pt-BR\");tempChart.data.labels.push(now);tempChart.data.datasets[0].data.push(data.temperatura_atual);tempChart.data.datasets[1].data.push(data.temperatura_desejada);if (tempChart.data.labels.length > MAX_DATA_POINTS) {tempChart.data.labels.shift();tempChart.data.datasets.forEach((dataset) => {dataset.data.shift();});}tempChart.update();}async function postarComToken(url, corpo) {const enviar = () => fetch(url, {method: \"POST\",headers: {\"Content-Type\": \"application/x-www-form-urlencoded\",Authorization: `Bearer ${localStorage.getItem(\"token\") || \"\"}`,},body: corpo,});let response = await enviar();if (response.status === 401) {const token = prompt(\"Token de acesso do dispositivo:\");if (token) {localStorage.setItem(\"token\", token);response = await enviar();}}return response;}setpointForm.addEventListener(\"submit\", async (e) => {e.preventDefault();const tempValue = novoSetpointInput.value.trim().replace(\",\", \".\");const newTemp = parseFloat(tempValue);if (isNaN(newTemp)) {showFeedback(\"Por favor, insira um número válido.\", \"error\");return;}try {const response = await postarComToken(\"/set_temperatura\", `temperatura=${newTemp}`);if (response.status === 401) {showFeedback(\"Token de acesso inválido.\", \"error\");return;}const result = await response.json();if (result.status === \"success\") {showFeedback(\"Setpoint atualizado com sucesso!\", \"success\");tempDesejadaElem.textContent = result.temperatura_desejada.toFixed(2);novoSetpointInput.value = \"\";} else {throw new Error(result.message || \"Erro desconhecido\");}} catch (error) {console.error(\"Erro ao enviar setpoint:\", error);showFeedback(\"Falha ao comunicar com o dispositivo.\", \"error\");}});function showFeedback(message, type) {feedbackMessage.textContent = message;feedbackMessage.className = type === \"success\" ? \"feedback-success\" : \"feedback-error\";setTimeout(() => {feedbackMessage.textContent = \"\";feedbackMessage.className = \"\";}, 4000);}if (window.EventSource) {const fonte = new EventSource(\"/events\");fonte.addEventListener(\"amostra\", (e) => {const data = JSON.parse(e.data);if (data.zona === 0) atualizarPainel(data);});fonte.addEventListener(\"zona\", (e) => {const data = JSON.parse(e.data);if (data.zona === 0) tempDesejadaElem.textContent = data.temperatura_desejada.toFixed(2);});fonte.onerror = mostrarErro;} else {fetchDataAndUpdate();setInterval(fetchDataAndUpdate, 1000);}});</script></body></html>";
 const char *SSID = "TAWLS";
 const char *SENHA = "0123456789";
 
+// === ACESSO HTTP ===
+// Exigido em "Authorization: Bearer <token>" em todo POST (alterações e /update);
+// o dashboard pede o token na primeira alteração e o guarda no navegador. Vem
+// do build (cmake -DTOKEN_ACESSO=...): um valor padrão no código seria conhecido
+// por qualquer um que lesse o repositório.
+#ifndef TOKEN_ACESSO
+#error "Defina o token de acesso HTTP no build: cmake -DTOKEN_ACESSO=<token> .."
+#endif
+
+// === ATUALIZAÇÃO OTA (POST /update, ver tools/ota.py) ===
+#define OTA_REINICIO_ATRASO_MS 1000 // Tempo para a resposta do upload sair antes do reinício
+
 // --- PROTÓTIPOS DE FUNÇÕES (Wilton) ---
 void inicializar_feedback();
 void atualizar_led_rgb();
-void bip(int freq, int duration_ms);
+void buzzer_tom(int freq);
 void bip_curto();
 void erro_bips();
 void alerta_temp_critica();
 void melodia_sucesso();
 void handle_buttons(uint gpio, uint32_t events);
-void atualizar_display(float temp_atual, float setpoint, float erro, float angulo, float motor);
-void desenhar_tela_principal(float temp_atual, float setpoint);
-void desenhar_tela_grafico(float temp_atual);
-void desenhar_tela_info(float erro);
+void tratar_evento(const Evento *evento);
+void tratar_botao(uint gpio);
+void aplicar_comando(const Comando *comando);
+void publicar_estado(void);
+void publicar_config(void);
+void salvar_config(void);
+void carregar_config(void);
+void atualizar_display(const ControleEstado *estado);
+void desenhar_tela_principal(const ControleEstado *estado);
+void desenhar_tela_grafico(const ControleEstado *estado);
+void desenhar_tela_info(const ControleEstado *estado);
+void desenhar_tela_programa(const ControleEstado *estado);
 void desenhar_menu_config();
 void desenhar_tela_setpoint();
+uint32_t display_redesenhos(void);
+void atualizar_status_sistema(void);
+void avancar_programas(void);
+void concluir_ciclo_controle(void);
+void publicar_amostras(void);
+void registrar_telemetria_mqtt(void);
+uint32_t configurar_stream_serial(int taxa_hz);
+
+
+// Monta a resposta de erro para um parâmetro inválido (400, 422 ou 500)
+static const char *responder_erro_parametro(http_param_result_t resultado)
+{
+    static char response_buffer[128];
+    if (resultado.status == HTTP_PARAM_ERR_SPEC)
+        http_server_set_status(500); // A rota descreve parâmetros demais: não é culpa do cliente
+    else
+        http_server_set_status(resultado.status == HTTP_PARAM_ERR_RANGE ? 422 : 400);
+    snprintf(response_buffer, sizeof(response_buffer),
+             "{\"status\":\"error\", \"message\":\"%s\", \"param\":\"%s\"}",
+             http_param_status_str(resultado.status), resultado.name ? resultado.name : "");
+    return response_buffer;
+}
+
+// Rejeita alterações feitas com GET nas rotas que só aceitam POST
+static const char *responder_metodo_invalido(void)
+{
+    http_server_set_status(405);
+    return "{\"status\":\"error\", \"message\":\"use POST para alterar\"}";
+}
+
+// Posta de uma vez os comandos de uma requisição, ou nenhum se não couberem
+static bool postar_na_fila(FilaComandos *fila, const Comando *comandos, int quantidade)
+{
+    if (fila_comandos_livres(fila) < (uint32_t)quantidade)
+    {
+        fila->descartados += quantidade;
+        return false;
+    }
+    for (int i = 0; i < quantidade; i++)
+        fila_comandos_postar(fila, comandos[i]);
+    return true;
+}
+
+static bool postar_comandos(const Comando *comandos, int quantidade)
+{
+    return postar_na_fila(&comandos_rede, comandos, quantidade);
+}
 
+static const char *responder_fila_cheia(void)
+{
+    http_server_set_status(503);
+    return "{\"status\":\"error\", \"message\":\"fila de comandos cheia\"}";
+}
 
-// Função para tratar a requisição "/status"
+// Reserva a carga da rede; false se a do pedido anterior ainda não foi aplicada
+static bool reservar_carga(void)
+{
+    if (carga_rede.ocupada)
+    {
+        comandos_rede.descartados++;
+        return false;
+    }
+    carga_rede.ocupada = true;
+    return true;
+}
+
+// Posta o comando que leva a carga já preenchida; sem espaço na fila, a libera
+static bool postar_com_carga(const Comando *comando)
+{
+    if (postar_comandos(comando, 1))
+        return true;
+    carga_rede.ocupada = false;
+    return false;
+}
+
+// Cópias do estado e da configuração publicados para os handlers. Rodam todos
+// no contexto do lwIP, um de cada vez: uma cópia de cada basta.
+static const ControleEstado *estado_http(void)
+{
+    static ControleEstado estado;
+    seqlock_ler(&estado_controle, &estado);
+    return &estado;
+}
+
+static const ConfigEstado *config_http(void)
+{
+    static ConfigEstado config;
+    seqlock_ler(&config_controle, &config);
+    return &config;
+}
+
+// Especificação do parâmetro opcional "zona" (índice a partir de 0), comum a todas as rotas
+#define PARAM_ZONA(destino) {"zona", HTTP_PARAM_INT, false, 0, NUM_ZONAS - 1, NULL, (destino), NULL}
+
+// Lê apenas o parâmetro "zona" de uma consulta GET
+static bool ler_zona_consulta(const char *request, int *indice, http_param_result_t *resultado)
+{
+    http_param_spec_t params[] = {PARAM_ZONA(indice)};
+    *resultado = http_server_parse_params(request, params, count_of(params));
+    return resultado->status == HTTP_PARAM_OK;
+}
+
+// Função para tratar a requisição "/status" (parâmetro opcional: zona). Os
+// valores vêm de uma única amostra publicada pelo controle.
 const char *status_handler(const char *request)
 {
-    static char response_buffer[256];
+    static char response_buffer[768];
     http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    int indice = 0;
+    http_param_result_t resultado;
+    if (!ler_zona_consulta(request, &indice, &resultado))
+        return responder_erro_parametro(resultado);
+
+    static ControleEstado estado;
+    seqlock_ler(&estado_controle, &estado);
+    const ZonaAmostra *zona = &estado.zonas[indice];
     snprintf(response_buffer, sizeof(response_buffer),
-             "{\"temperatura_atual\": %.2f, \"temperatura_desejada\": %.2f, \"erro\": %.2f, \"angulo_alvo\": %.2f, \"velocidade_ventoinha\": %.2f}",
-             http_temperatura_atual,
-             temperatura_desejada,
-             http_erro,
-             http_angulo_alvo,
-             http_velocidade_ventoinha);
+             "{\"zona\": %d, \"num_zonas\": %d, \"ciclo\": %lu, \"temperatura_atual\": %.2f, \"temperatura_desejada\": %.2f, \"setpoint_alvo\": %.2f, \"erro\": %.2f, \"angulo_alvo\": %.2f, \"velocidade_ventoinha\": %.2f, \"modo\": \"%s\", \"sensor_ok\": %s, \"sensor_estado\": \"%s\", \"sensor_falhas\": %lu, \"sensor_tentativas_recuperacao\": %lu, \"sensor_recuperacoes\": %lu, \"temperatura_critica\": %s, \"duracao_ciclo_us\": %lu, \"motivo_reinicio\": \"%s\", \"reinicios_watchdog\": %lu, \"uptime_anterior_ms\": %lu}",
+             indice,
+             NUM_ZONAS,
+             (unsigned long)estado.ciclo,
+             zona->temperatura_atual,
+             zona->temperatura_desejada,
+             zona->setpoint_alvo,
+             zona->erro,
+             zona->angulo_alvo,
+             zona->velocidade_ventoinha,
+             NOMES_MODO[zona->modo],
+             zona->sensor_ok ? "true" : "false",
+             monitor_sensor_estado_str(zona->sensor_estado),
+             (unsigned long)zona->sensor_falhas,
+             (unsigned long)zona->sensor_tentativas_recuperacao,
+             (unsigned long)zona->sensor_recuperacoes,
+             zona->temperatura_critica ? "true" : "false",
+             (unsigned long)estado.duracao_ciclo_us,
+             supervisor_motivo_str(supervisor_motivo_reinicio()),
+             (unsigned long)supervisor_reinicios(),
+             (unsigned long)supervisor_uptime_anterior_ms());
     return response_buffer;
 }
 
-// Função para tratar a requisição "/set_temperatura?"
+// Setpoint pedido à mão (serial, botões, web ou MQTT): assume o lugar do
+// programa que estiver rodando na zona
+void definir_setpoint(int indice, float setpoint)
+{
+    if (execucoes[indice].programa)
+    {
+        programa_parar(&execucoes[indice]);
+        LOG(LOG_INFO, "[%s] Programa interrompido pelo setpoint manual.\n", zonas[indice].hw.nome);
+    }
+    zona_definir_setpoint(&zonas[indice], setpoint);
+}
+
+// Função para tratar a requisição "/set_temperatura" (POST com temperatura;
+// opcional: taxa, em °C/min, da trajetória até o setpoint)
 const char *set_temperatura_handler(const char *request)
 {
     http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+    if (http_server_request_method() != HTTP_METHOD_POST)
+        return responder_metodo_invalido(); // Só POST passa pelo token
+
+    int indice = 0;
+    float new_temperatura_desejada, taxa = NAN;
+    http_param_spec_t params[] = {
+        {"temperatura", HTTP_PARAM_FLOAT, true, SETPOINT_MIN, SETPOINT_MAX, NULL, &new_temperatura_desejada, NULL},
+        {"taxa", HTTP_PARAM_FLOAT, false, 0.0f, TAXA_SETPOINT_MAX, NULL, &taxa, NULL},
+        PARAM_ZONA(&indice),
+    };
+    http_param_result_t resultado = http_server_parse_params(request, params, count_of(params));
+    if (resultado.status != HTTP_PARAM_OK)
+        return responder_erro_parametro(resultado);
+
+    Comando comandos[2];
+    int n = 0;
+    if (!isnan(taxa))
+        comandos[n++] = (Comando){.tipo = COMANDO_TAXA_SETPOINT, .zona = (uint8_t)indice, .valor = taxa};
+    else
+        taxa = config_http()->zonas[indice].taxa_setpoint;
+    comandos[n++] = (Comando){.tipo = COMANDO_SETPOINT, .zona = (uint8_t)indice, .valor = new_temperatura_desejada};
+    if (!postar_comandos(comandos, n))
+        return responder_fila_cheia();
+
+    static char response_buffer[160];
 
-    float new_temperatura_desejada;
+    snprintf(response_buffer, sizeof(response_buffer),
+             "{\"status\":\"success\", \"message\":\"Settings updated\", \"zona\":%d, \"temperatura_desejada\":%.2f, \"taxa\":%.2f}",
+             indice, new_temperatura_desejada, taxa);
 
-    http_server_parse_float_param(request, "temperatura=", &new_temperatura_desejada);
+    return response_buffer;
+}
 
-    temperatura_desejada = new_temperatura_desejada;
+// Função para tratar a requisição "/ganhos" (GET lê, POST altera kp e/ou ki)
+const char *ganhos_handler(const char *request)
+{
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    int indice = 0;
+    float ganho_p, ganho_i;
+    http_param_result_t resultado;
+    if (http_server_request_method() == HTTP_METHOD_POST)
+    {
+        float kp = NAN, ki = NAN;
+        http_param_spec_t params[] = {
+            {"kp", HTTP_PARAM_FLOAT, false, 0.0f, GANHO_P_MAX, NULL, &kp, NULL},
+            {"ki", HTTP_PARAM_FLOAT, false, 0.0f, GANHO_I_MAX, NULL, &ki, NULL},
+            PARAM_ZONA(&indice),
+        };
+        resultado = http_server_parse_params(request, params, count_of(params));
+        if (resultado.status != HTTP_PARAM_OK)
+            return responder_erro_parametro(resultado);
+
+        Comando comandos[2];
+        int n = 0;
+        if (!isnan(kp))
+            comandos[n++] = (Comando){.tipo = COMANDO_GANHO_P, .zona = (uint8_t)indice, .valor = kp};
+        if (!isnan(ki))
+            comandos[n++] = (Comando){.tipo = COMANDO_GANHO_I, .zona = (uint8_t)indice, .valor = ki};
+        if (!postar_comandos(comandos, n))
+            return responder_fila_cheia();
+        // Responde com os valores pedidos: a tarefa de comandos ainda vai aplicá-los
+        const ZonaConfig *config = &config_http()->zonas[indice];
+        ganho_p = isnan(kp) ? config->ganho_p : kp;
+        ganho_i = isnan(ki) ? config->ganho_i : ki;
+    }
+    else if (!ler_zona_consulta(request, &indice, &resultado))
+    {
+        return responder_erro_parametro(resultado);
+    }
+    else
+    {
+        const ZonaConfig *config = &config_http()->zonas[indice];
+        ganho_p = config->ganho_p;
+        ganho_i = config->ganho_i;
+    }
+
+    static char response_buffer[96];
+    snprintf(response_buffer, sizeof(response_buffer), "{\"zona\": %d, \"kp\": %.3f, \"ki\": %.3f}",
+             indice, ganho_p, ganho_i);
+    return response_buffer;
+}
+
+// Função para tratar a requisição "/modo" (GET lê, POST altera o modo, o ângulo e a ventoinha manuais)
+const char *modo_handler(const char *request)
+{
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    int indice = 0, modo = 0;
+    float angulo = NAN, ventoinha = NAN;
+    http_param_result_t resultado;
+    if (http_server_request_method() == HTTP_METHOD_POST)
+    {
+        http_param_spec_t params[] = {
+            {"modo", HTTP_PARAM_ENUM, true, 0, 0, NOMES_MODO, &modo, NULL},
+            {"angulo", HTTP_PARAM_FLOAT, false, 0.0f, 180.0f, NULL, &angulo, NULL},
+            {"ventoinha", HTTP_PARAM_FLOAT, false, 0.0f, 100.0f, NULL, &ventoinha, NULL},
+            PARAM_ZONA(&indice),
+        };
+        resultado = http_server_parse_params(request, params, count_of(params));
+        if (resultado.status != HTTP_PARAM_OK)
+            return responder_erro_parametro(resultado);
+
+        Comando comando = {.tipo = COMANDO_MODO, .zona = (uint8_t)indice, .inteiro = (int16_t)modo,
+                           .valor = angulo, .valor2 = ventoinha};
+        if (!postar_comandos(&comando, 1))
+            return responder_fila_cheia();
+        if (isnan(angulo))
+            angulo = config_http()->zonas[indice].angulo_manual;
+    }
+    else if (!ler_zona_consulta(request, &indice, &resultado))
+    {
+        return responder_erro_parametro(resultado);
+    }
+    else
+    {
+        const ZonaConfig *config = &config_http()->zonas[indice];
+        modo = estado_http()->zonas[indice].modo;
+        angulo = config->angulo_manual;
+        ventoinha = config->ventoinha_manual;
+    }
 
     static char response_buffer[128];
+    char texto_ventoinha[16] = "null";
+    if (!isnan(ventoinha))
+        snprintf(texto_ventoinha, sizeof(texto_ventoinha), "%.1f", ventoinha);
+    snprintf(response_buffer, sizeof(response_buffer), "{\"zona\": %d, \"modo\": \"%s\", \"angulo\": %.1f, \"ventoinha\": %s}",
+             indice, NOMES_MODO[modo], angulo, texto_ventoinha);
+    return response_buffer;
+}
+
+// Função para tratar a requisição "/limites" (GET lê, POST altera)
+const char *limites_handler(const char *request)
+{
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    int indice = 0;
+    float lim_integral = NAN, ang_min = NAN, ang_max = NAN, ang_seguro = NAN, vent_segura = NAN;
+    http_param_result_t resultado;
+    if (http_server_request_method() == HTTP_METHOD_POST)
+    {
+        http_param_spec_t params[] = {
+            {"integral_max", HTTP_PARAM_FLOAT, false, 0.0f, 180.0f, NULL, &lim_integral, NULL},
+            {"angulo_min", HTTP_PARAM_FLOAT, false, 0.0f, 180.0f, NULL, &ang_min, NULL},
+            {"angulo_max", HTTP_PARAM_FLOAT, false, 0.0f, 180.0f, NULL, &ang_max, NULL},
+            {"angulo_seguro", HTTP_PARAM_FLOAT, false, 0.0f, 180.0f, NULL, &ang_seguro, NULL},
+            {"ventoinha_segura", HTTP_PARAM_FLOAT, false, 0.0f, 100.0f, NULL, &vent_segura, NULL},
+            PARAM_ZONA(&indice),
+        };
+        resultado = http_server_parse_params(request, params, count_of(params));
+        if (resultado.status != HTTP_PARAM_OK)
+            return responder_erro_parametro(resultado);
+
+        const ZonaConfig *config = &config_http()->zonas[indice];
+        if (isnan(ang_min))
+            ang_min = config->angulo_min;
+        if (isnan(ang_max))
+            ang_max = config->angulo_max;
+        if (ang_min >= ang_max)
+        {
+            http_server_set_status(422);
+            return "{\"status\":\"error\", \"message\":\"angulo_min deve ser menor que angulo_max\"}";
+        }
+
+        Comando comandos[3];
+        int n = 0;
+        if (!isnan(lim_integral))
+            comandos[n++] = (Comando){.tipo = COMANDO_LIMITE_INTEGRAL, .zona = (uint8_t)indice, .valor = lim_integral};
+        comandos[n++] = (Comando){.tipo = COMANDO_LIMITES_ANGULO, .zona = (uint8_t)indice, .valor = ang_min, .valor2 = ang_max};
+        if (!isnan(ang_seguro) || !isnan(vent_segura))
+            comandos[n++] = (Comando){.tipo = COMANDO_POSICAO_SEGURA, .zona = (uint8_t)indice,
+                                      .valor = ang_seguro, .valor2 = vent_segura};
+        if (!postar_comandos(comandos, n))
+            return responder_fila_cheia();
+    }
+    else if (!ler_zona_consulta(request, &indice, &resultado))
+    {
+        return responder_erro_parametro(resultado);
+    }
+
+    // Valores não pedidos (ou GET) vêm da configuração publicada
+    const ZonaConfig *config = &config_http()->zonas[indice];
+    if (isnan(lim_integral))
+        lim_integral = config->integral_max;
+    if (isnan(ang_min))
+        ang_min = config->angulo_min;
+    if (isnan(ang_max))
+        ang_max = config->angulo_max;
+    if (isnan(ang_seguro))
+        ang_seguro = config->angulo_seguro;
+    if (isnan(vent_segura))
+        vent_segura = config->ventoinha_segura;
+
+    static char response_buffer[192];
+    snprintf(response_buffer, sizeof(response_buffer),
+             "{\"zona\": %d, \"integral_max\": %.1f, \"angulo_min\": %.1f, \"angulo_max\": %.1f, \"angulo_seguro\": %.1f, \"ventoinha_segura\": %.1f}",
+             indice, lim_integral, ang_min, ang_max, ang_seguro, vent_segura);
+    return response_buffer;
+}
+
+// Função para tratar a requisição "/filtro" (GET lê estado e estatísticas, POST altera a configuração)
+const char *filtro_handler(const char *request)
+{
+    static const char *const NOMES_FILTRO[] = {"nenhum", "ema", "kalman", NULL};
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    int indice = 0;
+    FiltroConfig cfg;
+    http_param_result_t resultado;
+    if (http_server_request_method() == HTTP_METHOD_POST)
+    {
+        int mediana = -1, tipo = -1, burst = -1;
+        float alfa = NAN, q = NAN, r = NAN, limite = NAN, ganho_modelo = NAN;
+        bool modelo, modelo_presente = false;
+        http_param_spec_t params[] = {
+            {"tipo", HTTP_PARAM_ENUM, false, 0, 0, NOMES_FILTRO, &tipo, NULL},
+            {"mediana", HTTP_PARAM_INT, false, 1, FILTRO_MEDIANA_MAX, NULL, &mediana, NULL},
+            {"alfa", HTTP_PARAM_FLOAT, false, 0.01f, 1.0f, NULL, &alfa, NULL},
+            {"q", HTTP_PARAM_FLOAT, false, 0.0001f, 10.0f, NULL, &q, NULL},
+            {"r", HTTP_PARAM_FLOAT, false, 0.0001f, 10.0f, NULL, &r, NULL},
+            {"limite_outlier", HTTP_PARAM_FLOAT, false, 0.0f, 50.0f, NULL, &limite, NULL},
+            {"burst", HTTP_PARAM_INT, false, 1, 4, NULL, &burst, NULL},
+            {"modelo", HTTP_PARAM_BOOL, false, 0, 0, NULL, &modelo, &modelo_presente},
+            {"ganho_modelo", HTTP_PARAM_FLOAT, false, -5.0f, 5.0f, NULL, &ganho_modelo, NULL},
+            PARAM_ZONA(&indice),
+        };
+        resultado = http_server_parse_params(request, params, count_of(params));
+        if (resultado.status != HTTP_PARAM_OK)
+            return responder_erro_parametro(resultado);
+        if (mediana != -1 && mediana % 2 == 0)
+        {
+            http_server_set_status(422);
+            return "{\"status\":\"error\", \"message\":\"mediana deve ser impar\", \"param\":\"mediana\"}";
+        }
+
+        cfg = config_http()->zonas[indice].filtro;
+        if (tipo != -1) cfg.tipo = (FiltroTipo)tipo;
+        if (mediana != -1) cfg.janela_mediana = (uint8_t)mediana;
+        if (burst != -1) cfg.amostras_burst = (uint8_t)burst;
+        if (!isnan(alfa)) cfg.alfa_ema = alfa;
+        if (!isnan(q)) cfg.kalman_q = q;
+        if (!isnan(r)) cfg.kalman_r = r;
+        if (!isnan(limite)) cfg.limite_outlier = limite;
+        if (!isnan(ganho_modelo)) cfg.modelo_ganho = ganho_modelo;
+        if (modelo_presente) cfg.usar_modelo = modelo;
+
+        if (!reservar_carga())
+            return responder_fila_cheia();
+        carga_rede.filtro = cfg;
+        Comando comando = {.tipo = COMANDO_FILTRO, .zona = (uint8_t)indice};
+        if (!postar_com_carga(&comando))
+            return responder_fila_cheia();
+        // A configuração da resposta é a pedida; as estatísticas ainda são da anterior
+    }
+    else if (!ler_zona_consulta(request, &indice, &resultado))
+    {
+        return responder_erro_parametro(resultado);
+    }
+    else
+    {
+        cfg = config_http()->zonas[indice].filtro;
+    }
+
+    const ZonaAmostra *zona = &estado_http()->zonas[indice];
+    static char response_buffer[512];
+    snprintf(response_buffer, sizeof(response_buffer),
+             "{\"zona\": %d, \"tipo\": \"%s\", \"mediana\": %d, \"alfa\": %.3f, \"q\": %.4f, \"r\": %.4f, "
+             "\"modelo\": %s, \"ganho_modelo\": %.3f, \"limite_outlier\": %.2f, \"burst\": %d, "
+             "\"temperatura_bruta\": %.2f, \"estimativa\": %.2f, \"variancia\": %.5f, "
+             "\"amostras\": %lu, \"rejeitadas_outlier\": %lu, \"rejeitadas_sensor\": %lu, "
+             "\"latencia_us\": %lu, \"latencia_max_us\": %lu, \"tempo_filtro_us\": %lu}",
+             indice, NOMES_FILTRO[cfg.tipo], cfg.janela_mediana, cfg.alfa_ema, cfg.kalman_q, cfg.kalman_r,
+             cfg.usar_modelo ? "true" : "false", cfg.modelo_ganho, cfg.limite_outlier, cfg.amostras_burst,
+             zona->temperatura_bruta, zona->estimativa, zona->variancia,
+             (unsigned long)zona->filtro_amostras, (unsigned long)zona->rejeitadas_outlier,
+             (unsigned long)zona->rejeitadas_sensor, (unsigned long)zona->latencia_us,
+             (unsigned long)zona->latencia_max_us, (unsigned long)zona->tempo_filtro_us);
+    return response_buffer;
+}
+
+// Função para tratar a requisição "/i2c" (métricas da fila de cada barramento)
+const char *i2c_handler(const char *request)
+{
+    static char response_buffer[512];
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    size_t len = snprintf(response_buffer, sizeof(response_buffer), "{\"barramentos\": [");
+    i2c_inst_t *const portas[] = {i2c0, i2c1};
+    for (int i = 0; i < 2; i++)
+    {
+        I2CFilaEstatisticas e;
+        i2c_fila_estatisticas(portas[i], &e);
+        float utilizacao = e.tempo_total_us ? 100.0f * (float)e.tempo_ocupado_us / (float)e.tempo_total_us : 0.0f;
+        len += snprintf(response_buffer + len, sizeof(response_buffer) - len,
+                        "%s{\"i2c\": %d, \"frequencia_hz\": %lu, \"profundidade\": %u, \"profundidade_max\": %u, "
+                        "\"concluidas\": %lu, \"erros\": %lu, \"timeouts\": %lu, \"bytes\": %lu, \"utilizacao\": %.2f}",
+                        i ? ", " : "", i, (unsigned long)e.frequencia_hz, e.profundidade, e.profundidade_max,
+                        (unsigned long)e.concluidas, (unsigned long)e.erros, (unsigned long)e.timeouts,
+                        (unsigned long)e.bytes, utilizacao);
+    }
+    snprintf(response_buffer + len, sizeof(response_buffer) - len, "]}");
+    return response_buffer;
+}
+
+// Função para tratar a requisição "/tarefas" (estatísticas do agendador)
+const char *tarefas_handler(const char *request)
+{
+    static char response_buffer[1024];
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    size_t len = snprintf(response_buffer, sizeof(response_buffer),
+                          "{\"eventos_descartados\": %lu, \"widgets_redesenhados\": %lu, \"tarefas\": [",
+                          (unsigned long)agendador_eventos_descartados(), (unsigned long)display_redesenhos());
+    for (int i = 0; i < agendador_num_tarefas() && len < sizeof(response_buffer); i++)
+    {
+        const Tarefa *t = agendador_tarefa(i);
+        len += snprintf(response_buffer + len, sizeof(response_buffer) - len,
+                        "%s{\"nome\": \"%s\", \"periodo_us\": %lu, \"execucoes\": %lu, \"duracao_us\": %lu, "
+                        "\"duracao_max_us\": %lu, \"estouros\": %lu, \"atrasos\": %lu}",
+                        i ? ", " : "", t->nome, (unsigned long)t->periodo_us, (unsigned long)t->execucoes,
+                        (unsigned long)t->duracao_us, (unsigned long)t->duracao_max_us,
+                        (unsigned long)t->estouros, (unsigned long)t->atrasos);
+    }
+    if (len < sizeof(response_buffer))
+        snprintf(response_buffer + len, sizeof(response_buffer) - len, "]}");
+    return response_buffer;
+}
+
+// Fases do boot em JSON (ms desde o reset; null se ainda não aconteceu)
+static int boot_json(char *buffer, size_t tamanho)
+{
+    WifiEstatisticas w;
+    wifi_estatisticas(&w);
+    const uint32_t instantes[] = {boot_us[BOOT_CONTROLE], boot_us[BOOT_PRIMEIRO_CICLO], boot_us[BOOT_RADIO],
+                                  w.associado_us, w.endereco_us};
+    static const char *const nomes[] = {"controle", "primeiro_ciclo", "radio", "associado", "endereco"};
+    int n = snprintf(buffer, tamanho, "{");
+    for (int i = 0; i < (int)count_of(instantes) && n < (int)tamanho; i++)
+    {
+        if (instantes[i])
+            n += snprintf(buffer + n, tamanho - n, "%s\"%s\": %.1f", i ? ", " : "", nomes[i], instantes[i] / 1000.0f);
+        else
+            n += snprintf(buffer + n, tamanho - n, "%s\"%s\": null", i ? ", " : "", nomes[i]);
+    }
+    if (n < (int)tamanho)
+        n += snprintf(buffer + n, tamanho - n, "}");
+    return n;
+}
+
+// Função para tratar a requisição "/rede" (estado do Wi-Fi e fases do boot)
+const char *rede_handler(const char *request)
+{
+    static char response_buffer[640];
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    WifiEstatisticas w;
+    wifi_estatisticas(&w);
+    http_server_stats_t h;
+    http_server_get_stats(&h);
+    int n = snprintf(response_buffer, sizeof(response_buffer),
+                     "{\"ssid\": \"%s\", \"estado\": \"%s\", \"ip\": \"%s\", \"tentativas\": %lu, \"falhas\": %lu, "
+                     "\"quedas\": %lu, \"conexoes\": %lu, \"backoff_ms\": %lu, "
+                     "\"http\": {\"conexoes\": %u, \"conexoes_max\": %u, \"recusadas_conexoes\": %lu, "
+                     "\"recusadas_ip\": %lu, \"recusadas_taxa\": %lu, \"recusadas_token\": %lu, "
+                     "\"expiradas\": %lu}, \"boot_ms\": ",
+                     SSID, wifi_estado_str(w.estado), w.ip, (unsigned long)w.tentativas, (unsigned long)w.falhas,
+                     (unsigned long)w.quedas, (unsigned long)w.conexoes, (unsigned long)w.backoff_ms, h.connections,
+                     h.connections_max, (unsigned long)h.rejected_connections, (unsigned long)h.rejected_per_ip,
+                     (unsigned long)h.rejected_rate, (unsigned long)h.rejected_auth, (unsigned long)h.idle_timeouts);
+    if (n < (int)sizeof(response_buffer))
+        n += boot_json(response_buffer + n, sizeof(response_buffer) - n);
+    if (n < (int)sizeof(response_buffer))
+        snprintf(response_buffer + n, sizeof(response_buffer) - n, "}");
+    return response_buffer;
+}
+
+// --- Atualização OTA ---
+// O upload chega em fluxo pelo servidor (http_upload_handler_t) e vai direto
+// para o banco inativo; o reinício fica para tarefa_rede, depois da resposta.
+static uint32_t reinicio_atualizacao_ms; // 0 = nenhum reinício pendente
+
+// "sha256=<64 hex>" da query string (maior que um valor de http_params)
+static bool ler_sha256_query(const char *alvo, uint8_t sha256[SHA256_TAMANHO])
+{
+    const char *query = strchr(alvo, '?');
+    const char *valor = query ? strstr(query, "sha256=") : NULL;
+    if (!valor || (valor[-1] != '?' && valor[-1] != '&'))
+        return false;
+    valor += strlen("sha256=");
+    for (int i = 0; i < 2 * SHA256_TAMANHO; i++)
+    {
+        int c = tolower((unsigned char)valor[i]);
+        int digito = isdigit(c) ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+        if (digito < 0)
+            return false;
+        if (i % 2 == 0)
+            sha256[i / 2] = (uint8_t)(digito << 4);
+        else
+            sha256[i / 2] |= (uint8_t)digito;
+    }
+    return valor[2 * SHA256_TAMANHO] == '\0' || valor[2 * SHA256_TAMANHO] == '&';
+}
+
+static int status_http_ota(OtaResultado resultado)
+{
+    switch (resultado)
+    {
+    case OTA_ERRO_OCUPADO:
+    case OTA_ERRO_EM_TESTE:
+        return 409;
+    case OTA_ERRO_TAMANHO:
+        return 413;
+    case OTA_ERRO_HASH:
+    case OTA_ERRO_IMAGEM:
+        return 422;
+    case OTA_ERRO_INCOMPLETO:
+        return 400;
+    default:
+        return 500;
+    }
+}
+
+static const char *responder_erro_ota(int status, const char *mensagem)
+{
+    static char response_buffer[128];
+    http_server_set_status(status);
+    snprintf(response_buffer, sizeof(response_buffer), "{\"status\":\"error\", \"message\":\"%s\"}", mensagem);
+    return response_buffer;
+}
+
+static const char *responder_estado_ota(void)
+{
+    static char response_buffer[320];
+    OtaEstatisticas e;
+    ota_estatisticas(&e);
+    snprintf(response_buffer, sizeof(response_buffer),
+             "{\"banco\": \"%c\", \"estado\": \"%s\", \"em_teste\": %s, \"baixando\": %s, \"recebido\": %lu, "
+             "\"tamanho\": %lu, \"downloads\": %lu, \"falhas\": %lu, \"ultimo_erro\": \"%s\", "
+             "\"reinicio_pendente\": %s}",
+             'A' + e.banco, ota_estado_str(e.estado), e.em_teste ? "true" : "false", e.baixando ? "true" : "false",
+             (unsigned long)e.recebido, (unsigned long)e.tamanho, (unsigned long)e.downloads,
+             (unsigned long)e.falhas, ota_resultado_str(e.ultimo_erro), reinicio_atualizacao_ms ? "true" : "false");
+    return response_buffer;
+}
+
+// "/update": GET consulta; POST ?sha256=... com a imagem (.bin) no corpo (o
+// servidor já conferiu o token)
+const char *update_iniciar(const char *request, uint32_t tamanho)
+{
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+    if (http_server_request_method() != HTTP_METHOD_POST)
+        return responder_estado_ota();
+
+    uint8_t sha256[SHA256_TAMANHO];
+    if (!ler_sha256_query(request, sha256))
+        return responder_erro_ota(400, "sha256 ausente ou invalido");
+    if (reinicio_atualizacao_ms)
+        return responder_erro_ota(409, "reinicio pendente");
+    OtaResultado resultado = ota_download_iniciar(tamanho, sha256);
+    if (resultado != OTA_OK)
+        return responder_erro_ota(status_http_ota(resultado), ota_resultado_str(resultado));
+    LOG(LOG_INFO, "OTA: recebendo %lu bytes.\n", (unsigned long)tamanho);
+    return NULL;
+}
+
+bool update_escrever(const uint8_t *dados, size_t tamanho)
+{
+    return ota_download_escrever(dados, tamanho) == OTA_OK;
+}
+
+const char *update_concluir(bool completo)
+{
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+    OtaResultado resultado;
+    if (completo)
+    {
+        resultado = ota_download_concluir();
+    }
+    else
+    {
+        ota_download_abortar(); // Sem efeito se a falha veio da própria escrita
+        OtaEstatisticas e;
+        ota_estatisticas(&e);
+        resultado = e.ultimo_erro;
+    }
+    if (resultado != OTA_OK)
+    {
+        LOG(LOG_ERRO, "OTA: %s.\n", ota_resultado_str(resultado));
+        return responder_erro_ota(status_http_ota(resultado), ota_resultado_str(resultado));
+    }
+
+    LOG(LOG_INFO, "OTA: imagem conferida; reiniciando para testa-la.\n");
+    reinicio_atualizacao_ms = to_ms_since_boot(get_absolute_time()) + OTA_REINICIO_ATRASO_MS;
+    return responder_estado_ota();
+}
+
+// Imagem nova em teste: confirma depois de OTA_SAUDE_MS de ciclos com todas as
+// zonas lidas e sem alarme crítico; sem isso até OTA_PRAZO_MS, reinicia e o
+// bootloader volta ao banco anterior.
+static void acompanhar_atualizacao(bool saudavel, uint32_t agora_ms)
+{
+    static uint32_t saudavel_desde_ms;
+    OtaEstatisticas e;
+    ota_estatisticas(&e);
+    if (!e.em_teste)
+        return;
+    if (!saudavel)
+        saudavel_desde_ms = agora_ms;
+    else if (agora_ms - saudavel_desde_ms >= OTA_SAUDE_MS && ota_confirmar())
+    {
+        LOG(LOG_INFO, "OTA: imagem do banco %c confirmada.\n", 'A' + e.banco);
+        return;
+    }
+    if (agora_ms >= OTA_PRAZO_MS)
+    {
+        LOG(LOG_ERRO, "OTA: imagem nao confirmada no prazo; voltando ao banco anterior.\n");
+        supervisor_reiniciar(REINICIO_SEM_CONFIRMACAO);
+    }
+}
+
+// Função para tratar a requisição "/mqtt" (estado da conexão e da fila offline)
+const char *mqtt_handler(const char *request)
+{
+    static char response_buffer[480];
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    MqttEstatisticas e;
+    mqtt_telemetria_estatisticas(&e);
+    snprintf(response_buffer, sizeof(response_buffer),
+             "{\"broker\": \"%s\", \"prefixo\": \"%s\", \"estado\": \"%s\", \"periodo_ms\": %lu, \"qos\": %d, "
+             "\"conexoes\": %lu, \"falhas_conexao\": %lu, \"backoff_ms\": %lu, \"fila_offline\": %u, "
+             "\"lotes_publicados\": %lu, \"lotes_confirmados\": %lu, \"lotes_reenviados\": %lu, \"lotes_descartados\": %lu, "
+             "\"registros_descartados\": %lu, \"comandos_recebidos\": %lu, \"comandos_descartados\": %lu}",
+             MQTT_BROKER, MQTT_PREFIXO, mqtt_telemetria_estado_str(e.estado), (unsigned long)e.periodo_ms, MQTT_QOS,
+             (unsigned long)e.conexoes, (unsigned long)e.falhas_conexao, (unsigned long)e.backoff_ms,
+             e.fila_offline, (unsigned long)e.lotes_publicados, (unsigned long)e.lotes_confirmados,
+             (unsigned long)e.lotes_reenviados, (unsigned long)e.lotes_descartados,
+             (unsigned long)e.registros_descartados, (unsigned long)e.comandos_recebidos, (unsigned long)e.comandos_descartados);
+    return response_buffer;
+}
 
+// Função para tratar a requisição "/udp" (GET consulta, POST liga/desliga e configura o fluxo)
+const char *udp_handler(const char *request)
+{
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    FluxoUdp fluxo = config_http()->udp;
+    if (http_server_request_method() == HTTP_METHOD_POST)
+    {
+        http_param_spec_t params[] = {
+            {"ativo", HTTP_PARAM_BOOL, false, 0, 0, NULL, &fluxo.ativo, NULL},
+            {"destino", HTTP_PARAM_STRING, false, 0, 0, NULL, fluxo.destino, NULL},
+            {"porta", HTTP_PARAM_INT, false, 1, 65535, NULL, &fluxo.porta, NULL},
+            {"taxa_hz", HTTP_PARAM_INT, false, 1, UDP_TAXA_MAX_HZ, NULL, &fluxo.taxa_hz, NULL},
+            {"amostras_por_pacote", HTTP_PARAM_INT, false, 1, TELEMETRIA_UDP_LOTE_MAX, NULL, &fluxo.amostras_por_pacote, NULL},
+        };
+        http_param_result_t resultado = http_server_parse_params(request, params, count_of(params));
+        if (resultado.status != HTTP_PARAM_OK)
+            return responder_erro_parametro(resultado);
+        if (!telemetria_udp_destino_valido(fluxo.destino))
+        {
+            resultado = (http_param_result_t){HTTP_PARAM_ERR_RANGE, "destino"};
+            return responder_erro_parametro(resultado);
+        }
+
+        if (!reservar_carga())
+            return responder_fila_cheia();
+        carga_rede.udp = fluxo;
+        Comando comando = {.tipo = COMANDO_UDP};
+        if (!postar_com_carga(&comando))
+            return responder_fila_cheia();
+    }
+
+    static char response_buffer[256];
+    TelemetriaUdpEstatisticas e;
+    telemetria_udp_estatisticas(&e);
     snprintf(response_buffer, sizeof(response_buffer),
-             "{\"status\":\"success\", \"message\":\"Settings updated\", \"temperatura_desejada\":%.2f}",
-             temperatura_desejada);
+             "{\"ativo\": %s, \"destino\": \"%s\", \"porta\": %d, \"taxa_hz\": %d, \"amostras_por_pacote\": %d, "
+             "\"pacotes\": %lu, \"amostras\": %lu, \"erros_envio\": %lu}",
+             fluxo.ativo ? "true" : "false", fluxo.destino, fluxo.porta, fluxo.taxa_hz,
+             fluxo.amostras_por_pacote, (unsigned long)e.pacotes, (unsigned long)e.amostras,
+             (unsigned long)e.erros_envio);
+    return response_buffer;
+}
+
+// Temperatura ambiente informada por uma fonte externa (HTTP ou MQTT), comum a todas as zonas
+static void definir_temperatura_ambiente(float ambiente)
+{
+    for (int i = 0; i < NUM_ZONAS; i++)
+        zonas[i].temperatura_ambiente = ambiente;
+}
+
+// Função para tratar a requisição "/feedforward" (GET lê o termo atual, POST liga/desliga e informa o ambiente)
+const char *feedforward_handler(const char *request)
+{
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    int indice = 0;
+    http_param_result_t resultado;
+    if (http_server_request_method() == HTTP_METHOD_POST)
+    {
+        bool ativo, ativo_presente = false;
+        float ambiente = NAN;
+        http_param_spec_t params[] = {
+            {"ativo", HTTP_PARAM_BOOL, false, 0, 0, NULL, &ativo, &ativo_presente},
+            {"ambiente", HTTP_PARAM_FLOAT, false, AMBIENTE_MIN, AMBIENTE_MAX, NULL, &ambiente, NULL},
+            PARAM_ZONA(&indice),
+        };
+        resultado = http_server_parse_params(request, params, count_of(params));
+        if (resultado.status != HTTP_PARAM_OK)
+            return responder_erro_parametro(resultado);
+
+        Comando comandos[2];
+        int n = 0;
+        if (!isnan(ambiente))
+            comandos[n++] = (Comando){.tipo = COMANDO_AMBIENTE, .valor = ambiente};
+        if (ativo_presente)
+            comandos[n++] = (Comando){.tipo = COMANDO_FEEDFORWARD, .zona = (uint8_t)indice, .inteiro = ativo};
+        if (!postar_comandos(comandos, n))
+            return responder_fila_cheia();
+        // O termo e o ambiente da resposta só mudam depois de aplicados
+    }
+    else if (!ler_zona_consulta(request, &indice, &resultado))
+    {
+        return responder_erro_parametro(resultado);
+    }
+
+    static char response_buffer[256];
+    const ZonaAmostra *zona = &estado_http()->zonas[indice];
+    const ZonaConfig *config = &config_http()->zonas[indice];
+    char ambiente[16] = "null";
+    if (!isnan(config->temperatura_ambiente))
+        snprintf(ambiente, sizeof(ambiente), "%.1f", config->temperatura_ambiente);
+    snprintf(response_buffer, sizeof(response_buffer),
+             "{\"zona\": %d, \"ativo\": %s, \"termo\": %.2f, \"previsto\": %.2f, \"ambiente\": %s, "
+             "\"ambiente_ref\": %.1f, \"umidade\": %.1f, \"termo_integral\": %.2f}",
+             indice, config->feedforward_ativo ? "true" : "false", zona->termo_feedforward,
+             feedforward_calcular(config->feedforward, zona->temperatura_desejada, zona->umidade, config->temperatura_ambiente),
+             ambiente, config->feedforward->ambiente_ref, zona->umidade, zona->termo_integral);
+    return response_buffer;
+}
+
+// Função para tratar a requisição "/atuadores" (GET mostra comandado x real, POST altera os perfis e a alocação)
+const char *atuadores_handler(const char *request)
+{
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    int indice = 0, alocacao = -1;
+    float velocidade = NAN, aceleracao = NAN, banda_morta = NAN, rampa = NAN, divisao = NAN, sobreposicao = NAN;
+    http_param_result_t resultado;
+    if (http_server_request_method() == HTTP_METHOD_POST)
+    {
+        http_param_spec_t params[] = {
+            {"alocacao", HTTP_PARAM_ENUM, false, 0, 0, NOMES_ALOCACAO, &alocacao, NULL},
+            {"divisao", HTTP_PARAM_FLOAT, false, 0.1f, 0.9f, NULL, &divisao, NULL},
+            {"sobreposicao", HTTP_PARAM_FLOAT, false, 0.0f, 0.5f, NULL, &sobreposicao, NULL},
+            {"velocidade_servo", HTTP_PARAM_FLOAT, false, 0.0f, 1000.0f, NULL, &velocidade, NULL},
+            {"aceleracao_servo", HTTP_PARAM_FLOAT, false, 0.0f, 10000.0f, NULL, &aceleracao, NULL},
+            {"banda_morta", HTTP_PARAM_FLOAT, false, 0.0f, 10.0f, NULL, &banda_morta, NULL},
+            {"rampa_ventoinha", HTTP_PARAM_FLOAT, false, 0.0f, 1000.0f, NULL, &rampa, NULL},
+            PARAM_ZONA(&indice),
+        };
+        resultado = http_server_parse_params(request, params, count_of(params));
+        if (resultado.status != HTTP_PARAM_OK)
+            return responder_erro_parametro(resultado);
+
+        Comando comandos[4];
+        int n = 0;
+        if (alocacao >= 0 || !isnan(divisao) || !isnan(sobreposicao))
+            comandos[n++] = (Comando){.tipo = COMANDO_ALOCACAO, .zona = (uint8_t)indice, .inteiro = (int16_t)alocacao,
+                                      .valor = divisao, .valor2 = sobreposicao};
+        if (!isnan(velocidade) || !isnan(aceleracao))
+            comandos[n++] = (Comando){.tipo = COMANDO_PERFIL_SERVO, .zona = (uint8_t)indice,
+                                      .valor = velocidade, .valor2 = aceleracao};
+        if (!isnan(banda_morta))
+            comandos[n++] = (Comando){.tipo = COMANDO_BANDA_MORTA, .zona = (uint8_t)indice, .valor = banda_morta};
+        if (!isnan(rampa))
+            comandos[n++] = (Comando){.tipo = COMANDO_RAMPA_VENTOINHA, .zona = (uint8_t)indice, .valor = rampa};
+        if (!postar_comandos(comandos, n))
+            return responder_fila_cheia();
+    }
+    else if (!ler_zona_consulta(request, &indice, &resultado))
+    {
+        return responder_erro_parametro(resultado);
+    }
+
+    // Valores não pedidos (ou GET) vêm da configuração publicada
+    const ConfigEstado *configs = config_http();
+    const ZonaConfig *config = &configs->zonas[indice];
+    if (alocacao < 0)
+        alocacao = config->alocacao;
+    if (isnan(divisao))
+        divisao = config->divisao;
+    if (isnan(sobreposicao))
+        sobreposicao = config->sobreposicao;
+    if (isnan(velocidade))
+        velocidade = config->servo_velocidade_max;
+    if (isnan(aceleracao))
+        aceleracao = config->servo_aceleracao_max;
+    if (isnan(banda_morta))
+        banda_morta = config->servo_banda_morta;
+    if (isnan(rampa))
+        rampa = config->ventoinha_rampa;
+
+    AtuadoresEstatisticas e;
+    atuadores_estatisticas(&e);
+
+    static char response_buffer[576];
+    const ZonaAmostra *zona = &estado_http()->zonas[indice];
+    snprintf(response_buffer, sizeof(response_buffer),
+             "{\"zona\": %d, \"alocacao\": \"%s\", \"divisao\": %.2f, \"sobreposicao\": %.2f, \"demanda\": %.1f, "
+             "\"servo\": {\"comandado\": %.1f, \"atual\": %.1f, \"velocidade\": %.1f, "
+             "\"velocidade_max\": %.1f, \"aceleracao_max\": %.1f, \"banda_morta\": %.2f, \"ignorados\": %lu}, "
+             "\"ventoinha\": {\"comandado\": %.1f, \"atual\": %.1f, \"rampa\": %.1f, \"duty\": %.1f}, "
+             "\"frequencia_hz\": %.1f, \"execucoes\": %lu, \"duracao_us\": %lu, \"duracao_max_us\": %lu}",
+             indice, NOMES_ALOCACAO[alocacao], divisao, sobreposicao, zona->demanda, zona->servo_alvo,
+             zona->servo_posicao, zona->servo_velocidade, velocidade, aceleracao, banda_morta,
+             (unsigned long)zona->servo_ignorados, zona->ventoinha_alvo, zona->ventoinha_posicao, rampa,
+             zona->duty_ventoinha, configs->zonas[0].pwm_servo.frequencia_real, (unsigned long)e.execucoes,
+             (unsigned long)e.duracao_us, (unsigned long)e.duracao_max_us);
+    return response_buffer;
+}
+
+// Função para tratar a requisição "/pwm" (GET lê, POST altera frequência e resolução dos atuadores e a partida da ventoinha)
+const char *pwm_handler(const char *request)
+{
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    int indice = 0;
+    http_param_result_t resultado;
+    if (http_server_request_method() == HTTP_METHOD_POST)
+    {
+        int freq_servo = 0, bits_servo = 0, freq_ventoinha = 0, bits_ventoinha = 0, partida_ms = -1;
+        float partida_duty = NAN;
+        http_param_spec_t params[] = {
+            {"frequencia_servo", HTTP_PARAM_INT, false, 40, 400, NULL, &freq_servo, NULL},
+            {"resolucao_servo", HTTP_PARAM_INT, false, 8, 16, NULL, &bits_servo, NULL},
+            {"frequencia_ventoinha", HTTP_PARAM_INT, false, 1000, 100000, NULL, &freq_ventoinha, NULL},
+            {"resolucao_ventoinha", HTTP_PARAM_INT, false, 8, 16, NULL, &bits_ventoinha, NULL},
+            {"partida_duty", HTTP_PARAM_FLOAT, false, 0.0f, 100.0f, NULL, &partida_duty, NULL},
+            {"partida_ms", HTTP_PARAM_INT, false, 0, 2000, NULL, &partida_ms, NULL},
+            PARAM_ZONA(&indice),
+        };
+        resultado = http_server_parse_params(request, params, count_of(params));
+        if (resultado.status != HTTP_PARAM_OK)
+            return responder_erro_parametro(resultado);
+
+        // Valida a combinação contra o divisor aqui: a tarefa de comandos não tem a quem responder
+        const ZonaConfig *config = &config_http()->zonas[indice];
+        Comando comandos[3];
+        int n = 0;
+        if (freq_servo || bits_servo)
+        {
+            uint32_t frequencia = freq_servo ? (uint32_t)freq_servo : config->pwm_servo.frequencia_hz;
+            uint8_t bits = bits_servo ? (uint8_t)bits_servo : config->pwm_servo.resolucao_bits;
+            if (!zona_pwm_valido(frequencia, bits))
+            {
+                http_server_set_status(422);
+                return "{\"status\":\"error\", \"message\":\"frequencia_servo e resolucao_servo fora do divisor do PWM\"}";
+            }
+            comandos[n++] = (Comando){.tipo = COMANDO_PWM, .zona = (uint8_t)indice, .inteiro = 1,
+                                      .valor = (float)frequencia, .valor2 = bits};
+        }
+        if (freq_ventoinha || bits_ventoinha)
+        {
+            uint32_t frequencia = freq_ventoinha ? (uint32_t)freq_ventoinha : config->pwm_ventoinha.frequencia_hz;
+            uint8_t bits = bits_ventoinha ? (uint8_t)bits_ventoinha : config->pwm_ventoinha.resolucao_bits;
+            if (!zona_pwm_valido(frequencia, bits))
+            {
+                http_server_set_status(422);
+                return "{\"status\":\"error\", \"message\":\"frequencia_ventoinha e resolucao_ventoinha fora do divisor do PWM\"}";
+            }
+            comandos[n++] = (Comando){.tipo = COMANDO_PWM, .zona = (uint8_t)indice, .inteiro = 0,
+                                      .valor = (float)frequencia, .valor2 = bits};
+        }
+        if (!isnan(partida_duty) || partida_ms >= 0)
+            comandos[n++] = (Comando){.tipo = COMANDO_PARTIDA_VENTOINHA, .zona = (uint8_t)indice, .valor = partida_duty,
+                                      .valor2 = partida_ms >= 0 ? partida_ms / 1000.0f : NAN};
+        if (!postar_comandos(comandos, n))
+            return responder_fila_cheia();
+        // A resposta mostra a configuração anterior: a frequência real só sai do divisor aplicado
+    }
+    else if (!ler_zona_consulta(request, &indice, &resultado))
+    {
+        return responder_erro_parametro(resultado);
+    }
+
+    static char response_buffer[384];
+    const ZonaConfig *zona = &config_http()->zonas[indice];
+    const VentoinhaCurva *curva = &zona->curva_ventoinha;
+    int n = snprintf(response_buffer, sizeof(response_buffer),
+                     "{\"zona\": %d, \"servo\": {\"frequencia_hz\": %.2f, \"resolucao_bits\": %d}, "
+                     "\"ventoinha\": {\"frequencia_hz\": %.0f, \"resolucao_bits\": %d, \"partida_duty\": %.0f, "
+                     "\"partida_ms\": %d, \"curva\": [",
+                     indice, zona->pwm_servo.frequencia_real, zona->pwm_servo.resolucao_bits,
+                     zona->pwm_ventoinha.frequencia_real, zona->pwm_ventoinha.resolucao_bits, curva->partida_duty,
+                     (int)(curva->partida_s * 1000.0f + 0.5f));
+    for (int i = 0; i < VENTOINHA_PONTOS_CURVA && n < (int)sizeof(response_buffer); i++)
+        n += snprintf(response_buffer + n, sizeof(response_buffer) - n, "%s%.0f", i ? ", " : "", curva->duty[i]);
+    if (n < (int)sizeof(response_buffer))
+        snprintf(response_buffer + n, sizeof(response_buffer) - n, "]}}");
+    return response_buffer;
+}
+
+// Função para tratar a requisição "/escalonamento" (GET lê a tabela, POST edita pontos e liga/desliga)
+const char *escalonamento_handler(const char *request)
+{
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    int indice = 0;
+    Escalonamento tabela;
+    bool ligado;
+    http_param_result_t resultado;
+    if (http_server_request_method() == HTTP_METHOD_POST)
+    {
+        bool ativo, ativo_presente = false, remover = false, limpar = false;
+        int chave = -1;
+        float ponto = NAN, kp = NAN, ki = NAN;
+        http_param_spec_t params[] = {
+            {"ativo", HTTP_PARAM_BOOL, false, 0, 0, NULL, &ativo, &ativo_presente},
+            {"chave", HTTP_PARAM_ENUM, false, 0, 0, NOMES_CHAVE_ESCALONAMENTO, &chave, NULL},
+            {"ponto", HTTP_PARAM_FLOAT, false, 0.0f, 100.0f, NULL, &ponto, NULL},
+            {"kp", HTTP_PARAM_FLOAT, false, 0.0f, GANHO_P_MAX, NULL, &kp, NULL},
+            {"ki", HTTP_PARAM_FLOAT, false, 0.0f, GANHO_I_MAX, NULL, &ki, NULL},
+            {"remover", HTTP_PARAM_BOOL, false, 0, 0, NULL, &remover, NULL},
+            {"limpar", HTTP_PARAM_BOOL, false, 0, 0, NULL, &limpar, NULL},
+            PARAM_ZONA(&indice),
+        };
+        resultado = http_server_parse_params(request, params, count_of(params));
+        if (resultado.status != HTTP_PARAM_OK)
+            return responder_erro_parametro(resultado);
+
+        // Valida tudo numa cópia da tabela publicada
+        const ZonaConfig *config = &config_http()->zonas[indice];
+        tabela = config->escalonamento;
+        if (limpar || (chave >= 0 && (EscalonamentoChave)chave != tabela.chave))
+            tabela.quantidade = 0; // Os pontos de uma chave não valem para a outra
+        if (chave >= 0)
+            tabela.chave = (EscalonamentoChave)chave;
+        if (!isnan(ponto))
+        {
+            bool ok;
+            if (remover)
+                ok = escalonamento_remover_ponto(&tabela, ponto);
+            else if (isnan(kp) || isnan(ki))
+                ok = false;
+            else
+                ok = escalonamento_definir_ponto(&tabela, ponto, kp, ki);
+            if (!ok)
+            {
+                http_server_set_status(422);
+                return remover ? "{\"status\":\"error\", \"message\":\"ponto inexistente\"}"
+                               : "{\"status\":\"error\", \"message\":\"informe kp e ki (tabela com no maximo 8 pontos)\"}";
+            }
+        }
+        if (ativo_presente && ativo && tabela.quantidade == 0)
+        {
+            http_server_set_status(422);
+            return "{\"status\":\"error\", \"message\":\"tabela vazia\"}";
+        }
+
+        if (!reservar_carga())
+            return responder_fila_cheia();
+        carga_rede.escalonamento = tabela;
+        Comando comando = {.tipo = COMANDO_ESCALONAMENTO, .zona = (uint8_t)indice,
+                           .inteiro = ativo_presente ? ativo : -1};
+        if (!postar_com_carga(&comando))
+            return responder_fila_cheia();
+        ligado = (ativo_presente ? ativo : config->escalonamento_ativo) && tabela.quantidade > 0;
+    }
+    else if (!ler_zona_consulta(request, &indice, &resultado))
+    {
+        return responder_erro_parametro(resultado);
+    }
+    else
+    {
+        const ZonaConfig *config = &config_http()->zonas[indice];
+        tabela = config->escalonamento;
+        ligado = config->escalonamento_ativo;
+    }
+
+    // Após um POST a tabela é a pedida; os ganhos aplicados ainda são os do último ciclo
+    static char response_buffer[640];
+    const ZonaAmostra *zona = &estado_http()->zonas[indice];
+    int n = snprintf(response_buffer, sizeof(response_buffer),
+                     "{\"zona\": %d, \"ativo\": %s, \"chave\": \"%s\", \"kp_aplicado\": %.3f, \"ki_aplicado\": %.4f, "
+                     "\"gravacoes\": %lu, \"pontos\": [",
+                     indice, ligado ? "true" : "false", NOMES_CHAVE_ESCALONAMENTO[tabela.chave],
+                     zona->ganho_p_aplicado, zona->ganho_i_aplicado, (unsigned long)persistencia_gravacoes());
+    for (int i = 0; i < tabela.quantidade && n < (int)sizeof(response_buffer); i++)
+        n += snprintf(response_buffer + n, sizeof(response_buffer) - n, "%s{\"ponto\": %.2f, \"kp\": %.3f, \"ki\": %.4f}",
+                      i ? ", " : "", tabela.pontos[i].chave, tabela.pontos[i].ganho_p, tabela.pontos[i].ganho_i);
+    if (n < (int)sizeof(response_buffer))
+        snprintf(response_buffer + n, sizeof(response_buffer) - n, "]}");
+    return response_buffer;
+}
+
+// "HH:MM" em minutos do dia; "-" tira o programa da agenda
+static bool ler_horario(const char *texto, int16_t *minuto)
+{
+    int horas, minutos;
+    char resto;
+    if (strcmp(texto, "-") == 0)
+    {
+        *minuto = PROGRAMA_SEM_HORARIO;
+        return true;
+    }
+    if (sscanf(texto, "%d:%d%c", &horas, &minutos, &resto) != 2 || horas < 0 || horas > 23 || minutos < 0 || minutos > 59)
+        return false;
+    *minuto = (int16_t)(horas * 60 + minutos);
+    return true;
+}
+
+// Minuto do dia como string JSON ("06:30"), ou null
+static const char *horario_json(int minuto, char *destino, size_t tamanho)
+{
+    if (minuto < 0)
+        return "null";
+    snprintf(destino, tamanho, "\"%02d:%02d\"", minuto / 60, minuto % 60);
+    return destino;
+}
+
+static bool programa_em_execucao(const Programa *programa)
+{
+    for (int i = 0; i < NUM_ZONAS; i++)
+        if (execucoes[i].programa == programa)
+            return true;
+    return false;
+}
+
+// Roda o programa na zona. A rampa parte da temperatura medida (ou do setpoint
+// atual, com o sensor em falha), para não esperar pela trajetória
+void iniciar_programa(int indice_programa, int indice)
+{
+    Zona *zona = &zonas[indice];
+    float inicio = zona->sensor_ok ? zona->temperatura_atual : zona->temperatura_desejada;
+    programa_iniciar(&execucoes[indice], &programas[indice_programa], inicio);
+    LOG(LOG_INFO, "[%s] Programa '%s' iniciado.\n", zona->hw.nome, programas[indice_programa].nome);
+}
+
+// Função para tratar a requisição "/programas". GET lista os programas e a
+// execução em cada zona (com programa=n, os segmentos do programa n). POST
+// segue o parâmetro acao:
+//   definir: altera nome, inicio ("HH:MM", "-" sem agenda), zona da partida
+//            agendada, repetir e tolerancia; com segmento, grava o segmento
+//            (alvo, taxa em °C/min, patamar em min). Segmento igual à
+//            quantidade acrescenta um no fim
+//   limpar:  apaga os segmentos (aceita os mesmos campos de definir)
+//   iniciar: roda o programa na zona
+//   parar:   para o programa da zona, mantendo o setpoint
+const char *programas_handler(const char *request)
+{
+    http_server_set_content_type(HTTP_CONTENT_TYPE_JSON);
+
+    int indice_programa = -1;
+    const ConfigEstado *config = config_http();
+    const Programa *exibido = NULL; // Programa definido no POST, mostrado no lugar do publicado
+    Programa novo;
+    http_param_result_t resultado;
+    if (http_server_request_method() == HTTP_METHOD_POST)
+    {
+        int acao, segmento = -1, patamar = 0, indice = 0;
+        float alvo = NAN, taxa = 0.0f, tolerancia = NAN;
+        bool repetir, repetir_presente = false, nome_presente = false, inicio_presente = false, zona_presente = false;
+        char nome[HTTP_PARAMS_MAX_VALUE], inicio[HTTP_PARAMS_MAX_VALUE];
+        http_param_spec_t params[] = {
+            {"acao", HTTP_PARAM_ENUM, true, 0, 0, NOMES_ACAO_PROGRAMA, &acao, NULL},
+            {"programa", HTTP_PARAM_INT, false, 0, PROGRAMAS_MAX - 1, NULL, &indice_programa, NULL},
+            {"segmento", HTTP_PARAM_INT, false, 0, PROGRAMA_SEGMENTOS_MAX - 1, NULL, &segmento, NULL},
+            {"alvo", HTTP_PARAM_FLOAT, false, SETPOINT_MIN, SETPOINT_MAX, NULL, &alvo, NULL},
+            {"taxa", HTTP_PARAM_FLOAT, false, 0.0f, TAXA_SETPOINT_MAX, NULL, &taxa, NULL},
+            {"patamar", HTTP_PARAM_INT, false, 0, PATAMAR_MAX_MIN, NULL, &patamar, NULL},
+            {"nome", HTTP_PARAM_STRING, false, 0, 0, NULL, nome, &nome_presente},
+            {"inicio", HTTP_PARAM_STRING, false, 0, 0, NULL, inicio, &inicio_presente},
+            {"repetir", HTTP_PARAM_BOOL, false, 0, 0, NULL, &repetir, &repetir_presente},
+            {"tolerancia", HTTP_PARAM_FLOAT, false, 0.0f, TOLERANCIA_MAX, NULL, &tolerancia, NULL},
+            {"zona", HTTP_PARAM_INT, false, 0, NUM_ZONAS - 1, NULL, &indice, &zona_presente},
+        };
+        resultado = http_server_parse_params(request, params, count_of(params));
+        if (resultado.status != HTTP_PARAM_OK)
+            return responder_erro_parametro(resultado);
+
+        if (acao == ACAO_PARAR)
+        {
+            Comando comando = {.tipo = COMANDO_PARAR_PROGRAMA, .zona = (uint8_t)indice};
+            if (!postar_comandos(&comando, 1))
+                return responder_fila_cheia();
+            return "{\"status\":\"success\", \"message\":\"programa parado\"}";
+        }
+        if (indice_programa < 0)
+            return responder_erro_parametro((http_param_result_t){HTTP_PARAM_ERR_MISSING, "programa"});
+
+        const Programa *programa = &config->programas[indice_programa];
+        if (acao == ACAO_INICIAR)
+        {
+            if (programa->quantidade == 0)
+            {
+                http_server_set_status(422);
+                return "{\"status\":\"error\", \"message\":\"programa vazio\"}";
+            }
+            Comando comando = {.tipo = COMANDO_INICIAR_PROGRAMA, .zona = (uint8_t)indice, .inteiro = (int16_t)indice_programa};
+            if (!postar_comandos(&comando, 1))
+                return responder_fila_cheia();
+            return "{\"status\":\"success\", \"message\":\"programa iniciado\"}";
+        }
+
+        // Definir ou limpar: valida tudo numa cópia antes de enfileirar
+        const ControleEstado *estado = estado_http();
+        for (int i = 0; i < NUM_ZONAS; i++)
+        {
+            if (estado->execucoes[i].programa == indice_programa)
+            {
+                http_server_set_status(409);
+                return "{\"status\":\"error\", \"message\":\"programa em execucao\"}";
+            }
+        }
+        novo = *programa;
+        if (acao == ACAO_LIMPAR)
+            novo.quantidade = 0;
+        if (nome_presente)
+        {
+            snprintf(novo.nome, sizeof(novo.nome), "%s", nome);
+            for (char *c = novo.nome; *c; c++)
+                if (*c == '"' || *c == '\\' || (unsigned char)*c < ' ')
+                    *c = '_'; // O nome vai cru para o JSON e para o OLED
+        }
+        if (inicio_presente && !ler_horario(inicio, &novo.inicio_min))
+            return responder_erro_parametro((http_param_result_t){HTTP_PARAM_ERR_RANGE, "inicio"});
+        if (zona_presente)
+            novo.zona = (int8_t)indice;
+        if (repetir_presente)
+            novo.repetir = repetir;
+        if (!isnan(tolerancia))
+            novo.tolerancia = tolerancia;
+        if (segmento >= 0 && (isnan(alvo) || !programa_definir_segmento(&novo, segmento, alvo, taxa, (uint16_t)patamar)))
+        {
+            http_server_set_status(422);
+            return "{\"status\":\"error\", \"message\":\"informe o alvo (segmentos em sequencia, no maximo 8)\"}";
+        }
+        if (!reservar_carga())
+            return responder_fila_cheia();
+        carga_rede.programa = novo;
+        Comando comando = {.tipo = COMANDO_DEFINIR_PROGRAMA, .inteiro = (int16_t)indice_programa};
+        if (!postar_com_carga(&comando))
+            return responder_fila_cheia();
+        exibido = &novo;
+    }
+    else
+    {
+        http_param_spec_t params[] = {
+            {"programa", HTTP_PARAM_INT, false, 0, PROGRAMAS_MAX - 1, NULL, &indice_programa, NULL},
+        };
+        resultado = http_server_parse_params(request, params, count_of(params));
+        if (resultado.status != HTTP_PARAM_OK)
+            return responder_erro_parametro(resultado);
+    }
+
+    static char response_buffer[1024];
+    char horario[8];
+    int minuto = -1;
+    uint32_t dia;
+    if (!relogio_hora_local(&minuto, &dia))
+        minuto = -1;
+    int n = snprintf(response_buffer, sizeof(response_buffer), "{\"relogio\": %s, ",
+                     horario_json(minuto, horario, sizeof(horario)));
+
+    if (indice_programa >= 0)
+    {
+        // Um programa, com os segmentos
+        const Programa *programa = exibido ? exibido : &config->programas[indice_programa];
+        n += snprintf(response_buffer + n, sizeof(response_buffer) - n,
+                      "\"programa\": %d, \"nome\": \"%s\", \"inicio\": %s, \"zona\": %d, \"repetir\": %s, "
+                      "\"tolerancia\": %.2f, \"segmentos\": [",
+                      indice_programa, programa->nome, horario_json(programa->inicio_min, horario, sizeof(horario)),
+                      programa->zona, programa->repetir ? "true" : "false", programa->tolerancia);
+        for (int i = 0; i < programa->quantidade && n < (int)sizeof(response_buffer); i++)
+            n += snprintf(response_buffer + n, sizeof(response_buffer) - n,
+                          "%s{\"alvo\": %.2f, \"taxa\": %.2f, \"patamar\": %u}", i ? ", " : "",
+                          programa->segmentos[i].alvo, programa->segmentos[i].taxa, programa->segmentos[i].patamar_min);
+        if (n < (int)sizeof(response_buffer))
+            snprintf(response_buffer + n, sizeof(response_buffer) - n, "]}");
+        return response_buffer;
+    }
+
+    // Lista resumida e execução em cada zona
+    const ControleEstado *estado = estado_http();
+    n += snprintf(response_buffer + n, sizeof(response_buffer) - n, "\"programas\": [");
+    for (int i = 0; i < PROGRAMAS_MAX && n < (int)sizeof(response_buffer); i++)
+        n += snprintf(response_buffer + n, sizeof(response_buffer) - n,
+                      "%s{\"programa\": %d, \"nome\": \"%s\", \"segmentos\": %d, \"inicio\": %s, \"zona\": %d}",
+                      i ? ", " : "", i, config->programas[i].nome, config->programas[i].quantidade,
+                      horario_json(config->programas[i].inicio_min, horario, sizeof(horario)), config->programas[i].zona);
+    if (n < (int)sizeof(response_buffer))
+        n += snprintf(response_buffer + n, sizeof(response_buffer) - n, "], \"execucao\": [");
+    for (int i = 0; i < NUM_ZONAS && n < (int)sizeof(response_buffer); i++)
+    {
+        const ExecucaoAmostra *execucao = &estado->execucoes[i];
+        n += snprintf(response_buffer + n, sizeof(response_buffer) - n,
+                      "%s{\"zona\": %d, \"programa\": %d, \"segmento\": %d, \"fase\": \"%s\", \"setpoint\": %.2f, "
+                      "\"restante_min\": %.1f, \"espera_min\": %.1f, \"ciclos\": %lu}",
+                      i ? ", " : "", i, execucao->programa, execucao->segmento, NOMES_FASE_PROGRAMA[execucao->fase],
+                      execucao->setpoint, execucao->restante_s / 60.0f, execucao->espera_s / 60.0f,
+                      (unsigned long)execucao->ciclos);
+    }
+    if (n < (int)sizeof(response_buffer))
+        snprintf(response_buffer + n, sizeof(response_buffer) - n, "]}");
+    return response_buffer;
+}
+
+// Troca o modo da zona. O sistema só fica em standby quando todas as zonas estão desligadas
+static void definir_modo(Zona *zona, ModoControle modo, float angulo, float ventoinha)
+{
+    if (modo != zona->modo)
+        zona->termo_integral = 0.0f; // Evita que o integral antigo cause um salto ao voltar
+    zona->modo = modo;
+    if (!isnan(angulo))
+        zona->angulo_manual = angulo;
+    zona->ventoinha_manual = ventoinha; // Sem o parâmetro a ventoinha volta a seguir o ângulo
+
+    bool todas_desligadas = true;
+    for (int i = 0; i < NUM_ZONAS; i++)
+        todas_desligadas &= zonas[i].modo == MODO_DESLIGADO;
+    if (todas_desligadas)
+        status_sistema = STANDBY;
+    else if (status_sistema == STANDBY)
+        status_sistema = OPERANDO_NORMAL;
+}
+
+// Aplica um comando postado na fila (laço principal, entre ciclos de controle)
+void aplicar_comando(const Comando *comando)
+{
+    Zona *zona = &zonas[comando->zona];
+    switch (comando->tipo)
+    {
+    case COMANDO_SETPOINT:
+        definir_setpoint(comando->zona, comando->valor);
+        break;
+    case COMANDO_TAXA_SETPOINT:
+        zona_definir_taxa_setpoint(zona, comando->valor);
+        break;
+    case COMANDO_GANHO_P:
+        zona->ganho_p = comando->valor;
+        break;
+    case COMANDO_GANHO_I:
+        zona->ganho_i = comando->valor;
+        break;
+    case COMANDO_MODO:
+        definir_modo(zona, (ModoControle)comando->inteiro, comando->valor, comando->valor2);
+        break;
+    case COMANDO_LIMITE_INTEGRAL:
+        zona->integral_max = comando->valor;
+        zona->integral_min = -comando->valor;
+        break;
+    case COMANDO_LIMITES_ANGULO:
+        zona->angulo_min = comando->valor;
+        zona->angulo_max = comando->valor2;
+        break;
+    case COMANDO_POSICAO_SEGURA:
+        if (!isnan(comando->valor))
+            zona->angulo_seguro = comando->valor;
+        if (!isnan(comando->valor2))
+            zona->ventoinha_segura = comando->valor2;
+        break;
+    case COMANDO_FEEDFORWARD:
+        zona_definir_feedforward(zona, comando->inteiro != 0);
+        break;
+    case COMANDO_AMBIENTE:
+        definir_temperatura_ambiente(comando->valor);
+        break;
+    case COMANDO_INICIAR_PROGRAMA:
+        iniciar_programa(comando->inteiro, comando->zona);
+        break;
+    case COMANDO_PARAR_PROGRAMA:
+        programa_parar(&execucoes[comando->zona]);
+        break;
+    case COMANDO_FILTRO:
+        filtro_configurar(&zona->filtro, &carga_rede.filtro);
+        carga_rede.aplicada = true;
+        break;
+    case COMANDO_ESCALONAMENTO:
+        zona->escalonamento = carga_rede.escalonamento;
+        if (comando->inteiro >= 0)
+            zona->escalonamento_ativo = comando->inteiro != 0;
+        if (zona->escalonamento.quantidade == 0)
+            zona->escalonamento_ativo = false;
+        carga_rede.aplicada = true;
+        agendador_publicar(EVENTO_SALVAR_CONFIG, 0); // Grava na flash fora da tarefa de comandos
+        break;
+    case COMANDO_DEFINIR_PROGRAMA:
+        // O handler já recusou um programa em execução; só um início na mesma rodada chega aqui
+        if (programa_em_execucao(&programas[comando->inteiro]))
+        {
+            LOG(LOG_AVISO, "Programa %d em execucao: definicao descartada.\n", comando->inteiro);
+        }
+        else
+        {
+            programas[comando->inteiro] = carga_rede.programa;
+            agendador_publicar(EVENTO_SALVAR_CONFIG, 0);
+        }
+        carga_rede.aplicada = true;
+        break;
+    case COMANDO_UDP:
+        fluxo_udp = carga_rede.udp;
+        fluxo_udp.reconfigurar = true;
+        carga_rede.aplicada = true;
+        break;
+    // Os campos dos perfis são palavras de 32 bits: a interrupção dos atuadores vê o valor antigo ou o novo
+    case COMANDO_PERFIL_SERVO:
+        if (!isnan(comando->valor))
+            zona->perfil_servo.velocidade_max = comando->valor;
+        if (!isnan(comando->valor2))
+            zona->perfil_servo.aceleracao_max = comando->valor2;
+        break;
+    case COMANDO_BANDA_MORTA:
+        zona->perfil_servo.banda_morta = comando->valor;
+        break;
+    case COMANDO_RAMPA_VENTOINHA:
+        zona->perfil_ventoinha.velocidade_max = comando->valor;
+        break;
+    case COMANDO_ALOCACAO:
+        if (comando->inteiro >= 0)
+            zona->alocacao = (AlocacaoModo)comando->inteiro;
+        if (!isnan(comando->valor))
+            zona->divisao = comando->valor;
+        if (!isnan(comando->valor2))
+            zona->sobreposicao = comando->valor2;
+        break;
+    case COMANDO_PWM:
+        if (!zona_configurar_pwm(zona, comando->inteiro != 0, (uint32_t)comando->valor, (uint8_t)comando->valor2))
+            LOG(LOG_AVISO, "[%s] PWM fora do divisor: comando descartado.\n", zona->hw.nome);
+        break;
+    case COMANDO_PARTIDA_VENTOINHA:
+        if (!isnan(comando->valor))
+            zona->curva_ventoinha.partida_duty = comando->valor;
+        if (!isnan(comando->valor2))
+            zona->curva_ventoinha.partida_s = comando->valor2;
+        break;
+    }
+}
+
+// Comandos recebidos em <prefixo>/set/... (contexto do lwIP, como os handlers HTTP).
+// Os payloads são os mesmos objetos JSON aceitos pelas rotas via POST:
+//   zona/<n>/setpoint  {"temperatura": 25.5}
+//   zona/<n>/ganhos    {"kp": 8, "ki": 0.1}
+//   telemetria         {"periodo_ms": 2000}
+//   ambiente           {"temperatura": 24.5} (para o avanço; ex.: estação externa)
+void tratar_comando_mqtt(const char *comando, const char *dados, size_t len)
+{
+    http_param_result_t resultado;
+    int indice;
+    char campo[16];
+
+    if (sscanf(comando, "zona/%d/%15s", &indice, campo) == 2)
+    {
+        if (indice < 0 || indice >= NUM_ZONAS)
+        {
+            LOG(LOG_AVISO, "MQTT: zona invalida em %s\n", comando);
+            return;
+        }
+        if (strcmp(campo, "setpoint") == 0)
+        {
+            float temperatura;
+            http_param_spec_t params[] = {
+                {"temperatura", HTTP_PARAM_FLOAT, true, SETPOINT_MIN, SETPOINT_MAX, NULL, &temperatura, NULL},
+            };
+            resultado = http_params_parse_json(dados, len, params, count_of(params));
+            Comando comando = {.tipo = COMANDO_SETPOINT, .zona = (uint8_t)indice, .valor = temperatura};
+            if (resultado.status == HTTP_PARAM_OK && !postar_comandos(&comando, 1))
+                LOG(LOG_AVISO, "MQTT: fila de comandos cheia, setpoint descartado\n");
+        }
+        else if (strcmp(campo, "ganhos") == 0)
+        {
+            float kp = NAN, ki = NAN;
+            http_param_spec_t params[] = {
+                {"kp", HTTP_PARAM_FLOAT, false, 0.0f, GANHO_P_MAX, NULL, &kp, NULL},
+                {"ki", HTTP_PARAM_FLOAT, false, 0.0f, GANHO_I_MAX, NULL, &ki, NULL},
+            };
+            resultado = http_params_parse_json(dados, len, params, count_of(params));
+            if (resultado.status == HTTP_PARAM_OK)
+            {
+                Comando comandos[2];
+                int n = 0;
+                if (!isnan(kp))
+                    comandos[n++] = (Comando){.tipo = COMANDO_GANHO_P, .zona = (uint8_t)indice, .valor = kp};
+                if (!isnan(ki))
+                    comandos[n++] = (Comando){.tipo = COMANDO_GANHO_I, .zona = (uint8_t)indice, .valor = ki};
+                if (!postar_comandos(comandos, n))
+                    LOG(LOG_AVISO, "MQTT: fila de comandos cheia, ganhos descartados\n");
+            }
+        }
+        else
+        {
+            LOG(LOG_AVISO, "MQTT: comando desconhecido: %s\n", comando);
+            return;
+        }
+    }
+    else if (strcmp(comando, "telemetria") == 0)
+    {
+        int periodo_ms;
+        http_param_spec_t params[] = {
+            {"periodo_ms", HTTP_PARAM_INT, true, MQTT_PERIODO_MIN_MS, MQTT_PERIODO_MAX_MS, NULL, &periodo_ms, NULL},
+        };
+        resultado = http_params_parse_json(dados, len, params, count_of(params));
+        if (resultado.status == HTTP_PARAM_OK)
+            mqtt_telemetria_definir_periodo((uint32_t)periodo_ms);
+    }
+    else if (strcmp(comando, "ambiente") == 0)
+    {
+        float ambiente;
+        http_param_spec_t params[] = {
+            {"temperatura", HTTP_PARAM_FLOAT, true, AMBIENTE_MIN, AMBIENTE_MAX, NULL, &ambiente, NULL},
+        };
+        resultado = http_params_parse_json(dados, len, params, count_of(params));
+        Comando comando = {.tipo = COMANDO_AMBIENTE, .valor = ambiente};
+        if (resultado.status == HTTP_PARAM_OK && !postar_comandos(&comando, 1))
+            LOG(LOG_AVISO, "MQTT: fila de comandos cheia, ambiente descartado\n");
+    }
+    else
+    {
+        LOG(LOG_AVISO, "MQTT: comando desconhecido: %s\n", comando);
+        return;
+    }
 
-    return response_buffer;
+    if (resultado.status != HTTP_PARAM_OK)
+        LOG(LOG_AVISO, "MQTT: %s rejeitado (%s: %s)\n", comando, resultado.name ? resultado.name : "",
+               http_param_status_str(resultado.status));
 }
 
-// Mapeia um valor de uma faixa de entrada para uma faixa de saída.
-float mapear_valores(float valor, float entrada_min, float entrada_max, float saida_min, float saida_max)
+// === SHELL SERIAL ===
+// A interrupção de recepção (UART ou USB) guarda os bytes no shell e publica
+// um evento; o laço principal executa as linhas completas. Os comandos que alteram o
+// controle vão pela fila de comandos, como os da rede, e valem para a zona
+// selecionada (a mesma do OLED).
+
+static void receber_serial(void *contexto)
 {
-    return (valor - entrada_min) * (saida_max - saida_min) / (entrada_max - entrada_min) + saida_min;
+    int c;
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT)
+        shell_receber((uint8_t)c);
+    agendador_publicar(EVENTO_SERIAL, 0);
 }
 
-// Configura a comunicação I2C e inicializa o sensor AHT20.
-bool inicializar_sensor(void)
+static bool postar_locais(const Comando *comandos, int quantidade)
 {
-    i2c_init(PORTA_I2C, 100000);
-    gpio_set_function(PINO_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(PINO_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(PINO_SDA);
-    gpio_pull_up(PINO_SCL);
-
-    if (!aht20_init(PORTA_I2C))
+    if (!postar_na_fila(&comandos_locais, comandos, quantidade))
     {
-        printf("ERRO: Falha ao inicializar sensor AHT20!\n");
+        shell_erro("fila de comandos cheia\n");
         return false;
     }
-    printf("Sensor AHT20 inicializado com sucesso.\n");
     return true;
 }
 
-// Lê a temperatura atual do sensor AHT20.
-bool ler_temperatura(float *temperatura_atual)
+static void cmd_zona(int argc, char **argv)
 {
-    AHT20_Data dados_sensor;
-    if (aht20_read(PORTA_I2C, &dados_sensor))
+    int zona;
+    if (argc > 1)
     {
-        *temperatura_atual = dados_sensor.temperature;
-        return true;
+        if (!shell_ler_int(argv[1], 1, NUM_ZONAS, &zona))
+        {
+            shell_erro("zona de 1 a %d\n", NUM_ZONAS);
+            return;
+        }
+        zona_exibida = zona - 1; // O shell numera as zonas como o OLED
     }
-    return false;
+    shell_escrever("Zona %d/%d: %s\n", zona_exibida + 1, NUM_ZONAS, zonas[zona_exibida].hw.nome);
 }
 
-// Configura o pino do servo para operar com PWM.
-void inicializar_servo(void)
+static void cmd_setpoint(int argc, char **argv)
 {
-    gpio_set_function(PINO_SERVO, GPIO_FUNC_PWM);
-    fatia_pwm_servo = pwm_gpio_to_slice_num(PINO_SERVO);
-    pwm_config configuracao = pwm_get_default_config();
-    pwm_config_set_clkdiv(&configuracao, DIVISOR_PWM);
-    pwm_config_set_wrap(&configuracao, WRAP_PWM);
-    pwm_init(fatia_pwm_servo, &configuracao, true);
-    printf("Servo motor inicializado no GPIO %d.\n", PINO_SERVO);
+    float setpoint, taxa;
+    if (!shell_ler_float(argv[1], SETPOINT_MIN, SETPOINT_MAX, &setpoint))
+    {
+        shell_erro("setpoint de %.0f a %.0f C\n", SETPOINT_MIN, SETPOINT_MAX);
+        return;
+    }
+    Comando comandos[2];
+    int n = 0;
+    if (argc > 2)
+    {
+        if (!shell_ler_float(argv[2], 0.0f, TAXA_SETPOINT_MAX, &taxa))
+        {
+            shell_erro("taxa de 0 a %.0f C/min\n", TAXA_SETPOINT_MAX);
+            return;
+        }
+        comandos[n++] = (Comando){.tipo = COMANDO_TAXA_SETPOINT, .zona = (uint8_t)zona_exibida, .valor = taxa};
+    }
+    // Sem zerar o integral: a trajetória leva o setpoint aos poucos
+    comandos[n++] = (Comando){.tipo = COMANDO_SETPOINT, .zona = (uint8_t)zona_exibida, .valor = setpoint};
+    if (postar_locais(comandos, n))
+        shell_escrever(">> Setpoint da %s atualizado para %.2f C\n", zonas[zona_exibida].hw.nome, setpoint);
 }
 
-// Converte o ângulo (0-180) para a largura de pulso e o aplica no pino do servo.
-void definir_angulo_servo(float angulo)
+// Linha que não começa por um comando: um número solto altera o setpoint
+static void cmd_padrao(int argc, char **argv)
 {
-    uint16_t largura_pulso = (uint16_t)mapear_valores(angulo, 0, 180, PULSO_MIN_US, PULSO_MAX_US);
-    pwm_set_gpio_level(PINO_SERVO, largura_pulso);
+    float setpoint;
+    if (argc == 1 && shell_ler_float(argv[0], -INFINITY, INFINITY, &setpoint))
+        cmd_setpoint(2, (char *[]){"sp", argv[0], NULL});
+    else
+        shell_erro("comando desconhecido: %s (digite ajuda)\n", argv[0]);
 }
 
-// Configura os pinos de controle e o PWM da ventoinha.
-void inicializar_ventoinha(void)
+static void cmd_ganhos(int argc, char **argv)
 {
-    gpio_init(PINO_IN1);
-    gpio_init(PINO_IN2);
-    gpio_set_dir(PINO_IN1, GPIO_OUT);
-    gpio_set_dir(PINO_IN2, GPIO_OUT);
-
-    gpio_put(PINO_IN1, true); // Define a direção de rotação
-    gpio_put(PINO_IN2, false);
-
-    gpio_set_function(PINO_ENA_PWM, GPIO_FUNC_PWM);
-    fatia_pwm_ventoinha = pwm_gpio_to_slice_num(PINO_ENA_PWM);
-
-    pwm_config config_ventoinha = pwm_get_default_config();
-    pwm_config_set_clkdiv(&config_ventoinha, DIVISOR_PWM_VENTOINHA);
-    pwm_config_set_wrap(&config_ventoinha, WRAP_PWM_VENTOINHA);
-    pwm_init(fatia_pwm_ventoinha, &config_ventoinha, true);
-
-    pwm_set_gpio_level(PINO_ENA_PWM, 0); // Garante que a ventoinha comece desligada
-    printf("Ventoinha inicializada nos GPIOs %d, %d, %d.\n", PINO_IN1, PINO_IN2, PINO_ENA_PWM);
+    const Zona *zona = &zonas[zona_exibida];
+    if (argc == 1)
+    {
+        shell_escrever("kp=%.3f ki=%.4f\n", zona->ganho_p, zona->ganho_i);
+        return;
+    }
+    float kp, ki;
+    if (argc != 3 || !shell_ler_float(argv[1], 0.0f, GANHO_P_MAX, &kp) ||
+        !shell_ler_float(argv[2], 0.0f, GANHO_I_MAX, &ki))
+    {
+        shell_erro("ganhos <kp 0 a %.0f> <ki 0 a %.0f>\n", GANHO_P_MAX, GANHO_I_MAX);
+        return;
+    }
+    Comando comandos[] = {
+        {.tipo = COMANDO_GANHO_P, .zona = (uint8_t)zona_exibida, .valor = kp},
+        {.tipo = COMANDO_GANHO_I, .zona = (uint8_t)zona_exibida, .valor = ki},
+    };
+    if (postar_locais(comandos, count_of(comandos)))
+        shell_escrever("kp=%.3f ki=%.4f\n", kp, ki);
 }
 
-// Define a velocidade da ventoinha (0 a 100%).
-void definir_velocidade_ventoinha(float porcentagem)
+static void cmd_modo(int argc, char **argv)
 {
-    if (porcentagem > 100.0f)
-        porcentagem = 100.0f;
-    if (porcentagem < 0.0f)
-        porcentagem = 0.0f;
-
-    uint16_t valor_pwm = (uint16_t)(porcentagem * WRAP_PWM_VENTOINHA / 100.0f);
-    pwm_set_gpio_level(PINO_ENA_PWM, valor_pwm);
+    if (argc == 1)
+    {
+        shell_escrever("modo=%s\n", NOMES_MODO[zonas[zona_exibida].modo]);
+        return;
+    }
+    int modo = shell_ler_opcao(argv[1], NOMES_MODO);
+    float angulo = NAN, ventoinha = NAN;
+    if (modo < 0 || (argc > 2 && !shell_ler_float(argv[2], 0.0f, 180.0f, &angulo)) ||
+        (argc > 3 && !shell_ler_float(argv[3], 0.0f, 100.0f, &ventoinha)))
+    {
+        shell_erro("modo <auto|manual|desligado> [angulo 0 a 180] [ventoinha 0 a 100]\n");
+        return;
+    }
+    Comando comando = {.tipo = COMANDO_MODO, .zona = (uint8_t)zona_exibida, .inteiro = (int16_t)modo,
+                       .valor = angulo, .valor2 = ventoinha};
+    if (postar_locais(&comando, 1))
+        shell_escrever("modo=%s\n", NOMES_MODO[modo]);
 }
 
-// Calcula o sinal de controle PI com base na temperatura atual.
-float calcular_controle_pi(float temperatura_atual)
+static void cmd_log(int argc, char **argv)
 {
-    float erro = temperatura_atual - temperatura_desejada;
-    float termo_proporcional = GANHO_P * erro;
-
-    termo_integral += GANHO_I * erro * PERIODO_AMOSTRA; // Acumula o erro
-
-    // Limita o termo integral para evitar sobrecarga (anti-windup)
-    if (termo_integral > INTEGRAL_MAX)
-        termo_integral = INTEGRAL_MAX;
-    if (termo_integral < INTEGRAL_MIN)
-        termo_integral = INTEGRAL_MIN;
-
-    return termo_proporcional + termo_integral;
+    if (argc > 1)
+    {
+        int nivel = log_nivel_de_str(argv[1]);
+        if (nivel < 0)
+        {
+            shell_erro("log <nada|erro|aviso|info|depuracao>\n");
+            return;
+        }
+        log_nivel = (LogNivel)nivel;
+    }
+    shell_escrever("log=%s\n", log_nivel_str(log_nivel));
 }
 
-// Aplica o controle PI ao servo e à ventoinha.
-void aplicar_controle(float temperatura_atual)
+static void cmd_stats(int argc, char **argv)
 {
-    float erro = temperatura_atual - temperatura_desejada;
-    float sinal_controle = calcular_controle_pi(temperatura_atual);
-
-    // O ângulo alvo parte de 90° e é ajustado pelo sinal de controle
-    float angulo_alvo = 90.0f + sinal_controle;
-
-    // Garante que o ângulo do servo permaneça dentro dos limites físicos
-    if (angulo_alvo > 180.0f)
-        angulo_alvo = 180.0f;
-    if (angulo_alvo < 0.0f)
-        angulo_alvo = 0.0f;
-
-    // Mapeia o ângulo do servo (0-180°) para a velocidade da ventoinha (0-100%)
-    float velocidade_ventoinha = mapear_valores(angulo_alvo, 0.0f, 180.0f, 0.0f, 100.0f);
-
-    definir_angulo_servo(angulo_alvo);
-    definir_velocidade_ventoinha(velocidade_ventoinha);
-
-    // Imprime o status atual do sistema no monitor serial
-    printf("Temp: %.2f C | Setpoint: %.2f C | Erro: %.2f | Servo: %.1f deg | Ventoinha (motor): %.0f%%\n",
-           temperatura_atual, temperatura_desejada, erro, angulo_alvo, velocidade_ventoinha);
+    static ControleEstado estado;
+    uint32_t publicacao = seqlock_ler(&estado_controle, &estado);
+    shell_escrever("status=%s ciclo=%lu duracao_ciclo=%luus publicacoes=%lu releituras=%lu uptime=%lus\n",
+                   NOMES_STATUS[estado.status], (unsigned long)estado.ciclo, (unsigned long)estado.duracao_ciclo_us,
+                   (unsigned long)publicacao, (unsigned long)estado_controle.releituras,
+                   (unsigned long)(to_ms_since_boot(get_absolute_time()) / 1000));
+    for (int i = 0; i < NUM_ZONAS; i++)
+    {
+        const ZonaAmostra *z = &estado.zonas[i];
+        shell_escrever("zona %d: %s temp=%.2f sp=%.2f alvo=%.2f erro=%.2f int=%.2f ang=%.1f vent=%.0f modo=%s "
+                       "sensor=%s falhas=%lu\n",
+                       i + 1, zonas[i].hw.nome, z->temperatura_atual, z->temperatura_desejada, z->setpoint_alvo,
+                       z->erro, z->termo_integral, z->angulo_alvo, z->velocidade_ventoinha, NOMES_MODO[z->modo],
+                       monitor_sensor_estado_str(z->sensor_estado), (unsigned long)z->sensor_falhas);
+    }
+    for (int i = 0; i < agendador_num_tarefas(); i++)
+    {
+        const Tarefa *t = agendador_tarefa(i);
+        shell_escrever("tarefa %-9s exec=%lu dur=%luus max=%luus estouros=%lu atrasos=%lu\n", t->nome,
+                       (unsigned long)t->execucoes, (unsigned long)t->duracao_us, (unsigned long)t->duracao_max_us,
+                       (unsigned long)t->estouros, (unsigned long)t->atrasos);
+    }
+    ShellEstatisticas e;
+    shell_estatisticas(&e);
+    shell_escrever("eventos_descartados=%lu comandos_descartados=%lu/%lu shell: linhas=%lu erros=%lu "
+                   "longas=%lu bytes_descartados=%lu\n",
+                   (unsigned long)agendador_eventos_descartados(), (unsigned long)comandos_rede.descartados,
+                   (unsigned long)comandos_locais.descartados, (unsigned long)e.linhas, (unsigned long)e.erros,
+                   (unsigned long)e.linhas_longas, (unsigned long)e.bytes_descartados);
+}
 
-    // Atualiza variáveis globais http
-    http_temperatura_atual = temperatura_atual;
-    http_erro = erro;
-    http_angulo_alvo = angulo_alvo;
-    http_velocidade_ventoinha = velocidade_ventoinha;
+// Saída binária: quadros no formato da telemetria UDP (cabeçalho e uma amostra
+// por zona, ver tools/receptor_udp.py --serial). Enquanto ela dura, nenhum texto
+// vai para a serial; "stream parar" (ecoado como texto) a encerra.
+static void cmd_stream(int argc, char **argv)
+{
+    int taxa_hz;
+    if (strcmp(argv[1], "parar") == 0)
+    {
+        uint32_t quadros = configurar_stream_serial(0);
+        shell_escrever("\nSTREAM parado: %lu quadros\n", (unsigned long)quadros);
+        return;
+    }
+    if (!shell_ler_int(argv[1], 1, UDP_TAXA_MAX_HZ, &taxa_hz))
+    {
+        shell_erro("stream <1 a %d Hz|parar>\n", UDP_TAXA_MAX_HZ);
+        return;
+    }
+    shell_escrever("STREAM %d Hz, quadros de %u bytes (magico 0x%04X)\n", taxa_hz,
+                   (unsigned)(sizeof(TelemetriaUdpCabecalho) + NUM_ZONAS * sizeof(TelemetriaUdpAmostra)),
+                   TELEMETRIA_UDP_MAGICO);
+    stdio_flush();
+    configurar_stream_serial(taxa_hz);
 }
 
-// Verifica se o usuário digitou uma nova temperatura via serial.
-void verificar_nova_temperatura_serial(void)
+static void cmd_rede(int argc, char **argv)
 {
-    static char buffer_entrada[20];
-    static int contador_chars = 0;
-    int caractere;
+    static char fases[160];
+    WifiEstatisticas w;
+    wifi_estatisticas(&w);
+    boot_json(fases, sizeof(fases));
+    shell_escrever("wifi=%s ip=%s tentativas=%lu falhas=%lu quedas=%lu backoff=%lums\nboot (ms): %s\n",
+                   wifi_estado_str(w.estado), w.ip[0] ? w.ip : "-", (unsigned long)w.tentativas,
+                   (unsigned long)w.falhas, (unsigned long)w.quedas, (unsigned long)w.backoff_ms, fases);
+
+    http_server_stats_t h;
+    http_server_get_stats(&h);
+    shell_escrever("http: conexoes=%u (max %u) recusadas: conexoes=%lu ip=%lu taxa=%lu token=%lu expiradas=%lu\n",
+                   h.connections, h.connections_max, (unsigned long)h.rejected_connections,
+                   (unsigned long)h.rejected_per_ip, (unsigned long)h.rejected_rate, (unsigned long)h.rejected_auth,
+                   (unsigned long)h.idle_timeouts);
+}
 
-    while ((caractere = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT)
+// Ocupação da RAM em uso: o orçamento estático vem do relatório de build
+// (tools/orcamento_memoria.py); aqui aparecem o heap e os picos do lwIP
+static void cmd_memoria(int argc, char **argv)
+{
+    extern char end, __StackLimit; // Definidos pelo linker: limites do heap
+    struct mallinfo m = mallinfo();
+    uint32_t heap_total = (uint32_t)(&__StackLimit - &end);
+    shell_escrever("ram: estatica=%luB heap: em_uso=%luB livre=%luB\n",
+                   (unsigned long)((uintptr_t)&end - SRAM_BASE), (unsigned long)m.uordblks,
+                   (unsigned long)(heap_total - m.uordblks));
+
+    static const struct { const char *nome; memp_t pool; } POOLS[] = {
+        {"pbuf_pool", MEMP_PBUF_POOL},
+        {"tcp_seg", MEMP_TCP_SEG},
+        {"tcp_pcb", MEMP_TCP_PCB},
+    };
+    const struct stats_mem *heap = &lwip_stats.mem;
+    shell_escrever("lwip heap: usado=%lu max=%lu/%lu erros=%lu\n", (unsigned long)heap->used,
+                   (unsigned long)heap->max, (unsigned long)heap->avail, (unsigned long)heap->err);
+    for (size_t i = 0; i < sizeof(POOLS) / sizeof(POOLS[0]); i++)
     {
-
-        if (caractere == '\n' || caractere == '\r')
-        { // Se o usuário apertou Enter
-            if (contador_chars > 0)
-            {
-                buffer_entrada[contador_chars] = '\0';
-
-                for (int i = 0; i < contador_chars; i++)
-                {
-                    if (buffer_entrada[i] == ',')
-                        buffer_entrada[i] = '.';
-                }
-
-                float nova_temperatura = atof(buffer_entrada);
-
-                // Valida a entrada para aceitar apenas números válidos
-                if (nova_temperatura > 0.0 || (strcmp(buffer_entrada, "0") == 0) || (strcmp(buffer_entrada, "0.0") == 0))
-                {
-                    temperatura_desejada = nova_temperatura;
-                    termo_integral = 0.0; // Reseta o termo integral
-                    printf("\n>> Setpoint atualizado para %.2f C\n", temperatura_desejada);
-                }
-                else
-                {
-                    printf("\n>> ERRO: Valor '%s' invalido. Digite um numero.\n", buffer_entrada);
-                }
-                contador_chars = 0; // Limpa o buffer
-            }
-        }
-        else
-        {
-            if (contador_chars < (sizeof(buffer_entrada) - 1))
-            {
-                if (isdigit(caractere) || caractere == '.' || caractere == ',')
-                {
-                    buffer_entrada[contador_chars++] = (char)caractere;
-                }
-            }
-        }
+        const struct stats_mem *p = lwip_stats.memp[POOLS[i].pool];
+        shell_escrever("lwip %s: usado=%lu max=%lu/%lu erros=%lu\n", POOLS[i].nome, (unsigned long)p->used,
+                       (unsigned long)p->max, (unsigned long)p->avail, (unsigned long)p->err);
     }
 }
 
+static void cmd_ota(int argc, char **argv)
+{
+    OtaEstatisticas e;
+    ota_estatisticas(&e);
+    shell_escrever("banco=%c estado=%s%s downloads=%lu falhas=%lu ultimo_erro=%s\n", 'A' + e.banco,
+                   ota_estado_str(e.estado), e.em_teste ? " (aguardando confirmacao)" : "",
+                   (unsigned long)e.downloads, (unsigned long)e.falhas, ota_resultado_str(e.ultimo_erro));
+    if (e.baixando)
+        shell_escrever("baixando: %lu/%lu bytes\n", (unsigned long)e.recebido, (unsigned long)e.tamanho);
+}
+
+static const ShellComando COMANDOS_SHELL[] = {
+    {"sp", "<C> [taxa C/min]  setpoint da zona (ou so o numero)", 1, 2, cmd_setpoint},
+    {"zona", "[1..n]  seleciona a zona dos comandos", 0, 1, cmd_zona},
+    {"ganhos", "[kp ki]  consulta ou altera os ganhos do PI", 0, 2, cmd_ganhos},
+    {"modo", "[auto|manual|desligado] [angulo] [ventoinha]", 0, 3, cmd_modo},
+    {"stats", "estado das zonas, tarefas e filas", 0, 0, cmd_stats},
+    {"log", "[nada|erro|aviso|info|depuracao]  nivel das mensagens", 0, 1, cmd_log},
+    {"rede", "estado do Wi-Fi, fases do boot e recusas do HTTP", 0, 0, cmd_rede},
+    {"memoria", "heap e picos dos pools do lwIP", 0, 0, cmd_memoria},
+    {"ota", "banco em execucao e estado da atualizacao", 0, 0, cmd_ota},
+    {"stream", "<hz|parar>  telemetria binaria pela serial", 1, 1, cmd_stream},
+};
+
 // --- NOVAS FUNÇÕES (Wilton) ---
 
 void inicializar_feedback() {
     // OLED
-    i2c_init(I2C_PORT_OLED, 400 * 1000);
+    i2c_fila_iniciar(I2C_PORT_OLED, 400 * 1000);
     gpio_set_function(I2C_SDA_OLED, GPIO_FUNC_I2C);
     gpio_set_function(I2C_SCL_OLED, GPIO_FUNC_I2C);
     gpio_pull_up(I2C_SDA_OLED);
@@ -360,9 +2102,17 @@ void inicializar_feedback() {
 void atualizar_led_rgb() {
     static uint32_t last_toggle_time = 0;
     static bool led_state = false;
+    static int status_anterior = -1;
     uint32_t now = to_ms_since_boot(get_absolute_time());
 
-    gpio_put(LED_R_PIN, 0); gpio_put(LED_G_PIN, 0); gpio_put(LED_B_PIN, 0);
+    // Apaga as cores só na troca de status: a tarefa roda a 20 Hz, e apagar a
+    // cada chamada desligaria o vermelho 50 ms depois de cada troca do pisca
+    if ((int)status_sistema != status_anterior) {
+        gpio_put(LED_R_PIN, 0); gpio_put(LED_G_PIN, 0); gpio_put(LED_B_PIN, 0);
+        status_anterior = status_sistema;
+        led_state = true; // O pisca começa aceso
+        last_toggle_time = now;
+    }
 
     switch (status_sistema) {
         case OPERANDO_NORMAL: gpio_put(LED_G_PIN, 1); break; // Verde
@@ -371,202 +2121,973 @@ void atualizar_led_rgb() {
         case ERRO_TEMP_CRITICA: // Vermelho piscando rápido
             if (now - last_toggle_time > 250) {
                 led_state = !led_state;
-                gpio_put(LED_R_PIN, led_state);
                 last_toggle_time = now;
             }
+            gpio_put(LED_R_PIN, led_state);
             break;
         case ERRO_SENSOR: // Vermelho piscando lento
             if (now - last_toggle_time > 1000) {
                 led_state = !led_state;
-                gpio_put(LED_R_PIN, led_state);
                 last_toggle_time = now;
             }
+            gpio_put(LED_R_PIN, led_state);
             break;
         case MODO_CONFIG: gpio_put(LED_R_PIN, 1); gpio_put(LED_B_PIN, 1); break; // Roxo
     }
 }
 
-void bip(int freq, int duration_ms) {
+// Liga o buzzer na frequência dada (0 desliga)
+void buzzer_tom(int freq) {
     if (freq > 0) {
         float div = (float)clock_get_hz(clk_sys) / (freq * 4096);
         pwm_set_clkdiv(fatia_pwm_buzzer, div);
-        pwm_set_gpio_level(fatia_pwm_buzzer, 2048);
+        pwm_set_gpio_level(BUZZER_PIN, 2048);
+    } else {
+        pwm_set_gpio_level(BUZZER_PIN, 0);
+    }
+}
+
+// Inicia uma sequência de notas; a tarefa do buzzer avança sem bloquear
+void tocar_sequencia(const Nota *notas, int quantidade) {
+    buzzer.notas = notas;
+    buzzer.quantidade = quantidade;
+    buzzer.atual = 0;
+    buzzer.fim_nota_ms = to_ms_since_boot(get_absolute_time()) + notas[0].duracao_ms;
+    buzzer_tom(notas[0].freq);
+}
+
+void tarefa_buzzer(void *contexto) {
+    if (!buzzer.notas) return;
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+    if ((int32_t)(agora - buzzer.fim_nota_ms) < 0) return;
+
+    if (++buzzer.atual == buzzer.quantidade) {
+        buzzer.notas = NULL;
+        buzzer_tom(0);
+        return;
     }
-    sleep_ms(duration_ms);
-    pwm_set_gpio_level(fatia_pwm_buzzer, 0);
+    const Nota *nota = &buzzer.notas[buzzer.atual];
+    buzzer.fim_nota_ms = agora + nota->duracao_ms;
+    buzzer_tom(nota->freq);
 }
 
-void bip_curto() { bip(1200, 100); }
-void erro_bips() { bip(500, 150); sleep_ms(50); bip(500, 150); }
-void alerta_temp_critica() { bip(2000, 500); sleep_ms(100); bip(2000, 500); sleep_ms(100); bip(2000, 500); }
-void melodia_sucesso() { bip(1000, 80); sleep_ms(50); bip(1500, 80); sleep_ms(50); bip(2000, 120); }
+static const Nota SEQ_BIP_CURTO[] = {{1200, 100}};
+static const Nota SEQ_ERRO[] = {{500, 150}, {0, 50}, {500, 150}};
+static const Nota SEQ_ALERTA[] = {{2000, 500}, {0, 100}, {2000, 500}, {0, 100}, {2000, 500}};
+static const Nota SEQ_SUCESSO[] = {{1000, 80}, {0, 50}, {1500, 80}, {0, 50}, {2000, 120}};
+
+void bip_curto() { tocar_sequencia(SEQ_BIP_CURTO, count_of(SEQ_BIP_CURTO)); }
+void erro_bips() { tocar_sequencia(SEQ_ERRO, count_of(SEQ_ERRO)); }
+void alerta_temp_critica() { tocar_sequencia(SEQ_ALERTA, count_of(SEQ_ALERTA)); }
+void melodia_sucesso() { tocar_sequencia(SEQ_SUCESSO, count_of(SEQ_SUCESSO)); }
 
+// Interrupção dos botões: só faz o debounce e publica o evento
 void handle_buttons(uint gpio, uint32_t events) {
     static uint32_t last_irq_time = 0;
     uint32_t now = to_ms_since_boot(get_absolute_time());
     if (now - last_irq_time < 200) return; // Debounce
     last_irq_time = now;
 
+    agendador_publicar(EVENTO_BOTAO, gpio);
+}
+
+void tratar_evento(const Evento *evento) {
+    if (evento->tipo == EVENTO_BOTAO)
+        tratar_botao(evento->dado);
+    else if (evento->tipo == EVENTO_SALVAR_CONFIG)
+        salvar_config();
+    else if (evento->tipo == EVENTO_SERIAL)
+        shell_processar();
+}
+
+// Grava a configuração editável na flash. Roda no laço principal: a gravação
+// para as interrupções por algumas dezenas de ms (os atuadores mantêm o último
+// pulso e o watchdog tolera bem mais que isso).
+void salvar_config(void) {
+    static ConfigPersistente config;
+    for (int i = 0; i < NUM_ZONAS; i++) {
+        config.escalonamento[i] = zonas[i].escalonamento;
+        config.escalonamento_ativo[i] = zonas[i].escalonamento_ativo;
+    }
+    memcpy(config.programas, programas, sizeof(programas));
+    bool ok = persistencia_gravar(CONFIG_VERSAO, &config, sizeof(config));
+    LOG(ok ? LOG_INFO : LOG_ERRO, "Configuracao %s na flash.\n", ok ? "gravada" : "NAO gravada");
+}
+
+void carregar_config(void) {
+    static ConfigPersistente config;
+    if (!persistencia_ler(CONFIG_VERSAO, &config, sizeof(config))) {
+        printf("Sem configuracao gravada: usando os padroes.\n");
+        return;
+    }
+    for (int i = 0; i < NUM_ZONAS; i++) {
+        if (!escalonamento_valido(&config.escalonamento[i]))
+            continue;
+        zonas[i].escalonamento = config.escalonamento[i];
+        zonas[i].escalonamento_ativo = config.escalonamento_ativo[i] && config.escalonamento[i].quantidade > 0;
+    }
+    for (int i = 0; i < PROGRAMAS_MAX; i++) {
+        if (programa_valido(&config.programas[i]) && config.programas[i].zona < NUM_ZONAS)
+            programas[i] = config.programas[i];
+    }
+    printf("Configuracao carregada da flash.\n");
+}
+
+void tratar_botao(uint gpio) {
+    Zona *zona = &zonas[zona_exibida];
     if (gpio == BTN_NEXT_PIN) {
         if (estado_menu == CONFIG_SETPOINT) {
-            temperatura_desejada += 0.5;
-            if (temperatura_desejada > 50.0) temperatura_desejada = 10.0;
+            setpoint_em_edicao += 0.5;
+            if (setpoint_em_edicao > 50.0) setpoint_em_edicao = 10.0;
         } else if (estado_menu == MENU_CONFIG) {
-            menu_selecionado = (menu_selecionado + 1) % 2;
+            menu_selecionado = (menu_selecionado + 1) % 3;
         } else {
-            estado_menu = (MenuState)((estado_menu + 1) % 4);
+            estado_menu = (MenuState)((estado_menu + 1) % (MENU_CONFIG + 1));
         }
     } else if (gpio == BTN_SELECT_PIN) {
         if (estado_menu == MENU_CONFIG) {
             if (menu_selecionado == 0) {
+                setpoint_em_edicao = zona->perfil_setpoint.alvo;
                 estado_menu = CONFIG_SETPOINT;
                 status_sistema = MODO_CONFIG;
+            } else if (menu_selecionado == 1) {
+                zona_exibida = (zona_exibida + 1) % NUM_ZONAS;
             } else {
                 estado_menu = TELA_PRINCIPAL;
             }
         } else if (estado_menu == CONFIG_SETPOINT) {
             estado_menu = TELA_PRINCIPAL;
             status_sistema = OPERANDO_NORMAL;
-            termo_integral = 0;
-            melodia_sucesso();
+            Comando comando = {.tipo = COMANDO_SETPOINT, .zona = (uint8_t)zona_exibida, .valor = setpoint_em_edicao};
+            if (fila_comandos_postar(&comandos_locais, comando)) {
+                melodia_sucesso();
+            } else {
+                // Já contado em descartados (shell "stats"); o aviso sonoro troca a confirmação
+                LOG(LOG_AVISO, "Botao: fila de comandos cheia, setpoint descartado\n");
+                erro_bips();
+            }
         } else {
              estado_menu = TELA_PRINCIPAL;
         }
     }
 }
 
-void atualizar_display(float temp_atual, float setpoint, float erro, float angulo, float motor) {
-    ssd1306_fill(&oled, false);
+// === TELAS DO OLED (widgets retidos: só o que muda é redesenhado e enviado) ===
+enum { P_TEMP, P_ZONA, P_SET, P_STATUS_ROTULO, P_STATUS, P_UPTIME };
+Widget widgets_principal[] = {
+    [P_TEMP] = {.tipo = WIDGET_VALOR, .x = 0, .y = 0, .fonte = &ssd1306_font_numbers, .formato = "%.1f°C"},
+    [P_ZONA] = {.tipo = WIDGET_ROTULO, .x = 104, .y = 0},
+    [P_SET] = {.tipo = WIDGET_VALOR, .x = 0, .y = 18, .formato = "Setpoint: %.1f°C"},
+    [P_STATUS_ROTULO] = {.tipo = WIDGET_ROTULO, .x = 0, .y = 33, .inicial = "Status:"},
+    [P_STATUS] = {.tipo = WIDGET_ROTULO, .x = 40, .y = 33},
+    [P_UPTIME] = {.tipo = WIDGET_VALOR, .x = 0, .y = 48, .formato = "Uptime: %.0fs"},
+};
+
+// Gráfico de tendência: uma coluna por TENDENCIA_AMOSTRAS_POR_COLUNA ciclos,
+// com a escala automática nas marcas da esquerda e o setpoint tracejado
+#define TENDENCIA_AMOSTRAS_POR_COLUNA 5 // 96 colunas x 5 s = 8 min de histórico
+Tendencia tendencias[NUM_ZONAS];
+
+enum { G_VALOR, G_JANELA, G_ESCALA_MAX, G_ESCALA_MIN, G_TENDENCIA };
+Widget widgets_grafico[] = {
+    [G_VALOR] = {.tipo = WIDGET_VALOR, .x = 0, .y = 0, .formato = "%.1f°C"},
+    [G_JANELA] = {.tipo = WIDGET_VALOR, .x = 88, .y = 0, .formato = "%.0fmin"},
+    [G_ESCALA_MAX] = {.tipo = WIDGET_VALOR, .x = 0, .y = 12, .formato = "%.0f"},
+    [G_ESCALA_MIN] = {.tipo = WIDGET_VALOR, .x = 0, .y = 56, .formato = "%.0f"},
+    [G_TENDENCIA] = {.tipo = WIDGET_SPARKLINE, .x = 32, .y = 12, .largura = TENDENCIA_COLUNAS, .altura = 52},
+};
+
+enum { I_TITULO, I_ERRO, I_INTEGRAL, I_CICLO };
+Widget widgets_info[] = {
+    [I_TITULO] = {.tipo = WIDGET_ROTULO, .x = 0, .y = 0, .inicial = "Info Detalhada"},
+    [I_ERRO] = {.tipo = WIDGET_VALOR, .x = 0, .y = 16, .formato = "Erro: %.2f"},
+    [I_INTEGRAL] = {.tipo = WIDGET_VALOR, .x = 0, .y = 32, .formato = "Integral: %.2f"},
+    [I_CICLO] = {.tipo = WIDGET_VALOR, .x = 0, .y = 48, .formato = "Ciclo: %.0fms"},
+};
+
+// Programa da zona: segmento, fase, referência e tempo restante, com o
+// progresso do ciclo na barra da direita
+enum { R_TITULO, R_SEGMENTO, R_SETPOINT, R_RESTANTE, R_PROGRESSO };
+Widget widgets_programa[] = {
+    [R_TITULO] = {.tipo = WIDGET_ROTULO, .x = 0, .y = 0},
+    [R_SEGMENTO] = {.tipo = WIDGET_ROTULO, .x = 0, .y = 16},
+    [R_SETPOINT] = {.tipo = WIDGET_ROTULO, .x = 0, .y = 32},
+    [R_RESTANTE] = {.tipo = WIDGET_ROTULO, .x = 0, .y = 48},
+    [R_PROGRESSO] = {.tipo = WIDGET_BARRA, .x = 120, .y = 16, .largura = 8, .altura = 48, .minimo = 0.0f, .maximo = 100.0f},
+};
+
+enum { M_TITULO, M_SETPOINT, M_ZONA, M_VOLTAR, M_CURSOR };
+#define MENU_OPCOES 3
+Widget widgets_menu[] = {
+    [M_TITULO] = {.tipo = WIDGET_ROTULO, .x = 0, .y = 0, .inicial = "Menu"},
+    [M_SETPOINT] = {.tipo = WIDGET_ROTULO, .x = 10, .y = 16, .inicial = "Ajustar Setpoint"},
+    [M_ZONA] = {.tipo = WIDGET_ROTULO, .x = 10, .y = 32},
+    [M_VOLTAR] = {.tipo = WIDGET_ROTULO, .x = 10, .y = 48, .inicial = "Voltar"},
+    [M_CURSOR] = {.tipo = WIDGET_ROTULO, .x = 0, .y = 16},
+    [M_CURSOR + 1] = {.tipo = WIDGET_ROTULO, .x = 0, .y = 32},
+    [M_CURSOR + 2] = {.tipo = WIDGET_ROTULO, .x = 0, .y = 48},
+};
+
+enum { S_TITULO, S_VALOR, S_AJUDA };
+Widget widgets_setpoint[] = {
+    [S_TITULO] = {.tipo = WIDGET_ROTULO, .x = 0, .y = 0, .inicial = "Ajuste Setpoint"},
+    [S_VALOR] = {.tipo = WIDGET_VALOR, .x = 36, .y = 24, .fonte = &ssd1306_font_numbers, .formato = "%.1f°C"},
+    [S_AJUDA] = {.tipo = WIDGET_ROTULO, .x = 0, .y = 56, .inicial = "Next:+ | Sel:OK"},
+};
+
+#define TELA(widgets) {(widgets), (int)count_of(widgets)}
+Tela telas[] = {
+    [TELA_PRINCIPAL] = TELA(widgets_principal),
+    [TELA_GRAFICO_BARRAS] = TELA(widgets_grafico),
+    [TELA_INFO_DETALHADA] = TELA(widgets_info),
+    [TELA_PROGRAMA] = TELA(widgets_programa),
+    [MENU_CONFIG] = TELA(widgets_menu),
+    [CONFIG_SETPOINT] = TELA(widgets_setpoint),
+};
+
+// Widgets redesenhados desde o início, somando todas as telas
+uint32_t display_redesenhos(void) {
+    uint32_t total = 0;
+    for (int i = 0; i < (int)count_of(telas); i++)
+        total += telas[i].redesenhos;
+    return total;
+}
+
+// Cada quadro só entrega os valores atuais aos widgets; se nada mudou, nenhum
+// pixel é tocado e nada vai para o barramento.
+void atualizar_display(const ControleEstado *estado) {
+    static Tela *tela_atual = NULL;
+    Tela *tela = &telas[estado_menu];
+    if (tela != tela_atual) {
+        tela_mostrar(&oled, tela);
+        tela_atual = tela;
+    }
+
     switch (estado_menu) {
-        case TELA_PRINCIPAL: desenhar_tela_principal(temp_atual, setpoint); break;
-        case TELA_GRAFICO_BARRAS: desenhar_tela_grafico(temp_atual); break;
-        case TELA_INFO_DETALHADA: desenhar_tela_info(erro); break;
+        case TELA_PRINCIPAL: desenhar_tela_principal(estado); break;
+        case TELA_GRAFICO_BARRAS: desenhar_tela_grafico(estado); break;
+        case TELA_INFO_DETALHADA: desenhar_tela_info(estado); break;
+        case TELA_PROGRAMA: desenhar_tela_programa(estado); break;
         case MENU_CONFIG: desenhar_menu_config(); break;
         case CONFIG_SETPOINT: desenhar_tela_setpoint(); break;
     }
+    tela_desenhar(&oled, tela);
     ssd1306_send_data(&oled);
 }
 
-void desenhar_tela_principal(float temp_atual, float setpoint) {
-    char buffer[22];
-    sprintf(buffer, "Temp: %.1f C", temp_atual);
-    ssd1306_draw_string(&oled, buffer, 0, 0);
+void desenhar_tela_principal(const ControleEstado *estado) {
+    const ZonaAmostra *zona = &estado->zonas[zona_exibida];
+    if (zona->sensor_ok)
+        widget_valor(&widgets_principal[P_TEMP], zona->temperatura_atual);
+    else
+        widget_texto(&widgets_principal[P_TEMP], "--°C");
+
+    static const char *const ROTULOS_ZONA[] = {"", "Z1", "Z2", "Z3", "Z4"};
+    if (NUM_ZONAS > 1 && zona_exibida + 1 < (int)count_of(ROTULOS_ZONA))
+        widget_texto(&widgets_principal[P_ZONA], ROTULOS_ZONA[zona_exibida + 1]);
 
-    sprintf(buffer, "Set:  %.1f C", setpoint);
-    ssd1306_draw_string(&oled, buffer, 0, 16);
+    widget_valor(&widgets_principal[P_SET], zona->temperatura_desejada);
 
     const char* s = "OK";
-    if (status_sistema == AQUECENDO) s = "Aquecendo";
-    if (status_sistema == STANDBY) s = "Standby";
-    if (status_sistema == ERRO_TEMP_CRITICA) s = "CRITICO!";
-    if (status_sistema == ERRO_SENSOR) s = "Sensor Falhou";
-    if (status_sistema == MODO_CONFIG) s = "Config";
-    sprintf(buffer, "Status: %s", s);
-    ssd1306_draw_string(&oled, buffer, 0, 32);
+    if (estado->status == AQUECENDO) s = "Aquecendo";
+    if (estado->status == STANDBY) s = "Standby";
+    if (estado->status == ERRO_TEMP_CRITICA) s = "CRÍTICO!";
+    if (estado->status == ERRO_SENSOR) s = "Sensor Falhou";
+    if (estado->status == MODO_CONFIG) s = "Config";
+    widget_texto(&widgets_principal[P_STATUS], s);
 
     uint32_t uptime_s = (to_ms_since_boot(get_absolute_time()) - tempo_inicio_operacao) / 1000;
-    sprintf(buffer, "Uptime: %lus", uptime_s);
-    ssd1306_draw_string(&oled, buffer, 0, 48);
+    widget_valor(&widgets_principal[P_UPTIME], (float)uptime_s);
+}
+
+void desenhar_tela_grafico(const ControleEstado *estado) {
+    const ZonaAmostra *zona = &estado->zonas[zona_exibida];
+    const Tendencia *tendencia = &tendencias[zona_exibida];
+    if (zona->sensor_ok)
+        widget_valor(&widgets_grafico[G_VALOR], zona->temperatura_atual);
+    else
+        widget_texto(&widgets_grafico[G_VALOR], "--°C");
+    widget_valor(&widgets_grafico[G_JANELA], TENDENCIA_COLUNAS * TENDENCIA_AMOSTRAS_POR_COLUNA * PERIODO_AMOSTRA / 60.0f);
+
+    if (tendencia_num_colunas(tendencia) == 0)
+        return; // Sem histórico ainda: escala e gráfico ficam vazios
+    widget_valor(&widgets_grafico[G_ESCALA_MAX], tendencia->escala_max);
+    widget_valor(&widgets_grafico[G_ESCALA_MIN], tendencia->escala_min);
+    widget_sparkline(&widgets_grafico[G_TENDENCIA], tendencia);
 }
 
-void desenhar_tela_grafico(float temp_atual) {
-    ssd1306_draw_string(&oled, "Grafico Temp.", 0, 0);
-    int bar_height = (int)mapear_valores(temp_atual, 10, 50, 0, 50);
-    if(bar_height < 0) bar_height = 0;
-    if(bar_height > 50) bar_height = 50;
-    ssd1306_rect(&oled, 64 - bar_height, 50, 28, bar_height, true, true);
-    char buffer[20];
-    sprintf(buffer, "%.1fC", temp_atual);
-    ssd1306_draw_string(&oled, buffer, 40, 24);
+void desenhar_tela_info(const ControleEstado *estado) {
+    const ZonaAmostra *zona = &estado->zonas[zona_exibida];
+    widget_valor(&widgets_info[I_ERRO], zona->erro);
+    widget_valor(&widgets_info[I_INTEGRAL], zona->termo_integral);
+    widget_valor(&widgets_info[I_CICLO], (float)(estado->duracao_ciclo_us / 1000));
 }
 
-void desenhar_tela_info(float erro) {
-    char buffer[20];
-    ssd1306_draw_string(&oled, "Info Detalhada", 0, 0);
-    sprintf(buffer, "Erro: %.2f", erro);
-    ssd1306_draw_string(&oled, buffer, 0, 16);
-    sprintf(buffer, "Integral: %.2f", termo_integral);
-    ssd1306_draw_string(&oled, buffer, 0, 32);
+void desenhar_tela_programa(const ControleEstado *estado) {
+    const ZonaAmostra *zona = &estado->zonas[zona_exibida];
+    const ProgramaExecucao *execucao = &execucoes[zona_exibida];
+    const Programa *programa = execucao->programa;
+    char texto[WIDGET_TEXTO_MAX];
+
+    if (!programa) {
+        int minuto;
+        uint32_t dia;
+        widget_texto(&widgets_programa[R_TITULO], "Sem programa");
+        if (relogio_hora_local(&minuto, &dia))
+            snprintf(texto, sizeof(texto), "Hora: %02d:%02d", minuto / 60, minuto % 60);
+        else
+            snprintf(texto, sizeof(texto), "Hora: --:--");
+        widget_texto(&widgets_programa[R_SEGMENTO], texto);
+        widget_texto(&widgets_programa[R_SETPOINT], "");
+        widget_texto(&widgets_programa[R_RESTANTE], "");
+        widget_barra(&widgets_programa[R_PROGRESSO], 0.0f);
+        return;
+    }
+
+    snprintf(texto, sizeof(texto), "Prog: %s", programa->nome);
+    widget_texto(&widgets_programa[R_TITULO], texto);
+    snprintf(texto, sizeof(texto), "Seg %d/%d %s", execucao->segmento + 1, programa->quantidade,
+             NOMES_FASE_PROGRAMA[execucao->fase]);
+    widget_texto(&widgets_programa[R_SEGMENTO], texto);
+    snprintf(texto, sizeof(texto), "SP %.1f > %.1f°C", zona->temperatura_desejada,
+             programa->segmentos[execucao->segmento].alvo);
+    widget_texto(&widgets_programa[R_SETPOINT], texto);
+
+    float restante = programa_restante_s(execucao);
+    snprintf(texto, sizeof(texto), "Falta: %.0fmin", ceilf(restante / 60.0f));
+    widget_texto(&widgets_programa[R_RESTANTE], texto);
+    float progresso = execucao->duracao_s > 0.0f ? 100.0f * (1.0f - restante / execucao->duracao_s) : 100.0f;
+    widget_barra(&widgets_programa[R_PROGRESSO], progresso);
 }
 
 void desenhar_menu_config() {
-    ssd1306_draw_string(&oled, "Menu", 0, 0);
-    ssd1306_draw_string(&oled, "Ajustar Setpoint", 10, 24);
-    ssd1306_draw_string(&oled, "Voltar", 10, 40);
-    ssd1306_draw_char(&oled, '>', 0, 24 + (menu_selecionado * 16));
+    char zona[16];
+    snprintf(zona, sizeof(zona), "Zona: %d/%d", zona_exibida + 1, NUM_ZONAS);
+    widget_texto(&widgets_menu[M_ZONA], zona);
+    for (int i = 0; i < MENU_OPCOES; i++)
+        widget_texto(&widgets_menu[M_CURSOR + i], i == menu_selecionado ? ">" : "");
 }
 
 void desenhar_tela_setpoint() {
-    char buffer[20];
-    ssd1306_draw_string(&oled, "Ajuste Setpoint", 0, 0);
-    sprintf(buffer, "   %.1f C", temperatura_desejada);
-    ssd1306_draw_string(&oled, buffer, 0, 28);
-    ssd1306_draw_string(&oled, "Next:+ | Sel:OK", 0, 56);
+    widget_valor(&widgets_setpoint[S_VALOR], setpoint_em_edicao);
 }
 
-// --- FUNÇÃO MAIN ---
-int main() {
-    stdio_init_all();
-    sleep_ms(4000);
-
-    // Inicia o servidor com sua rede e senha
-    if (http_server_init(SSID, SENHA))
+// === CICLO DE CONTROLE ===
+// As medições de todas as zonas são disparadas juntas e lidas após um único
+// tempo de conversão, então o custo do ciclo cresce pouco com o número de zonas.
+// Zonas com sobreamostragem repetem o disparo e usam a média das leituras válidas.
+// A espera da conversão não bloqueia: a tarefa de leitura é agendada para depois dela.
+struct {
+    uint32_t inicio;
+    int rodada;
+    int rodadas;
+    bool disparada[NUM_ZONAS];
+    float soma_temperatura[NUM_ZONAS];
+    float soma_umidade[NUM_ZONAS];
+    int leituras_validas[NUM_ZONAS];
+    uint32_t concluidos; // Numera as amostras da telemetria UDP
+} ciclo;
+
+// Publica o estado do controle para os leitores (só o laço principal escreve)
+void publicar_estado(void)
+{
+    ControleEstado *estado = seqlock_escrita(&estado_controle);
+    estado->ciclo = ciclo.concluidos;
+    estado->duracao_ciclo_us = duracao_ciclo_us;
+    estado->status = status_sistema;
+    for (int i = 0; i < NUM_ZONAS; i++)
     {
-        printf("Falha ao iniciar o servidor.\n");
-        while (1)
-            ;
+        const ProgramaExecucao *execucao = &execucoes[i];
+        zona_amostrar(&zonas[i], &estado->zonas[i]);
+        estado->execucoes[i] = (ExecucaoAmostra){
+            .programa = execucao->programa ? (int8_t)(execucao->programa - programas) : -1,
+            .segmento = execucao->segmento,
+            .fase = execucao->fase,
+            .setpoint = execucao->setpoint,
+            .restante_s = programa_restante_s(execucao),
+            .espera_s = execucao->espera_s,
+            .ciclos = execucao->ciclos,
+        };
     }
+    seqlock_publicar(&estado_controle);
+}
 
-    
-    // Definição da página http
-    http_server_set_homepage(HTML_BODY);
+// Publica a configuração para os handlers (no boot e após aplicar comandos)
+void publicar_config(void)
+{
+    ConfigEstado *config = seqlock_escrita(&config_controle);
+    for (int i = 0; i < NUM_ZONAS; i++)
+        zona_copiar_config(&zonas[i], &config->zonas[i]);
+    memcpy(config->programas, programas, sizeof(programas));
+    config->udp = fluxo_udp;
+    seqlock_publicar(&config_controle);
+}
 
-    // Cadastra o handler para a rota "/status"
-    http_server_register_handler((http_request_handler_t){"/status", &status_handler});
+void tarefa_controle(void *contexto);
+void tarefa_leitura(void *contexto);
+void tarefa_display(void *contexto);
+void tarefa_led(void *contexto);
+void tarefa_serial(void *contexto);
+void tarefa_rede(void *contexto);
+void tarefa_eventos(void *contexto);
+void tarefa_mqtt(void *contexto);
+void tarefa_udp(void *contexto);
+void tarefa_stream(void *contexto);
+void tarefa_comandos(void *contexto);
+
+// Tarefas, em ordem de prioridade
+#define US_POR_MS 1000u
+Tarefa tarefas_sistema[] = {
+    {.nome = "leitura", .funcao = tarefa_leitura, .prazo_us = 20 * US_POR_MS},
+    {.nome = "controle", .funcao = tarefa_controle, .periodo_us = (uint32_t)(PERIODO_AMOSTRA * 1000000), .prazo_us = 10 * US_POR_MS},
+    {.nome = "udp", .funcao = tarefa_udp, .periodo_us = 1000000 / UDP_TAXA_PADRAO_HZ, .prazo_us = 2 * US_POR_MS},
+    {.nome = "stream", .funcao = tarefa_stream, .prazo_us = 5 * US_POR_MS}, // Ligada pelo comando "stream"
+    {.nome = "comandos", .funcao = tarefa_comandos, .periodo_us = 10 * US_POR_MS},
+    {.nome = "buzzer", .funcao = tarefa_buzzer, .periodo_us = 10 * US_POR_MS},
+    {.nome = "led", .funcao = tarefa_led, .periodo_us = 50 * US_POR_MS},      // 20 Hz
+    {.nome = "display", .funcao = tarefa_display, .periodo_us = 100 * US_POR_MS}, // 10 Hz
+    {.nome = "serial", .funcao = tarefa_serial, .periodo_us = 100 * US_POR_MS}, // Só cobre um evento descartado
+    {.nome = "eventos", .funcao = tarefa_eventos, .periodo_us = 100 * US_POR_MS},
+    {.nome = "mqtt", .funcao = tarefa_mqtt, .periodo_us = 100 * US_POR_MS},
+    {.nome = "rede", .funcao = tarefa_rede, .periodo_us = 10 * US_POR_MS},
+};
+#define TAREFA_LEITURA (&tarefas_sistema[0])
+#define TAREFA_UDP (&tarefas_sistema[2])
+#define TAREFA_STREAM (&tarefas_sistema[3])
+
+static void disparar_rodada(void)
+{
+    for (int i = 0; i < NUM_ZONAS; i++)
+    {
+        ciclo.disparada[i] = ciclo.rodada < zonas[i].filtro.cfg.amostras_burst && zona_disparar_leitura(&zonas[i]);
+    }
+    agendador_agendar(TAREFA_LEITURA, AHT20_TEMPO_MEDICAO_MS * US_POR_MS);
+}
+
+// Início do ciclo: zera os acumuladores e dispara a primeira rodada
+void tarefa_controle(void *contexto)
+{
+    ciclo.inicio = time_us_32();
+    ciclo.rodada = 0;
+    ciclo.rodadas = 1;
+    for (int i = 0; i < NUM_ZONAS; i++)
+    {
+        ciclo.soma_temperatura[i] = 0.0f;
+        ciclo.soma_umidade[i] = 0.0f;
+        ciclo.leituras_validas[i] = 0;
+        if (zonas[i].filtro.cfg.amostras_burst > ciclo.rodadas)
+            ciclo.rodadas = zonas[i].filtro.cfg.amostras_burst;
+    }
+    disparar_rodada();
+}
 
-    // Cadastra o handler para a rota "/set_temperatura?"
-    http_server_register_handler((http_request_handler_t){"/set_temperatura?", &set_temperatura_handler});
+// Fim da conversão: lê a rodada e dispara a próxima ou conclui o ciclo
+void tarefa_leitura(void *contexto)
+{
+    // Enfileira todas as leituras antes de esperar a primeira: barramentos
+    // diferentes trabalham em paralelo
+    for (int i = 0; i < NUM_ZONAS; i++)
+    {
+        if (ciclo.disparada[i])
+            zona_solicitar_resultado(&zonas[i]);
+    }
 
-    printf("\n=== Controle PI de Temperatura com Servo Motor e Ventoinha ===\n");
+    for (int i = 0; i < NUM_ZONAS; i++)
+    {
+        float temperatura, umidade;
+        if (ciclo.disparada[i] && zona_ler_temperatura(&zonas[i], &temperatura, &umidade) == AHT20_OK)
+        {
+            ciclo.soma_temperatura[i] += temperatura;
+            ciclo.soma_umidade[i] += umidade;
+            ciclo.leituras_validas[i]++;
+        }
+    }
 
-    if (!inicializar_sensor())
+    if (++ciclo.rodada < ciclo.rodadas)
     {
-        while (1)
-            ; // Trava se o sensor falhar
+        disparar_rodada();
+        return;
     }
+    concluir_ciclo_controle();
+}
 
-    inicializar_servo();
-    definir_angulo_servo(90); // Posição inicial do servo
-    inicializar_ventoinha();
-    inicializar_feedback();
-    
-    tempo_inicio_operacao = to_ms_since_boot(get_absolute_time());
+// Partidas agendadas e programas em execução, seguidos da trajetória do
+// setpoint de cada zona. Roda no início de cada ciclo, com a temperatura do
+// ciclo anterior.
+void avancar_programas(void)
+{
+    int minuto;
+    uint32_t dia;
+    if (relogio_hora_local(&minuto, &dia))
+    {
+        for (int i = 0; i < PROGRAMAS_MAX; i++)
+        {
+            const Programa *programa = &programas[i];
+            if (programa->quantidade == 0 || programa->inicio_min != minuto || dia_agendado[i] == dia)
+                continue;
+            dia_agendado[i] = dia;
+            iniciar_programa(i, programa->zona);
+        }
+    }
 
-    printf("\nDigite uma nova temperatura (ex: 25.5 ou 25,5) e pressione Enter.\n\n");
+    for (int i = 0; i < NUM_ZONAS; i++)
+    {
+        Zona *zona = &zonas[i];
+        ProgramaExecucao *execucao = &execucoes[i];
+        const Programa *programa = execucao->programa;
+        if (programa)
+            zona_definir_setpoint(zona, programa_avancar(execucao, zona->sensor_ok ? zona->temperatura_atual : NAN,
+                                                         PERIODO_AMOSTRA));
+        if (programa && !execucao->programa)
+        {
+            LOG(LOG_INFO, "[%s] Programa '%s' concluido.\n", zona->hw.nome, programa->nome);
+            melodia_sucesso();
+        }
+        zona_avancar_setpoint(zona, PERIODO_AMOSTRA);
+    }
+}
 
+void concluir_ciclo_controle(void)
+{
+    uint32_t agora_ms = to_ms_since_boot(get_absolute_time());
+    bool todas_lidas = true;
+    avancar_programas();
+    for (int i = 0; i < NUM_ZONAS; i++)
+    {
+        Zona *zona = &zonas[i];
+        if (ciclo.leituras_validas[i] == 0)
+        {
+            LOG(LOG_ERRO, "[%s] Erro ao ler dados do sensor AHT20.\n", zona->hw.nome);
+            zona_tratar_falha_sensor(zona, agora_ms);
+            todas_lidas = false;
+            continue;
+        }
+        zona_confirmar_leitura_sensor(zona);
 
-    while (1) {
-        cyw43_arch_poll();
-        verificar_nova_temperatura_serial();
+        zona->temperatura_bruta = ciclo.soma_temperatura[i] / ciclo.leituras_validas[i];
+        zona->umidade = ciclo.soma_umidade[i] / ciclo.leituras_validas[i];
 
         float temperatura_atual;
-        if ((ler_temperatura(&temperatura_atual)) && status_sistema != MODO_CONFIG)
+        uint32_t inicio_filtro = time_us_32();
+        zona_filtrar_temperatura(zona, zona->temperatura_bruta, &temperatura_atual);
+        uint32_t fim_filtro = time_us_32();
+        zona->tempo_filtro_us = fim_filtro - inicio_filtro;
+        zona->latencia_us = fim_filtro - ciclo.inicio;
+        if (zona->latencia_us > zona->latencia_max_us)
+            zona->latencia_max_us = zona->latencia_us;
+
+        if (status_sistema != MODO_CONFIG)
         {
-            aplicar_controle(temperatura_atual);
+            zona_aplicar_controle(zona, temperatura_atual);
         }
         else
         {
-            printf("Erro ao ler dados do sensor AHT20.\n");
+            zona->temperatura_atual = temperatura_atual; // O supervisor continua vigiando
         }
-        
-        atualizar_display(temperatura_atual, temperatura_desejada, http_erro, http_angulo_alvo, http_velocidade_ventoinha);
-        atualizar_led_rgb();
+        tendencia_adicionar(&tendencias[i], zona->temperatura_atual, zona->temperatura_desejada);
+    }
 
-        if (status_sistema == ERRO_TEMP_CRITICA) {
-            alerta_temp_critica();
-        }
-        
-        sleep_ms(PERIODO_AMOSTRA * 1000);
+    atualizar_status_sistema();
+    if (status_sistema == ERRO_TEMP_CRITICA && !buzzer.notas)
+        alerta_temp_critica();
+
+    duracao_ciclo_us = time_us_32() - ciclo.inicio;
+    if (ciclo.concluidos++ == 0)
+        boot_us[BOOT_PRIMEIRO_CICLO] = time_us_32();
+    publicar_estado();
+    supervisor_sinalizar_vida();
+    publicar_amostras();
+    registrar_telemetria_mqtt();
+    acompanhar_atualizacao(todas_lidas && status_sistema != ERRO_TEMP_CRITICA, agora_ms);
+}
+
+// Envia a amostra de cada zona aos assinantes de /events (serializada uma vez por ciclo)
+void publicar_amostras(void)
+{
+    if (http_server_event_subscribers() == 0)
+        return;
+
+    static ControleEstado estado;
+    static char dados[320];
+    seqlock_ler(&estado_controle, &estado);
+    for (int i = 0; i < NUM_ZONAS; i++)
+    {
+        const ZonaAmostra *zona = &estado.zonas[i];
+        snprintf(dados, sizeof(dados),
+                 "{\"zona\": %d, \"temperatura_atual\": %.2f, \"temperatura_desejada\": %.2f, \"erro\": %.2f, "
+                 "\"angulo_alvo\": %.2f, \"velocidade_ventoinha\": %.2f, \"umidade\": %.1f, \"modo\": \"%s\", "
+                 "\"sensor_ok\": %s, \"status\": \"%s\"}",
+                 i, zona->temperatura_atual, zona->temperatura_desejada, zona->erro, zona->angulo_alvo,
+                 zona->velocidade_ventoinha, zona->umidade, NOMES_MODO[zona->modo],
+                 zona->sensor_ok ? "true" : "false", NOMES_STATUS[estado.status]);
+        http_server_publish_event("amostra", dados);
+    }
+}
+
+// Acrescenta a amostra de cada zona ao lote MQTT (enviado a cada MQTT_PERIODO_MS)
+void registrar_telemetria_mqtt(void)
+{
+    if (!rede_iniciada)
+        return;
+    static ControleEstado estado;
+    char registro[160];
+    uint32_t agora_ms = to_ms_since_boot(get_absolute_time());
+    seqlock_ler(&estado_controle, &estado);
+    for (int i = 0; i < NUM_ZONAS; i++)
+    {
+        const ZonaAmostra *zona = &estado.zonas[i];
+        snprintf(registro, sizeof(registro),
+                 "{\"t\":%lu,\"zona\":%d,\"temp\":%.2f,\"sp\":%.2f,\"ang\":%.1f,\"vent\":%.0f,\"umid\":%.1f,\"ok\":%d}",
+                 (unsigned long)agora_ms, i, zona->temperatura_atual, zona->temperatura_desejada,
+                 zona->angulo_alvo, zona->velocidade_ventoinha, zona->umidade, zona->sensor_ok);
+        mqtt_telemetria_adicionar(registro);
+    }
+}
+
+// Publica mudanças de estado assim que acontecem, venham da serial, dos botões
+// ou da web: compara com o que foi publicado por último.
+void tarefa_eventos(void *contexto)
+{
+    static SystemStatus status_publicado = OPERANDO_NORMAL;
+    static float setpoint_publicado[NUM_ZONAS];
+    static ModoControle modo_publicado[NUM_ZONAS];
+    static ControleEstado estado;
+    static char dados[128];
+
+    seqlock_ler(&estado_controle, &estado);
+    if (estado.status != status_publicado)
+    {
+        status_publicado = estado.status;
+        snprintf(dados, sizeof(dados), "{\"status\": \"%s\"}", NOMES_STATUS[estado.status]);
+        http_server_publish_event("status", dados);
+    }
+
+    for (int i = 0; i < NUM_ZONAS; i++)
+    {
+        const ZonaAmostra *zona = &estado.zonas[i];
+        // A trajetória muda a cada ciclo (vai nas amostras); aqui só o setpoint pedido
+        if (zona->setpoint_alvo == setpoint_publicado[i] && zona->modo == modo_publicado[i])
+            continue;
+        setpoint_publicado[i] = zona->setpoint_alvo;
+        modo_publicado[i] = zona->modo;
+        snprintf(dados, sizeof(dados),
+                 "{\"zona\": %d, \"temperatura_desejada\": %.2f, \"setpoint_alvo\": %.2f, \"modo\": \"%s\"}",
+                 i, zona->temperatura_desejada, setpoint_publicado[i], NOMES_MODO[zona->modo]);
+        http_server_publish_event("zona", dados);
+    }
+}
+
+void tarefa_display(void *contexto)
+{
+    static ControleEstado estado;
+    seqlock_ler(&estado_controle, &estado);
+    atualizar_display(&estado);
+}
+
+// Aplica os comandos postados pela rede, pela serial e pelos botões. Publica o
+// estado e a configuração logo em seguida, para uma leitura após a resposta já
+// ver a mudança.
+void tarefa_comandos(void *contexto)
+{
+    Comando comando;
+    bool aplicou = false;
+    while (fila_comandos_retirar(&comandos_rede, &comando) || fila_comandos_retirar(&comandos_locais, &comando))
+    {
+        aplicar_comando(&comando);
+        aplicou = true;
+    }
+    if (aplicou)
+    {
+        publicar_estado();
+        publicar_config();
+    }
+    // A carga só volta a ficar livre com a configuração nova já publicada
+    if (carga_rede.aplicada)
+    {
+        carga_rede.aplicada = false;
+        carga_rede.ocupada = false;
+    }
+}
+void tarefa_led(void *contexto) { atualizar_led_rgb(); }
+void tarefa_serial(void *contexto) { shell_processar(); }
+// Sobe o rádio, o lwIP e os serviços de rede. Só o rádio bloqueia (carga do
+// firmware); o resto fica em segundo plano e atende quando o DHCP responder.
+static bool iniciar_rede(void)
+{
+    if (!wifi_iniciar(SSID, SENHA))
+    {
+        LOG(LOG_ERRO, "Falha ao iniciar o radio: controle segue sem rede.\n");
+        return false;
+    }
+    boot_us[BOOT_RADIO] = time_us_32();
+
+    if (http_server_init())
+        LOG(LOG_ERRO, "Falha ao iniciar o servidor.\n");
+
+    // Telemetria da frota: conecta em segundo plano, com backoff se o broker estiver fora
+    MqttConfig cfg_mqtt = {
+        .broker = MQTT_BROKER,
+        .porta = MQTT_PORTA,
+        .cliente_id = MQTT_CLIENTE_ID,
+        .prefixo = MQTT_PREFIXO,
+        .periodo_ms = MQTT_PERIODO_MS,
+        .qos = MQTT_QOS,
+        .ao_receber_comando = tratar_comando_mqtt,
+    };
+    if (!mqtt_telemetria_iniciar(&cfg_mqtt))
+        LOG(LOG_ERRO, "Falha ao iniciar o cliente MQTT.\n");
+
+    // Hora do dia para as partidas agendadas dos programas
+    relogio_iniciar(SNTP_SERVIDOR, FUSO_HORARIO_MIN);
+    return true;
+}
+
+// A rede parte depois do primeiro ciclo de controle; daí em diante, acompanha
+// o Wi-Fi e reconecta quando ele cair
+void tarefa_rede(void *contexto)
+{
+    static bool boot_relatado = false;
+    static bool radio_falhou = false;
+    if (!rede_iniciada)
+    {
+        if (ciclo.concluidos == 0 || radio_falhou)
+            return;
+        rede_iniciada = iniciar_rede();
+        radio_falhou = !rede_iniciada;
+        return;
+    }
+    cyw43_arch_poll();
+    uint32_t agora_ms = to_ms_since_boot(get_absolute_time());
+    wifi_processar(agora_ms);
+
+    // Imagem nova gravada por /update: reinicia depois que a resposta saiu
+    if (reinicio_atualizacao_ms && (int32_t)(agora_ms - reinicio_atualizacao_ms) >= 0)
+        supervisor_reiniciar(REINICIO_ATUALIZACAO);
+
+    if (!boot_relatado && wifi_conectado())
+    {
+        static char fases[160];
+        boot_json(fases, sizeof(fases));
+        LOG(LOG_INFO, "Boot (ms): %s\n", fases);
+        boot_relatado = true;
+    }
+}
+// Converte para inteiro escalado, saturando na faixa do campo do datagrama
+static int32_t escalar(float valor, float escala, int32_t minimo, int32_t maximo)
+{
+    float v = roundf(valor * escala);
+    return v < minimo ? minimo : v > maximo ? maximo : (int32_t)v;
+}
+
+// Amostra binária da zona @p i, comum ao fluxo UDP e à saída binária da serial
+static TelemetriaUdpAmostra montar_amostra(const ControleEstado *estado, int i, uint32_t agora)
+{
+    const ZonaAmostra *zona = &estado->zonas[i];
+    // A posição real dos atuadores anda entre ciclos (IRQ do PWM): vem direto da zona
+    const Zona *atuadores = &zonas[i];
+    return (TelemetriaUdpAmostra){
+        .instante_us = agora,
+        .zona = (uint8_t)i,
+        .estado = (zona->sensor_ok ? TELEMETRIA_UDP_SENSOR_OK : 0) |
+                  (zona->temperatura_critica ? TELEMETRIA_UDP_CRITICA : 0) |
+                  (uint8_t)(zona->modo << TELEMETRIA_UDP_MODO_SHIFT),
+        .ciclo = (uint16_t)estado->ciclo,
+        .temperatura_bruta = (int16_t)escalar(zona->temperatura_bruta, 100.0f, INT16_MIN, INT16_MAX),
+        .temperatura = (int16_t)escalar(zona->temperatura_atual, 100.0f, INT16_MIN, INT16_MAX),
+        .setpoint = (int16_t)escalar(zona->temperatura_desejada, 100.0f, INT16_MIN, INT16_MAX),
+        .integral = (int16_t)escalar(zona->termo_integral, 100.0f, INT16_MIN, INT16_MAX),
+        .angulo = (uint16_t)escalar(zona->angulo_alvo, 10.0f, 0, UINT16_MAX),
+        .ventoinha = (uint8_t)escalar(zona->velocidade_ventoinha, 1.0f, 0, 100),
+        .angulo_atual = (uint16_t)escalar(atuadores->perfil_servo.posicao, 10.0f, 0, UINT16_MAX),
+        .ventoinha_atual = (uint8_t)escalar(atuadores->perfil_ventoinha.posicao, 1.0f, 0, 100),
+        .umidade = (uint8_t)escalar(zona->umidade, 1.0f, 0, 100),
+    };
+}
+
+// Captura o estado de cada zona na taxa do fluxo UDP. O controle roda a cada
+// PERIODO_AMOSTRA: entre dois ciclos as amostras repetem os valores, e o campo
+// "ciclo" indica qual deles os produziu.
+void tarefa_udp(void *contexto)
+{
+    if (fluxo_udp.reconfigurar)
+    {
+        fluxo_udp.reconfigurar = false;
+        TAREFA_UDP->periodo_us = 1000000u / (uint32_t)fluxo_udp.taxa_hz;
+        if (fluxo_udp.ativo)
+            telemetria_udp_iniciar(fluxo_udp.destino, (uint16_t)fluxo_udp.porta, (uint8_t)fluxo_udp.amostras_por_pacote);
+        else
+            telemetria_udp_parar();
+    }
+    if (!telemetria_udp_ativa())
+        return;
+
+    static ControleEstado estado;
+    uint32_t agora = time_us_32();
+    seqlock_ler(&estado_controle, &estado);
+    for (int i = 0; i < NUM_ZONAS; i++)
+    {
+        TelemetriaUdpAmostra amostra = montar_amostra(&estado, i, agora);
+        telemetria_udp_adicionar(&amostra);
+    }
+}
+
+// Saída binária do shell: um quadro por execução, com todas as zonas
+struct {
+    uint32_t sequencia;
+    uint32_t quadros;
+} stream_serial;
+
+// Liga a saída binária a @p taxa_hz (0 desliga e volta o texto). Retorna os
+// quadros enviados desde que foi ligada.
+uint32_t configurar_stream_serial(int taxa_hz)
+{
+    if (taxa_hz <= 0)
+    {
+        TAREFA_STREAM->periodo_us = 0;
+        TAREFA_STREAM->pendente = false;
+        log_silenciado = false;
+        return stream_serial.quadros;
+    }
+    stream_serial.quadros = 0;
+    log_silenciado = true;
+    TAREFA_STREAM->periodo_us = 1000000u / (uint32_t)taxa_hz;
+    agendador_agendar(TAREFA_STREAM, 0);
+    return 0;
+}
+
+void tarefa_stream(void *contexto)
+{
+    if (!log_silenciado)
+        return;
+    static ControleEstado estado;
+    static struct __attribute__((packed)) {
+        TelemetriaUdpCabecalho cabecalho;
+        TelemetriaUdpAmostra amostras[NUM_ZONAS];
+    } quadro;
+
+    uint32_t agora = time_us_32();
+    seqlock_ler(&estado_controle, &estado);
+    quadro.cabecalho = (TelemetriaUdpCabecalho){TELEMETRIA_UDP_MAGICO, TELEMETRIA_UDP_VERSAO, NUM_ZONAS,
+                                                stream_serial.sequencia++, agora};
+    for (int i = 0; i < NUM_ZONAS; i++)
+        quadro.amostras[i] = montar_amostra(&estado, i, agora);
+
+    // Sem conversão de fim de linha: os bytes saem como estão
+    const uint8_t *bytes = (const uint8_t *)&quadro;
+    for (size_t i = 0; i < sizeof(quadro); i++)
+        putchar_raw(bytes[i]);
+    stdio_flush();
+    stream_serial.quadros++;
+}
+
+void tarefa_mqtt(void *contexto)
+{
+    if (rede_iniciada)
+        mqtt_telemetria_processar(to_ms_since_boot(get_absolute_time()));
+}
+
+// Temperatura crítica tem prioridade sobre os demais estados. Modo degradado:
+// ERRO_SENSOR enquanto alguma zona estiver com o sensor em falha (as demais
+// continuam controlando). Estados definidos pelo usuário são preservados.
+void atualizar_status_sistema(void)
+{
+    if (supervisor_temperatura_critica())
+    {
+        status_sistema = ERRO_TEMP_CRITICA;
+        return;
+    }
+    if (status_sistema == ERRO_TEMP_CRITICA)
+        status_sistema = OPERANDO_NORMAL;
+
+    bool alguma_falha = false;
+    for (int i = 0; i < NUM_ZONAS; i++)
+        alguma_falha |= zonas[i].monitor.estado == SENSOR_EM_FALHA;
+
+    if (alguma_falha && status_sistema == OPERANDO_NORMAL)
+    {
+        status_sistema = ERRO_SENSOR;
+        erro_bips();
+    }
+    else if (!alguma_falha && status_sistema == ERRO_SENSOR)
+    {
+        status_sistema = OPERANDO_NORMAL;
+    }
+}
+
+// --- FUNÇÃO MAIN ---
+int main() {
+    stdio_init_all();
+    shell_iniciar(COMANDOS_SHELL, count_of(COMANDOS_SHELL), cmd_padrao);
+    stdio_set_chars_available_callback(receber_serial, NULL);
+    printf("\n=== Controle PI de Temperatura com Servo Motor e Ventoinha ===\n");
+
+    // Um sensor ausente não trava o sistema: a zona começa em falha, com os
+    // atuadores na posição segura, e o monitor tenta recuperá-lo a cada ciclo.
+    bool algum_sensor_falhou = false;
+    for (int i = 0; i < NUM_ZONAS; i++)
+    {
+        algum_sensor_falhou |= !zona_inicializar_sensor(&zonas[i]);
+        zona_inicializar_atuadores(&zonas[i]);
+        tendencia_iniciar(&tendencias[i], TENDENCIA_AMOSTRAS_POR_COLUNA);
     }
+    atuadores_iniciar(zonas, NUM_ZONAS);
+    for (int i = 0; i < PROGRAMAS_MAX; i++)
+        programas[i].inicio_min = PROGRAMA_SEM_HORARIO; // Programas novos só partem à mão
+    carregar_config();
+
+    // Banco em execução e registro da última atualização (o bootloader já escolheu o banco)
+    extern char __flash_binary_start; // Definido pelo linker: início desta imagem
+    ota_iniciar(&OTA_FLASH_PICO, (uintptr_t)&__flash_binary_start - XIP_BASE);
+    inicializar_feedback();
+    if (algum_sensor_falhou)
+        status_sistema = ERRO_SENSOR;
+    publicar_estado(); // Leitores já encontram um estado válido antes do primeiro ciclo
+    publicar_config();
+    boot_us[BOOT_CONTROLE] = time_us_32();
+
+    // Página e rotas HTTP (só as tabelas: o servidor abre a porta quando a rede subir)
+    http_server_set_homepage(HTML_BODY);
+    http_server_set_token(TOKEN_ACESSO); // Todo POST precisa do token
+
+    // Cadastra o handler para a rota "/status"
+    http_server_register_handler((http_request_handler_t){"/status", &status_handler});
+
+    // Cadastra o handler para a rota "/set_temperatura"
+    http_server_register_handler((http_request_handler_t){"/set_temperatura", &set_temperatura_handler});
+
+    // Rotas de configuração: GET consulta, POST (JSON ou formulário) altera
+    http_server_register_handler((http_request_handler_t){"/ganhos", &ganhos_handler});
+    http_server_register_handler((http_request_handler_t){"/modo", &modo_handler});
+    http_server_register_handler((http_request_handler_t){"/limites", &limites_handler});
+    http_server_register_handler((http_request_handler_t){"/filtro", &filtro_handler});
+    http_server_register_handler((http_request_handler_t){"/i2c", &i2c_handler});
+    http_server_register_handler((http_request_handler_t){"/tarefas", &tarefas_handler});
+    http_server_register_handler((http_request_handler_t){"/mqtt", &mqtt_handler});
+    http_server_register_handler((http_request_handler_t){"/udp", &udp_handler});
+    http_server_register_handler((http_request_handler_t){"/feedforward", &feedforward_handler});
+    http_server_register_handler((http_request_handler_t){"/atuadores", &atuadores_handler});
+    http_server_register_handler((http_request_handler_t){"/pwm", &pwm_handler});
+    http_server_register_handler((http_request_handler_t){"/escalonamento", &escalonamento_handler});
+    http_server_register_handler((http_request_handler_t){"/programas", &programas_handler});
+    http_server_register_handler((http_request_handler_t){"/rede", &rede_handler});
+
+    // Atualização de firmware: o corpo (a imagem) chega em fluxo, fora da tabela de handlers
+    http_server_register_upload((http_upload_handler_t){"/update", &update_iniciar, &update_escrever,
+                                                         &update_concluir});
+
+    // Fluxo de eventos: amostras a cada ciclo e mudanças de estado
+    http_server_register_event_stream("/events");
+
+    // A partir daqui o laço precisa sinalizar vida a cada ciclo, ou o watchdog reinicia a placa
+    supervisor_iniciar(zonas, NUM_ZONAS, TEMP_CRITICA);
+    
+    tempo_inicio_operacao = to_ms_since_boot(get_absolute_time());
+
+    printf("\nDigite uma nova temperatura (ex: 25.5 ou 25,5) e pressione Enter, ou ajuda para os comandos.\n\n");
+
+    agendador_definir_tratador(tratar_evento);
+    for (int i = 0; i < (int)count_of(tarefas_sistema); i++)
+        agendador_registrar(&tarefas_sistema[i]);
+    agendador_executar();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pico/stdlib.h"
+#include "teste.h"
+#include "http_parser.h"
+
+// Vazão do parser HTTP no host: requisições típicas do dashboard lidas de uma
+// vez, em segmentos do tamanho de um MSS e em segmentos pequenos (cadeia de
+// pbufs). Os números servem para comparar versões do parser na mesma máquina;
+// o teste só falha se alguma requisição não for reconhecida.
+//   bench_http_parser [repetições]
+
+#define REPETICOES_PADRAO 20000
+
+static const char *const REQUISICOES[] = {
+    "GET /status?zona=0 HTTP/1.1\r\nHost: 192.168.0.50\r\nUser-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n"
+    "Accept: application/json\r\nAccept-Language: pt-BR,pt;q=0.9\r\nConnection: keep-alive\r\n\r\n",
+    "POST /set_temperatura HTTP/1.1\r\nHost: 192.168.0.50\r\nAuthorization: Bearer 0123456789abcdef\r\n"
+    "Content-Type: application/x-www-form-urlencoded\r\nContent-Length: 16\r\n\r\ntemperatura=25.5",
+    "POST /ganhos HTTP/1.1\r\nHost: 192.168.0.50\r\nAuthorization: Bearer 0123456789abcdef\r\n"
+    "Content-Type: application/json\r\nContent-Length: 33\r\n\r\n{\"kp\": 8.5, \"ki\": 0.1, \"zona\": 0}",
+};
+
+static double agora_s(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void medir(size_t segmento, int repeticoes)
+{
+    static http_parser_t parser;
+    size_t bytes = 0;
+    int reconhecidas = 0, total = 0;
+    double inicio = agora_s();
+    for (int r = 0; r < repeticoes; r++)
+    {
+        for (size_t i = 0; i < count_of(REQUISICOES); i++)
+        {
+            const char *requisicao = REQUISICOES[i];
+            size_t tamanho = strlen(requisicao), lidos = 0, usados;
+            http_parse_result_t resultado = HTTP_PARSE_INCOMPLETE;
+            http_parser_init(&parser);
+            while (lidos < tamanho && resultado == HTTP_PARSE_INCOMPLETE)
+            {
+                size_t n = tamanho - lidos < segmento ? tamanho - lidos : segmento;
+                resultado = http_parser_feed(&parser, requisicao + lidos, n, &usados);
+                lidos += usados;
+            }
+            reconhecidas += resultado == HTTP_PARSE_DONE;
+            total++;
+            bytes += tamanho;
+        }
+    }
+    double duracao = agora_s() - inicio;
+    CHECAR_IGUAL(reconhecidas, total);
+    printf("segmento %4zu: %8.0f req/s %7.1f MB/s %6.0f ns/req\n", segmento, total / duracao, bytes / duracao / 1e6,
+           duracao / total * 1e9);
+}
+
+int main(int argc, char **argv)
+{
+    int repeticoes = argc > 1 ? atoi(argv[1]) : REPETICOES_PADRAO;
+    if (repeticoes <= 0)
+        repeticoes = REPETICOES_PADRAO;
+    medir(1460, repeticoes); // Um MSS: a requisição cabe num pbuf
+    medir(64, repeticoes);
+    medir(8, repeticoes);
+    return teste_resultado("bench_http_parser");
+}
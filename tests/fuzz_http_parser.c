@@ -0,0 +1,124 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "http_parser.h"
+
+// Alvo de fuzzing do parser HTTP. Com clang e TESTES_FUZZ=ON vira um
+// executável do libFuzzer (corpus inicial em corpus/http_parser); sem isso é
+// chamado pelo teste_http_parser com o mesmo corpus e mutações determinísticas.
+//
+// O primeiro byte escolhe o tamanho dos segmentos; o resto é a requisição. Ela
+// é lida inteira e em segmentos, como uma cadeia de pbufs, e os dois
+// resultados têm de ser iguais. Depois confere os limites do estado.
+
+#define EXIGIR(condicao)                                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(condicao))                                                        \
+        {                                                                       \
+            fprintf(stderr, "%s:%d: violado: %s\n", __FILE__, __LINE__, #condicao); \
+            abort();                                                            \
+        }                                                                       \
+    } while (0)
+
+static http_parse_result_t alimentar(http_parser_t *parser, const char *dados, size_t tamanho, size_t segmento,
+                                     size_t *consumidos)
+{
+    http_parse_result_t resultado = HTTP_PARSE_INCOMPLETE;
+    size_t total = 0;
+
+    http_parser_init(parser);
+    while (total < tamanho && resultado == HTTP_PARSE_INCOMPLETE)
+    {
+        size_t n = tamanho - total < segmento ? tamanho - total : segmento;
+        size_t usados;
+        resultado = http_parser_feed(parser, dados + total, n, &usados);
+        EXIGIR(usados <= n);
+        EXIGIR(resultado != HTTP_PARSE_INCOMPLETE || usados == n);
+        total += usados;
+    }
+    *consumidos = total;
+    return resultado;
+}
+
+// Busca um parâmetro com uma saída do tamanho exato, para o ASan pegar escritas além dela
+static void buscar_parametro(const http_parser_t *parser, const char *nome, size_t tamanho)
+{
+    char *saida = malloc(tamanho ? tamanho : 1);
+    if (http_parser_query_param(parser, nome, saida, tamanho))
+        EXIGIR(tamanho > 0 && strlen(saida) < tamanho);
+    free(saida);
+}
+
+static void conferir_requisicao(const http_parser_t *parser, http_parse_result_t resultado)
+{
+    EXIGIR(parser->method == HTTP_METHOD_GET || parser->method == HTTP_METHOD_POST);
+    EXIGIR(parser->target_len > 0 && parser->target_len < HTTP_PARSER_MAX_TARGET);
+    EXIGIR(parser->target[0] == '/' && strlen(parser->target) == parser->target_len);
+    EXIGIR(parser->path_len <= parser->target_len);
+    EXIGIR(parser->path_len == parser->target_len || parser->target[parser->path_len] == '?');
+    EXIGIR(parser->authorization_len <= HTTP_PARSER_MAX_AUTHORIZATION);
+    EXIGIR(parser->authorization[parser->authorization_len] == '\0'); // Pode conter '\0': comparado pelo tamanho
+
+    if (resultado == HTTP_PARSE_DONE)
+    {
+        EXIGIR(parser->body_len == parser->content_length && parser->body_len <= HTTP_PARSER_MAX_BODY);
+        EXIGIR(parser->body[parser->body_len] == '\0');
+    }
+    else
+    {
+        EXIGIR(parser->content_length > HTTP_PARSER_MAX_BODY && parser->body_len == 0);
+    }
+
+    static const char *const NOMES[] = {"zona", "temperatura", "destino", "x", ""};
+    for (size_t i = 0; i < sizeof(NOMES) / sizeof(NOMES[0]); i++)
+    {
+        buscar_parametro(parser, NOMES[i], 0);
+        buscar_parametro(parser, NOMES[i], 1);
+        buscar_parametro(parser, NOMES[i], 4);
+        buscar_parametro(parser, NOMES[i], HTTP_PARSER_MAX_TARGET);
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *dados, size_t tamanho)
+{
+    static http_parser_t inteiro, segmentado;
+    if (tamanho == 0)
+        return 0;
+
+    size_t segmento = 1 + dados[0] % 32;
+    const char *requisicao = (const char *)dados + 1;
+    tamanho--;
+
+    size_t consumidos_inteiro, consumidos_segmentado;
+    http_parse_result_t resultado = alimentar(&inteiro, requisicao, tamanho, tamanho ? tamanho : 1, &consumidos_inteiro);
+    EXIGIR(alimentar(&segmentado, requisicao, tamanho, segmento, &consumidos_segmentado) == resultado);
+    EXIGIR(consumidos_inteiro == consumidos_segmentado && consumidos_inteiro <= tamanho);
+
+    switch (resultado)
+    {
+    case HTTP_PARSE_INCOMPLETE:
+        EXIGIR(consumidos_inteiro == tamanho);
+        break;
+    case HTTP_PARSE_ERROR:
+        EXIGIR(inteiro.error != HTTP_PARSER_OK && inteiro.error == segmentado.error);
+        break;
+    case HTTP_PARSE_DONE:
+    case HTTP_PARSE_BODY:
+        EXIGIR(inteiro.method == segmentado.method && inteiro.content_length == segmentado.content_length);
+        EXIGIR(strcmp(inteiro.target, segmentado.target) == 0 && inteiro.path_len == segmentado.path_len);
+        EXIGIR(inteiro.authorization_len == segmentado.authorization_len &&
+               memcmp(inteiro.authorization, segmentado.authorization, inteiro.authorization_len) == 0);
+        EXIGIR(inteiro.body_len == segmentado.body_len && memcmp(inteiro.body, segmentado.body, inteiro.body_len) == 0);
+        conferir_requisicao(&inteiro, resultado);
+        break;
+    }
+
+    // A decodificação nunca cresce e respeita a saída
+    char decodificado[64];
+    size_t n = tamanho < sizeof(decodificado) ? tamanho : sizeof(decodificado);
+    int escritos = http_url_decode(decodificado, sizeof(decodificado), requisicao, n);
+    EXIGIR(escritos < 0 || ((size_t)escritos <= n && decodificado[escritos] == '\0'));
+    return 0;
+}
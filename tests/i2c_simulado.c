@@ -0,0 +1,341 @@
+#include <string.h>
+#include "i2c_simulado.h"
+#include "aht20.h"
+#include "sdk_simulado.h"
+
+i2c_inst_t i2c0_inst = {0}, i2c1_inst = {1};
+
+#define STATUS_OCUPADO 0x80
+#define STATUS_CALIBRADO 0x08
+#define STATUS_REPOUSO 0x10 // Bits de modo que o AHT20 real devolve com o sensor parado
+
+typedef struct {
+    i2c_inst_t *i2c;
+    uint8_t endereco;
+    AHT20Simulado sensor;
+} Dispositivo;
+
+// Cadeia aceita: o resultado já está decidido e vale quando o barramento a concluir
+typedef struct {
+    I2CTransacao *cadeia;
+    I2CFilaStatus status;
+    uint64_t fim_us;
+} Pendente;
+
+typedef struct {
+    bool iniciado;
+    uint64_t livre_us; // Fim da última cadeia aceita
+    bool sda_presa;
+    uint pino_sda, pino_scl;
+    int pulsos, pulsos_para_soltar;
+    Pendente fila[I2C_FILA_PROFUNDIDADE];
+    int cabeca, quantidade;
+    I2CFilaEstatisticas estatisticas;
+} Barramento;
+
+static Dispositivo dispositivos[I2C_SIMULADO_DISPOSITIVOS];
+static int num_dispositivos;
+static Barramento barramentos[2];
+
+static uint8_t crc8(const uint8_t *dados, int tamanho)
+{
+    uint8_t crc = 0xFF;
+    for (int i = 0; i < tamanho; i++)
+    {
+        crc ^= dados[i];
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+// Dispositivo que responde no endereço (um sensor ausente não responde)
+static Dispositivo *dispositivo_em(i2c_inst_t *i2c, uint8_t endereco)
+{
+    for (int i = 0; i < num_dispositivos; i++)
+        if (dispositivos[i].i2c == i2c && dispositivos[i].endereco == endereco &&
+            dispositivos[i].sensor.falha != AHT20_SIMULADO_AUSENTE)
+            return &dispositivos[i];
+    return NULL;
+}
+
+// Converte a grandeza atual com a codificação de 20 bits do AHT20
+static void medir(AHT20Simulado *s, uint64_t agora_us)
+{
+    uint32_t umidade = (uint32_t)(s->umidade / 100.0f * 1048576.0f);
+    uint32_t temperatura = (uint32_t)((s->temperatura + 50.0f) / 200.0f * 1048576.0f);
+    if (umidade > 0xFFFFF)
+        umidade = 0xFFFFF;
+    if (temperatura > 0xFFFFF)
+        temperatura = 0xFFFFF;
+    s->quadro[1] = (uint8_t)(umidade >> 12);
+    s->quadro[2] = (uint8_t)(umidade >> 4);
+    s->quadro[3] = (uint8_t)((umidade << 4) | (temperatura >> 16));
+    s->quadro[4] = (uint8_t)(temperatura >> 8);
+    s->quadro[5] = (uint8_t)temperatura;
+    s->fim_conversao_us = agora_us + I2C_SIMULADO_CONVERSAO_US;
+    s->medicoes++;
+}
+
+static void escrever(AHT20Simulado *s, const uint8_t *dados, size_t tamanho, uint64_t agora_us)
+{
+    if (tamanho == 0)
+        return;
+    switch (dados[0])
+    {
+    case AHT20_CMD_INIT:
+        s->calibrado = true;
+        break;
+    case AHT20_CMD_TRIGGER:
+        medir(s, agora_us);
+        break;
+    case AHT20_CMD_RESET:
+        s->resets++;
+        s->calibrado = false;
+        s->fim_conversao_us = 0;
+        break;
+    }
+}
+
+static void ler(AHT20Simulado *s, uint8_t *dados, size_t tamanho, uint64_t agora_us)
+{
+    bool ocupado = s->falha == AHT20_SIMULADO_OCUPADO || agora_us < s->fim_conversao_us;
+    s->quadro[0] = STATUS_REPOUSO | (s->calibrado ? STATUS_CALIBRADO : 0) | (ocupado ? STATUS_OCUPADO : 0);
+    s->quadro[6] = crc8(s->quadro, 6);
+    if (s->falha == AHT20_SIMULADO_CRC)
+        s->quadro[6] ^= 0x5A;
+    for (size_t i = 0; i < tamanho; i++)
+        dados[i] = i < sizeof(s->quadro) ? s->quadro[i] : 0xFF;
+}
+
+static uint64_t bits_us(uint64_t bits, uint32_t frequencia_hz)
+{
+    return (bits * 1000000 + frequencia_hz - 1) / frequencia_hz;
+}
+
+static uint64_t duracao_us(const I2CTransacao *t, uint32_t frequencia_hz)
+{
+    // Endereço antes da escrita e de novo no START repetido da leitura
+    size_t bytes = t->escrita_len + t->leitura_len + (t->escrita_len > 0) + (t->leitura_len > 0);
+    return bits_us(bytes * 9 + 2, frequencia_hz);
+}
+
+static Barramento *barramento_de(i2c_inst_t *i2c)
+{
+    return &barramentos[i2c->indice];
+}
+
+// Entrega as cadeias que o barramento já terminou até o instante atual
+static void concluir_terminadas(Barramento *b)
+{
+    while (b->quantidade > 0 && b->fila[b->cabeca].fim_us <= time_us_64())
+    {
+        Pendente *p = &b->fila[b->cabeca];
+        b->cabeca = (b->cabeca + 1) % I2C_FILA_PROFUNDIDADE;
+        b->quantidade--;
+        if (p->status == I2C_FILA_OK)
+            b->estatisticas.concluidas++;
+        else if (p->status == I2C_FILA_ERRO_TIMEOUT)
+            b->estatisticas.timeouts++;
+        else
+            b->estatisticas.erros++;
+        p->cadeia->status = p->status;
+        if (p->cadeia->callback)
+            p->cadeia->callback(p->cadeia, p->cadeia->contexto);
+    }
+}
+
+// Cada subida de SCL com SDA presa conta um pulso da recuperação
+static void observar_pino(uint pino, bool nivel)
+{
+    for (int i = 0; i < (int)count_of(barramentos); i++)
+    {
+        Barramento *b = &barramentos[i];
+        if (!b->sda_presa || pino != b->pino_scl || !nivel)
+            continue;
+        if (++b->pulsos >= b->pulsos_para_soltar)
+        {
+            b->sda_presa = false;
+            sdk_simulado_forcar_baixo(b->pino_sda, false);
+        }
+    }
+}
+
+void i2c_simulado_prender_sda(i2c_inst_t *i2c, uint pino_sda, uint pino_scl, int pulsos)
+{
+    Barramento *b = barramento_de(i2c);
+    b->sda_presa = true;
+    b->pino_sda = pino_sda;
+    b->pino_scl = pino_scl;
+    b->pulsos = 0;
+    b->pulsos_para_soltar = pulsos;
+    sdk_simulado_forcar_baixo(pino_sda, true);
+    sdk_simulado_observar_gpio(observar_pino);
+}
+
+int i2c_simulado_pulsos_scl(i2c_inst_t *i2c)
+{
+    return barramento_de(i2c)->pulsos;
+}
+
+void i2c_simulado_reiniciar(void)
+{
+    for (int i = 0; i < (int)count_of(barramentos); i++)
+        if (barramentos[i].sda_presa)
+            sdk_simulado_forcar_baixo(barramentos[i].pino_sda, false);
+    memset(dispositivos, 0, sizeof(dispositivos));
+    num_dispositivos = 0;
+    memset(barramentos, 0, sizeof(barramentos));
+}
+
+AHT20Simulado *i2c_simulado_aht20(i2c_inst_t *i2c, uint8_t endereco)
+{
+    if (num_dispositivos == I2C_SIMULADO_DISPOSITIVOS)
+        return NULL;
+    Dispositivo *d = &dispositivos[num_dispositivos++];
+    *d = (Dispositivo){.i2c = i2c, .endereco = endereco, .sensor = {.temperatura = 25.0f, .umidade = 50.0f}};
+    return &d->sensor;
+}
+
+void i2c_fila_iniciar(i2c_inst_t *i2c, uint frequencia_hz)
+{
+    Barramento *b = barramento_de(i2c);
+    b->iniciado = true;
+    b->estatisticas.frequencia_hz = frequencia_hz;
+}
+
+bool i2c_fila_iniciado(i2c_inst_t *i2c)
+{
+    return barramento_de(i2c)->iniciado;
+}
+
+void i2c_deinit(i2c_inst_t *i2c)
+{
+    (void)i2c;
+}
+
+bool i2c_fila_enviar(i2c_inst_t *i2c, I2CTransacao *cadeia)
+{
+    for (const I2CTransacao *t = cadeia; t; t = t->proxima)
+    {
+        size_t n = t->escrita_len + t->leitura_len;
+        if (n == 0 || n > I2C_FILA_MAX_PALAVRAS)
+        {
+            cadeia->status = I2C_FILA_ERRO_TAMANHO;
+            return false;
+        }
+    }
+
+    Barramento *b = barramento_de(i2c);
+    concluir_terminadas(b);
+    if (b->quantidade == I2C_FILA_PROFUNDIDADE)
+    {
+        cadeia->status = I2C_FILA_ERRO_CHEIA;
+        return false;
+    }
+
+    // Executa a cadeia no instante em que o barramento a começaria
+    uint64_t instante = b->livre_us > time_us_64() ? b->livre_us : time_us_64();
+    I2CFilaStatus status = I2C_FILA_OK;
+    for (const I2CTransacao *t = cadeia; t && status == I2C_FILA_OK; t = t->proxima)
+    {
+        uint64_t duracao = duracao_us(t, b->estatisticas.frequencia_hz);
+        Dispositivo *d = dispositivo_em(i2c, t->endereco);
+        if (b->sda_presa)
+        {
+            // Nenhum START passa: a fila aborta pelo timeout
+            status = I2C_FILA_ERRO_TIMEOUT;
+            duracao += I2C_FILA_TIMEOUT_BASE_US;
+        }
+        else if (!d)
+        {
+            status = I2C_FILA_ERRO_NACK;
+            duracao = bits_us(9 + 2, b->estatisticas.frequencia_hz); // Para no endereço
+        }
+        else
+        {
+            escrever(&d->sensor, t->escrita, t->escrita_len, instante);
+            ler(&d->sensor, t->leitura, t->leitura_len, instante);
+            b->estatisticas.bytes += t->escrita_len + t->leitura_len;
+        }
+        instante += duracao;
+        b->estatisticas.tempo_ocupado_us += duracao;
+    }
+
+    cadeia->status = I2C_FILA_PENDENTE;
+    b->fila[(b->cabeca + b->quantidade) % I2C_FILA_PROFUNDIDADE] = (Pendente){cadeia, status, instante};
+    b->quantidade++;
+    if (b->quantidade > b->estatisticas.profundidade_max)
+        b->estatisticas.profundidade_max = b->quantidade;
+    b->livre_us = instante;
+    return true;
+}
+
+I2CFilaStatus i2c_fila_aguardar(I2CTransacao *cadeia)
+{
+    for (int i = 0; i < (int)count_of(barramentos) && cadeia->status == I2C_FILA_PENDENTE; i++)
+    {
+        Barramento *b = &barramentos[i];
+        for (int j = 0; j < b->quantidade; j++)
+        {
+            const Pendente *p = &b->fila[(b->cabeca + j) % I2C_FILA_PROFUNDIDADE];
+            if (p->cadeia == cadeia)
+            {
+                sdk_simulado_avancar_ate(p->fim_us);
+                concluir_terminadas(b);
+                break;
+            }
+        }
+    }
+    return cadeia->status;
+}
+
+void i2c_fila_aguardar_ocioso(i2c_inst_t *i2c)
+{
+    Barramento *b = barramento_de(i2c);
+    sdk_simulado_avancar_ate(b->livre_us);
+    concluir_terminadas(b);
+}
+
+static int executar_bloqueante(i2c_inst_t *i2c, I2CTransacao *t, size_t len)
+{
+    if (!i2c_fila_enviar(i2c, t))
+    {
+        // Cheia: espera a fila esvaziar e tenta uma vez mais
+        if (t->status != I2C_FILA_ERRO_CHEIA)
+            return PICO_ERROR_GENERIC;
+        i2c_fila_aguardar_ocioso(i2c);
+        if (!i2c_fila_enviar(i2c, t))
+            return PICO_ERROR_GENERIC;
+    }
+    switch (i2c_fila_aguardar(t))
+    {
+    case I2C_FILA_OK:
+        return (int)len;
+    case I2C_FILA_ERRO_TIMEOUT:
+        return PICO_ERROR_TIMEOUT;
+    default:
+        return PICO_ERROR_GENERIC;
+    }
+}
+
+int i2c_fila_escrever(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *dados, size_t len)
+{
+    I2CTransacao t = {.endereco = endereco, .escrita = dados, .escrita_len = len};
+    return executar_bloqueante(i2c, &t, len);
+}
+
+int i2c_fila_ler(i2c_inst_t *i2c, uint8_t endereco, uint8_t *dados, size_t len)
+{
+    I2CTransacao t = {.endereco = endereco, .leitura = dados, .leitura_len = len};
+    return executar_bloqueante(i2c, &t, len);
+}
+
+void i2c_fila_estatisticas(i2c_inst_t *i2c, I2CFilaEstatisticas *estatisticas)
+{
+    Barramento *b = barramento_de(i2c);
+    concluir_terminadas(b);
+    *estatisticas = b->estatisticas;
+    estatisticas->profundidade = (uint8_t)b->quantidade;
+    estatisticas->tempo_total_us = time_us_64();
+}
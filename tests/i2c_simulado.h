@@ -0,0 +1,56 @@
+#ifndef I2C_SIMULADO_H
+#define I2C_SIMULADO_H
+
+#include "i2c_fila.h"
+
+// Fila I2C simulada (substitui lib/i2c_fila.c no host) com sensores AHT20 no
+// barramento. Cada cadeia ocupa o barramento pelo tempo dos seus bytes na
+// frequência configurada (9 bits por byte, mais START e STOP); barramentos
+// diferentes correm em paralelo, como com o DMA. O tempo é o de sdk_simulado.c.
+// Os testes podem injetar falhas nos sensores e travar um barramento.
+
+#define I2C_SIMULADO_DISPOSITIVOS 8
+#define I2C_SIMULADO_CONVERSAO_US 75000 // Conversão do AHT20 (o firmware espera AHT20_TEMPO_MEDICAO_MS)
+
+/* ---------- Falhas injetáveis num sensor ---------- */
+typedef enum {
+    AHT20_SIMULADO_OK,
+    AHT20_SIMULADO_AUSENTE, // Não responde (NACK no endereço), como desconectado
+    AHT20_SIMULADO_CRC,     // Quadros de medição com o CRC errado
+    AHT20_SIMULADO_OCUPADO  // A conversão nunca termina
+} AHT20SimuladoFalha;
+
+/* ---------- Sensor AHT20 simulado ---------- */
+// Zerar @c calibrado simula a perda da calibração: o sensor volta com o reset
+// e o comando de inicialização.
+typedef struct {
+    // Grandeza que a próxima medição disparada vai converter (o teste atualiza)
+    float temperatura;
+    float umidade;
+
+    AHT20SimuladoFalha falha;
+
+    // Estado do sensor
+    bool calibrado;
+    uint64_t fim_conversao_us;
+    uint8_t quadro[7]; // Status, 5 bytes de dados e CRC da última medição
+    uint32_t medicoes;
+    uint32_t resets; // Comandos de reset recebidos
+} AHT20Simulado;
+
+// Remove os dispositivos e reinicia os barramentos.
+void i2c_simulado_reiniciar(void);
+
+// Conecta um AHT20 (descalibrado até receber o comando de inicialização) em
+// @p endereco de @p i2c; NULL se já houver I2C_SIMULADO_DISPOSITIVOS.
+AHT20Simulado *i2c_simulado_aht20(i2c_inst_t *i2c, uint8_t endereco);
+
+// Um escravo passa a segurar SDA de @p i2c em nível baixo: toda transação
+// termina em timeout até que a recuperação pulse SCL (pinos @p pino_sda e
+// @p pino_scl, por GPIO) @p pulsos vezes.
+void i2c_simulado_prender_sda(i2c_inst_t *i2c, uint pino_sda, uint pino_scl, int pulsos);
+
+// Pulsos de SCL recebidos desde o último i2c_simulado_prender_sda().
+int i2c_simulado_pulsos_scl(i2c_inst_t *i2c);
+
+#endif // I2C_SIMULADO_H
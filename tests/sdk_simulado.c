@@ -0,0 +1,138 @@
+#include "sdk_simulado.h"
+#include "hardware/pwm.h"
+
+static uint64_t agora_us;
+
+static struct
+{
+    bool saida;
+    bool valor;
+    bool forcado_baixo;
+    bool nivel;
+} pinos[SDK_SIMULADO_PINOS];
+
+static sdk_simulado_observador_t observador;
+
+static uint16_t niveis_pwm[SDK_SIMULADO_PINOS];
+static uint16_t topos_pwm[8];
+
+void sdk_simulado_avancar_ate(uint64_t instante_us)
+{
+    if (instante_us > agora_us)
+        agora_us = instante_us;
+}
+
+uint64_t time_us_64(void)
+{
+    return agora_us;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)agora_us;
+}
+
+absolute_time_t get_absolute_time(void)
+{
+    return agora_us;
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t)
+{
+    return (uint32_t)(t / 1000);
+}
+
+void sleep_us(uint64_t us)
+{
+    agora_us += us;
+}
+
+void sleep_ms(uint32_t ms)
+{
+    agora_us += (uint64_t)ms * 1000;
+}
+
+// Entradas têm pull-up; qualquer um pode puxar a linha para baixo (dreno aberto)
+static bool nivel_de(uint pino)
+{
+    return !pinos[pino].forcado_baixo && (!pinos[pino].saida || pinos[pino].valor);
+}
+
+static void atualizar_nivel(uint pino)
+{
+    bool nivel = nivel_de(pino);
+    if (nivel == pinos[pino].nivel)
+        return;
+    pinos[pino].nivel = nivel;
+    if (observador)
+        observador(pino, nivel);
+}
+
+void sdk_simulado_forcar_baixo(uint pino, bool forcar)
+{
+    pinos[pino].forcado_baixo = forcar;
+    atualizar_nivel(pino);
+}
+
+void sdk_simulado_observar_gpio(sdk_simulado_observador_t novo)
+{
+    observador = novo;
+    for (uint pino = 0; pino < SDK_SIMULADO_PINOS; pino++)
+        pinos[pino].nivel = nivel_de(pino);
+}
+
+void gpio_init(uint pino)
+{
+    pinos[pino].saida = false;
+    pinos[pino].valor = false;
+    atualizar_nivel(pino);
+}
+
+void gpio_set_function(uint pino, enum gpio_function funcao)
+{
+    (void)pino;
+    (void)funcao;
+}
+
+void gpio_set_dir(uint pino, bool saida)
+{
+    pinos[pino].saida = saida;
+    atualizar_nivel(pino);
+}
+
+void gpio_put(uint pino, bool valor)
+{
+    pinos[pino].valor = valor;
+    atualizar_nivel(pino);
+}
+
+bool gpio_get(uint pino)
+{
+    return nivel_de(pino);
+}
+
+void gpio_pull_up(uint pino)
+{
+    (void)pino;
+}
+
+void pwm_init(uint fatia, pwm_config *configuracao, bool iniciar)
+{
+    (void)iniciar;
+    topos_pwm[fatia] = configuracao->topo;
+}
+
+void pwm_set_gpio_level(uint pino, uint16_t nivel)
+{
+    niveis_pwm[pino] = nivel;
+}
+
+uint16_t sdk_simulado_pwm_nivel(uint pino)
+{
+    return niveis_pwm[pino];
+}
+
+uint16_t sdk_simulado_pwm_topo(uint pino)
+{
+    return topos_pwm[pwm_gpio_to_slice_num(pino)];
+}
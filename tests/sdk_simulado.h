@@ -0,0 +1,28 @@
+#ifndef SDK_SIMULADO_H
+#define SDK_SIMULADO_H
+
+#include "pico/stdlib.h"
+
+// Implementação no host das funções de tempo, GPIO e PWM declaradas em stubs/.
+// O tempo é virtual: só anda com sleep_*(), com as esperas da fila I2C
+// simulada e com sdk_simulado_avancar_ate(), então as medidas não dependem da
+// máquina que roda o teste.
+
+#define SDK_SIMULADO_PINOS 40 // Além dos 30 do RP2040: as zonas simuladas têm pinos próprios
+
+// Leva o relógio a @p instante_us (não volta se ele já passou).
+void sdk_simulado_avancar_ate(uint64_t instante_us);
+
+// Um dispositivo externo segura o pino em nível baixo (ex.: escravo I2C preso)
+// ou o solta. gpio_get() lê o nível resultante.
+void sdk_simulado_forcar_baixo(uint pino, bool forcar);
+
+// Chamada a cada mudança de nível de um pino (uma por vez; NULL desliga).
+typedef void (*sdk_simulado_observador_t)(uint pino, bool nivel);
+void sdk_simulado_observar_gpio(sdk_simulado_observador_t observador);
+
+// Último nível escrito no PWM do pino e o topo da fatia dele.
+uint16_t sdk_simulado_pwm_nivel(uint pino);
+uint16_t sdk_simulado_pwm_topo(uint pino);
+
+#endif // SDK_SIMULADO_H
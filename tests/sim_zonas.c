@@ -0,0 +1,497 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "teste.h"
+#include "zona.h"
+#include "log.h"
+#include "sdk_simulado.h"
+#include "i2c_simulado.h"
+
+// Simulador de várias zonas no host: zona.c, aht20.c, filtro e perfis reais,
+// com o ciclo de tarefa_controle(), tarefa_leitura() e concluir_ciclo_controle()
+// de main.c sobre a fila I2C simulada e o modelo térmico de tools/feedforward.py
+// em cada zona. Mostra que 4 e 8 zonas cabem no período de controle e nos
+// prazos das tarefas, inclusive com a sobreamostragem máxima, e que as malhas
+// são independentes. Também compara os ganhos fixos com a tabela de
+// escalonamento (testar_escalonamento).
+//   sim_zonas [minutos]
+//   sim_zonas escalonamento [ganhos.csv]
+//
+// O tempo de barramento e de conversão é o do relógio virtual; a CPU do ciclo
+// é medida no host e multiplicada por FATOR_CPU para estimar a do RP2040.
+
+#define ZONAS_MAX 8
+#define MINUTOS_PADRAO 30
+#define MINUTOS_REGIME 5            // Janela final em que o erro é medido
+#define ERRO_REGIME_MAX 0.2f        // °C, média de |temperatura - setpoint| na janela
+#define FATOR_CPU 200.0             // Host contra o M0+ a 125 MHz com ponto flutuante em software (folgado)
+#define PRAZO_DISPARO_US 10000      // Prazo de tarefa_controle em main.c
+#define PRAZO_LEITURA_US 20000      // Prazo de tarefa_leitura
+#define PASSOS_ATUADORES 50         // Interrupção dos atuadores (período do PWM do servo)
+#define AMBIENTE 25.0f
+#define UMIDADE 50.0f
+#define SETPOINT_BASE 30.0f         // Zona i controla em SETPOINT_BASE + i
+#define DEGRAU_SETPOINT 3.0f
+
+/* ---------- Modelo térmico (classe Planta de tools/feedforward.py) ---------- */
+#define CAPACIDADE 800.0f    // J/K
+#define PERDA 5.0f           // W/K
+#define G_MAX 30.0f          // W/K com o servo todo aberto
+#define EXPOENTE 0.6f
+#define EFEITO_UMIDADE 0.004f
+#define RUIDO 0.02f          // °C
+
+typedef struct {
+    float temperatura;
+    float carga;    // W
+    float ambiente; // °C
+    uint32_t semente;
+} Planta;
+
+// Gaussiana de desvio 1 (Box-Muller sobre um xorshift32 por zona)
+static float ruido(Planta *p)
+{
+    float u[2];
+    for (int i = 0; i < 2; i++)
+    {
+        p->semente ^= p->semente << 13;
+        p->semente ^= p->semente >> 17;
+        p->semente ^= p->semente << 5;
+        u[i] = (p->semente + 1.0f) / 4294967296.0f;
+    }
+    return sqrtf(-2.0f * logf(u[0])) * cosf(6.2831853f * u[1]);
+}
+
+static void planta_passo(Planta *p, float angulo, float dt)
+{
+    float abertura = fminf(fmaxf(angulo / 180.0f, 0.0f), 1.0f);
+    float g = G_MAX * powf(abertura, EXPOENTE) * (1.0f - EFEITO_UMIDADE * (UMIDADE - 50.0f));
+    float fluxo = p->carga + PERDA * (p->ambiente - p->temperatura) - g * (p->temperatura - p->ambiente);
+    p->temperatura += fluxo * dt / CAPACIDADE;
+}
+
+/* ---------- Zonas ---------- */
+
+static Zona zonas[ZONAS_MAX];
+static Planta plantas[ZONAS_MAX];
+static AHT20Simulado *sensores[ZONAS_MAX];
+
+// Zona i com os valores de ZONA_PADRAO de main.c. O AHT20 tem endereço fixo: as
+// zonas se alternam entre os dois barramentos e os endereços seguintes fazem o
+// papel dos canais de um mux.
+static Zona zona_simulada(int i, uint8_t amostras_burst)
+{
+    static char nomes[ZONAS_MAX][24];
+    snprintf(nomes[i], sizeof(nomes[i]), "Zona %d", i + 1);
+    FiltroConfig filtro = FILTRO_CONFIG_PADRAO;
+    filtro.amostras_burst = amostras_burst;
+    float setpoint = SETPOINT_BASE + i;
+
+    return (Zona){
+        .hw = {nomes[i], i % 2 ? i2c1 : i2c0, i % 2 ? 14 : 0, i % 2 ? 15 : 1, AHT20_I2C_ADDR + i / 2,
+               2 + i, 18 + i, 26 + i, 10 + i},
+        .temperatura_desejada = setpoint,
+        .perfil_setpoint = PERFIL_SETPOINT_PADRAO(setpoint),
+        .ganho_p = 10.0f,
+        .ganho_i = 0.2f,
+        .ganho_p_aplicado = 10.0f,
+        .ganho_i_aplicado = 0.2f,
+        .integral_min = -90.0f,
+        .integral_max = 90.0f,
+        .angulo_min = 0.0f,
+        .angulo_max = 180.0f,
+        .angulo_manual = 90.0f,
+        .modo = MODO_AUTOMATICO,
+        .angulo_seguro = 180.0f,
+        .ventoinha_segura = 100.0f,
+        .ventoinha_manual = NAN,
+        .alocacao = ALOCACAO_PARALELA,
+        .divisao = 0.5f,
+        .sobreposicao = 0.2f,
+        .pwm_servo = PWM_SERVO_PADRAO,
+        .pwm_ventoinha = PWM_VENTOINHA_PADRAO,
+        .perfil_servo = PERFIL_SERVO_PADRAO,
+        .perfil_ventoinha = PERFIL_VENTOINHA_PADRAO,
+        .curva_ventoinha = VENTOINHA_CURVA_PADRAO,
+        .temperatura_ambiente = NAN,
+        .filtro = {.cfg = filtro},
+    };
+}
+
+// Liga a zona i, já preenchida em zonas[i], à planta e ao sensor simulados
+static void iniciar_zona(int i, Planta planta)
+{
+    plantas[i] = planta;
+    sensores[i] = i2c_simulado_aht20(zonas[i].hw.porta_i2c, zonas[i].hw.endereco_sensor);
+    sensores[i]->temperatura = planta.temperatura;
+    sensores[i]->umidade = UMIDADE;
+    CHECAR(zona_inicializar_sensor(&zonas[i]));
+    zona_inicializar_atuadores(&zonas[i]);
+}
+
+/* ---------- Simulação ---------- */
+
+typedef struct {
+    // Cenário
+    int zonas;
+    uint8_t amostras_burst;
+    int minutos;
+    int zona_degrau; // Recebe um degrau de setpoint em um terço da simulação (-1: nenhuma)
+
+    // Resultados
+    uint32_t disparo_max_us;  // Maior disparo de uma rodada (tarefa_controle)
+    uint32_t leitura_max_us;  // Maior rodada de tarefa_leitura, sem a CPU do controle
+    uint32_t ciclo_max_us;    // Do início do ciclo ao fim do controle, sem a CPU
+    double cpu_host_us;       // CPU média do host por ciclo em concluir_ciclo_controle()
+    float erro_regime[ZONAS_MAX];
+    double assinatura[ZONAS_MAX]; // Soma das temperaturas aplicadas: compara trajetórias
+} Simulacao;
+
+static double agora_host_us(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec * 1e-3;
+}
+
+static void maximo(uint32_t *atual, uint64_t valor)
+{
+    if (valor > *atual)
+        *atual = (uint32_t)valor;
+}
+
+// Um ciclo como em main.c: rodadas de disparo, espera da conversão e leitura,
+// depois filtro e controle de cada zona
+static void ciclo_controle(Simulacao *s)
+{
+    uint64_t inicio = time_us_64();
+    float soma_temperatura[ZONAS_MAX] = {0}, soma_umidade[ZONAS_MAX] = {0};
+    int validas[ZONAS_MAX] = {0};
+    bool disparada[ZONAS_MAX];
+
+    int rodadas = 1;
+    for (int i = 0; i < s->zonas; i++)
+        if (zonas[i].filtro.cfg.amostras_burst > rodadas)
+            rodadas = zonas[i].filtro.cfg.amostras_burst;
+
+    for (int rodada = 0; rodada < rodadas; rodada++)
+    {
+        uint64_t t = time_us_64();
+        for (int i = 0; i < s->zonas; i++)
+            disparada[i] = rodada < zonas[i].filtro.cfg.amostras_burst && zona_disparar_leitura(&zonas[i]);
+        maximo(&s->disparo_max_us, time_us_64() - t);
+
+        // agendador_agendar(TAREFA_LEITURA, AHT20_TEMPO_MEDICAO_MS)
+        sdk_simulado_avancar_ate(time_us_64() + AHT20_TEMPO_MEDICAO_MS * 1000);
+        t = time_us_64();
+        for (int i = 0; i < s->zonas; i++)
+            if (disparada[i])
+                zona_solicitar_resultado(&zonas[i]);
+        for (int i = 0; i < s->zonas; i++)
+        {
+            float temperatura, umidade;
+            if (disparada[i] && zona_ler_temperatura(&zonas[i], &temperatura, &umidade) == AHT20_OK)
+            {
+                soma_temperatura[i] += temperatura;
+                soma_umidade[i] += umidade;
+                validas[i]++;
+            }
+        }
+        maximo(&s->leitura_max_us, time_us_64() - t);
+    }
+
+    double cpu = agora_host_us();
+    for (int i = 0; i < s->zonas; i++)
+    {
+        Zona *zona = &zonas[i];
+        zona_avancar_setpoint(zona, PERIODO_AMOSTRA);
+        if (validas[i] == 0)
+        {
+            zona_tratar_falha_sensor(zona, to_ms_since_boot(get_absolute_time()));
+            continue;
+        }
+        zona_confirmar_leitura_sensor(zona);
+        zona->temperatura_bruta = soma_temperatura[i] / validas[i];
+        zona->umidade = soma_umidade[i] / validas[i];
+        float temperatura_atual;
+        zona_filtrar_temperatura(zona, zona->temperatura_bruta, &temperatura_atual);
+        zona_aplicar_controle(zona, temperatura_atual);
+    }
+    s->cpu_host_us += agora_host_us() - cpu;
+    maximo(&s->ciclo_max_us, time_us_64() - inicio);
+}
+
+// Resto do período: a interrupção dos atuadores move servo e ventoinha e a
+// planta responde à posição real do servo
+static void passar_periodo(int n, uint64_t inicio)
+{
+    const float dt = PERIODO_AMOSTRA / PASSOS_ATUADORES;
+    for (int passo = 0; passo < PASSOS_ATUADORES; passo++)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            zona_atualizar_atuadores(&zonas[i], dt);
+            planta_passo(&plantas[i], zonas[i].perfil_servo.posicao, dt);
+            sensores[i]->temperatura = plantas[i].temperatura + RUIDO * ruido(&plantas[i]);
+        }
+    }
+    sdk_simulado_avancar_ate(inicio + (uint64_t)(PERIODO_AMOSTRA * 1000000));
+}
+
+static void simular(Simulacao *s)
+{
+    i2c_simulado_reiniciar();
+    for (int i = 0; i < s->zonas; i++)
+    {
+        zonas[i] = zona_simulada(i, s->amostras_burst);
+        iniciar_zona(i, (Planta){.temperatura = AMBIENTE + 10.0f, .carga = 100.0f + 10.0f * i, .ambiente = AMBIENTE,
+                                 .semente = 2463534242u + i});
+    }
+
+    int ciclos = s->minutos * 60, inicio_regime = ciclos - MINUTOS_REGIME * 60;
+    double erro[ZONAS_MAX] = {0};
+    for (int c = 0; c < ciclos; c++)
+    {
+        uint64_t inicio = time_us_64();
+        if (c == ciclos / 3 && s->zona_degrau >= 0)
+        {
+            Zona *zona = &zonas[s->zona_degrau];
+            zona_definir_setpoint(zona, zona->perfil_setpoint.alvo + DEGRAU_SETPOINT);
+        }
+        ciclo_controle(s);
+        for (int i = 0; i < s->zonas; i++)
+        {
+            s->assinatura[i] += zonas[i].temperatura_atual;
+            if (c >= inicio_regime)
+                erro[i] += fabsf(plantas[i].temperatura - zonas[i].perfil_setpoint.alvo);
+        }
+        passar_periodo(s->zonas, inicio);
+    }
+    for (int i = 0; i < s->zonas; i++)
+        s->erro_regime[i] = (float)(erro[i] / (ciclos - inicio_regime));
+    s->cpu_host_us /= ciclos;
+}
+
+// Tempo do ciclo e prazos das tarefas com 1 a 8 zonas
+static void testar_periodo(int minutos)
+{
+    static const struct {
+        int zonas;
+        uint8_t amostras_burst;
+    } CENARIOS[] = {{1, 1}, {4, 1}, {4, 4}, {8, 1}, {8, 4}};
+
+    // Simula tudo antes: a inicialização das zonas também escreve na saída
+    Simulacao resultados[count_of(CENARIOS)];
+    for (size_t c = 0; c < count_of(CENARIOS); c++)
+    {
+        resultados[c] = (Simulacao){.zonas = CENARIOS[c].zonas, .amostras_burst = CENARIOS[c].amostras_burst,
+                                    .minutos = minutos, .zona_degrau = -1};
+        simular(&resultados[c]);
+    }
+
+    printf("zonas leituras disparo  leitura  ciclo     CPU(est.) erro max\n");
+    for (size_t c = 0; c < count_of(CENARIOS); c++)
+    {
+        const Simulacao *s = &resultados[c];
+        double cpu_us = s->cpu_host_us * FATOR_CPU;
+        float erro_max = 0.0f;
+        for (int i = 0; i < s->zonas; i++)
+        {
+            erro_max = fmaxf(erro_max, s->erro_regime[i]);
+            if (s->erro_regime[i] > ERRO_REGIME_MAX)
+            {
+                printf("%d zonas: zona %d com erro de %.3f °C em regime\n", s->zonas, i + 1, s->erro_regime[i]);
+                teste_falhas++;
+            }
+        }
+        printf("%5d %8d %5.2f ms %5.2f ms %6.1f ms %6.2f ms %6.3f °C\n", s->zonas, s->amostras_burst,
+               s->disparo_max_us / 1e3, s->leitura_max_us / 1e3, s->ciclo_max_us / 1e3, cpu_us / 1e3, erro_max);
+
+        CHECAR(s->disparo_max_us < PRAZO_DISPARO_US);
+        CHECAR(s->leitura_max_us + cpu_us < PRAZO_LEITURA_US);
+        CHECAR(s->ciclo_max_us + cpu_us < PERIODO_AMOSTRA * 1e6);
+    }
+}
+
+// Um degrau de setpoint numa zona não altera a trajetória das outras
+static void testar_independencia(int minutos)
+{
+    Simulacao base = {.zonas = 4, .amostras_burst = 1, .minutos = minutos, .zona_degrau = -1};
+    Simulacao degrau = base;
+    degrau.zona_degrau = 2;
+    simular(&base);
+    simular(&degrau);
+    for (int i = 0; i < base.zonas; i++)
+    {
+        if (i == degrau.zona_degrau)
+            CHECAR(base.assinatura[i] != degrau.assinatura[i]);
+        else
+            CHECAR(base.assinatura[i] == degrau.assinatura[i]);
+    }
+    CHECAR(degrau.erro_regime[degrau.zona_degrau] < ERRO_REGIME_MAX);
+}
+
+/* ---------- Escalonamento de ganhos ---------- */
+// Cenário de tools/escalonamento.py: ambiente frio e carga maior, para que a
+// faixa de 18 a 45 °C seja alcançável, e degraus de setpoint por toda ela
+#define ESCALONAMENTO_AMBIENTE 13.0f
+#define ESCALONAMENTO_CARGA 160.0f // W
+
+// Degraus subindo e descendo; o primeiro só leva a zona ao regime e fica fora
+// dos totais
+static const struct {
+    int duracao; // s
+    float setpoint;
+} ROTEIRO[] = {{1200, 30.0f}, {900, 25.0f}, {900, 19.0f}, {900, 22.0f}, {900, 35.0f},
+               {900, 40.0f},  {900, 44.0f}, {900, 37.0f}, {900, 28.0f}, {900, 32.0f}};
+
+// Saída de "tools/escalonamento.py sintonizar" com os parâmetros padrão
+static const EscalonamentoPonto TABELA_PADRAO[] = {
+    {18.00f, 69.726f, 2.7890f}, {21.71f, 30.194f, 0.6930f}, {25.43f, 17.134f, 0.2757f},
+    {29.14f, 10.923f, 0.1353f}, {32.86f, 7.346f, 0.0740f},  {36.57f, 4.993f, 0.0424f},
+    {40.29f, 3.225f, 0.0236f},  {44.00f, 1.450f, 0.0094f},
+};
+
+typedef struct {
+    double ise; // °C²·s
+    double iae; // °C·s
+} Desempenho;
+
+// Lê o CSV de "tools/escalonamento.py sintonizar" (cabeçalho ponto,kp,ki)
+static bool ler_tabela(const char *caminho, Escalonamento *tabela)
+{
+    FILE *arquivo = fopen(caminho, "r");
+    if (!arquivo)
+        return false;
+    char linha[80];
+    float ponto, kp, ki;
+    bool ok = fgets(linha, sizeof(linha), arquivo) != NULL; // Cabeçalho
+    while (ok && fgets(linha, sizeof(linha), arquivo))
+        if (sscanf(linha, "%f,%f,%f", &ponto, &kp, &ki) == 3)
+            ok = escalonamento_definir_ponto(tabela, ponto, kp, ki);
+    fclose(arquivo);
+    return ok && tabela->quantidade > 0 && escalonamento_valido(tabela);
+}
+
+// Roda o roteiro numa zona com a tabela (NULL: ganhos fixos de ZONA_PADRAO) e
+// acumula ISE e IAE de cada degrau contra o setpoint do degrau
+static void rodar_roteiro(const Escalonamento *tabela, Desempenho *degraus)
+{
+    Simulacao s = {.zonas = 1, .amostras_burst = 1};
+    i2c_simulado_reiniciar();
+    zonas[0] = zona_simulada(0, s.amostras_burst);
+    zona_definir_taxa_setpoint(&zonas[0], 0.0f); // Degraus, como na sintonia
+    if (tabela)
+    {
+        zonas[0].escalonamento = *tabela;
+        zonas[0].escalonamento_ativo = true;
+    }
+    iniciar_zona(0, (Planta){.temperatura = ROTEIRO[0].setpoint, .carga = ESCALONAMENTO_CARGA,
+                             .ambiente = ESCALONAMENTO_AMBIENTE, .semente = 2463534242u});
+
+    for (size_t d = 0; d < count_of(ROTEIRO); d++)
+    {
+        zona_definir_setpoint(&zonas[0], ROTEIRO[d].setpoint);
+        degraus[d] = (Desempenho){0};
+        for (int c = 0; c < ROTEIRO[d].duracao; c++)
+        {
+            uint64_t inicio = time_us_64();
+            ciclo_controle(&s);
+            passar_periodo(1, inicio);
+            double erro = plantas[0].temperatura - ROTEIRO[d].setpoint;
+            degraus[d].ise += erro * erro * PERIODO_AMOSTRA;
+            degraus[d].iae += fabs(erro) * PERIODO_AMOSTRA;
+        }
+    }
+}
+
+// Liga a tabela com a zona fora do setpoint (como pela rota /escalonamento),
+// num setpoint a um quarto do caminho entre os dois primeiros pontos: os
+// ganhos são interpolados ali e a saída só anda o incremento normal do integral
+static void testar_troca_sem_solavanco(const Escalonamento *tabela)
+{
+    const EscalonamentoPonto *p = tabela->pontos;
+    const EscalonamentoPonto *q = tabela->quantidade > 1 ? &p[1] : &p[0];
+    const float erro = 0.5f;
+    Zona zona = zona_simulada(0, 1);
+    zona.escalonamento = *tabela;
+    zona.temperatura_desejada = p->chave + 0.25f * (q->chave - p->chave);
+
+    for (int c = 0; c < 5; c++)
+        zona_calcular_controle_pi(&zona, zona.temperatura_desejada + erro);
+    float antes = zona_calcular_controle_pi(&zona, zona.temperatura_desejada + erro);
+    zona.escalonamento_ativo = true;
+    float depois = zona_calcular_controle_pi(&zona, zona.temperatura_desejada + erro);
+
+    float ganho_p = p->ganho_p + 0.25f * (q->ganho_p - p->ganho_p);
+    float ganho_i = p->ganho_i + 0.25f * (q->ganho_i - p->ganho_i);
+    CHECAR(fabsf(zona.ganho_p_aplicado - ganho_p) < 1e-3f * ganho_p);
+    CHECAR(fabsf(zona.ganho_i_aplicado - ganho_i) < 1e-3f * ganho_i + 1e-6f);
+    CHECAR(fabsf(depois - antes - ganho_i * erro * PERIODO_AMOSTRA) < 1e-3f);
+}
+
+// A tabela (a padrão ou a de @p caminho) não pode ter ISE nem IAE totais
+// maiores que os ganhos fixos. Passa por escalonamento_ganhos() e pela troca
+// de ganhos sem solavanco de zona_calcular_controle_pi() a cada degrau, e
+// confere as duas diretamente antes.
+static void testar_escalonamento(const char *caminho)
+{
+    Escalonamento tabela = {.chave = ESCALONAMENTO_SETPOINT};
+    if (caminho)
+    {
+        if (!ler_tabela(caminho, &tabela))
+        {
+            printf("%s: tabela inválida (1 a %d pontos ponto,kp,ki)\n", caminho, ESCALONAMENTO_PONTOS_MAX);
+            teste_falhas++;
+            return;
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count_of(TABELA_PADRAO); i++)
+            escalonamento_definir_ponto(&tabela, TABELA_PADRAO[i].chave, TABELA_PADRAO[i].ganho_p,
+                                        TABELA_PADRAO[i].ganho_i);
+    }
+
+    testar_troca_sem_solavanco(&tabela);
+
+    Desempenho fixos[count_of(ROTEIRO)], escalonados[count_of(ROTEIRO)];
+    rodar_roteiro(NULL, fixos);
+    rodar_roteiro(&tabela, escalonados);
+
+    Desempenho total_fixo = {0}, total_escalonado = {0};
+    printf("setpoint |  ISE fixo escalonado |  IAE fixo escalonado\n");
+    for (size_t d = 1; d < count_of(ROTEIRO); d++)
+    {
+        printf("%8.1f | %9.0f %10.0f | %9.0f %10.0f\n", ROTEIRO[d].setpoint, fixos[d].ise, escalonados[d].ise,
+               fixos[d].iae, escalonados[d].iae);
+        total_fixo.ise += fixos[d].ise;
+        total_fixo.iae += fixos[d].iae;
+        total_escalonado.ise += escalonados[d].ise;
+        total_escalonado.iae += escalonados[d].iae;
+    }
+    printf("   total | %9.0f %10.0f | %9.0f %10.0f\n", total_fixo.ise, total_escalonado.ise, total_fixo.iae,
+           total_escalonado.iae);
+
+    CHECAR(total_escalonado.ise <= total_fixo.ise);
+    CHECAR(total_escalonado.iae <= total_fixo.iae);
+}
+
+int main(int argc, char **argv)
+{
+    log_nivel = LOG_NADA;
+    if (argc > 1 && strcmp(argv[1], "escalonamento") == 0)
+    {
+        testar_escalonamento(argc > 2 ? argv[2] : NULL);
+        return teste_resultado("sim_escalonamento");
+    }
+
+    int minutos = argc > 1 ? atoi(argv[1]) : MINUTOS_PADRAO;
+    if (minutos <= MINUTOS_REGIME)
+        minutos = MINUTOS_PADRAO;
+    testar_independencia(minutos);
+    testar_periodo(minutos);
+    return teste_resultado("sim_zonas");
+}
@@ -0,0 +1,15 @@
+#ifndef STUB_HARDWARE_CLOCKS_H
+#define STUB_HARDWARE_CLOCKS_H
+
+#include <stdint.h>
+
+enum clock_index { clk_sys = 5 };
+
+// Clock padrão do RP2040
+static inline uint32_t clock_get_hz(enum clock_index clock)
+{
+    (void)clock;
+    return 125000000;
+}
+
+#endif // STUB_HARDWARE_CLOCKS_H
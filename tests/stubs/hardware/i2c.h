@@ -0,0 +1,18 @@
+#ifndef STUB_HARDWARE_I2C_H
+#define STUB_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+// Cada barramento é só uma identidade no host
+typedef struct i2c_inst
+{
+    int indice;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst, i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+void i2c_deinit(i2c_inst_t *i2c);
+
+#endif // STUB_HARDWARE_I2C_H
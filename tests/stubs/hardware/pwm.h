@@ -0,0 +1,36 @@
+#ifndef STUB_HARDWARE_PWM_H
+#define STUB_HARDWARE_PWM_H
+
+#include "pico/stdlib.h"
+
+// Configuração de uma fatia; pwm_init() e o nível por pino ficam com sdk_simulado.c
+typedef struct
+{
+    float divisor;
+    uint16_t topo;
+} pwm_config;
+
+static inline uint pwm_gpio_to_slice_num(uint pino)
+{
+    return (pino >> 1) & 7;
+}
+
+static inline pwm_config pwm_get_default_config(void)
+{
+    return (pwm_config){1.0f, 0xffff};
+}
+
+static inline void pwm_config_set_clkdiv(pwm_config *configuracao, float divisor)
+{
+    configuracao->divisor = divisor;
+}
+
+static inline void pwm_config_set_wrap(pwm_config *configuracao, uint16_t topo)
+{
+    configuracao->topo = topo;
+}
+
+void pwm_init(uint fatia, pwm_config *configuracao, bool iniciar);
+void pwm_set_gpio_level(uint pino, uint16_t nivel);
+
+#endif // STUB_HARDWARE_PWM_H
@@ -0,0 +1,23 @@
+#ifndef STUB_HARDWARE_SYNC_H
+#define STUB_HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+// Sem interrupções no host
+static inline uint32_t save_and_disable_interrupts(void)
+{
+    return 0;
+}
+
+static inline void restore_interrupts(uint32_t estado)
+{
+    (void)estado;
+}
+
+// Barreira de memória: no host basta impedir o compilador de reordenar
+static inline void __dmb(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+#endif // STUB_HARDWARE_SYNC_H
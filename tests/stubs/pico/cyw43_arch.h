@@ -0,0 +1,13 @@
+#ifndef STUB_PICO_CYW43_ARCH_H
+#define STUB_PICO_CYW43_ARCH_H
+
+// Sem interrupções no host: os callbacks do lwIP simulado rodam na hora
+static inline void cyw43_arch_lwip_begin(void)
+{
+}
+
+static inline void cyw43_arch_lwip_end(void)
+{
+}
+
+#endif // STUB_PICO_CYW43_ARCH_H
@@ -0,0 +1,40 @@
+// Substituto mínimo do SDK para os testes no host: só o que os módulos
+// testados usam. Tempo e GPIO são implementados por sdk_simulado.c, nos
+// testes que precisam deles.
+#ifndef STUB_PICO_STDLIB_H
+#define STUB_PICO_STDLIB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define __not_in_flash_func(f) f
+
+#define PICO_ERROR_GENERIC -1
+#define PICO_ERROR_TIMEOUT -2
+
+/* ---------- Tempo (relógio virtual) ---------- */
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+absolute_time_t get_absolute_time(void);
+uint32_t to_ms_since_boot(absolute_time_t t);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+/* ---------- GPIO ---------- */
+enum gpio_function { GPIO_FUNC_SIO = 5, GPIO_FUNC_I2C = 3, GPIO_FUNC_PWM = 4 };
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+void gpio_init(uint pino);
+void gpio_set_function(uint pino, enum gpio_function funcao);
+void gpio_set_dir(uint pino, bool saida);
+void gpio_put(uint pino, bool valor);
+bool gpio_get(uint pino);
+void gpio_pull_up(uint pino);
+
+#endif // STUB_PICO_STDLIB_H
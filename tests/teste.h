@@ -0,0 +1,42 @@
+#ifndef TESTE_H
+#define TESTE_H
+
+#include <stdio.h>
+
+// Verificações dos testes no host: uma falha é relatada e o teste continua,
+// para mostrar todas de uma vez; o código de saída diz ao ctest se passou.
+
+static int teste_falhas;
+
+#define CHECAR(condicao)                                                          \
+    do                                                                            \
+    {                                                                             \
+        if (!(condicao))                                                          \
+        {                                                                         \
+            printf("%s:%d: falhou: %s\n", __FILE__, __LINE__, #condicao);         \
+            teste_falhas++;                                                       \
+        }                                                                         \
+    } while (0)
+
+#define CHECAR_IGUAL(obtido, esperado)                                            \
+    do                                                                            \
+    {                                                                             \
+        long long obtido_ = (long long)(obtido), esperado_ = (long long)(esperado); \
+        if (obtido_ != esperado_)                                                 \
+        {                                                                         \
+            printf("%s:%d: %s = %lld, esperado %lld\n", __FILE__, __LINE__, #obtido, \
+                   obtido_, esperado_);                                           \
+            teste_falhas++;                                                       \
+        }                                                                         \
+    } while (0)
+
+static inline int teste_resultado(const char *nome)
+{
+    if (teste_falhas)
+        printf("%s: %d falha(s)\n", nome, teste_falhas);
+    else
+        printf("%s: ok\n", nome);
+    return teste_falhas ? 1 : 0;
+}
+
+#endif // TESTE_H
@@ -0,0 +1,289 @@
+#include <math.h>
+#include "teste.h"
+#include "zona.h"
+#include "log.h"
+#include "sdk_simulado.h"
+#include "i2c_simulado.h"
+
+// Falhas do sensor injetadas na fila I2C simulada, com zona.c, aht20.c e o
+// monitor reais: instabilidade passageira, falha com posição segura e backoff,
+// CRC, conversão travada, perda de calibração, SDA presa e sensor ausente no boot.
+
+#define PINO_SDA 0
+#define PINO_SCL 1
+#define ANGULO_SEGURO 150.0f // Diferentes do padrão, para não coincidirem com a saída do PI
+#define VENTOINHA_SEGURA 70.0f
+
+static Zona zona;
+static AHT20Simulado *sensor;
+
+static void montar_zona(void)
+{
+    i2c_simulado_reiniciar();
+    sensor = i2c_simulado_aht20(i2c0, AHT20_I2C_ADDR);
+    sensor->temperatura = 30.0f;
+    zona = (Zona){
+        .hw = {"Zona 1", i2c0, PINO_SDA, PINO_SCL, AHT20_I2C_ADDR, 8, 18, 19, 20},
+        .temperatura_desejada = 28.0f,
+        .perfil_setpoint = PERFIL_SETPOINT_PADRAO(28.0f),
+        .ganho_p = 10.0f,
+        .ganho_i = 0.2f,
+        .ganho_p_aplicado = 10.0f,
+        .ganho_i_aplicado = 0.2f,
+        .integral_min = -90.0f,
+        .integral_max = 90.0f,
+        .angulo_max = 180.0f,
+        .modo = MODO_AUTOMATICO,
+        .angulo_seguro = ANGULO_SEGURO,
+        .ventoinha_segura = VENTOINHA_SEGURA,
+        .ventoinha_manual = NAN,
+        .pwm_servo = PWM_SERVO_PADRAO,
+        .pwm_ventoinha = PWM_VENTOINHA_PADRAO,
+        .perfil_servo = PERFIL_SERVO_PADRAO,
+        .perfil_ventoinha = PERFIL_VENTOINHA_PADRAO,
+        .curva_ventoinha = VENTOINHA_CURVA_PADRAO,
+        .temperatura_ambiente = NAN,
+        .filtro = {.cfg = FILTRO_CONFIG_PADRAO},
+    };
+}
+
+// Um ciclo de controle de 1 s, como em main.c: disparo, conversão, leitura e
+// controle, ou o tratamento da falha
+static void ciclo(void)
+{
+    uint64_t inicio = time_us_64();
+    float temperatura, umidade;
+    bool valida = zona_disparar_leitura(&zona);
+    sdk_simulado_avancar_ate(time_us_64() + AHT20_TEMPO_MEDICAO_MS * 1000);
+    valida = valida && zona_solicitar_resultado(&zona) &&
+             zona_ler_temperatura(&zona, &temperatura, &umidade) == AHT20_OK;
+
+    if (valida)
+    {
+        zona_confirmar_leitura_sensor(&zona);
+        zona.umidade = umidade;
+        zona_filtrar_temperatura(&zona, temperatura, &temperatura);
+        zona_aplicar_controle(&zona, temperatura);
+    }
+    else
+    {
+        zona_tratar_falha_sensor(&zona, to_ms_since_boot(get_absolute_time()));
+    }
+    sdk_simulado_avancar_ate(inicio + (uint64_t)(PERIODO_AMOSTRA * 1000000));
+}
+
+static void ciclos(int n)
+{
+    for (int i = 0; i < n; i++)
+        ciclo();
+}
+
+static bool em_posicao_segura(void)
+{
+    return zona.perfil_servo.alvo == ANGULO_SEGURO && zona.perfil_ventoinha.alvo == VENTOINHA_SEGURA;
+}
+
+// Falhas abaixo do limite: instável, mantém a saída e não tenta recuperar
+static void testar_instavel(void)
+{
+    montar_zona();
+    CHECAR(zona_inicializar_sensor(&zona));
+    ciclos(5);
+    float alvo_servo = zona.perfil_servo.alvo;
+
+    sensor->falha = AHT20_SIMULADO_AUSENTE;
+    ciclos(MONITOR_FALHAS_PARA_FALHA - 1);
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_INSTAVEL);
+    CHECAR(!zona.sensor_ok);
+    CHECAR(zona.perfil_servo.alvo == alvo_servo);
+    CHECAR_IGUAL(zona.monitor.tentativas_recuperacao, 0);
+
+    sensor->falha = AHT20_SIMULADO_OK;
+    ciclo();
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_SAUDAVEL);
+    CHECAR(zona.sensor_ok);
+    CHECAR_IGUAL(zona.monitor.total_falhas, MONITOR_FALHAS_PARA_FALHA - 1);
+    CHECAR_IGUAL(zona.monitor.recuperacoes, 0);
+    CHECAR_IGUAL(sensor->resets, 0);
+}
+
+// Sensor desconectado: posição segura, tentativas com backoff de 1 s a 64 s e
+// volta ao controle quando ele reaparece, sem o histórico de antes
+static void testar_falha_e_backoff(void)
+{
+    static const uint32_t INTERVALOS_S[] = {1, 2, 4, 8, 16, 32, 64, 64};
+
+    montar_zona();
+    CHECAR(zona_inicializar_sensor(&zona));
+    ciclos(60);
+    CHECAR(zona.termo_integral != 0.0f);
+
+    sensor->falha = AHT20_SIMULADO_AUSENTE;
+    ciclos(MONITOR_FALHAS_PARA_FALHA);
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_EM_FALHA);
+    CHECAR(em_posicao_segura());
+    CHECAR_IGUAL(zona.monitor.tentativas_recuperacao, 1); // A primeira é imediata
+
+    // Instante de cada tentativa, em ciclos desde a anterior
+    uint32_t tentativas = zona.monitor.tentativas_recuperacao, desde_anterior = 0;
+    size_t intervalo = 0;
+    while (intervalo < count_of(INTERVALOS_S))
+    {
+        ciclo();
+        desde_anterior++;
+        if (zona.monitor.tentativas_recuperacao == tentativas)
+            continue;
+        tentativas = zona.monitor.tentativas_recuperacao;
+        // A tentativa leva parte do ciclo: o próximo prazo pode cair um ciclo depois
+        if (desde_anterior < INTERVALOS_S[intervalo] || desde_anterior > INTERVALOS_S[intervalo] + 1)
+        {
+            printf("tentativa %zu: %u s depois da anterior, esperado %u s\n", intervalo + 2,
+                   (unsigned)desde_anterior, (unsigned)INTERVALOS_S[intervalo]);
+            teste_falhas++;
+        }
+        desde_anterior = 0;
+        intervalo++;
+    }
+    CHECAR(em_posicao_segura());
+    CHECAR_IGUAL(zona.monitor.backoff_ms, MONITOR_BACKOFF_MAX_MS);
+
+    // Reaparece recém-ligado, sem calibração: só a próxima tentativa (reset e
+    // inicialização) o traz de volta, e a leitura seguinte confirma
+    sensor->falha = AHT20_SIMULADO_OK;
+    sensor->calibrado = false;
+    for (int i = 0; i < 2 * MONITOR_BACKOFF_MAX_MS / 1000 && zona.monitor.estado == SENSOR_EM_FALHA; i++)
+        ciclo();
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_SAUDAVEL);
+    CHECAR_IGUAL(zona.monitor.recuperacoes, 1);
+    CHECAR_IGUAL(sensor->resets, 1);
+    CHECAR_IGUAL(zona.monitor.backoff_ms, MONITOR_BACKOFF_INICIAL_MS);
+    CHECAR_IGUAL(zona.filtro.janela_n, 1);              // Histórico descartado
+    CHECAR(fabsf(zona.termo_integral) < 1.0f);          // Integral recomeçou nesta leitura
+    CHECAR(!em_posicao_segura());
+}
+
+// Quadros inválidos contam como falha e como rejeição do sensor
+static void testar_quadros_invalidos(void)
+{
+    montar_zona();
+    CHECAR(zona_inicializar_sensor(&zona));
+    ciclo();
+
+    sensor->falha = AHT20_SIMULADO_CRC;
+    ciclos(2);
+    CHECAR_IGUAL(zona.filtro.rejeitadas_sensor, 2);
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_INSTAVEL);
+
+    // Conversão travada: não é rejeição (o quadro nem foi lido), mas é falha
+    sensor->falha = AHT20_SIMULADO_OCUPADO;
+    ciclo();
+    CHECAR_IGUAL(zona.filtro.rejeitadas_sensor, 2);
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_EM_FALHA);
+    CHECAR(em_posicao_segura());
+
+    // O reset não destrava uma conversão presa: as tentativas continuam
+    ciclos(10);
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_EM_FALHA);
+    CHECAR(zona.monitor.tentativas_recuperacao > 1);
+
+    sensor->falha = AHT20_SIMULADO_OK;
+    ciclos(40);
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_SAUDAVEL);
+}
+
+// Perda de calibração: o reset com a inicialização resolve sem intervenção
+static void testar_calibracao(void)
+{
+    montar_zona();
+    CHECAR(zona_inicializar_sensor(&zona));
+    ciclo();
+
+    sensor->calibrado = false;
+    ciclos(MONITOR_FALHAS_PARA_FALHA);
+    CHECAR_IGUAL(zona.filtro.rejeitadas_sensor, MONITOR_FALHAS_PARA_FALHA);
+    CHECAR_IGUAL(sensor->resets, 1);
+    CHECAR(sensor->calibrado);
+    ciclo();
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_SAUDAVEL);
+    CHECAR_IGUAL(zona.monitor.recuperacoes, 1);
+}
+
+// Escravo segurando SDA: as transações terminam em timeout sem travar o ciclo e
+// a recuperação pulsa SCL só até SDA subir
+static void testar_sda_presa(void)
+{
+    montar_zona();
+    CHECAR(zona_inicializar_sensor(&zona));
+    ciclo();
+
+    i2c_simulado_prender_sda(i2c0, PINO_SDA, PINO_SCL, 5);
+    uint64_t inicio = time_us_64();
+    ciclos(MONITOR_FALHAS_PARA_FALHA - 1);
+    CHECAR_IGUAL(time_us_64() - inicio, (MONITOR_FALHAS_PARA_FALHA - 1) * (uint64_t)(PERIODO_AMOSTRA * 1000000));
+    CHECAR_IGUAL(i2c_simulado_pulsos_scl(i2c0), 0);
+
+    I2CFilaEstatisticas estatisticas;
+    i2c_fila_estatisticas(i2c0, &estatisticas);
+    CHECAR(estatisticas.timeouts > 0);
+
+    ciclo(); // Entra em falha e recupera na hora
+    CHECAR_IGUAL(i2c_simulado_pulsos_scl(i2c0), 5);
+    CHECAR_IGUAL(sensor->resets, 1);
+    ciclo();
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_SAUDAVEL);
+
+    // Preso além dos 9 pulsos: a recuperação falha e o backoff cresce
+    i2c_simulado_prender_sda(i2c0, PINO_SDA, PINO_SCL, 20);
+    ciclos(MONITOR_FALHAS_PARA_FALHA + 1);
+    CHECAR_IGUAL(i2c_simulado_pulsos_scl(i2c0), 2 * 9);
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_EM_FALHA);
+    CHECAR_IGUAL(zona.monitor.backoff_ms, 4 * MONITOR_BACKOFF_INICIAL_MS);
+    CHECAR(em_posicao_segura());
+}
+
+// Sem sensor no boot: a zona começa em falha e se recupera quando ele aparece
+static void testar_ausente_no_boot(void)
+{
+    montar_zona();
+    sensor->falha = AHT20_SIMULADO_AUSENTE;
+    CHECAR(!zona_inicializar_sensor(&zona));
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_EM_FALHA);
+
+    ciclo();
+    CHECAR_IGUAL(zona.monitor.tentativas_recuperacao, 1);
+    CHECAR(em_posicao_segura());
+
+    sensor->falha = AHT20_SIMULADO_OK;
+    ciclos(3);
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_SAUDAVEL);
+    CHECAR_IGUAL(zona.monitor.recuperacoes, 1);
+}
+
+// Com a temperatura crítica quem comanda os atuadores é o supervisor
+static void testar_temperatura_critica(void)
+{
+    montar_zona();
+    CHECAR(zona_inicializar_sensor(&zona));
+    ciclo();
+
+    zona.temperatura_critica = true;
+    zona_forcar_resfriamento_maximo(&zona);
+    sensor->falha = AHT20_SIMULADO_AUSENTE;
+    ciclos(MONITOR_FALHAS_PARA_FALHA + 1);
+    CHECAR_IGUAL(zona.monitor.estado, SENSOR_EM_FALHA);
+    CHECAR(zona.perfil_servo.alvo == ANGULO_ABERTURA_TOTAL);
+    CHECAR(zona.perfil_ventoinha.alvo == 100.0f);
+}
+
+int main(void)
+{
+    log_nivel = LOG_NADA;
+    testar_instavel();
+    testar_falha_e_backoff();
+    testar_quadros_invalidos();
+    testar_calibracao();
+    testar_sda_presa();
+    testar_ausente_no_boot();
+    testar_temperatura_critica();
+    return teste_resultado("falha_sensor");
+}
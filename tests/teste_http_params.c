@@ -0,0 +1,201 @@
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "teste.h"
+#include "http_params.h"
+
+// Extrator de parâmetros: os casos de corpus/params.txt, nos dois formatos, e
+// as regras que valem para qualquer entrada (destinos intactos em caso de
+// erro, leitura limitada ao tamanho informado).
+
+static const char *const MODOS[] = {"auto", "manual", "desligado", NULL};
+
+static float temperatura, taxa;
+static int zona, modo;
+static bool ativo, temperatura_presente, zona_presente, taxa_presente, modo_presente, ativo_presente, destino_presente;
+static char destino[HTTP_PARAMS_MAX_VALUE];
+
+static const http_param_spec_t SPECS[] = {
+    {"temperatura", HTTP_PARAM_FLOAT, true, 5.0f, 80.0f, NULL, &temperatura, &temperatura_presente},
+    {"zona", HTTP_PARAM_INT, false, 0, 3, NULL, &zona, &zona_presente},
+    {"taxa", HTTP_PARAM_FLOAT, false, 0.0f, 10.0f, NULL, &taxa, &taxa_presente},
+    {"modo", HTTP_PARAM_ENUM, false, 0, 0, MODOS, &modo, &modo_presente},
+    {"ativo", HTTP_PARAM_BOOL, false, 0, 0, NULL, &ativo, &ativo_presente},
+    {"destino", HTTP_PARAM_STRING, false, 0, 0, NULL, destino, &destino_presente},
+};
+
+static const char *const NOMES_STATUS[] = {"ok", "ausente", "sintaxe", "faixa", "repetido", "longo", "spec"};
+
+// Valores que nenhuma entrada produz: um destino alterado num erro aparece
+static void preencher_sentinelas(void)
+{
+    temperatura = taxa = -1000.0f;
+    zona = modo = -1000;
+    ativo = true;
+    strcpy(destino, "sentinela");
+}
+
+static bool sentinelas_intactas(void)
+{
+    return temperatura == -1000.0f && taxa == -1000.0f && zona == -1000 && modo == -1000 && ativo &&
+           strcmp(destino, "sentinela") == 0;
+}
+
+static http_param_result_t extrair(bool json, const char *entrada, size_t tamanho)
+{
+    return json ? http_params_parse_json(entrada, tamanho, SPECS, count_of(SPECS))
+                : http_params_parse_query(entrada, tamanho, SPECS, count_of(SPECS));
+}
+
+// Descreve o resultado no formato da terceira coluna do corpus
+static void descrever(http_param_result_t resultado, char *texto, size_t tamanho)
+{
+    if (resultado.status != HTTP_PARAM_OK)
+    {
+        snprintf(texto, tamanho, "%s %s", NOMES_STATUS[resultado.status], resultado.name ? resultado.name : "-");
+        return;
+    }
+    int n = snprintf(texto, tamanho, "ok");
+    if (temperatura_presente)
+        n += snprintf(texto + n, tamanho - n, " temperatura=%g", temperatura);
+    if (zona_presente)
+        n += snprintf(texto + n, tamanho - n, " zona=%d", zona);
+    if (taxa_presente)
+        n += snprintf(texto + n, tamanho - n, " taxa=%g", taxa);
+    if (modo_presente)
+        n += snprintf(texto + n, tamanho - n, " modo=%s", MODOS[modo]);
+    if (ativo_presente)
+        n += snprintf(texto + n, tamanho - n, " ativo=%s", ativo ? "true" : "false");
+    if (destino_presente)
+        snprintf(texto + n, tamanho - n, " destino=%s", destino);
+}
+
+// "\n", "\r" e "\t" da entrada do corpus viram os caracteres de controle
+static void converter_escapes(char *texto)
+{
+    char *saida = texto;
+    for (const char *c = texto; *c; c++)
+    {
+        if (c[0] == '\\' && (c[1] == 'n' || c[1] == 'r' || c[1] == 't'))
+        {
+            *saida++ = c[1] == 'n' ? '\n' : c[1] == 'r' ? '\r' : '\t';
+            c++;
+        }
+        else
+        {
+            *saida++ = *c;
+        }
+    }
+    *saida = '\0';
+}
+
+// Confere uma entrada do corpus e as propriedades gerais sobre ela
+static void conferir_caso(int linha, bool json, const char *entrada, const char *esperado)
+{
+    char obtido[160];
+    size_t tamanho = strlen(entrada);
+
+    preencher_sentinelas();
+    http_param_result_t resultado = extrair(json, entrada, tamanho);
+    descrever(resultado, obtido, sizeof(obtido));
+    if (strcmp(obtido, esperado) != 0)
+    {
+        printf("params.txt:%d: \"%s\", esperado \"%s\"\n", linha, obtido, esperado);
+        teste_falhas++;
+    }
+    if (resultado.status != HTTP_PARAM_OK && !sentinelas_intactas())
+    {
+        printf("params.txt:%d: destino alterado num erro\n", linha);
+        teste_falhas++;
+    }
+
+    // Cada prefixo, copiado para um buffer do tamanho exato: a leitura não passa
+    // do tamanho informado e um erro nunca altera os destinos
+    for (size_t n = 0; n < tamanho; n++)
+    {
+        char *prefixo = malloc(n ? n : 1);
+        memcpy(prefixo, entrada, n);
+        preencher_sentinelas();
+        resultado = extrair(json, prefixo, n);
+        if (resultado.status != HTTP_PARAM_OK && !sentinelas_intactas())
+        {
+            printf("params.txt:%d: destino alterado num erro com %zu bytes\n", linha, n);
+            teste_falhas++;
+        }
+        free(prefixo);
+    }
+}
+
+static void testar_corpus(void)
+{
+    FILE *arquivo = fopen(CORPUS_PARAMS, "r");
+    CHECAR(arquivo != NULL);
+    if (!arquivo)
+        return;
+
+    char linha[512];
+    int numero = 0, casos = 0;
+    while (fgets(linha, sizeof(linha), arquivo))
+    {
+        numero++;
+        linha[strcspn(linha, "\n")] = '\0';
+        if (linha[0] == '#' || linha[0] == '\0')
+            continue;
+
+        // formato | entrada | esperado: a entrada vai do primeiro ao último separador
+        char *primeiro = strstr(linha, " | ");
+        char *ultimo = primeiro;
+        for (char *p = primeiro; p && (p = strstr(p + 1, " | ")) != NULL;)
+            ultimo = p;
+        if (!primeiro || ultimo == primeiro)
+        {
+            printf("params.txt:%d: linha malformada\n", numero);
+            teste_falhas++;
+            continue;
+        }
+        *primeiro = '\0';
+        *ultimo = '\0';
+        char *entrada = primeiro + 3;
+        converter_escapes(entrada);
+        conferir_caso(numero, strcmp(linha, "json") == 0, entrada, ultimo + 3);
+        casos++;
+    }
+    fclose(arquivo);
+    CHECAR(casos > 0);
+    printf("params: %d casos do corpus\n", casos);
+}
+
+static void testar_especificacoes_demais(void)
+{
+    http_param_spec_t specs[HTTP_PARAMS_MAX + 1];
+    int valores[HTTP_PARAMS_MAX + 1];
+    char nomes[HTTP_PARAMS_MAX + 1][8];
+    for (int i = 0; i <= HTTP_PARAMS_MAX; i++)
+    {
+        snprintf(nomes[i], sizeof(nomes[i]), "p%d", i);
+        valores[i] = -1;
+        specs[i] = (http_param_spec_t){nomes[i], HTTP_PARAM_INT, false, 0, 100, NULL, &valores[i], NULL};
+    }
+
+    // No limite funciona, inclusive o último
+    http_param_result_t resultado = http_params_parse_query("p0=1&p11=2", 10, specs, HTTP_PARAMS_MAX);
+    CHECAR_IGUAL(resultado.status, HTTP_PARAM_OK);
+    CHECAR_IGUAL(valores[0], 1);
+    CHECAR_IGUAL(valores[HTTP_PARAMS_MAX - 1], 2);
+
+    // Um além: recusada inteira, sem tocar nos destinos
+    valores[0] = -1;
+    resultado = http_params_parse_query("p0=1&p12=3", 10, specs, count_of(specs));
+    CHECAR_IGUAL(resultado.status, HTTP_PARAM_ERR_SPEC);
+    CHECAR_IGUAL(valores[0], -1);
+    resultado = http_params_parse_json("{\"p0\": 1}", 9, specs, count_of(specs));
+    CHECAR_IGUAL(resultado.status, HTTP_PARAM_ERR_SPEC);
+    CHECAR_IGUAL(valores[0], -1);
+}
+
+int main(void)
+{
+    testar_corpus();
+    testar_especificacoes_demais();
+    return teste_resultado("http_params");
+}
@@ -0,0 +1,247 @@
+#include <dirent.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "teste.h"
+#include "http_parser.h"
+
+// Casos do parser HTTP e uma rodada determinística do alvo de fuzzing
+// (fuzz_http_parser.c) sobre o corpus e mutações dele. Uma violação no alvo
+// aborta o processo, o que o ctest conta como falha.
+
+int LLVMFuzzerTestOneInput(const uint8_t *dados, size_t tamanho);
+
+#define MUTACOES_POR_ARQUIVO 4000
+#define ENTRADA_MAX 4096
+
+static http_parse_result_t analisar(http_parser_t *parser, const char *texto, size_t segmento)
+{
+    size_t tamanho = strlen(texto), total = 0, usados;
+    http_parse_result_t resultado = HTTP_PARSE_INCOMPLETE;
+    http_parser_init(parser);
+    while (total < tamanho && resultado == HTTP_PARSE_INCOMPLETE)
+    {
+        size_t n = tamanho - total < segmento ? tamanho - total : segmento;
+        resultado = http_parser_feed(parser, texto + total, n, &usados);
+        total += usados;
+    }
+    return resultado;
+}
+
+static void testar_get(void)
+{
+    static http_parser_t parser;
+    char valor[32];
+    for (size_t segmento = 1; segmento <= 64; segmento *= 2)
+    {
+        CHECAR_IGUAL(analisar(&parser, "GET /udp?destino=10.0.0.2%3A5005&nome=a+b HTTP/1.1\r\nHost: x\r\n\r\n", segmento),
+                     HTTP_PARSE_DONE);
+        CHECAR_IGUAL(parser.method, HTTP_METHOD_GET);
+        CHECAR(http_parser_path_equals(&parser, "/udp"));
+        CHECAR(!http_parser_path_equals(&parser, "/ud"));
+        CHECAR(http_parser_query_param(&parser, "destino", valor, sizeof(valor)));
+        CHECAR(strcmp(valor, "10.0.0.2:5005") == 0);
+        CHECAR(http_parser_query_param(&parser, "nome", valor, sizeof(valor)));
+        CHECAR(strcmp(valor, "a b") == 0);
+        CHECAR(!http_parser_query_param(&parser, "dest", valor, sizeof(valor)));
+        CHECAR(!http_parser_query_param(&parser, "destino", valor, 8)); // Não cabe
+    }
+
+    // Só "\n" também encerra as linhas
+    CHECAR_IGUAL(analisar(&parser, "GET / HTTP/1.0\nHost: x\n\n", 3), HTTP_PARSE_DONE);
+    CHECAR(http_parser_path_equals(&parser, "/"));
+}
+
+static void testar_post(void)
+{
+    static http_parser_t parser;
+    const char *requisicao = "POST /ganhos HTTP/1.1\r\nAUTHORIZATION:  Bearer abc \r\nContent-Length: 9\r\n\r\n{\"kp\":8}\r";
+    for (size_t segmento = 1; segmento <= 128; segmento *= 2)
+    {
+        CHECAR_IGUAL(analisar(&parser, requisicao, segmento), HTTP_PARSE_DONE);
+        CHECAR_IGUAL(parser.method, HTTP_METHOD_POST);
+        CHECAR(strcmp(parser.body, "{\"kp\":8}\r") == 0);
+        CHECAR(strcmp(parser.authorization, "Bearer abc") == 0);
+        CHECAR_IGUAL(parser.authorization_len, 10);
+    }
+
+    // Corpo ainda incompleto
+    CHECAR_IGUAL(analisar(&parser, "POST /modo HTTP/1.1\r\nContent-Length: 20\r\n\r\nmodo=auto", 7), HTTP_PARSE_INCOMPLETE);
+
+    // Corpo maior que o parser: fica com o chamador, a partir do byte indicado
+    const char *upload = "POST /update HTTP/1.1\r\nContent-Length: 1000\r\n\r\nABC";
+    size_t usados;
+    http_parser_init(&parser);
+    CHECAR_IGUAL(http_parser_feed(&parser, upload, strlen(upload), &usados), HTTP_PARSE_BODY);
+    CHECAR(strcmp(upload + usados, "ABC") == 0);
+    CHECAR_IGUAL(parser.content_length, 1000);
+
+    // Pipelining: a segunda requisição não é consumida
+    const char *duas = "GET /a HTTP/1.1\r\n\r\nGET /b HTTP/1.1\r\n\r\n";
+    http_parser_init(&parser);
+    CHECAR_IGUAL(http_parser_feed(&parser, duas, strlen(duas), &usados), HTTP_PARSE_DONE);
+    CHECAR(strcmp(duas + usados, "GET /b HTTP/1.1\r\n\r\n") == 0);
+}
+
+static void testar_erros(void)
+{
+    static http_parser_t parser;
+    static char longo[HTTP_PARSER_MAX_HEADER_BYTES + 64];
+
+    CHECAR_IGUAL(analisar(&parser, "DELETE / HTTP/1.1\r\n\r\n", 5), HTTP_PARSE_ERROR);
+    CHECAR_IGUAL(parser.error, HTTP_PARSER_ERR_METHOD);
+    CHECAR_IGUAL(analisar(&parser, "get / HTTP/1.1\r\n\r\n", 5), HTTP_PARSE_ERROR);
+    CHECAR_IGUAL(parser.error, HTTP_PARSER_ERR_METHOD);
+    CHECAR_IGUAL(analisar(&parser, "GET status HTTP/1.1\r\n\r\n", 5), HTTP_PARSE_ERROR);
+    CHECAR_IGUAL(parser.error, HTTP_PARSER_ERR_BAD_REQUEST);
+    CHECAR_IGUAL(analisar(&parser, "GET / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n", 5), HTTP_PARSE_ERROR);
+    CHECAR_IGUAL(parser.error, HTTP_PARSER_ERR_BAD_REQUEST);
+    CHECAR_IGUAL(analisar(&parser, "GET / HTTP/1.1\r\nContent-Length: 123456789\r\n\r\n", 5), HTTP_PARSE_ERROR);
+    CHECAR_IGUAL(analisar(&parser, "GET / HTTP/1.1\r\n: x\r\n\r\n", 5), HTTP_PARSE_ERROR);
+    CHECAR_IGUAL(analisar(&parser, "GET / HTTP/1.1\rX\n\r\n", 5), HTTP_PARSE_ERROR);
+
+    // Alvo no limite e um byte além dele
+    memset(longo, 0, sizeof(longo));
+    memcpy(longo, "GET /", 5);
+    memset(longo + 5, 'a', HTTP_PARSER_MAX_TARGET - 2);
+    strcat(longo, " HTTP/1.1\r\n\r\n");
+    CHECAR_IGUAL(analisar(&parser, longo, 16), HTTP_PARSE_DONE);
+    CHECAR_IGUAL(parser.target_len, HTTP_PARSER_MAX_TARGET - 1);
+    longo[5 + HTTP_PARSER_MAX_TARGET - 2] = 'a';
+    CHECAR_IGUAL(analisar(&parser, longo, 16), HTTP_PARSE_ERROR);
+    CHECAR_IGUAL(parser.error, HTTP_PARSER_ERR_URI_TOO_LONG);
+
+    // Cabeçalhos acima do total permitido
+    memset(longo, 0, sizeof(longo));
+    strcpy(longo, "GET / HTTP/1.1\r\nX-Longo: ");
+    memset(longo + strlen(longo), 'b', HTTP_PARSER_MAX_HEADER_BYTES);
+    strcat(longo, "\r\n\r\n");
+    CHECAR_IGUAL(analisar(&parser, longo, 100), HTTP_PARSE_ERROR);
+    CHECAR_IGUAL(parser.error, HTTP_PARSER_ERR_HEADERS_TOO_LARGE);
+}
+
+static void testar_decodificacao(void)
+{
+    char saida[8];
+    CHECAR_IGUAL(http_url_decode(saida, sizeof(saida), "a%41+%7e", 8), 4);
+    CHECAR(strcmp(saida, "aA ~") == 0);
+    CHECAR_IGUAL(http_url_decode(saida, sizeof(saida), "%4", 2), -1);
+    CHECAR_IGUAL(http_url_decode(saida, sizeof(saida), "%G1", 3), -1);
+    CHECAR_IGUAL(http_url_decode(saida, sizeof(saida), "1234567", 7), 7);
+    CHECAR_IGUAL(http_url_decode(saida, sizeof(saida), "12345678", 8), -1); // Sem espaço para o '\0'
+}
+
+// Gerador fixo (xorshift32): a mesma sequência de mutações em toda execução
+static uint32_t semente = 2463534242u;
+static uint32_t aleatorio(void)
+{
+    semente ^= semente << 13;
+    semente ^= semente >> 17;
+    semente ^= semente << 5;
+    return semente;
+}
+
+// Troca, insere, apaga ou repete bytes da entrada, como as mutações básicas do libFuzzer
+static size_t mutar(uint8_t *dados, size_t tamanho)
+{
+    static const char FRAGMENTOS[][8] = {"\r\n", "%", "?", "&", "=", ":", " ", "\r\n\r\n", "%4", "+"};
+    int passos = 1 + aleatorio() % 4;
+    for (int p = 0; p < passos && tamanho > 0; p++)
+    {
+        size_t pos = aleatorio() % tamanho;
+        switch (aleatorio() % 5)
+        {
+        case 0:
+            dados[pos] = (uint8_t)aleatorio();
+            break;
+        case 1:
+            memmove(dados + pos, dados + pos + 1, tamanho - pos - 1);
+            tamanho--;
+            break;
+        case 2:
+        {
+            const char *f = FRAGMENTOS[aleatorio() % (sizeof(FRAGMENTOS) / sizeof(FRAGMENTOS[0]))];
+            size_t n = strlen(f);
+            if (tamanho + n <= ENTRADA_MAX)
+            {
+                memmove(dados + pos + n, dados + pos, tamanho - pos);
+                memcpy(dados + pos, f, n);
+                tamanho += n;
+            }
+            break;
+        }
+        case 3:
+        {
+            // Repete um trecho: cabeçalhos e alvos longos
+            size_t n = 1 + aleatorio() % 64;
+            if (n > tamanho - pos)
+                n = tamanho - pos;
+            for (int r = aleatorio() % 40; r > 0 && tamanho + n <= ENTRADA_MAX; r--)
+            {
+                memmove(dados + pos + n, dados + pos, tamanho - pos);
+                tamanho += n;
+            }
+            break;
+        }
+        default:
+            tamanho = pos + 1;
+            break;
+        }
+    }
+    return tamanho;
+}
+
+static int rodar_arquivo(const char *caminho)
+{
+    static uint8_t original[ENTRADA_MAX], entrada[ENTRADA_MAX];
+    FILE *arquivo = fopen(caminho, "rb");
+    if (!arquivo)
+        return 0;
+    size_t tamanho = fread(original + 1, 1, sizeof(original) - 1, arquivo) + 1;
+    fclose(arquivo);
+
+    // Cada segmentação, depois mutações com segmentação sorteada
+    for (int segmento = 0; segmento < 32; segmento++)
+    {
+        original[0] = (uint8_t)segmento;
+        LLVMFuzzerTestOneInput(original, tamanho);
+    }
+    for (int i = 0; i < MUTACOES_POR_ARQUIVO; i++)
+    {
+        memcpy(entrada, original, tamanho);
+        entrada[0] = (uint8_t)aleatorio();
+        size_t n = mutar(entrada + 1, tamanho - 1) + 1;
+        LLVMFuzzerTestOneInput(entrada, n);
+    }
+    return 1;
+}
+
+static void testar_corpus(void)
+{
+    char caminho[512];
+    int arquivos = 0;
+    DIR *dir = opendir(CORPUS_HTTP);
+    CHECAR(dir != NULL);
+    if (!dir)
+        return;
+    for (struct dirent *e; (e = readdir(dir)) != NULL;)
+    {
+        if (e->d_name[0] == '.')
+            continue;
+        snprintf(caminho, sizeof(caminho), "%s/%s", CORPUS_HTTP, e->d_name);
+        arquivos += rodar_arquivo(caminho);
+    }
+    closedir(dir);
+    CHECAR(arquivos > 0);
+    printf("fuzz: %d arquivos, %d entradas\n", arquivos, arquivos * (32 + MUTACOES_POR_ARQUIVO));
+}
+
+int main(void)
+{
+    testar_get();
+    testar_post();
+    testar_erros();
+    testar_decodificacao();
+    testar_corpus();
+    return teste_resultado("http_parser");
+}
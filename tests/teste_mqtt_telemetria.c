@@ -0,0 +1,314 @@
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "teste.h"
+#include "sdk_simulado.h"
+#include "mqtt_telemetria.h"
+#include "log.h"
+#include "lwip/apps/mqtt.h"
+
+// Fila offline do cliente MQTT contra um broker simulado no lugar do cliente
+// do lwIP: o teste decide quando chegam o CONNACK e cada PUBACK, e derruba a
+// conexão como o lwIP faz (as publicações em andamento somem sem callback).
+// Com QoS 1 nenhum lote pode se perder numa queda; só a fila cheia descarta.
+
+#define PERIODO_MS 1000
+#define EM_ANDAMENTO_MAX 4 // MQTT_REQ_MAX_IN_FLIGHT do lwIP
+#define LOTES_MAX 128
+
+/* ---------- Broker simulado ---------- */
+typedef struct {
+    mqtt_request_cb_t callback;
+    void *arg;
+    uint32_t sequencia;
+} Publicacao;
+
+static struct {
+    mqtt_connection_cb_t ao_conectar;
+    bool conectando;
+    Publicacao em_andamento[EM_ANDAMENTO_MAX]; // Em ordem de envio
+    int quantidade;
+    uint32_t publicacoes;          // Lotes aceitos pelo cliente do lwIP
+    uint8_t recebidos[LOTES_MAX];  // PUBACKs enviados por sequência
+    uint32_t ordem[LOTES_MAX];     // Sequências na ordem das publicações
+} broker;
+
+struct mqtt_client_s {
+    int nada;
+};
+
+int ipaddr_aton(const char *texto, ip_addr_t *endereco)
+{
+    endereco->addr = 0;
+    return texto[0] != '\0';
+}
+
+mqtt_client_t *mqtt_client_new(void)
+{
+    static mqtt_client_t cliente;
+    return &cliente;
+}
+
+err_t mqtt_client_connect(mqtt_client_t *client, const ip_addr_t *ip, u16_t port, mqtt_connection_cb_t cb,
+                          void *arg, const struct mqtt_connect_client_info_t *info)
+{
+    broker.ao_conectar = cb;
+    broker.conectando = true;
+    return ERR_OK;
+}
+
+void mqtt_set_inpub_callback(mqtt_client_t *client, mqtt_incoming_publish_cb_t pub_cb,
+                             mqtt_incoming_data_cb_t data_cb, void *arg)
+{
+}
+
+err_t mqtt_subscribe(mqtt_client_t *client, const char *topic, u8_t qos, mqtt_request_cb_t cb, void *arg)
+{
+    return ERR_OK;
+}
+
+err_t mqtt_publish(mqtt_client_t *client, const char *topic, const void *payload, u16_t payload_length,
+                   u8_t qos, u8_t retain, mqtt_request_cb_t cb, void *arg)
+{
+    if (strstr(topic, "/telemetria") == NULL)
+        return ERR_OK; // Presença
+    if (broker.quantidade == EM_ANDAMENTO_MAX)
+        return ERR_MEM;
+
+    char texto[MQTT_TELEMETRIA_LOTE_MAX + 1];
+    memcpy(texto, payload, payload_length);
+    texto[payload_length] = '\0';
+    const char *seq = strstr(texto, "\"seq\":");
+    CHECAR(seq != NULL);
+    uint32_t sequencia = seq ? (uint32_t)strtoul(seq + 6, NULL, 10) : 0;
+    broker.ordem[broker.publicacoes++ % LOTES_MAX] = sequencia;
+    broker.em_andamento[broker.quantidade++] = (Publicacao){cb, arg, sequencia};
+    return ERR_OK;
+}
+
+static void aceitar_conexao(void)
+{
+    CHECAR(broker.conectando);
+    broker.conectando = false;
+    broker.ao_conectar(NULL, NULL, MQTT_CONNECT_ACCEPTED);
+}
+
+// Queda percebida pelo keep-alive: o lwIP descarta as requisições pendentes
+static void derrubar(void)
+{
+    broker.quantidade = 0;
+    broker.ao_conectar(NULL, NULL, MQTT_CONNECT_DISCONNECTED);
+}
+
+static void concluir(int indice, err_t err)
+{
+    Publicacao p = broker.em_andamento[indice];
+    memmove(&broker.em_andamento[indice], &broker.em_andamento[indice + 1],
+            (broker.quantidade - indice - 1) * sizeof(Publicacao));
+    broker.quantidade--;
+    if (err == ERR_OK && p.sequencia < LOTES_MAX)
+        broker.recebidos[p.sequencia]++;
+    p.callback(p.arg, err);
+}
+
+// PUBACK das @p n publicações mais antigas
+static void confirmar(int n)
+{
+    CHECAR(n <= broker.quantidade);
+    for (int i = 0; i < n && broker.quantidade > 0; i++)
+        concluir(0, ERR_OK);
+}
+
+static void confirmar_sequencia(uint32_t sequencia)
+{
+    for (int i = 0; i < broker.quantidade; i++)
+        if (broker.em_andamento[i].sequencia == sequencia)
+        {
+            concluir(i, ERR_OK);
+            return;
+        }
+    CHECAR(false);
+}
+
+// Timeout das requisições do lwIP (MQTT_REQ_TIMEOUT) sem PUBACK
+static void expirar(void)
+{
+    while (broker.quantidade > 0)
+        concluir(0, ERR_TIMEOUT);
+}
+
+/* ---------- Cliente ---------- */
+static uint32_t sequencia_seguinte;
+
+static void passo(uint32_t ms)
+{
+    sleep_ms(ms);
+    mqtt_telemetria_processar(to_ms_since_boot(get_absolute_time()));
+}
+
+// Fecha @p n lotes de um registro, um por período
+static void fechar_lotes(int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        CHECAR(mqtt_telemetria_adicionar("{\"zona\":0}"));
+        passo(PERIODO_MS);
+        sequencia_seguinte++;
+    }
+}
+
+static MqttEstatisticas estatisticas(void)
+{
+    MqttEstatisticas e;
+    mqtt_telemetria_estatisticas(&e);
+    return e;
+}
+
+static void iniciar(uint8_t qos)
+{
+    static const MqttConfig CONFIG = {"192.168.0.10", 1883, "pico", NULL, NULL, "estufa/pico", PERIODO_MS, 1, NULL};
+    MqttConfig config = CONFIG;
+    config.qos = qos;
+    broker.quantidade = 0;
+    CHECAR(mqtt_telemetria_iniciar(&config));
+    passo(0);
+    aceitar_conexao();
+    CHECAR_IGUAL(estatisticas().estado, MQTT_CONECTADO);
+}
+
+/* ---------- Testes ---------- */
+static void testar_confirmacao(void)
+{
+    MqttEstatisticas antes = estatisticas();
+
+    // O lote fica na fila até o PUBACK
+    fechar_lotes(3);
+    CHECAR_IGUAL(broker.quantidade, 3);
+    CHECAR_IGUAL(estatisticas().fila_offline, 3);
+    confirmar(2);
+    CHECAR_IGUAL(estatisticas().fila_offline, 1);
+
+    // PUBACK fora de ordem: o confirmado espera o mais antigo sair
+    uint32_t primeiro = sequencia_seguinte - 1;
+    fechar_lotes(2);
+    confirmar_sequencia(primeiro + 1);
+    CHECAR_IGUAL(estatisticas().fila_offline, 3);
+    confirmar_sequencia(primeiro);
+    CHECAR_IGUAL(estatisticas().fila_offline, 1);
+    confirmar(1);
+
+    MqttEstatisticas e = estatisticas();
+    CHECAR_IGUAL(e.fila_offline, 0);
+    CHECAR_IGUAL(e.lotes_publicados - antes.lotes_publicados, 5);
+    CHECAR_IGUAL(e.lotes_confirmados - antes.lotes_confirmados, 5);
+    CHECAR_IGUAL(e.lotes_reenviados, antes.lotes_reenviados);
+}
+
+static void testar_queda_sem_puback(void)
+{
+    MqttEstatisticas antes = estatisticas();
+    uint32_t primeiro = sequencia_seguinte;
+
+    // Publicados a um broker que já caiu, antes do keep-alive perceber
+    fechar_lotes(3);
+    CHECAR_IGUAL(broker.quantidade, 3);
+    derrubar();
+    MqttEstatisticas e = estatisticas();
+    CHECAR_IGUAL(e.estado, MQTT_DESCONECTADO);
+    CHECAR_IGUAL(e.fila_offline, 3);
+    CHECAR_IGUAL(e.lotes_reenviados - antes.lotes_reenviados, 3);
+
+    // Mais um durante a queda; ao reconectar vão os quatro, em ordem
+    fechar_lotes(1);
+    passo(MQTT_TELEMETRIA_BACKOFF_INICIAL_MS);
+    aceitar_conexao();
+    uint32_t publicacoes = broker.publicacoes;
+    passo(0);
+    CHECAR_IGUAL(broker.publicacoes - publicacoes, 4);
+    for (uint32_t i = 0; i < 4; i++)
+        CHECAR_IGUAL(broker.ordem[(publicacoes + i) % LOTES_MAX], primeiro + i);
+    confirmar(4);
+
+    e = estatisticas();
+    CHECAR_IGUAL(e.fila_offline, 0);
+    CHECAR_IGUAL(e.lotes_descartados, antes.lotes_descartados);
+    for (uint32_t s = 0; s < sequencia_seguinte; s++)
+        CHECAR_IGUAL(broker.recebidos[s], 1);
+}
+
+static void testar_limite_e_timeout(void)
+{
+    MqttEstatisticas antes = estatisticas();
+
+    // Só EM_ANDAMENTO_MAX com o lwIP; os outros esperam na fila
+    fechar_lotes(EM_ANDAMENTO_MAX + 2);
+    CHECAR_IGUAL(broker.quantidade, EM_ANDAMENTO_MAX);
+    CHECAR_IGUAL(estatisticas().fila_offline, EM_ANDAMENTO_MAX + 2);
+
+    // Sem PUBACK no prazo: os mesmos lotes vão de novo
+    expirar();
+    CHECAR_IGUAL(estatisticas().lotes_reenviados - antes.lotes_reenviados, EM_ANDAMENTO_MAX);
+    passo(0);
+    CHECAR_IGUAL(broker.quantidade, EM_ANDAMENTO_MAX);
+    CHECAR_IGUAL(broker.em_andamento[0].sequencia, sequencia_seguinte - EM_ANDAMENTO_MAX - 2);
+    confirmar(EM_ANDAMENTO_MAX);
+    passo(0);
+    confirmar(2);
+
+    MqttEstatisticas e = estatisticas();
+    CHECAR_IGUAL(e.fila_offline, 0);
+    CHECAR_IGUAL(e.lotes_confirmados - antes.lotes_confirmados, EM_ANDAMENTO_MAX + 2);
+    for (uint32_t s = 0; s < sequencia_seguinte; s++)
+        CHECAR_IGUAL(broker.recebidos[s], 1);
+}
+
+static void testar_fila_cheia(void)
+{
+    MqttEstatisticas antes = estatisticas();
+
+    // Fila cheia perde o mais antigo, mesmo aguardando o PUBACK; o PUBACK
+    // que chega depois não conta
+    fechar_lotes(MQTT_TELEMETRIA_FILA_OFFLINE + 2);
+    CHECAR_IGUAL(estatisticas().fila_offline, MQTT_TELEMETRIA_FILA_OFFLINE);
+    CHECAR_IGUAL(estatisticas().lotes_descartados - antes.lotes_descartados, 2);
+    confirmar(2);
+    CHECAR_IGUAL(estatisticas().lotes_confirmados, antes.lotes_confirmados);
+    CHECAR_IGUAL(estatisticas().fila_offline, MQTT_TELEMETRIA_FILA_OFFLINE);
+
+    while (broker.quantidade > 0)
+    {
+        confirmar(broker.quantidade);
+        passo(0);
+    }
+    MqttEstatisticas e = estatisticas();
+    CHECAR_IGUAL(e.fila_offline, 0);
+    CHECAR_IGUAL(e.lotes_confirmados - antes.lotes_confirmados, MQTT_TELEMETRIA_FILA_OFFLINE);
+}
+
+static void testar_qos0(void)
+{
+    // Sem PUBACK: o lote sai da fila ao ser entregue e não volta numa queda
+    iniciar(0);
+    MqttEstatisticas antes = estatisticas();
+    fechar_lotes(2);
+    CHECAR_IGUAL(estatisticas().fila_offline, 0);
+    confirmar(1); // Enviado pelo TCP
+    derrubar();
+    MqttEstatisticas e = estatisticas();
+    CHECAR_IGUAL(e.fila_offline, 0);
+    CHECAR_IGUAL(e.lotes_publicados - antes.lotes_publicados, 2);
+    CHECAR_IGUAL(e.lotes_confirmados - antes.lotes_confirmados, 1);
+    CHECAR_IGUAL(e.lotes_reenviados, antes.lotes_reenviados);
+}
+
+int main(void)
+{
+    log_nivel = LOG_NADA;
+    iniciar(1);
+    testar_confirmacao();
+    testar_queda_sem_puback();
+    testar_limite_e_timeout();
+    testar_fila_cheia();
+    testar_qos0();
+    return teste_resultado("mqtt_telemetria");
+}
@@ -0,0 +1,417 @@
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "teste.h"
+#include "ota.h"
+#include "sha256.h"
+
+// OTA sobre uma flash emulada na RAM com a semântica da NOR: apagar leva o
+// setor a 0xFF e gravar só zera bits. A emulação confere o alinhamento de
+// cada operação, recusa escritas fora do banco inativo e do registro, e pode
+// cortar a energia no meio de uma operação (só os primeiros bytes feitos,
+// depois falha) para conferir que o bootloader sempre acha uma imagem boa.
+
+/* ---------- Flash emulada ---------- */
+static uint8_t memoria[OTA_FLASH_TAMANHO];
+static int banco_gravavel = -1; // Banco que a aplicação pode gravar; -1 no bootloader
+static int operacoes;
+static int corte_em = -1;    // Operação em que a energia cai
+static uint32_t corte_bytes; // Bytes que ela chega a apagar ou gravar
+static int violacoes;        // Alinhamento errado ou escrita em região proibida
+
+static bool regiao_permitida(uint32_t offset, uint32_t tamanho)
+{
+    if (offset >= OTA_REGISTRO_OFFSET(0) && offset + tamanho <= OTA_REGISTRO_OFFSET(2))
+        return true;
+    if (banco_gravavel < 0)
+        return false;
+    uint32_t inicio = OTA_BANCO_OFFSET(banco_gravavel);
+    return offset >= inicio && offset + tamanho <= inicio + OTA_BANCO_TAMANHO;
+}
+
+static bool energia_caiu(void)
+{
+    return operacoes++ == corte_em;
+}
+
+static bool apagar(uint32_t offset, uint32_t tamanho)
+{
+    if (offset % OTA_SETOR || tamanho % OTA_SETOR || !regiao_permitida(offset, tamanho))
+    {
+        violacoes++;
+        return false;
+    }
+    if (energia_caiu())
+    {
+        memset(memoria + offset, 0xFF, corte_bytes < tamanho ? corte_bytes : tamanho);
+        return false;
+    }
+    memset(memoria + offset, 0xFF, tamanho);
+    return true;
+}
+
+static bool programar(uint32_t offset, const uint8_t *dados, uint32_t tamanho)
+{
+    if (offset % OTA_PAGINA || tamanho % OTA_PAGINA || !regiao_permitida(offset, tamanho))
+    {
+        violacoes++;
+        return false;
+    }
+    bool caiu = energia_caiu();
+    for (uint32_t i = 0; i < tamanho && !(caiu && i >= corte_bytes); i++)
+        memoria[offset + i] &= dados[i];
+    return !caiu;
+}
+
+static const uint8_t *ler(uint32_t offset)
+{
+    return memoria + offset;
+}
+
+static const OtaFlash FLASH = {apagar, programar, ler};
+
+/* ---------- Imagens ---------- */
+#define IMAGEM_MAX 40000
+
+// Conteúdo qualquer com a tabela de vetores de uma imagem linkada para @p banco
+static void gerar_imagem(uint8_t *imagem, size_t tamanho, uint8_t banco, uint8_t semente)
+{
+    for (size_t i = 0; i < tamanho; i++)
+        imagem[i] = (uint8_t)(i * 7 + semente);
+    uint32_t vetores[2] = {0x20042000u, OTA_XIP_BASE + OTA_BANCO_OFFSET(banco) + 0x1F7};
+    memcpy(imagem + OTA_VETORES, vetores, sizeof(vetores));
+}
+
+static void resumir(const uint8_t *dados, size_t tamanho, uint8_t resumo[SHA256_TAMANHO])
+{
+    Sha256 sha;
+    sha256_iniciar(&sha);
+    sha256_atualizar(&sha, dados, tamanho);
+    sha256_finalizar(&sha, resumo);
+}
+
+// Gravação pela USB: a imagem direto no banco, sem registro
+static void gravar_pela_usb(uint8_t banco, uint8_t semente)
+{
+    static uint8_t imagem[IMAGEM_MAX];
+    gerar_imagem(imagem, sizeof(imagem), banco, semente);
+    memcpy(memoria + OTA_BANCO_OFFSET(banco), imagem, sizeof(imagem));
+}
+
+// Boot: o bootloader escolhe o banco e a aplicação dele inicia o OTA
+static uint8_t reiniciar(void)
+{
+    banco_gravavel = -1;
+    uint8_t banco = ota_escolher_banco(&FLASH);
+    ota_iniciar(&FLASH, OTA_BANCO_OFFSET(banco));
+    banco_gravavel = !banco;
+    return banco;
+}
+
+// Download inteiro em blocos de @p bloco bytes, como os segmentos TCP
+static OtaResultado enviar(const uint8_t *imagem, size_t tamanho, const uint8_t resumo[SHA256_TAMANHO], size_t bloco)
+{
+    OtaResultado resultado = ota_download_iniciar(tamanho, resumo);
+    for (size_t i = 0; i < tamanho && resultado == OTA_OK; i += bloco)
+        resultado = ota_download_escrever(imagem + i, tamanho - i < bloco ? tamanho - i : bloco);
+    return resultado == OTA_OK ? ota_download_concluir() : resultado;
+}
+
+static OtaRegistro registro(void)
+{
+    OtaRegistro r;
+    memset(&r, 0, sizeof(r));
+    CHECAR(ota_ler_registro(&FLASH, &r));
+    return r;
+}
+
+/* ---------- SHA-256 ---------- */
+static bool resumo_igual(const uint8_t resumo[SHA256_TAMANHO], const char *hex)
+{
+    char texto[2 * SHA256_TAMANHO + 1];
+    for (int i = 0; i < SHA256_TAMANHO; i++)
+        snprintf(texto + 2 * i, 3, "%02x", resumo[i]);
+    return strcmp(texto, hex) == 0;
+}
+
+static void testar_sha256(void)
+{
+    // Vetores do FIPS 180-2, inclusive as mensagens que cruzam o bloco de 64
+    uint8_t resumo[SHA256_TAMANHO];
+    resumir((const uint8_t *)"", 0, resumo);
+    CHECAR(resumo_igual(resumo, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+    resumir((const uint8_t *)"abc", 3, resumo);
+    CHECAR(resumo_igual(resumo, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+    const char *dois_blocos = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    resumir((const uint8_t *)dois_blocos, strlen(dois_blocos), resumo);
+    CHECAR(resumo_igual(resumo, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+
+    // Um milhão de 'a', em blocos de tamanho variado
+    static uint8_t as[1000000];
+    memset(as, 'a', sizeof(as));
+    Sha256 sha;
+    sha256_iniciar(&sha);
+    for (size_t i = 0, n = 1; i < sizeof(as); i += n, n = n % 97 + 1)
+        sha256_atualizar(&sha, as + i, sizeof(as) - i < n ? sizeof(as) - i : n);
+    sha256_finalizar(&sha, resumo);
+    CHECAR(resumo_igual(resumo, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+
+    // Incremental igual ao de uma vez em todos os tamanhos perto do bloco
+    uint8_t inteiro[SHA256_TAMANHO], partes[SHA256_TAMANHO];
+    for (size_t tamanho = 50; tamanho <= 130; tamanho++)
+    {
+        resumir(as, tamanho, inteiro);
+        sha256_iniciar(&sha);
+        sha256_atualizar(&sha, as, tamanho / 3);
+        sha256_atualizar(&sha, as, 0);
+        sha256_atualizar(&sha, as + tamanho / 3, tamanho - tamanho / 3);
+        sha256_finalizar(&sha, partes);
+        CHECAR(memcmp(inteiro, partes, SHA256_TAMANHO) == 0);
+    }
+}
+
+/* ---------- OTA ---------- */
+static uint8_t imagem[IMAGEM_MAX];
+static uint8_t resumo[SHA256_TAMANHO];
+
+static void testar_boot_sem_registro(void)
+{
+    // Flash apagada: nada a escolher, o bootloader fica no A (e cai na USB)
+    memset(memoria, 0xFF, sizeof(memoria));
+    CHECAR_IGUAL(ota_escolher_banco(&FLASH), OTA_BANCO_A);
+
+    // Só o B gravado: cai no B; com o A também, o A vale
+    gravar_pela_usb(OTA_BANCO_B, 1);
+    CHECAR_IGUAL(ota_escolher_banco(&FLASH), OTA_BANCO_B);
+    gravar_pela_usb(OTA_BANCO_A, 2);
+    CHECAR_IGUAL(reiniciar(), OTA_BANCO_A);
+
+    // Sem registro a imagem da USB vale como confirmada
+    OtaEstatisticas e;
+    ota_estatisticas(&e);
+    CHECAR_IGUAL(e.banco, OTA_BANCO_A);
+    CHECAR_IGUAL(e.estado, OTA_CONFIRMADO);
+    CHECAR(!e.em_teste);
+    OtaRegistro r;
+    CHECAR(!ota_ler_registro(&FLASH, &r));
+}
+
+static void testar_recusas(void)
+{
+    OtaEstatisticas antes, e;
+    ota_estatisticas(&antes);
+    gerar_imagem(imagem, 20000, OTA_BANCO_B, 3);
+    resumir(imagem, 20000, resumo);
+
+    CHECAR_IGUAL(ota_download_iniciar(0, resumo), OTA_ERRO_TAMANHO);
+    CHECAR_IGUAL(ota_download_iniciar(OTA_BANCO_TAMANHO + 1, resumo), OTA_ERRO_TAMANHO);
+    CHECAR_IGUAL(ota_download_escrever(imagem, 10), OTA_ERRO_INCOMPLETO);
+
+    // Só um download por vez, sem derrubar o que está em andamento
+    CHECAR_IGUAL(ota_download_iniciar(20000, resumo), OTA_OK);
+    CHECAR_IGUAL(ota_download_iniciar(20000, resumo), OTA_ERRO_OCUPADO);
+    CHECAR_IGUAL(ota_download_escrever(imagem, 19000), OTA_OK);
+    CHECAR_IGUAL(ota_download_concluir(), OTA_ERRO_INCOMPLETO);
+
+    // Mais bytes que o anunciado
+    CHECAR_IGUAL(ota_download_iniciar(20000, resumo), OTA_OK);
+    CHECAR_IGUAL(ota_download_escrever(imagem, 20000), OTA_OK);
+    CHECAR_IGUAL(ota_download_escrever(imagem, 1), OTA_ERRO_TAMANHO);
+
+    // Resumo diferente do anunciado
+    uint8_t outro[SHA256_TAMANHO];
+    memcpy(outro, resumo, sizeof(outro));
+    outro[31] ^= 1;
+    CHECAR_IGUAL(enviar(imagem, 20000, outro, 1460), OTA_ERRO_HASH);
+
+    // Imagem linkada para o banco em execução
+    gerar_imagem(imagem, 20000, OTA_BANCO_A, 3);
+    resumir(imagem, 20000, outro);
+    CHECAR_IGUAL(enviar(imagem, 20000, outro, 1460), OTA_ERRO_IMAGEM);
+
+    // Abortado no meio
+    CHECAR_IGUAL(ota_download_iniciar(20000, resumo), OTA_OK);
+    ota_download_abortar();
+    ota_estatisticas(&e);
+    CHECAR(!e.baixando);
+    CHECAR_IGUAL(e.falhas - antes.falhas, 7);
+    CHECAR_IGUAL(e.downloads, antes.downloads);
+
+    // Nada disso criou registro: o boot continua no A
+    OtaRegistro r;
+    CHECAR(!ota_ler_registro(&FLASH, &r));
+    CHECAR_IGUAL(reiniciar(), OTA_BANCO_A);
+}
+
+static void testar_atualizacao_confirmada(void)
+{
+    // Tamanho que não fecha página nem setor, em blocos irregulares
+    size_t tamanho = 3 * OTA_SETOR + OTA_PAGINA + 77;
+    gerar_imagem(imagem, tamanho, OTA_BANCO_B, 4);
+    resumir(imagem, tamanho, resumo);
+    uint8_t banco_a[IMAGEM_MAX];
+    memcpy(banco_a, memoria + OTA_BANCO_OFFSET(OTA_BANCO_A), sizeof(banco_a));
+
+    static const size_t BLOCOS[] = {1, 255, 256, 257, 1460, 4096, 4097};
+    CHECAR_IGUAL(ota_download_iniciar(tamanho, resumo), OTA_OK);
+    for (size_t i = 0, b = 0; i < tamanho; b = (b + 1) % count_of(BLOCOS))
+    {
+        size_t n = tamanho - i < BLOCOS[b] ? tamanho - i : BLOCOS[b];
+        CHECAR_IGUAL(ota_download_escrever(imagem + i, n), OTA_OK);
+        i += n;
+    }
+    CHECAR_IGUAL(ota_download_concluir(), OTA_OK);
+
+    // Imagem no banco B, resto da página apagado, banco A intacto
+    CHECAR(memcmp(memoria + OTA_BANCO_OFFSET(OTA_BANCO_B), imagem, tamanho) == 0);
+    CHECAR_IGUAL(memoria[OTA_BANCO_OFFSET(OTA_BANCO_B) + tamanho], 0xFF);
+    CHECAR(memcmp(memoria + OTA_BANCO_OFFSET(OTA_BANCO_A), banco_a, sizeof(banco_a)) == 0);
+    OtaRegistro r = registro();
+    CHECAR_IGUAL(r.estado, OTA_TESTE);
+    CHECAR_IGUAL(r.banco, OTA_BANCO_B);
+    CHECAR_IGUAL(r.banco_anterior, OTA_BANCO_A);
+    CHECAR_IGUAL(r.tamanho, tamanho);
+
+    // Primeiro boot: a imagem nova em teste, que não aceita outro download
+    CHECAR_IGUAL(reiniciar(), OTA_BANCO_B);
+    CHECAR_IGUAL(registro().tentativas, 1);
+    OtaEstatisticas e;
+    ota_estatisticas(&e);
+    CHECAR(e.em_teste);
+    CHECAR_IGUAL(ota_download_iniciar(tamanho, resumo), OTA_ERRO_EM_TESTE);
+
+    // Confirmada, fica nos boots seguintes
+    CHECAR(ota_confirmar());
+    CHECAR_IGUAL(registro().estado, OTA_CONFIRMADO);
+    for (int i = 0; i < 3; i++)
+        CHECAR_IGUAL(reiniciar(), OTA_BANCO_B);
+    CHECAR_IGUAL(registro().estado, OTA_CONFIRMADO);
+}
+
+static void testar_reversao(void)
+{
+    // Imagem nova no A que não se confirma: o boot seguinte volta ao B
+    size_t tamanho = 30000;
+    gerar_imagem(imagem, tamanho, OTA_BANCO_A, 5);
+    resumir(imagem, tamanho, resumo);
+    CHECAR_IGUAL(enviar(imagem, tamanho, resumo, 1460), OTA_OK);
+    CHECAR_IGUAL(reiniciar(), OTA_BANCO_A);
+    CHECAR_IGUAL(reiniciar(), OTA_BANCO_B);
+    OtaRegistro r = registro();
+    CHECAR_IGUAL(r.estado, OTA_REVERTIDO);
+    CHECAR_IGUAL(r.banco, OTA_BANCO_B);
+    OtaEstatisticas e;
+    ota_estatisticas(&e);
+    CHECAR(!e.em_teste);
+    CHECAR_IGUAL(e.estado, OTA_REVERTIDO);
+    CHECAR_IGUAL(reiniciar(), OTA_BANCO_B);
+
+    // Banco corrompido depois do download: o resumo do primeiro boot reverte
+    // sem executar a imagem
+    CHECAR_IGUAL(enviar(imagem, tamanho, resumo, 1000), OTA_OK);
+    memoria[OTA_BANCO_OFFSET(OTA_BANCO_A) + 9000] ^= 0x10;
+    CHECAR_IGUAL(reiniciar(), OTA_BANCO_B);
+    CHECAR_IGUAL(registro().estado, OTA_REVERTIDO);
+
+    // A tabela de vetores apagada também
+    CHECAR_IGUAL(enviar(imagem, tamanho, resumo, 1000), OTA_OK);
+    memset(memoria + OTA_BANCO_OFFSET(OTA_BANCO_A) + OTA_VETORES, 0xFF, 8);
+    CHECAR_IGUAL(reiniciar(), OTA_BANCO_B);
+    CHECAR_IGUAL(registro().estado, OTA_REVERTIDO);
+}
+
+static void testar_registro(void)
+{
+    // Sequências crescentes alternando os dois setores
+    OtaRegistro r = registro();
+    uint32_t sequencia = r.sequencia;
+    banco_gravavel = -1;
+    for (int i = 1; i <= 4; i++)
+    {
+        CHECAR(ota_gravar_registro(&FLASH, &r));
+        CHECAR_IGUAL(r.sequencia, sequencia + i);
+        OtaRegistro copia;
+        memcpy(&copia, memoria + OTA_REGISTRO_OFFSET(r.sequencia % 2), sizeof(copia));
+        CHECAR_IGUAL(copia.sequencia, r.sequencia);
+    }
+
+    // Energia cortada no apagamento ou em qualquer ponto da gravação: vale a
+    // cópia anterior, a menos que a nova tenha chegado inteira
+    for (int corte = 0; corte < 2; corte++)
+        for (corte_bytes = 0; corte_bytes <= OTA_PAGINA; corte_bytes += 4)
+        {
+            OtaRegistro antes = registro(), novo = antes;
+            novo.estado = antes.estado == OTA_TESTE ? OTA_CONFIRMADO : OTA_TESTE;
+            operacoes = 0;
+            corte_em = corte;
+            CHECAR(!ota_gravar_registro(&FLASH, &novo));
+            corte_em = -1;
+            r = registro();
+            bool completa = corte == 1 && corte_bytes >= sizeof(OtaRegistro);
+            CHECAR_IGUAL(r.sequencia, antes.sequencia + completa);
+            CHECAR_IGUAL(r.estado, completa ? novo.estado : antes.estado);
+        }
+    corte_bytes = 0;
+
+    // As duas cópias corrompidas: sem registro
+    memoria[OTA_REGISTRO_OFFSET(0) + 8] ^= 1;
+    memoria[OTA_REGISTRO_OFFSET(1) + 8] ^= 1;
+    CHECAR(!ota_ler_registro(&FLASH, &r));
+    memoria[OTA_REGISTRO_OFFSET(0) + 8] ^= 1;
+    memoria[OTA_REGISTRO_OFFSET(1) + 8] ^= 1;
+}
+
+static void testar_corte_de_energia(void)
+{
+    // Uma atualização completa do B para o A, cortada em cada operação de
+    // flash: o banco em execução e o registro anterior sempre sobram
+    static uint8_t copia[OTA_FLASH_TAMANHO];
+    CHECAR_IGUAL(reiniciar(), OTA_BANCO_B);
+    memcpy(copia, memoria, sizeof(copia));
+    OtaRegistro antes = registro();
+
+    size_t tamanho = 2 * OTA_SETOR + 300;
+    gerar_imagem(imagem, tamanho, OTA_BANCO_A, 6);
+    resumir(imagem, tamanho, resumo);
+    operacoes = 0;
+    CHECAR_IGUAL(enviar(imagem, tamanho, resumo, 1460), OTA_OK);
+    int total = operacoes;
+
+    for (int corte = 0; corte < total; corte++)
+    {
+        memcpy(memoria, copia, sizeof(memoria));
+        ota_iniciar(&FLASH, OTA_BANCO_OFFSET(OTA_BANCO_B));
+        operacoes = 0;
+        corte_em = corte;
+        CHECAR_IGUAL(enviar(imagem, tamanho, resumo, 1460), OTA_ERRO_FLASH);
+        corte_em = -1;
+        CHECAR_IGUAL(registro().sequencia, antes.sequencia);
+        CHECAR_IGUAL(reiniciar(), OTA_BANCO_B);
+    }
+
+    // Cortada na confirmação: a imagem nova volta atrás no boot seguinte
+    memcpy(memoria, copia, sizeof(memoria));
+    ota_iniciar(&FLASH, OTA_BANCO_OFFSET(OTA_BANCO_B));
+    CHECAR_IGUAL(enviar(imagem, tamanho, resumo, 1460), OTA_OK);
+    CHECAR_IGUAL(reiniciar(), OTA_BANCO_A);
+    operacoes = 0;
+    corte_em = 1;
+    CHECAR(!ota_confirmar());
+    corte_em = -1;
+    CHECAR_IGUAL(registro().estado, OTA_TESTE);
+    CHECAR_IGUAL(reiniciar(), OTA_BANCO_B);
+    CHECAR_IGUAL(registro().estado, OTA_REVERTIDO);
+}
+
+int main(void)
+{
+    testar_sha256();
+    testar_boot_sem_registro();
+    testar_recusas();
+    testar_atualizacao_confirmada();
+    testar_reversao();
+    testar_registro();
+    testar_corte_de_energia();
+    CHECAR_IGUAL(violacoes, 0);
+    return teste_resultado("ota");
+}
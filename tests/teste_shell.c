@@ -0,0 +1,299 @@
+#define _POSIX_C_SOURCE 200809L
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "pico/stdlib.h"
+#include "teste.h"
+#include "shell.h"
+#include "log.h"
+
+// Shell serial: os bytes entram por shell_receber(), como na interrupção, e
+// shell_processar() monta e executa as linhas sobre uma tabela no formato da
+// de main.c. A saída (printf) é capturada para conferir as respostas.
+
+/* ---------- Comandos de teste ---------- */
+static int chamadas;
+static int ultimo_argc;
+static char ultimo_argv[SHELL_ARGS_MAX][SHELL_LINHA_MAX];
+static float setpoint;
+
+static void registrar(int argc, char **argv)
+{
+    chamadas++;
+    ultimo_argc = argc;
+    for (int i = 0; i < argc; i++)
+        snprintf(ultimo_argv[i], sizeof(ultimo_argv[i]), "%s", argv[i]);
+}
+
+static void cmd_setpoint(int argc, char **argv)
+{
+    registrar(argc, argv);
+    if (!shell_ler_float(argv[1], -20.0f, 80.0f, &setpoint))
+        shell_erro("setpoint de -20 a 80 C\n");
+    else
+        shell_escrever("setpoint %.2f\n", setpoint);
+}
+
+static void cmd_modo(int argc, char **argv)
+{
+    static const char *const MODOS[] = {"auto", "manual", "desligado", NULL};
+    registrar(argc, argv);
+    if (argc > 1 && shell_ler_opcao(argv[1], MODOS) < 0)
+        shell_erro("modo invalido: %s\n", argv[1]);
+}
+
+static const ShellComando COMANDOS[] = {
+    {"sp", "<C> [taxa C/min]  setpoint", 1, 2, cmd_setpoint},
+    {"modo", "[auto|manual|desligado]", 0, 1, cmd_modo},
+    {"stats", "estado", 0, 0, registrar},
+};
+
+// Como o cmd_padrao de main.c: um número solto altera o setpoint
+static void cmd_padrao(int argc, char **argv)
+{
+    float valor;
+    if (argc == 1 && shell_ler_float(argv[0], -INFINITY, INFINITY, &valor))
+        cmd_setpoint(2, (char *[]){"sp", argv[0], NULL});
+    else
+        shell_erro("comando desconhecido: %s (digite ajuda)\n", argv[0]);
+}
+
+/* ---------- Entrada e saída ---------- */
+static void receber(const char *texto)
+{
+    for (const char *c = texto; *c; c++)
+        shell_receber((uint8_t)*c);
+}
+
+// Processa o que foi recebido e devolve o que o shell escreveu
+static const char *processar(void)
+{
+    static char saida[2048];
+    fflush(stdout);
+    FILE *arquivo = tmpfile();
+    int original = dup(STDOUT_FILENO);
+    dup2(fileno(arquivo), STDOUT_FILENO);
+
+    shell_processar();
+
+    fflush(stdout);
+    dup2(original, STDOUT_FILENO);
+    close(original);
+    rewind(arquivo);
+    size_t n = fread(saida, 1, sizeof(saida) - 1, arquivo);
+    saida[n] = '\0';
+    fclose(arquivo);
+    return saida;
+}
+
+static const char *linha(const char *texto)
+{
+    receber(texto);
+    return processar();
+}
+
+static ShellEstatisticas estatisticas(void)
+{
+    ShellEstatisticas e;
+    shell_estatisticas(&e);
+    return e;
+}
+
+/* ---------- Testes ---------- */
+static void testar_linhas(void)
+{
+    ShellEstatisticas antes = estatisticas();
+
+    // CR, LF e CRLF terminam uma linha só; espaços e tabs separam argumentos
+    chamadas = 0;
+    CHECAR(strstr(linha("sp 25,5\r"), "setpoint 25.50") != NULL);
+    CHECAR(strcmp(linha("\n"), "") == 0);
+    linha("  sp\t30   1,5 \r\n");
+    CHECAR_IGUAL(chamadas, 2);
+    CHECAR_IGUAL(ultimo_argc, 3);
+    CHECAR(strcmp(ultimo_argv[0], "sp") == 0);
+    CHECAR(strcmp(ultimo_argv[1], "30") == 0);
+    CHECAR(strcmp(ultimo_argv[2], "1,5") == 0);
+
+    // Linhas vazias não contam
+    linha("\r\n\n   \t\r");
+    CHECAR_IGUAL(estatisticas().linhas - antes.linhas, 2);
+
+    // Uma linha partida entre duas interrupções é executada inteira
+    chamadas = 0;
+    receber("st");
+    CHECAR(strcmp(processar(), "") == 0);
+    CHECAR_IGUAL(chamadas, 0);
+    linha("ats\n");
+    CHECAR_IGUAL(chamadas, 1);
+    CHECAR(strcmp(ultimo_argv[0], "stats") == 0);
+
+    // Backspace (BS ou DEL) apaga o último caractere; no início não faz nada
+    linha("\b\x7fspx\b 4\x7f" "12\n");
+    CHECAR(strcmp(ultimo_argv[0], "sp") == 0);
+    CHECAR(strcmp(ultimo_argv[1], "12") == 0);
+    CHECAR(setpoint == 12.0f);
+    CHECAR_IGUAL(estatisticas().erros, antes.erros);
+}
+
+static void testar_erros(void)
+{
+    shell_iniciar(COMANDOS, count_of(COMANDOS), NULL);
+    ShellEstatisticas antes = estatisticas();
+    chamadas = 0;
+
+    // Sem o padrão, o que não é comando é erro
+    CHECAR(strstr(linha("42\n"), "ERRO: comando desconhecido: 42") != NULL);
+
+    // Quantidade de argumentos conferida antes de chamar a função
+    CHECAR(strstr(linha("sp\n"), "ERRO: uso: sp <C>") != NULL);
+    CHECAR(strstr(linha("sp 1 2 3\n"), "ERRO: uso: sp") != NULL);
+    CHECAR(strstr(linha("stats agora\n"), "ERRO: uso: stats") != NULL);
+    CHECAR_IGUAL(chamadas, 0);
+
+    // Mais de SHELL_ARGS_MAX palavras
+    CHECAR(strstr(linha("sp 1 2 3 4 5 6\n"), "ERRO: argumentos demais") != NULL);
+    CHECAR_IGUAL(chamadas, 0);
+    linha("modo a b c d e\n"); // Exatamente SHELL_ARGS_MAX: chega ao uso
+    CHECAR_IGUAL(chamadas, 0);
+
+    // Erro vindo da função do comando
+    CHECAR(strstr(linha("modo turbo\n"), "ERRO: modo invalido: turbo") != NULL);
+    CHECAR(strcmp(linha("modo manual\n"), "") == 0);
+    CHECAR_IGUAL(chamadas, 2);
+
+    CHECAR_IGUAL(estatisticas().erros - antes.erros, 7);
+
+    // Silenciado (saída binária): nada escrito, mas o erro ainda conta
+    log_silenciado = true;
+    CHECAR(strcmp(linha("xyz\n"), "") == 0);
+    CHECAR(strcmp(linha("sp 20\n"), "") == 0);
+    log_silenciado = false;
+    CHECAR(setpoint == 20.0f);
+    CHECAR_IGUAL(estatisticas().erros - antes.erros, 8);
+}
+
+static void testar_padrao_e_ajuda(void)
+{
+    shell_iniciar(COMANDOS, count_of(COMANDOS), cmd_padrao);
+    ShellEstatisticas antes = estatisticas();
+
+    // Número solto vira setpoint, inclusive zero e negativos
+    CHECAR(strstr(linha("0\n"), "setpoint 0.00") != NULL);
+    CHECAR(setpoint == 0.0f);
+    linha("-5,5\n");
+    CHECAR(setpoint == -5.5f);
+    CHECAR(strstr(linha("100\n"), "ERRO: setpoint") != NULL);
+    CHECAR(strstr(linha("temperatura\n"), "ERRO: comando desconhecido: temperatura") != NULL);
+    CHECAR(strstr(linha("25 30\n"), "ERRO: comando desconhecido: 25") != NULL);
+    CHECAR_IGUAL(estatisticas().erros - antes.erros, 3);
+
+    // Ajuda embutida, com os dois nomes
+    const char *saida = linha("ajuda\n");
+    CHECAR(strstr(saida, "  ajuda\n") != NULL);
+    CHECAR(strstr(saida, "  sp <C> [taxa C/min]  setpoint\n") != NULL);
+    CHECAR(strstr(saida, "  stats estado\n") != NULL);
+    CHECAR(strstr(linha("?\n"), "  modo [auto|manual|desligado]\n") != NULL);
+    CHECAR_IGUAL(estatisticas().erros - antes.erros, 3);
+}
+
+static void testar_linha_longa(void)
+{
+    ShellEstatisticas antes = estatisticas();
+    chamadas = 0;
+
+    // A maior linha aceita: SHELL_LINHA_MAX - 1 caracteres
+    char texto[3 * SHELL_LINHA_MAX];
+    memset(texto, ' ', SHELL_LINHA_MAX - 1);
+    memcpy(texto, "stats", 5);
+    strcpy(texto + SHELL_LINHA_MAX - 1, "\n");
+    linha(texto);
+    CHECAR_IGUAL(chamadas, 1);
+
+    // Uma além é descartada inteira, sem executar o começo
+    memset(texto, ' ', SHELL_LINHA_MAX);
+    memcpy(texto, "stats", 5);
+    strcpy(texto + SHELL_LINHA_MAX, "x\n");
+    CHECAR(strstr(linha(texto), "ERRO: linha com mais de 63 caracteres") != NULL);
+    CHECAR_IGUAL(chamadas, 1);
+    CHECAR_IGUAL(estatisticas().linhas_longas - antes.linhas_longas, 1);
+
+    // A seguinte volta ao normal
+    linha("stats\n");
+    CHECAR_IGUAL(chamadas, 2);
+}
+
+static void testar_buffer_cheio(void)
+{
+    ShellEstatisticas antes = estatisticas();
+    chamadas = 0;
+
+    // Linhas até encher o buffer sem o consumidor rodar: o excesso é descartado
+    int linhas = SHELL_RX_CAPACIDADE / 6; // "stats\n"
+    for (int i = 0; i < linhas; i++)
+        receber("stats\n");
+    receber("stats\n"); // Só parte cabe
+    receber("\n");      // Perdido: a linha parcial fica à espera
+    int excesso = 6 * (linhas + 1) + 1 - SHELL_RX_CAPACIDADE;
+    CHECAR_IGUAL(estatisticas().bytes_descartados - antes.bytes_descartados, excesso);
+    processar();
+    CHECAR_IGUAL(chamadas, linhas);
+
+    // O resto parcial ("st...") se junta com a próxima linha, como na serial
+    linha("\n");
+    CHECAR_IGUAL(estatisticas().erros, antes.erros + 1);
+
+    // Com o consumidor acompanhando, os índices dão várias voltas sem perdas
+    chamadas = 0;
+    for (int i = 0; i < 10 * SHELL_RX_CAPACIDADE / 6; i++)
+        linha("stats\n");
+    CHECAR_IGUAL(chamadas, 10 * SHELL_RX_CAPACIDADE / 6);
+    CHECAR_IGUAL(estatisticas().bytes_descartados - antes.bytes_descartados, excesso);
+}
+
+static void testar_conversoes(void)
+{
+    float f = -1.0f;
+    CHECAR(shell_ler_float("25,5", 0.0f, 80.0f, &f) && f == 25.5f);
+    CHECAR(shell_ler_float("0", 0.0f, 80.0f, &f) && f == 0.0f);
+    CHECAR(shell_ler_float("-0.5", -1.0f, 80.0f, &f) && f == -0.5f);
+    CHECAR(shell_ler_float("80", 0.0f, 80.0f, &f) && f == 80.0f);
+    f = -1.0f;
+    CHECAR(!shell_ler_float("80.01", 0.0f, 80.0f, &f));
+    CHECAR(!shell_ler_float("-0.5", 0.0f, 80.0f, &f));
+    CHECAR(!shell_ler_float("", 0.0f, 80.0f, &f));
+    CHECAR(!shell_ler_float("12abc", 0.0f, 80.0f, &f));
+    CHECAR(!shell_ler_float("1,5,2", 0.0f, 80.0f, &f));
+    CHECAR(!shell_ler_float("nan", -INFINITY, INFINITY, &f));
+    CHECAR(!shell_ler_float("1234567890123456789012345", -INFINITY, INFINITY, &f));
+    CHECAR(f == -1.0f); // Intacto nas recusas
+
+    int i = -1;
+    CHECAR(shell_ler_int("3", 1, 4, &i) && i == 3);
+    CHECAR(shell_ler_int("-2", -5, 5, &i) && i == -2);
+    i = -1;
+    CHECAR(!shell_ler_int("5", 1, 4, &i));
+    CHECAR(!shell_ler_int("", 1, 4, &i));
+    CHECAR(!shell_ler_int("2,5", 1, 4, &i));
+    CHECAR(!shell_ler_int("99999999999", 1, 4, &i));
+    CHECAR(i == -1);
+
+    static const char *const OPCOES[] = {"nada", "erro", "aviso", NULL};
+    CHECAR_IGUAL(shell_ler_opcao("nada", OPCOES), 0);
+    CHECAR_IGUAL(shell_ler_opcao("aviso", OPCOES), 2);
+    CHECAR_IGUAL(shell_ler_opcao("Aviso", OPCOES), -1);
+    CHECAR_IGUAL(shell_ler_opcao("", OPCOES), -1);
+}
+
+int main(void)
+{
+    shell_iniciar(COMANDOS, count_of(COMANDOS), NULL);
+    testar_linhas();
+    testar_erros();
+    testar_padrao_e_ajuda();
+    testar_linha_longa();
+    testar_buffer_cheio();
+    testar_conversoes();
+    return teste_resultado("shell");
+}
@@ -0,0 +1,232 @@
+#include <string.h>
+#include "teste.h"
+#include "widget.h"
+
+// Conta os redesenhos da camada de widgets em cenários das telas de main.c
+// e os bytes que sairiam pelo I2C a cada quadro. Usa o ssd1306.c real; só a
+// fila I2C é trocada por um contador.
+
+i2c_inst_t i2c0_inst, i2c1_inst;
+
+static uint32_t bytes_enviados;
+
+bool i2c_fila_enviar(i2c_inst_t *i2c, I2CTransacao *cadeia)
+{
+    (void)i2c;
+    for (I2CTransacao *t = cadeia; t; t = t->proxima)
+        bytes_enviados += t->escrita_len;
+    cadeia->status = I2C_FILA_OK;
+    return true;
+}
+
+I2CFilaStatus i2c_fila_aguardar(I2CTransacao *cadeia)
+{
+    return cadeia->status;
+}
+
+int i2c_fila_escrever(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *dados, size_t len)
+{
+    (void)i2c;
+    (void)endereco;
+    (void)dados;
+    return (int)len;
+}
+
+static ssd1306_t ssd;
+
+// Um quadro do laço de display: desenha os sujos e envia a região alterada.
+// Retorna os widgets redesenhados; os bytes ficam em bytes_enviados.
+static int quadro(Tela *tela)
+{
+    bytes_enviados = 0;
+    int redesenhados = tela_desenhar(&ssd, tela);
+    ssd1306_send_data(&ssd);
+    return redesenhados;
+}
+
+static void testar_tela_estatica(void)
+{
+    // Menu de configuração: só rótulos fixos
+    Widget widgets[] = {
+        {.tipo = WIDGET_ROTULO, .x = 0, .y = 0, .inicial = "Menu"},
+        {.tipo = WIDGET_ROTULO, .x = 10, .y = 16, .inicial = "Ajustar Setpoint"},
+        {.tipo = WIDGET_ROTULO, .x = 10, .y = 48, .inicial = "Voltar"},
+        {.tipo = WIDGET_ROTULO, .x = 0, .y = 16},
+    };
+    Tela tela = {widgets, count_of(widgets), 0};
+
+    tela_mostrar(&ssd, &tela);
+    widget_texto(&widgets[3], ">");
+    CHECAR_IGUAL(quadro(&tela), 4);
+    CHECAR(bytes_enviados > 0);
+
+    for (int i = 0; i < 100; i++)
+    {
+        widget_texto(&widgets[3], ">"); // O laço reaplica o cursor a cada quadro
+        CHECAR_IGUAL(quadro(&tela), 0);
+        CHECAR_IGUAL(bytes_enviados, 0);
+    }
+    CHECAR_IGUAL(tela.redesenhos, 4);
+
+    // Cursor muda de linha: só ele é redesenhado
+    widget_texto(&widgets[3], " ");
+    CHECAR_IGUAL(quadro(&tela), 1);
+    CHECAR(bytes_enviados > 0);
+    CHECAR_IGUAL(widgets[3].redesenhos, 2);
+    CHECAR_IGUAL(widgets[1].redesenhos, 1);
+}
+
+static void testar_valor(void)
+{
+    Widget widgets[] = {
+        {.tipo = WIDGET_VALOR, .x = 0, .y = 0, .fonte = &ssd1306_font_numbers, .formato = "%.1f°C"},
+        {.tipo = WIDGET_VALOR, .x = 0, .y = 18, .formato = "Setpoint: %.1f°C"},
+    };
+    Tela tela = {widgets, count_of(widgets), 0};
+
+    tela_mostrar(&ssd, &tela);
+    widget_valor(&widgets[0], 25.0f);
+    widget_valor(&widgets[1], 30.0f);
+    CHECAR_IGUAL(quadro(&tela), 2);
+
+    // Ruído abaixo da resolução exibida: o texto formatado não muda
+    widget_valor(&widgets[0], 25.01f);
+    widget_valor(&widgets[0], 25.04f);
+    widget_valor(&widgets[1], 30.0f);
+    CHECAR_IGUAL(quadro(&tela), 0);
+    CHECAR_IGUAL(bytes_enviados, 0);
+
+    widget_valor(&widgets[0], 25.2f);
+    CHECAR_IGUAL(quadro(&tela), 1);
+    CHECAR_IGUAL(widgets[0].redesenhos, 2);
+    CHECAR_IGUAL(widgets[1].redesenhos, 1);
+
+    // Sem leitura: "--" troca o texto; voltar ao mesmo número redesenha
+    widget_texto(&widgets[0], "--");
+    CHECAR_IGUAL(quadro(&tela), 1);
+    widget_valor(&widgets[0], 25.2f);
+    CHECAR_IGUAL(quadro(&tela), 1);
+    CHECAR(strcmp(widgets[0].texto, "25.2°C") == 0);
+
+    // Texto mais curto apaga a sobra do anterior
+    widget_valor(&widgets[0], 5.0f);
+    CHECAR_IGUAL(quadro(&tela), 1);
+    CHECAR(widgets[0].desenhado_largura < ssd1306_text_width(&ssd1306_font_numbers, "25.2°C"));
+}
+
+static void testar_barra(void)
+{
+    Widget widgets[] = {
+        {.tipo = WIDGET_BARRA, .x = 120, .y = 16, .largura = 8, .altura = 48, .minimo = 0.0f, .maximo = 100.0f},
+    };
+    Tela tela = {widgets, count_of(widgets), 0};
+
+    tela_mostrar(&ssd, &tela);
+    widget_barra(&widgets[0], 50.0f);
+    CHECAR_IGUAL(quadro(&tela), 1);
+    CHECAR_IGUAL(widgets[0].nivel, 24);
+
+    // 50% a 50.5% cabe no mesmo pixel (48 px para 100%)
+    widget_barra(&widgets[0], 50.5f);
+    CHECAR_IGUAL(quadro(&tela), 0);
+
+    widget_barra(&widgets[0], 75.0f);
+    CHECAR_IGUAL(quadro(&tela), 1);
+    CHECAR_IGUAL(widgets[0].nivel, 36);
+
+    // Fora da faixa e NaN ficam nos extremos
+    widget_barra(&widgets[0], 150.0f);
+    CHECAR_IGUAL(quadro(&tela), 1);
+    CHECAR_IGUAL(widgets[0].nivel, 48);
+    widget_barra(&widgets[0], 0.0f / 0.0f);
+    CHECAR_IGUAL(quadro(&tela), 1);
+    CHECAR_IGUAL(widgets[0].nivel, 0);
+}
+
+static void testar_sparkline(void)
+{
+    static Tendencia zona0, zona1;
+    tendencia_iniciar(&zona0, 4);
+    tendencia_iniciar(&zona1, 4);
+    tendencia_adicionar(&zona1, 30.0f, 30.0f);
+
+    Widget widgets[] = {
+        {.tipo = WIDGET_VALOR, .x = 0, .y = 0, .formato = "%.1f°C"},
+        {.tipo = WIDGET_SPARKLINE, .x = 32, .y = 12, .largura = TENDENCIA_COLUNAS, .altura = 52},
+    };
+    Tela tela = {widgets, count_of(widgets), 0};
+
+    // Sem histórico ligado a SPARKLINE não é desenhada
+    tela_mostrar(&ssd, &tela);
+    widget_valor(&widgets[0], 25.0f);
+    CHECAR_IGUAL(quadro(&tela), 1);
+    CHECAR_IGUAL(widgets[1].redesenhos, 0);
+
+    tendencia_adicionar(&zona0, 25.0f, 30.0f);
+    widget_sparkline(&widgets[1], &zona0);
+    CHECAR_IGUAL(quadro(&tela), 1);
+
+    // Histórico parado: nada a fazer
+    for (int i = 0; i < 10; i++)
+    {
+        widget_sparkline(&widgets[1], &zona0);
+        CHECAR_IGUAL(quadro(&tela), 0);
+    }
+
+    // Uma amostra por leitura: um redesenho por amostra
+    for (int i = 0; i < 8; i++)
+    {
+        tendencia_adicionar(&zona0, 25.0f + i * 0.1f, 30.0f);
+        widget_sparkline(&widgets[1], &zona0);
+        CHECAR_IGUAL(quadro(&tela), 1);
+    }
+    CHECAR_IGUAL(widgets[1].redesenhos, 9);
+
+    // Troca de zona liga outro histórico
+    widget_sparkline(&widgets[1], &zona1);
+    CHECAR_IGUAL(quadro(&tela), 1);
+    widget_sparkline(&widgets[1], &zona1);
+    CHECAR_IGUAL(quadro(&tela), 0);
+}
+
+static void testar_troca_de_tela(void)
+{
+    Widget principal[] = {
+        {.tipo = WIDGET_VALOR, .x = 0, .y = 0, .formato = "%.1f°C"},
+        {.tipo = WIDGET_ROTULO, .x = 0, .y = 33, .inicial = "Status:"},
+    };
+    Widget info[] = {
+        {.tipo = WIDGET_ROTULO, .x = 0, .y = 0, .inicial = "Info Detalhada"},
+        {.tipo = WIDGET_VALOR, .x = 0, .y = 16, .formato = "Erro: %.2f"},
+    };
+    Tela telas[] = {{principal, count_of(principal), 0}, {info, count_of(info), 0}};
+
+    tela_mostrar(&ssd, &telas[0]);
+    widget_valor(&principal[0], 25.0f);
+    CHECAR_IGUAL(quadro(&telas[0]), 2);
+
+    // A tela nova é desenhada inteira; a antiga guarda o texto retido
+    tela_mostrar(&ssd, &telas[1]);
+    widget_valor(&info[1], 0.5f);
+    CHECAR_IGUAL(quadro(&telas[1]), 2);
+
+    // Na volta tudo é redesenhado uma vez (o display foi apagado), mesmo sem
+    // valor novo, e depois a tela fica parada
+    tela_mostrar(&ssd, &telas[0]);
+    widget_valor(&principal[0], 25.0f);
+    CHECAR_IGUAL(quadro(&telas[0]), 2);
+    widget_valor(&principal[0], 25.0f);
+    CHECAR_IGUAL(quadro(&telas[0]), 0);
+    CHECAR_IGUAL(telas[0].redesenhos, 4);
+}
+
+int main(void)
+{
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c1);
+    testar_tela_estatica();
+    testar_valor();
+    testar_barra();
+    testar_sparkline();
+    testar_troca_de_tela();
+    return teste_resultado("widget");
+}
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Sintonia do escalonamento de ganhos do controle de temperatura.
+
+Subcomandos:
+
+  sintonizar  Lineariza o modelo térmico da zona em cada ponto de operação
+              (setpoint) e calcula Kp e Ki por sintonia lambda; grava a tabela
+              em CSV (ponto,kp,ki) e, com --placa, mostra os comandos para
+              carregá-la pela rota /escalonamento.
+
+Uso:
+    python3 tools/escalonamento.py sintonizar --csv ganhos.csv --placa 192.168.0.50
+
+A comparação com os ganhos fixos (ISE/IAE em degraus por toda a faixa) roda
+no simulador do host, com o PI de lib/zona.c:
+    build_testes/sim_zonas escalonamento ganhos.csv
+
+O modelo é o de tools/feedforward.py com uma carga maior e ambiente frio, para
+que a faixa de 18 a 45 °C seja alcançável.
+"""
+
+import argparse
+import csv
+import sys
+
+from feedforward import Planta
+
+# Mesmo tamanho de lib/escalonamento.h
+PONTOS_MAX = 8
+
+AMBIENTE = 13.0
+UMIDADE = 50.0
+ATRASO = 2.0  # s: filtro EMA e meio período de amostragem
+
+
+class PlantaAquecida(Planta):
+    carga = 160.0  # W: com 13 °C de ambiente, o regime vai de ~18 a 45 °C
+
+
+def eficacia(planta, umidade):
+    return planta.g_max * (1.0 - planta.efeito_umidade * (umidade - 50.0))
+
+
+def linearizar(setpoint, planta=PlantaAquecida, ambiente=AMBIENTE, umidade=UMIDADE):
+    """Ganho estático (°C por grau de servo), constante de tempo (s) e ângulo
+    de regime em um setpoint; None se o setpoint estiver fora do alcance."""
+    elevacao = setpoint - ambiente
+    if elevacao <= 0:
+        return None
+    g = planta.carga / elevacao - planta.perda
+    x = g / eficacia(planta, umidade)
+    if not 0.0 < x < 1.0:
+        return None
+    # Tss = ambiente + carga / (perda + g(u)) => dTss/du = -carga·g'(u) / (perda + g)²
+    derivada_g = eficacia(planta, umidade) * planta.expoente * x ** (planta.expoente - 1) / 180.0
+    ganho = planta.carga * derivada_g / (planta.carga / elevacao) ** 2
+    tau = planta.capacidade * elevacao / planta.carga
+    return ganho, tau, 180.0 * x ** (1.0 / planta.expoente)
+
+
+def sintonia_lambda(ganho, tau, lambda_s):
+    """PI por sintonia lambda (IMC) para um modelo de 1ª ordem com atraso."""
+    kp = tau / (ganho * (lambda_s + ATRASO))
+    return kp, kp / tau
+
+
+def tabela_sintonizada(inicio, fim, pontos, lambda_s, kp_max=100.0, ki_max=10.0):
+    tabela = []
+    for k in range(pontos):
+        setpoint = inicio + (fim - inicio) * k / (pontos - 1)
+        lin = linearizar(setpoint)
+        if lin is None:
+            continue
+        kp, ki = sintonia_lambda(lin[0], lin[1], lambda_s)
+        tabela.append((round(setpoint, 2), round(min(kp, kp_max), 3), round(min(ki, ki_max), 4)))
+    return tabela
+
+
+def cmd_sintonizar(args):
+    tabela = tabela_sintonizada(args.inicio, args.fim, args.pontos, args.lambda_s)
+    with open(args.csv, "w", newline="") as arquivo:
+        escritor = csv.writer(arquivo)
+        escritor.writerow(["ponto", "kp", "ki"])
+        escritor.writerows(tabela)
+    for ponto, kp, ki in tabela:
+        lin = linearizar(ponto)
+        print(f"{ponto:6.2f} °C  ganho {lin[0]:7.4f} °C/°  tau {lin[1]:5.0f} s  ->  kp {kp:7.3f}  ki {ki:.4f}",
+              file=sys.stderr)
+    print(f"gravado {args.csv}", file=sys.stderr)
+    if args.placa:
+        url = f"http://{args.placa}/escalonamento"
+        curl = 'curl -X POST -H "Authorization: Bearer $TOKEN"'  # TOKEN_ACESSO do build
+        print(f"{curl} {url} -d 'chave=setpoint&limpar=true'")
+        for ponto, kp, ki in tabela:
+            print(f"{curl} {url} -d 'ponto={ponto}&kp={kp}&ki={ki}'")
+        print(f"{curl} {url} -d 'ativo=true'")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="comando", required=True)
+
+    p = sub.add_parser("sintonizar", help="calcula a tabela pelo modelo")
+    p.add_argument("--csv", default="ganhos.csv")
+    p.add_argument("--inicio", type=float, default=18.0, help="primeiro setpoint (°C)")
+    p.add_argument("--fim", type=float, default=44.0, help="último setpoint (°C)")
+    p.add_argument("--pontos", type=int, default=PONTOS_MAX, choices=range(2, PONTOS_MAX + 1))
+    p.add_argument("--lambda", dest="lambda_s", type=float, default=20.0, help="constante de tempo desejada (s)")
+    p.add_argument("--placa", help="IP da placa, para imprimir os comandos curl")
+    p.set_defaults(func=cmd_sintonizar)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
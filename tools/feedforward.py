@@ -0,0 +1,435 @@
+#!/usr/bin/env python3
+"""Identificação e simulação do avanço (feed-forward) do controle de temperatura.
+
+Subcomandos:
+
+  identificar  Ajusta a tabela de ângulo de regime (elevação sobre o ambiente x
+               umidade) a partir de capturas de tools/receptor_udp.py e grava
+               lib/feedforward_tabela.h.
+  simular      Compara, num modelo térmico da zona, o PI do firmware com e sem
+               o avanço após degraus de setpoint (tempo de acomodação e IAE).
+  gerar        Produz uma captura sintética no formato do receptor, para testar
+               a identificação sem a placa.
+
+Uso:
+    python3 tools/feedforward.py identificar captura.csv@25 tarde.csv@29
+    python3 tools/feedforward.py simular
+    python3 tools/feedforward.py gerar --csv sintetico.csv
+
+A temperatura ambiente de cada captura vem da coluna "ambiente", se houver, ou
+do sufixo @<°C> no nome do arquivo. Sem ambiente nas capturas, a tabela supõe
+AMBIENTE_PADRAO e só vale enquanto o ambiente real ficar perto dele.
+"""
+
+import argparse
+import csv
+import math
+import pathlib
+import random
+import re
+import sys
+
+RAIZ = pathlib.Path(__file__).resolve().parent.parent
+TABELA_H = RAIZ / "lib" / "feedforward_tabela.h"
+
+# Mesmo tamanho de lib/feedforward.h
+PONTOS_ELEVACAO = 8
+PONTOS_UMIDADE = 4
+
+# Controle do firmware (main.c e lib/zona.c)
+GANHO_P = 10.0
+GANHO_I = 0.2
+INTEGRAL_LIMITE = 90.0
+PERIODO = 1.0
+
+AMBIENTE_PADRAO = 25.0
+
+
+# ---------------------------------------------------------------- tabela
+
+class Tabela:
+    def __init__(self, elevacao_min, elevacao_passo, umidade_min, umidade_passo, angulo,
+                 ambiente_ref=AMBIENTE_PADRAO):
+        self.elevacao_min = elevacao_min
+        self.elevacao_passo = elevacao_passo
+        self.umidade_min = umidade_min
+        self.umidade_passo = umidade_passo
+        self.angulo = angulo  # [PONTOS_ELEVACAO][PONTOS_UMIDADE]
+        self.ambiente_ref = ambiente_ref
+
+    @staticmethod
+    def posicao(valor, minimo, passo, pontos):
+        """Igual a posicao_na_grade() de lib/feedforward.c."""
+        f = (valor - minimo) / passo
+        f = min(max(f, 0.0), pontos - 1)
+        i = min(int(f), pontos - 2)
+        return i, f - i
+
+    def pesos(self, elevacao, umidade):
+        """Pesos bilineares [(linha, coluna, peso)] de um ponto."""
+        i, fe = self.posicao(elevacao, self.elevacao_min, self.elevacao_passo, PONTOS_ELEVACAO)
+        j, fu = self.posicao(umidade, self.umidade_min, self.umidade_passo, PONTOS_UMIDADE)
+        return [(i, j, (1 - fe) * (1 - fu)), (i, j + 1, (1 - fe) * fu),
+                (i + 1, j, fe * (1 - fu)), (i + 1, j + 1, fe * fu)]
+
+    def elevacao(self, setpoint, ambiente):
+        return setpoint - (self.ambiente_ref if ambiente is None else ambiente)
+
+    def calcular(self, setpoint, umidade, ambiente=None):
+        """Igual a feedforward_calcular(); ambiente None = sem leitura."""
+        return sum(p * self.angulo[i][j] for i, j, p in self.pesos(self.elevacao(setpoint, ambiente), umidade))
+
+    def gravar(self, caminho, origem):
+        linhas = [
+            f"// Gerado por tools/feedforward.py identificar a partir de {origem}; não edite à mão.",
+            "// Ângulo de regime do servo menos 90°, por elevação sobre o ambiente (linhas) e",
+            "// umidade (colunas).",
+            "// Incluído só por main.c.",
+            "",
+            "#ifndef FEEDFORWARD_TABELA_H",
+            "#define FEEDFORWARD_TABELA_H",
+            "",
+            '#include "feedforward.h"',
+            "",
+            "static const FeedForwardTabela FEEDFORWARD_TABELA = {",
+            f"    .elevacao_min = {self.elevacao_min:.2f}f,",
+            f"    .elevacao_passo = {self.elevacao_passo:.3f}f,",
+            f"    .umidade_min = {self.umidade_min:.1f}f,",
+            f"    .umidade_passo = {self.umidade_passo:.2f}f,",
+            "    .angulo = {",
+        ]
+        for i, linha in enumerate(self.angulo):
+            valores = ", ".join(f"{v:.1f}f" for v in linha)
+            linhas.append(f"        {{{valores}}}, // +{self.elevacao_min + i * self.elevacao_passo:.1f} °C")
+        linhas += [
+            "    },",
+            f"    .ambiente_ref = {self.ambiente_ref:.1f}f,",
+            "};",
+            "",
+            "#endif // FEEDFORWARD_TABELA_H",
+        ]
+        caminho.write_text("\n".join(linhas) + "\n", encoding="utf-8")
+
+    @classmethod
+    def ler(cls, caminho):
+        texto = caminho.read_text(encoding="utf-8")
+
+        def campo(nome):
+            m = re.search(rf"\.{nome}\s*=\s*(-?[\d.]+)f", texto)
+            if not m:
+                sys.exit(f"{caminho}: campo {nome} não encontrado")
+            return float(m.group(1))
+
+        bloco = re.search(r"\.angulo\s*=\s*\{(.*?)\n\s*\},", texto, re.S)
+        linhas = re.findall(r"\{([^{}]*)\}", bloco.group(1)) if bloco else []
+        angulo = [[float(v.strip().rstrip("f")) for v in linha.split(",") if v.strip()] for linha in linhas]
+        if len(angulo) != PONTOS_ELEVACAO or any(len(l) != PONTOS_UMIDADE for l in angulo):
+            sys.exit(f"{caminho}: tabela .angulo fora do tamanho {PONTOS_ELEVACAO}x{PONTOS_UMIDADE}")
+        return cls(campo("elevacao_min"), campo("elevacao_passo"), campo("umidade_min"),
+                   campo("umidade_passo"), angulo, campo("ambiente_ref"))
+
+
+# ---------------------------------------------------------------- identificação
+
+def ler_captura(argumento):
+    """Amostras de controle (uma por ciclo) de uma captura do receptor UDP."""
+    nome, _, ambiente = argumento.partition("@")
+    ambiente_arquivo = float(ambiente) if ambiente else None
+    amostras = []
+    ultimo_ciclo = {}
+    with open(nome, newline="") as arquivo:
+        for linha in csv.DictReader(arquivo):
+            zona = linha["zona"]
+            # O fluxo UDP repete a amostra entre ciclos de controle; só o primeiro registro conta
+            if ultimo_ciclo.get(zona) == linha["ciclo"]:
+                continue
+            ultimo_ciclo[zona] = linha["ciclo"]
+            if linha["modo"] != "auto" or linha["sensor_ok"] != "1" or linha["critica"] == "1":
+                continue
+            ambiente = linha.get("ambiente")
+            amostras.append({
+                "zona": zona,
+                "temperatura": float(linha["temperatura"]),
+                "setpoint": float(linha["setpoint"]),
+                "angulo": float(linha["angulo"]),
+                "umidade": float(linha["umidade"]),
+                "ambiente": float(ambiente) if ambiente not in (None, "") else ambiente_arquivo,
+            })
+    return amostras
+
+
+def janelas_de_regime(amostras, tamanho, erro_max, desvio_angulo_max):
+    """Médias de janelas sem sobreposição em que a zona está parada no setpoint."""
+    janelas = []
+    por_zona = {}
+    for a in amostras:
+        por_zona.setdefault(a["zona"], []).append(a)
+    for serie in por_zona.values():
+        inicio = 0
+        while inicio + tamanho <= len(serie):
+            trecho = serie[inicio:inicio + tamanho]
+            angulos = [a["angulo"] for a in trecho]
+            media_angulo = sum(angulos) / tamanho
+            desvio = math.sqrt(sum((x - media_angulo) ** 2 for x in angulos) / tamanho)
+            estavel = (
+                all(a["setpoint"] == trecho[0]["setpoint"] for a in trecho)
+                and max(abs(a["temperatura"] - a["setpoint"]) for a in trecho) <= erro_max
+                and max(a["umidade"] for a in trecho) - min(a["umidade"] for a in trecho) <= 5
+                and desvio <= desvio_angulo_max
+                and 0.5 < media_angulo < 179.5  # Saturado não diz o ângulo necessário
+            )
+            if not estavel:
+                inicio += 1
+                continue
+            ambientes = [a["ambiente"] for a in trecho if a["ambiente"] is not None]
+            janelas.append({
+                "setpoint": trecho[0]["setpoint"],
+                "umidade": sum(a["umidade"] for a in trecho) / tamanho,
+                "ambiente": sum(ambientes) / len(ambientes) if ambientes else None,
+                "angulo": media_angulo - 90.0,
+            })
+            inicio += tamanho
+    return janelas
+
+
+def resolver(matriz, vetor):
+    """Eliminação de Gauss com pivotamento parcial (sistemas pequenos)."""
+    n = len(vetor)
+    a = [linha[:] + [v] for linha, v in zip(matriz, vetor)]
+    for col in range(n):
+        pivo = max(range(col, n), key=lambda r: abs(a[r][col]))
+        if abs(a[pivo][col]) < 1e-12:
+            raise ValueError("sistema singular")
+        a[col], a[pivo] = a[pivo], a[col]
+        for r in range(col + 1, n):
+            f = a[r][col] / a[col][col]
+            for c in range(col, n + 1):
+                a[r][c] -= f * a[col][c]
+    x = [0.0] * n
+    for r in range(n - 1, -1, -1):
+        x[r] = (a[r][n] - sum(a[r][c] * x[c] for c in range(r + 1, n))) / a[r][r]
+    return x
+
+
+def ajustar(janelas, suavizacao):
+    """Mínimos quadrados da grade bilinear.
+
+    Cada janela de regime é uma equação; diferenças entre pontos vizinhos da
+    grade entram com peso @suavizacao, o que preenche suavemente as células sem
+    dados e segura o ajuste quando há poucas janelas.
+    """
+    ambientes = [j["ambiente"] for j in janelas if j["ambiente"] is not None]
+    ambiente_ref = sum(ambientes) / len(ambientes) if ambientes else AMBIENTE_PADRAO
+    pontos = [(j["setpoint"] - (ambiente_ref if j["ambiente"] is None else j["ambiente"]), j["umidade"], j["angulo"])
+              for j in janelas]
+
+    elevacoes = [p[0] for p in pontos]
+    umidades = [p[1] for p in pontos]
+    el_min, el_max = math.floor(min(elevacoes) * 2) / 2, math.ceil(max(elevacoes) * 2) / 2
+    ur_min, ur_max = math.floor(min(umidades) / 5) * 5, math.ceil(max(umidades) / 5) * 5
+    tabela = Tabela(el_min, max(el_max - el_min, 1.0) / (PONTOS_ELEVACAO - 1),
+                    ur_min, max(ur_max - ur_min, 5.0) / (PONTOS_UMIDADE - 1),
+                    [[0.0] * PONTOS_UMIDADE for _ in range(PONTOS_ELEVACAO)], ambiente_ref)
+
+    n = PONTOS_ELEVACAO * PONTOS_UMIDADE
+    linhas, alvos = [], []
+    for elevacao, umidade, angulo in pontos:
+        linha = [0.0] * n
+        for i, k, p in tabela.pesos(elevacao, umidade):
+            linha[i * PONTOS_UMIDADE + k] += p
+        linhas.append(linha)
+        alvos.append(angulo)
+    for i in range(PONTOS_ELEVACAO):
+        for k in range(PONTOS_UMIDADE):
+            for di, dk in ((1, 0), (0, 1)):
+                if i + di < PONTOS_ELEVACAO and k + dk < PONTOS_UMIDADE:
+                    linha = [0.0] * n
+                    linha[i * PONTOS_UMIDADE + k] = suavizacao
+                    linha[(i + di) * PONTOS_UMIDADE + k + dk] = -suavizacao
+                    linhas.append(linha)
+                    alvos.append(0.0)
+
+    ata = [[sum(l[r] * l[c] for l in linhas) for c in range(n)] for r in range(n)]
+    atb = [sum(l[r] * y for l, y in zip(linhas, alvos)) for r in range(n)]
+    x = resolver(ata, atb)
+
+    tabela.angulo = [[x[i * PONTOS_UMIDADE + k] for k in range(PONTOS_UMIDADE)] for i in range(PONTOS_ELEVACAO)]
+    residuos = [sum(p * tabela.angulo[i][k] for i, k, p in tabela.pesos(e, u)) - a for e, u, a in pontos]
+    rms = math.sqrt(sum(r * r for r in residuos) / len(residuos))
+    return tabela, bool(ambientes), rms
+
+
+def cmd_identificar(args):
+    amostras = []
+    for argumento in args.capturas:
+        amostras += ler_captura(argumento)
+    janelas = janelas_de_regime(amostras, args.janela, args.erro_max, args.desvio_angulo)
+    if len(janelas) < 4:
+        sys.exit(f"só {len(janelas)} janelas de regime em {len(amostras)} amostras; "
+                 "capture mais tempo parado em setpoints diferentes")
+
+    tabela, usar_ambiente, rms = ajustar(janelas, args.suavizacao)
+    origem = " ".join(pathlib.Path(a.partition("@")[0]).name for a in args.capturas)
+    tabela.gravar(args.saida, origem)
+    print(f"{len(janelas)} janelas de regime de {len(amostras)} amostras; resíduo RMS {rms:.2f}°", file=sys.stderr)
+    if not usar_ambiente:
+        print(f"capturas sem ambiente: a tabela supõe {AMBIENTE_PADRAO} °C", file=sys.stderr)
+    print(f"gravado {args.saida}", file=sys.stderr)
+
+
+# ---------------------------------------------------------------- simulação
+
+class Planta:
+    """Modelo térmico de uma zona: carga fixa, perdas pelas paredes e ventoinha
+    puxando ar ambiente, com eficácia que satura com a abertura e cai com a umidade."""
+    capacidade = 800.0    # J/K
+    carga = 100.0         # W
+    perda = 5.0           # W/K
+    g_max = 30.0          # W/K com o servo todo aberto
+    expoente = 0.6        # Eficácia ~ abertura^expoente
+    efeito_umidade = 0.004  # Perda relativa de eficácia por ponto de umidade acima de 50%
+    alfa_filtro = 0.5     # EMA do filtro padrão do firmware
+    ruido = 0.02          # °C
+
+    def __init__(self, temperatura, semente=1):
+        self.temperatura = temperatura
+        self.medida = temperatura
+        self.aleatorio = random.Random(semente)
+
+    def passo(self, angulo, umidade, ambiente, dt=PERIODO):
+        u = min(max(angulo / 180.0, 0.0), 1.0)
+        g = self.g_max * u ** self.expoente * (1.0 - self.efeito_umidade * (umidade - 50.0))
+        fluxo = self.carga + self.perda * (ambiente - self.temperatura) - g * (self.temperatura - ambiente)
+        self.temperatura += fluxo * dt / self.capacidade
+        leitura = self.temperatura + self.aleatorio.gauss(0.0, self.ruido)
+        self.medida += self.alfa_filtro * (leitura - self.medida)
+        return self.medida
+
+    def angulo_de_regime(self, setpoint, umidade, ambiente):
+        """Ângulo que equilibra a zona no setpoint (referência do modelo)."""
+        dt = setpoint - ambiente
+        g = (self.carga - self.perda * dt) / dt
+        efic = self.g_max * (1.0 - self.efeito_umidade * (umidade - 50.0))
+        return 180.0 * min(max(g / efic, 0.0), 1.0) ** (1.0 / self.expoente)
+
+
+class Controlador:
+    """PI de zona_aplicar_controle(), com o avanço opcional."""
+
+    def __init__(self, tabela=None):
+        self.tabela = tabela
+        self.integral = 0.0
+
+    def saida(self, medida, setpoint, umidade, ambiente):
+        erro = medida - setpoint
+        self.integral = min(max(self.integral + GANHO_I * erro * PERIODO, -INTEGRAL_LIMITE), INTEGRAL_LIMITE)
+        avanco = self.tabela.calcular(setpoint, umidade, ambiente) if self.tabela else 0.0
+        return min(max(90.0 + GANHO_P * erro + self.integral + avanco, 0.0), 180.0)
+
+
+def rodar(planta, controlador, roteiro, registrar=None):
+    """Executa o roteiro [(duracao_s, setpoint, umidade, ambiente)] e mede cada degrau."""
+    resultados = []
+    t = 0
+    for duracao, setpoint, umidade, ambiente in roteiro:
+        serie = []
+        for _ in range(int(duracao / PERIODO)):
+            medida = planta.medida
+            angulo = controlador.saida(medida, setpoint, umidade, ambiente)
+            if registrar:
+                registrar(t, medida, setpoint, controlador.integral, angulo, umidade, ambiente)
+            planta.passo(angulo, umidade, ambiente)
+            serie.append(planta.medida - setpoint)
+            t += PERIODO
+
+        # Acomodação: último instante fora da faixa de ±0,3 °C
+        fora = [i for i, e in enumerate(serie) if abs(e) > 0.3]
+        acomodacao = (fora[-1] + 1) * PERIODO if fora else 0.0
+        if fora and fora[-1] == len(serie) - 1:
+            acomodacao = math.inf
+        iae = sum(abs(e) for e in serie) * PERIODO
+        resultados.append((setpoint, umidade, ambiente, acomodacao, iae))
+    return resultados
+
+
+ROTEIRO_DEGRAUS = [
+    # duração (s), setpoint (°C), umidade (%), ambiente (°C)
+    (1200, 30.0, 60, 25.0),
+    (900, 28.5, 60, 25.0),
+    (900, 32.0, 60, 25.0),
+    (900, 29.0, 75, 25.0),
+    (900, 31.0, 45, 27.0),
+    (900, 30.0, 45, 23.0),
+]
+
+
+def cmd_simular(args):
+    tabela = Tabela.ler(args.tabela)
+    inicial = ROTEIRO_DEGRAUS[0][1]
+    sem = rodar(Planta(inicial), Controlador(), ROTEIRO_DEGRAUS)
+    com = rodar(Planta(inicial), Controlador(tabela), ROTEIRO_DEGRAUS)
+
+    print(f"{'setpoint':>8} {'umid':>5} {'amb':>5} | {'acomodação PI':>14} {'PI+avanço':>10} | {'IAE PI':>8} {'PI+avanço':>10}")
+    for (sp, ur, amb, a0, e0), (_, _, _, a1, e1) in zip(sem[1:], com[1:]):
+        print(f"{sp:8.1f} {ur:5.0f} {amb:5.1f} | {a0:13.0f}s {a1:9.0f}s | {e0:8.0f} {e1:10.0f}")
+    finitos = [(a0, a1) for (*_, a0, _), (*_, a1, _) in zip(sem[1:], com[1:]) if math.isfinite(a0) and math.isfinite(a1)]
+    if finitos:
+        m0 = sum(a for a, _ in finitos) / len(finitos)
+        m1 = sum(b for _, b in finitos) / len(finitos)
+        print(f"acomodação média (±0,3 °C): PI {m0:.0f} s, PI+avanço {m1:.0f} s ({100 * (1 - m1 / m0):.0f}% menor)")
+
+
+def cmd_gerar(args):
+    """Captura sintética no formato de tools/receptor_udp.py, só com o PI."""
+    aleatorio = random.Random(args.semente)
+    roteiro = []
+    for _ in range(args.patamares):
+        roteiro.append((args.duracao, round(aleatorio.uniform(28.0, 33.5) * 2) / 2,
+                        aleatorio.choice([35, 50, 65, 80]), aleatorio.choice([22.0, 25.0, 28.0])))
+    planta = Planta(roteiro[0][1], semente=args.semente)
+
+    with open(args.csv, "w", newline="") as arquivo:
+        escritor = csv.writer(arquivo)
+        escritor.writerow(["recebido_s", "sequencia", "instante_us", "zona", "ciclo", "sensor_ok", "critica", "modo",
+                           "temperatura_bruta", "temperatura", "setpoint", "integral", "angulo", "ventoinha",
+                           "umidade", "ambiente"])
+
+        def registrar(t, medida, setpoint, integral, angulo, umidade, ambiente):
+            escritor.writerow([f"{t:.6f}", int(t), int(t * 1e6) % 2**32, 0, int(t) % 65536, 1, 0, "auto",
+                               f"{medida:.2f}", f"{medida:.2f}", setpoint, f"{integral:.2f}", f"{angulo:.1f}",
+                               round(angulo / 1.8), umidade, ambiente])
+
+        rodar(planta, Controlador(), roteiro, registrar)
+    print(f"gravado {args.csv}: {args.patamares} patamares de {args.duracao} s", file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="comando", required=True)
+
+    p = sub.add_parser("identificar", help="ajusta a tabela a partir de capturas")
+    p.add_argument("capturas", nargs="+", help="CSV do receptor UDP, opcionalmente com @<ambiente °C>")
+    p.add_argument("--saida", type=pathlib.Path, default=TABELA_H)
+    p.add_argument("--janela", type=int, default=60, help="ciclos por janela de regime")
+    p.add_argument("--erro-max", type=float, default=0.3, help="|erro| máximo na janela (°C)")
+    p.add_argument("--desvio-angulo", type=float, default=3.0, help="desvio padrão máximo do ângulo na janela")
+    p.add_argument("--suavizacao", type=float, default=0.3, help="peso das diferenças entre vizinhos da grade")
+    p.set_defaults(func=cmd_identificar)
+
+    p = sub.add_parser("simular", help="compara PI e PI+avanço após degraus de setpoint")
+    p.add_argument("--tabela", type=pathlib.Path, default=TABELA_H)
+    p.set_defaults(func=cmd_simular)
+
+    p = sub.add_parser("gerar", help="gera uma captura sintética com o modelo")
+    p.add_argument("--csv", default="sintetico.csv")
+    p.add_argument("--patamares", type=int, default=60)
+    p.add_argument("--duracao", type=int, default=900, help="segundos por patamar")
+    p.add_argument("--semente", type=int, default=7)
+    p.set_defaults(func=cmd_gerar)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""Gera lib/font.h a partir dos desenhos de glifos em tools/fontes/*.txt.
+
+Formato dos desenhos: linhas `nome`, `altura` e `espaco` no cabeçalho, depois
+um bloco por glifo com o código Latin-1 (ex.: `0xE7 ç`) seguido de `altura`
+linhas de '#' (aceso) e '.' (apagado). A largura do glifo é a das linhas, então
+cada caractere ocupa só as colunas que desenha.
+
+Uso:
+    python3 tools/gerar_fonte.py
+"""
+
+import pathlib
+import sys
+
+RAIZ = pathlib.Path(__file__).resolve().parent.parent
+FONTES = ["pequena.txt", "numeros.txt"]
+SAIDA = RAIZ / "lib" / "font.h"
+LARGURA_MAX = 12  # GLYPH_MAX_WIDTH em lib/ssd1306.c
+
+
+class Fonte:
+    def __init__(self, caminho):
+        self.caminho = caminho
+        self.nome = None
+        self.altura = None
+        self.espaco = 1
+        self.glifos = {}  # código -> (descrição, linhas)
+        self.ler()
+
+    def erro(self, numero, mensagem):
+        sys.exit(f"{self.caminho.name}:{numero}: {mensagem}")
+
+    def ler(self):
+        codigo = None
+        for numero, linha in enumerate(self.caminho.read_text(encoding="utf-8").splitlines(), 1):
+            linha = linha.rstrip()
+            if not linha or linha.startswith("#") and codigo is None:
+                continue
+            campos = linha.split(maxsplit=1)
+            if campos[0] in ("nome", "altura", "espaco"):
+                valor = campos[1] if campos[0] == "nome" else int(campos[1])
+                setattr(self, campos[0], valor)
+            elif campos[0].startswith("0x"):
+                codigo = int(campos[0], 16)
+                if codigo in self.glifos:
+                    self.erro(numero, f"glifo 0x{codigo:02X} repetido")
+                if not 0x20 <= codigo <= 0xFF:
+                    self.erro(numero, f"0x{codigo:02X} fora do Latin-1 imprimível")
+                descricao = campos[1] if len(campos) > 1 else ""
+                if descricao.endswith("\\"):
+                    self.erro(numero, "descrição terminada em '\\' continuaria o comentário em C")
+                self.glifos[codigo] = (descricao, [])
+            elif codigo is not None and set(linha) <= {"#", "."}:
+                linhas = self.glifos[codigo][1]
+                if linhas and len(linha) != len(linhas[0]):
+                    self.erro(numero, f"glifo 0x{codigo:02X} com linhas de larguras diferentes")
+                linhas.append(linha)
+            else:
+                self.erro(numero, f"linha não reconhecida: {linha!r}")
+
+        if not self.nome or not self.altura or not self.glifos:
+            sys.exit(f"{self.caminho.name}: faltam nome, altura ou glifos")
+        if self.altura > 32:
+            sys.exit(f"{self.caminho.name}: altura máxima é 32 linhas")
+        for codigo, (_, linhas) in self.glifos.items():
+            if linhas and len(linhas[0]) > LARGURA_MAX:
+                sys.exit(f"{self.caminho.name}: glifo 0x{codigo:02X} mais largo que {LARGURA_MAX} colunas")
+            if len(linhas) != self.altura:
+                sys.exit(f"{self.caminho.name}: glifo 0x{codigo:02X} tem {len(linhas)} linhas, esperado {self.altura}")
+
+    def colunas(self, linhas):
+        """Bytes do glifo coluna a coluna, página por página (bit 0 = linha de cima)."""
+        paginas = (self.altura + 7) // 8
+        saida = []
+        for x in range(len(linhas[0])):
+            bits = sum(1 << y for y, linha in enumerate(linhas) if linha[x] == "#")
+            saida.extend((bits >> (8 * p)) & 0xFF for p in range(paginas))
+        return saida
+
+    def gerar(self):
+        primeiro, ultimo = min(self.glifos), max(self.glifos)
+        bitmap, tabela = [], []
+        for codigo in range(primeiro, ultimo + 1):
+            if codigo not in self.glifos:
+                tabela.append(None)
+                continue
+            descricao, linhas = self.glifos[codigo]
+            dados = self.colunas(linhas)
+            tabela.append((len(bitmap), len(linhas[0]), codigo, descricao))
+            bitmap.append((dados, codigo, descricao))
+
+        texto = [f"static const uint8_t {self.nome}_bitmap[] = {{"]
+        for dados, codigo, descricao in bitmap:
+            bytes_ = " ".join(f"0x{b:02x}," for b in dados)
+            texto.append(f"    {bytes_} // 0x{codigo:02X} {descricao}".rstrip())
+        texto.append("};")
+        texto.append("")
+
+        texto.append(f"static const ssd1306_glyph_t {self.nome}_glyphs[] = {{")
+        deslocamento = 0
+        ausentes = []
+        for i, entrada in enumerate(tabela + [()]):
+            if entrada is None:
+                ausentes.append(primeiro + i)
+                continue
+            if ausentes:
+                if len(ausentes) == 1:
+                    faixa = f"0x{ausentes[0]:02X} ausente"
+                else:
+                    faixa = f"0x{ausentes[0]:02X}-0x{ausentes[-1]:02X} ausentes"
+                for j in range(0, len(ausentes), 8):
+                    vazios = " ".join("{0, 0}," for _ in ausentes[j:j + 8])
+                    texto.append(f"    {vazios}" + (f" // {faixa}" if j == 0 else ""))
+                ausentes = []
+            if entrada == ():
+                break
+            _, largura, codigo, descricao = entrada
+            texto.append(f"    {{{deslocamento}, {largura}}}, // 0x{codigo:02X} {descricao}".rstrip())
+            deslocamento += largura
+        texto.append("};")
+        texto.append("")
+
+        texto.append(f"const ssd1306_font_t {self.nome} = {{")
+        texto.append(f"    .height = {self.altura},")
+        texto.append(f"    .spacing = {self.espaco},")
+        texto.append(f"    .first = 0x{primeiro:02X},")
+        texto.append(f"    .last = 0x{ultimo:02X},")
+        texto.append(f"    .glyphs = {self.nome}_glyphs,")
+        texto.append(f"    .bitmap = {self.nome}_bitmap,")
+        texto.append("};")
+        return "\n".join(texto)
+
+
+def main():
+    fontes = [Fonte(RAIZ / "tools" / "fontes" / nome) for nome in FONTES]
+    partes = [
+        "// Gerado por tools/gerar_fonte.py a partir de tools/fontes/*.txt; não edite à mão.",
+        "// Glifos coluna a coluna, com (altura + 7) / 8 bytes por coluna e bit 0 na linha",
+        "// de cima, no mesmo arranjo das páginas do SSD1306. Incluído só por ssd1306.c.",
+        "",
+        "#ifndef FONT_H",
+        "#define FONT_H",
+        "",
+        '#include "ssd1306.h"',
+        "",
+    ]
+    for fonte in fontes:
+        partes.append(f"/* ---------- {fonte.nome}: {len(fonte.glifos)} glifos, altura {fonte.altura} ---------- */")
+        partes.append("")
+        partes.append(fonte.gerar())
+        partes.append("")
+    partes.append("#endif // FONT_H")
+    SAIDA.write_text("\n".join(partes) + "\n", encoding="utf-8")
+    print(f"{SAIDA.relative_to(RAIZ)}: " + ", ".join(f"{f.nome} ({len(f.glifos)} glifos)" for f in fontes))
+
+
+if __name__ == "__main__":
+    main()
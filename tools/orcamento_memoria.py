@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+"""Orçamento de RAM e flash por módulo a partir do arquivo .map do link.
+
+Soma as seções de entrada de cada objeto, agrupadas por módulo (main, zona,
+lwip, cyw43, pico-sdk, libc...), e confere os totais contra os limites de
+tools/orcamento_memoria.txt. Termina com código 1 se algum limite for
+ultrapassado, para o build (alvo orcamento_memoria) falhar.
+
+Uso:
+    python3 tools/orcamento_memoria.py build/Controle_PI_Servo_Temperatura.elf.map
+    python3 tools/orcamento_memoria.py firmware.elf.map --limites outro.txt --todos
+
+RAM conta .data, .bss, pilhas e o heap reservado; flash conta código,
+constantes e a imagem de .data copiada para a RAM no boot. O que sobra da RAM
+fica para o heap (malloc) crescer; os picos de uso aparecem no comando
+"memoria" do shell.
+"""
+
+import argparse
+import re
+import sys
+from collections import defaultdict
+from pathlib import Path
+
+LIMITES_PADRAO = Path(__file__).resolve().parent / "orcamento_memoria.txt"
+
+REGIOES_RAM = ("RAM", "SCRATCH_X", "SCRATCH_Y")
+
+# Bibliotecas do SDK reconhecidas pelo caminho do objeto, na ordem de teste
+GRUPOS = (
+    ("lwip", "/lwip/"),
+    ("cyw43", "cyw43"),
+    ("btstack", "btstack"),
+    ("mbedtls", "mbedtls"),
+)
+
+SECAO = re.compile(r"^ (\S+)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s*(.*))?$")
+CONTINUACAO = re.compile(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(.+)$")
+SAIDA = re.compile(r"^(\.\S+)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)(.*))?$")
+REGIAO = re.compile(r"^(\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)")
+
+
+def tamanho(texto):
+    """'160K', '1M' ou bytes; None para '-'."""
+    if texto == "-":
+        return None
+    fator = {"K": 1024, "M": 1024 * 1024}.get(texto[-1].upper(), 1)
+    return int(float(texto.rstrip("kKmM")) * fator)
+
+
+def modulo(objeto):
+    objeto = objeto.strip()
+    arquivo = re.match(r"(.*)\((.*)\)$", objeto)
+    if arquivo:  # Membro de biblioteca estática: lib/.../libc.a(memcpy.o)
+        nome = Path(arquivo.group(1)).name
+        return nome[:-2] if nome.endswith(".a") else nome
+    for grupo, marca in GRUPOS:
+        if marca in objeto:
+            return grupo
+    alvo = re.search(r"CMakeFiles/[^/]+\.dir/(.*)$", objeto)
+    if alvo:
+        caminho = alvo.group(1)
+        # Fontes do projeto ficam na raiz ou em lib/; o resto é o SDK
+        if "/" not in caminho or caminho.startswith("lib/"):
+            return Path(caminho).name.split(".")[0]
+        return "pico-sdk"
+    return Path(objeto).name.split(".")[0] or "(outros)"
+
+
+def ler_mapa(caminho):
+    """Regiões de memória e {módulo: [ram, flash]}."""
+    regioes = {}
+    modulos = defaultdict(lambda: [0, 0])
+    linhas = Path(caminho).read_text(errors="replace").splitlines()
+
+    i = 0
+    while i < len(linhas) and not linhas[i].startswith("Memory Configuration"):
+        i += 1
+    while i < len(linhas) and not linhas[i].startswith("Linker script and memory map"):
+        m = REGIAO.match(linhas[i])
+        if m and m.group(1) != "*default*":
+            regioes[m.group(1)] = (int(m.group(2), 16), int(m.group(3), 16))
+        i += 1
+    if not regioes:
+        sys.exit(f"{caminho}: sem 'Memory Configuration' (é um .map do GNU ld?)")
+
+    def regiao(endereco):
+        for nome, (origem, comprimento) in regioes.items():
+            if origem <= endereco < origem + comprimento:
+                return nome
+        return None
+
+    carregada = False  # Seção de saída na RAM com imagem na flash (.data)
+    pendente = None  # Nome de seção longo: endereço e tamanho na linha seguinte
+    saida_pendente = False  # O mesmo para uma seção de saída
+    for linha in linhas[i:]:
+        if saida_pendente:
+            saida_pendente = False
+            carregada = "load address" in linha
+            continue
+        if pendente is not None:
+            m = CONTINUACAO.match(linha)
+            entrada = (pendente, m.group(1), m.group(2), m.group(3)) if m else None
+            pendente = None
+        else:
+            entrada = None
+            saida = SAIDA.match(linha)
+            if saida:
+                saida_pendente = saida.group(2) is None
+                carregada = "load address" in (saida.group(4) or "")
+                continue
+            if linha.startswith(" .") or linha.startswith(" COMMON") or linha.startswith(" *fill*"):
+                m = SECAO.match(linha)
+                if m and m.group(2) is None:
+                    pendente = m.group(1)
+                    continue
+                if m:
+                    entrada = m.groups()
+            elif linha and not linha[0].isspace():
+                carregada = False  # Símbolos do script entre seções
+        if not entrada:
+            continue
+
+        nome, endereco, bytes_, objeto = entrada
+        endereco, bytes_ = int(endereco, 16), int(bytes_, 16)
+        onde = regiao(endereco)
+        if not bytes_ or onde is None:
+            continue  # Seções de depuração e descartadas
+        chave = "(preenchimento)" if nome == "*fill*" else modulo(objeto)
+        if onde in REGIOES_RAM:
+            modulos[chave][0] += bytes_
+            if carregada:
+                modulos[chave][1] += bytes_
+        else:
+            modulos[chave][1] += bytes_
+    return regioes, modulos
+
+
+def ler_limites(caminho):
+    limites = {}
+    for numero, linha in enumerate(Path(caminho).read_text().splitlines(), 1):
+        linha = linha.split("#", 1)[0].strip()
+        if not linha:
+            continue
+        campos = linha.split()
+        if len(campos) != 3:
+            sys.exit(f"{caminho}:{numero}: esperado 'módulo ram flash'")
+        try:
+            limites[campos[0]] = (tamanho(campos[1]), tamanho(campos[2]))
+        except ValueError:
+            sys.exit(f"{caminho}:{numero}: tamanho inválido")
+    return limites
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("mapa", help="arquivo .map gerado pelo link (<alvo>.elf.map)")
+    parser.add_argument("--limites", default=LIMITES_PADRAO, help="arquivo de limites por módulo")
+    parser.add_argument("--todos", action="store_true", help="lista também os módulos pequenos")
+    args = parser.parse_args()
+
+    regioes, modulos = ler_mapa(args.mapa)
+    limites = ler_limites(args.limites)
+    ram_total = sum(regioes[r][1] for r in REGIOES_RAM if r in regioes)
+    ram = sum(v[0] for v in modulos.values())
+    flash = sum(v[1] for v in modulos.values())
+
+    def kb(n):
+        return f"{n / 1024:8.1f}K"
+
+    print(f"{'módulo':<18}{'RAM':>9}{'flash':>9}")
+    outros = [0, 0]
+    for nome, (r, f) in sorted(modulos.items(), key=lambda item: (-item[1][0], -item[1][1])):
+        if args.todos or nome in limites or r >= 512 or f >= 4096:
+            print(f"{nome:<18}{kb(r)}{kb(f)}")
+        else:
+            outros[0] += r
+            outros[1] += f
+    if outros != [0, 0]:
+        print(f"{'(demais)':<18}{kb(outros[0])}{kb(outros[1])}")
+    print(f"{'TOTAL':<18}{kb(ram)}{kb(flash)}")
+    print(f"RAM livre para heap e pilha: {(ram_total - ram) / 1024:.1f}K de {ram_total / 1024:.0f}K")
+
+    estouros = []
+    for nome, (limite_ram, limite_flash) in limites.items():
+        r, f = (ram, flash) if nome == "TOTAL" else modulos.get(nome, (0, 0))
+        if limite_ram is not None and r > limite_ram:
+            estouros.append(f"{nome}: RAM {r} B > {limite_ram} B")
+        if limite_flash is not None and f > limite_flash:
+            estouros.append(f"{nome}: flash {f} B > {limite_flash} B")
+    for estouro in estouros:
+        print(f"ERRO: orçamento excedido, {estouro}", file=sys.stderr)
+    return 1 if estouros else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
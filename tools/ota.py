@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""Atualização do firmware pela rede (rota /update).
+
+Consulta o banco em execução, escolhe a imagem linkada para o outro banco
+(build/Controle_PI_Servo_Temperatura.bin para o A, ..._b.bin para o B),
+envia com o SHA-256 e acompanha o reinício até a placa confirmar a imagem
+nova ou o bootloader voltar à anterior.
+
+Uso:
+    python3 tools/ota.py 192.168.0.50 --token $TOKEN
+    python3 tools/ota.py 192.168.0.50 --token ... --build outro/build --sem-esperar
+
+O token é o TOKEN_ACESSO definido no build (cmake -DTOKEN_ACESSO=...); sem
+--token, vem da variável de ambiente TOKEN.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import sys
+import time
+import urllib.error
+import urllib.request
+from pathlib import Path
+
+IMAGENS = {"A": "Controle_PI_Servo_Temperatura_b.bin", "B": "Controle_PI_Servo_Temperatura.bin"}
+BANCO_TAMANHO = 0xFA000  # lib/ota.h
+SAUDE_S = 30  # OTA_SAUDE_MS
+PRAZO_S = 120  # OTA_PRAZO_MS
+
+
+def consultar(placa, tempo=5):
+    with urllib.request.urlopen(f"http://{placa}/update", timeout=tempo) as resposta:
+        return json.load(resposta)
+
+
+def enviar(placa, token, imagem):
+    resumo = hashlib.sha256(imagem).hexdigest()
+    pedido = urllib.request.Request(
+        f"http://{placa}/update?sha256={resumo}",
+        data=imagem,
+        method="POST",
+        headers={"Authorization": f"Bearer {token}", "Content-Type": "application/octet-stream"},
+    )
+    try:
+        # A flash é apagada setor a setor no caminho: o envio é mais lento que a rede
+        with urllib.request.urlopen(pedido, timeout=60) as resposta:
+            return json.load(resposta)
+    except urllib.error.HTTPError as erro:
+        corpo = erro.read().decode(errors="replace")
+        try:
+            corpo = json.loads(corpo).get("message", corpo)
+        except ValueError:
+            pass
+        sys.exit(f"recusado: {erro.code} {corpo}")
+
+
+def esperar(placa, banco_novo):
+    """Espera a placa voltar e a imagem nova ser confirmada (ou revertida)."""
+    limite = time.monotonic() + PRAZO_S + 30
+    estado = None
+    while time.monotonic() < limite:
+        time.sleep(2)
+        try:
+            estado = consultar(placa, tempo=2)
+        except (OSError, ValueError):
+            continue  # Reiniciando ou ainda sem Wi-Fi
+        if estado["banco"] != banco_novo:
+            print(f"a placa voltou ao banco {estado['banco']} ({estado['estado']})")
+            return False
+        if not estado["em_teste"]:
+            print(f"banco {banco_novo} confirmado")
+            return True
+        print(f"banco {banco_novo} em teste (confirma após {SAUDE_S} s de controle saudável)...")
+    print(f"sem confirmação no prazo; último estado: {estado}")
+    return False
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("placa", help="IP da placa")
+    parser.add_argument("--token", default=os.environ.get("TOKEN"), help="TOKEN_ACESSO do build")
+    parser.add_argument("--build", default="build", help="diretório de build com os .bin dos dois bancos")
+    parser.add_argument("--sem-esperar", action="store_true", help="não acompanha o reinício")
+    args = parser.parse_args()
+    if not args.token:
+        parser.error("informe --token ou a variável TOKEN")
+
+    estado = consultar(args.placa)
+    if estado["em_teste"]:
+        sys.exit("a imagem atual ainda não foi confirmada; aguarde ou reinicie a placa")
+    caminho = Path(args.build) / IMAGENS[estado["banco"]]
+    imagem = caminho.read_bytes()
+    if len(imagem) > BANCO_TAMANHO:
+        sys.exit(f"{caminho}: {len(imagem)} bytes não cabem no banco ({BANCO_TAMANHO})")
+
+    banco_novo = "B" if estado["banco"] == "A" else "A"
+    print(f"banco {estado['banco']} em execução; enviando {caminho} ({len(imagem)} bytes) para o {banco_novo}")
+    inicio = time.monotonic()
+    enviar(args.placa, args.token, imagem)
+    print(f"imagem conferida pela placa em {time.monotonic() - inicio:.1f} s; reiniciando")
+    if args.sem_esperar:
+        return 0
+    return 0 if esperar(args.placa, banco_novo) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+"""Receptor da telemetria UDP do PicoTermoControl.
+
+Grava cada amostra em CSV e informa periodicamente a perda de pacotes
+(saltos na sequência) e o jitter de chegada (RFC 3550, usando o instante de
+envio gravado pela placa em cada datagrama).
+
+Uso:
+    python3 tools/receptor_udp.py --porta 5005 --csv captura.csv
+    python3 tools/receptor_udp.py --serial /dev/ttyACM0 --taxa 50 --csv captura.csv
+
+Ative o fluxo na placa com:
+    curl -X POST -H "Authorization: Bearer $TOKEN" http://<ip-da-placa>/udp -d 'ativo=true&destino=<ip-deste-pc>&taxa_hz=50'
+
+Com --serial o receptor liga a saída binária do shell ("stream <taxa>"), que
+usa os mesmos quadros, e a desliga ao sair (requer pyserial).
+"""
+
+import argparse
+import csv
+import math
+import socket
+import struct
+import sys
+import time
+
+# Mesmo formato de lib/telemetria_udp.h (little-endian, sem preenchimento)
+CABECALHO = struct.Struct("<HBBII")
+AMOSTRA = struct.Struct("<IBBHhhhhHBHBB")
+MAGICO = 0x5450
+VERSAO = 2
+MODOS = ("auto", "manual", "desligado")
+
+COLUNAS = [
+    "recebido_s", "sequencia", "instante_us", "zona", "ciclo", "sensor_ok", "critica", "modo",
+    "temperatura_bruta", "temperatura", "setpoint", "integral", "angulo", "ventoinha",
+    "angulo_atual", "ventoinha_atual", "umidade",
+]
+
+
+class Estatisticas:
+    def __init__(self):
+        self.pacotes = 0
+        self.amostras = 0
+        self.perdidos = 0
+        self.fora_de_ordem = 0
+        self.invalidos = 0
+        self.proxima_seq = None
+        self.jitter_us = 0.0
+        self.transito_anterior = None
+        self.intervalos = []
+        self.ultima_chegada = None
+
+    def registrar(self, seq, envio_us, chegada_s):
+        self.pacotes += 1
+        if self.proxima_seq is not None:
+            if seq > self.proxima_seq:
+                self.perdidos += seq - self.proxima_seq
+            elif seq < self.proxima_seq:
+                self.fora_de_ordem += 1
+                return
+        self.proxima_seq = seq + 1
+
+        # Jitter (RFC 3550): variação do tempo de trânsito entre pacotes seguidos.
+        # O relógio da placa (32 bits em µs) dá a volta a cada ~71 min.
+        chegada_us = chegada_s * 1e6
+        transito = chegada_us - envio_us
+        if self.transito_anterior is not None:
+            d = transito - self.transito_anterior
+            d = (d + 2**31) % 2**32 - 2**31
+            self.jitter_us += (abs(d) - self.jitter_us) / 16.0
+        self.transito_anterior = transito
+
+        if self.ultima_chegada is not None:
+            self.intervalos.append(chegada_s - self.ultima_chegada)
+        self.ultima_chegada = chegada_s
+
+    def resumo(self):
+        esperados = self.pacotes + self.perdidos
+        perda = 100.0 * self.perdidos / esperados if esperados else 0.0
+        texto = (f"pacotes={self.pacotes} amostras={self.amostras} perdidos={self.perdidos} "
+                 f"({perda:.2f}%) fora_de_ordem={self.fora_de_ordem} invalidos={self.invalidos} "
+                 f"jitter={self.jitter_us / 1000:.2f}ms")
+        if len(self.intervalos) > 1:
+            media = sum(self.intervalos) / len(self.intervalos)
+            desvio = math.sqrt(sum((x - media) ** 2 for x in self.intervalos) / (len(self.intervalos) - 1))
+            texto += f" intervalo={media * 1000:.2f}±{desvio * 1000:.2f}ms"
+        self.intervalos.clear()
+        return texto
+
+
+def decodificar(datagrama):
+    """Retorna (sequencia, envio_us, amostras) ou None se o datagrama for inválido."""
+    if len(datagrama) < CABECALHO.size:
+        return None
+    magico, versao, quantidade, seq, envio_us = CABECALHO.unpack_from(datagrama)
+    if magico != MAGICO or versao != VERSAO or len(datagrama) != CABECALHO.size + quantidade * AMOSTRA.size:
+        return None
+    amostras = [AMOSTRA.unpack_from(datagrama, CABECALHO.size + i * AMOSTRA.size) for i in range(quantidade)]
+    return seq, envio_us, amostras
+
+
+class LeitorSerial:
+    """Separa os quadros da saída binária do shell, ressincronizando pelo cabeçalho."""
+
+    def __init__(self, porta, taxa_hz):
+        import serial  # pyserial, só necessário neste modo
+        self.porta = serial.Serial(porta, 115200, timeout=0.5)
+        self.buffer = bytearray()
+        self.porta.write(f"stream {taxa_hz}\n".encode())
+
+    def fechar(self):
+        self.porta.write(b"stream parar\n")
+        self.porta.close()
+
+    def receber(self):
+        """Retorna o próximo quadro completo, b"" se ainda não chegou ou None se o lixo foi descartado."""
+        self.buffer += self.porta.read(max(1, self.porta.in_waiting))
+        inicio = self.buffer.find(struct.pack("<HB", MAGICO, VERSAO))
+        if inicio < 0:
+            del self.buffer[:-2]  # Mantém um possível cabeçalho partido
+            return b""
+        descartou = inicio > 0
+        del self.buffer[:inicio]
+        if len(self.buffer) < CABECALHO.size:
+            return None if descartou else b""
+        tamanho = CABECALHO.size + self.buffer[3] * AMOSTRA.size
+        if len(self.buffer) < tamanho:
+            return None if descartou else b""
+        quadro = bytes(self.buffer[:tamanho])
+        del self.buffer[:tamanho]
+        return quadro
+
+
+def linha_csv(recebido_s, seq, amostra):
+    (instante, zona, estado, ciclo, bruta, temp, setpoint, integral, angulo, ventoinha,
+     angulo_atual, ventoinha_atual, umidade) = amostra
+    modo = (estado >> 2) & 0x3
+    return [
+        f"{recebido_s:.6f}", seq, instante, zona, ciclo, estado & 1, (estado >> 1) & 1,
+        MODOS[modo] if modo < len(MODOS) else modo,
+        bruta / 100, temp / 100, setpoint / 100, integral / 100, angulo / 10, ventoinha,
+        angulo_atual / 10, ventoinha_atual, umidade,
+    ]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--porta", type=int, default=5005)
+    parser.add_argument("--csv", default="telemetria.csv", help="arquivo de saída")
+    parser.add_argument("--intervalo", type=float, default=5.0, help="segundos entre relatórios")
+    parser.add_argument("--serial", help="porta serial da placa (em vez de UDP)")
+    parser.add_argument("--taxa", type=int, default=20, help="quadros por segundo na serial (1 a 50)")
+    args = parser.parse_args()
+
+    if args.serial:
+        leitor = LeitorSerial(args.serial, args.taxa)
+        receber = leitor.receber
+        origem = f"na serial {args.serial}"
+    else:
+        leitor = None
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.bind(("", args.porta))
+        sock.settimeout(0.5)
+
+        def receber():
+            try:
+                return sock.recvfrom(2048)[0]
+            except socket.timeout:
+                return b""
+        origem = f"na porta UDP {args.porta}"
+
+    estatisticas = Estatisticas()
+    print(f"Aguardando telemetria {origem}, gravando em {args.csv}", file=sys.stderr)
+
+    with open(args.csv, "w", newline="") as arquivo:
+        escritor = csv.writer(arquivo)
+        escritor.writerow(COLUNAS)
+        proximo_relatorio = time.monotonic() + args.intervalo
+        try:
+            while True:
+                datagrama = receber()
+                if datagrama:
+                    chegada = time.monotonic()
+                    decodificado = decodificar(datagrama)
+                    if decodificado is None:
+                        estatisticas.invalidos += 1
+                    else:
+                        seq, envio_us, amostras = decodificado
+                        estatisticas.registrar(seq, envio_us, chegada)
+                        estatisticas.amostras += len(amostras)
+                        recebido = time.time()
+                        escritor.writerows(linha_csv(recebido, seq, a) for a in amostras)
+                elif datagrama is None:
+                    estatisticas.invalidos += 1
+
+                if time.monotonic() >= proximo_relatorio:
+                    arquivo.flush()
+                    print(estatisticas.resumo(), file=sys.stderr)
+                    proximo_relatorio += args.intervalo
+        except KeyboardInterrupt:
+            print("\nFinal: " + estatisticas.resumo(), file=sys.stderr)
+        finally:
+            if leitor:
+                leitor.fechar()
+
+
+if __name__ == "__main__":
+    main()